@@ -0,0 +1,298 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "tools/io_packager.h"
+
+namespace
+{
+std::atomic<std::uint64_t> allocationCount{0};
+
+void *countedAllocate(std::size_t size) noexcept
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+}
+
+// Every non-aligned form is replaced so nothing allocated here reaches the library's delete (or
+// the reverse); std::stable_sort, for one, uses the nothrow form.
+void *operator new(std::size_t size)
+{
+    if (void *ptr = countedAllocate(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+ExternalIoEnvelope makeEnvelope()
+{
+    ExternalIoEnvelope envelope;
+    envelope.metadata.platformProfile = "air";
+    envelope.metadata.adapterId = "official.air";
+    envelope.metadata.adapterVersion = "1.0.0";
+    envelope.metadata.uiSurface = "tui";
+    envelope.metadata.seed = 42U;
+    envelope.mode.activeMode = "gps";
+    envelope.mode.contributors = {"gps", "imu", "baro"};
+    envelope.mode.confidence = 0.9101234567890123;
+    envelope.mode.decisionReason = "gps_eligible";
+    envelope.mode.ladderStatus = "ok";
+    const char *sensorIds[] = {"gps", "imu", "radar", "thermal", "vision", "lidar", "magnetometer", "baro",
+                               "dead_reckoning"};
+    int index = 0;
+    for (const char *sensorId : sensorIds)
+    {
+        envelope.sensors.push_back({sensorId, true, index % 3 != 0, true, 0.1 * index, 0.95 - 0.01 * index, ""});
+        ++index;
+    }
+    envelope.frontView.activeMode = "eo";
+    envelope.frontView.viewState = "streaming";
+    envelope.frontView.frameId = "frame-000123";
+    envelope.frontView.sequence = 123U;
+    envelope.frontView.timestampMs = 1700000000123ULL;
+    envelope.frontView.latencyMs = 10.987654321012345;
+    envelope.frontView.confidence = 0.8123456789012345;
+    envelope.frontView.gimbalYawDeg = 12.3456789012345;
+    envelope.frontView.streamCount = 2U;
+    envelope.frontView.maxConcurrentViews = 2U;
+    for (unsigned int stream = 0; stream < 2U; ++stream)
+    {
+        ExternalIoFrontViewStreamRecord record;
+        record.streamId = "stream-" + std::to_string(stream);
+        record.activeMode = stream == 0 ? "eo" : "ir";
+        record.frameId = "frame-000123";
+        record.sensorType = record.activeMode;
+        record.sequence = 123U;
+        record.timestampMs = 1700000000123ULL;
+        record.latencyMs = 11.5 + stream;
+        record.confidence = 0.8;
+        envelope.frontViewStreams.push_back(record);
+    }
+    envelope.authStatus = "authenticated";
+    envelope.loggingStatus = "ok";
+    envelope.adapterStatus = "ok";
+    return envelope;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int messages = 20000;
+    if (argc > 1)
+    {
+        messages = std::stoi(argv[1]);
+    }
+    if (messages <= 0)
+    {
+        std::cerr << "Usage: AirTraceIoEnvelopeBench [messages>0]\n";
+        return 1;
+    }
+
+    ExternalIoEnvelope envelope = makeEnvelope();
+    const tools::IoEnvelopeFormat formats[] = {
+        tools::IoEnvelopeFormat::Json, tools::IoEnvelopeFormat::KeyValue, tools::IoEnvelopeFormat::Binary};
+    std::uint64_t bufferAllocations = 0;
+    std::uint64_t parseAllocations = 0;
+    bool matches = true;
+    bool parsed = true;
+    for (tools::IoEnvelopeFormat format : formats)
+    {
+        const std::string reference = tools::serializeExternalIoEnvelope(format, envelope).payload;
+        double resultSeconds = 0.0;
+        double bufferSeconds = 0.0;
+        std::uint64_t resultAllocations = 0;
+        double parseSeconds = 0.0;
+        double parseIntoSeconds = 0.0;
+        std::uint64_t checksum = 0;
+        std::string buffer;
+        tools::serializeExternalIoEnvelope(format, envelope, buffer);
+        ExternalIoEnvelope decoded;
+        std::string error;
+        tools::parseExternalIoEnvelope(format, buffer, decoded, error);
+        for (int message = 0; message < messages; ++message)
+        {
+            envelope.frontView.sequence = static_cast<unsigned int>(message);
+
+            std::uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+            auto start = std::chrono::steady_clock::now();
+            const tools::IoEnvelopeSerializeResult result = tools::serializeExternalIoEnvelope(format, envelope);
+            auto stop = std::chrono::steady_clock::now();
+            resultAllocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+            resultSeconds += std::chrono::duration<double>(stop - start).count();
+
+            allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+            start = std::chrono::steady_clock::now();
+            tools::serializeExternalIoEnvelope(format, envelope, buffer);
+            stop = std::chrono::steady_clock::now();
+            bufferAllocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+            bufferSeconds += std::chrono::duration<double>(stop - start).count();
+
+            matches = matches && buffer == result.payload;
+            checksum += buffer.size();
+
+            start = std::chrono::steady_clock::now();
+            const tools::IoEnvelopeParseResult parsedResult = tools::parseExternalIoEnvelope(format, buffer);
+            stop = std::chrono::steady_clock::now();
+            parseSeconds += std::chrono::duration<double>(stop - start).count();
+
+            allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+            start = std::chrono::steady_clock::now();
+            const bool parsedInto = tools::parseExternalIoEnvelope(format, buffer, decoded, error);
+            stop = std::chrono::steady_clock::now();
+            parseAllocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+            parseIntoSeconds += std::chrono::duration<double>(stop - start).count();
+
+            parsed = parsed && parsedResult.ok && parsedInto && decoded.frontView.sequence == envelope.frontView.sequence &&
+                     parsedResult.envelope.frontView.sequence == envelope.frontView.sequence;
+            checksum += decoded.sensors.size();
+        }
+        tools::serializeExternalIoEnvelope(format, decoded, buffer);
+        parsed = parsed && buffer == tools::serializeExternalIoEnvelope(format, envelope).payload;
+        envelope.frontView.sequence = 123U;
+        tools::serializeExternalIoEnvelope(format, envelope, buffer);
+        matches = matches && buffer == reference;
+
+        std::cout << "IO envelope benchmark: format=" << tools::ioEnvelopeFormatName(format)
+                  << " messages=" << messages << " bytes=" << reference.size()
+                  << " ns/serialize=" << (resultSeconds * 1e9 / messages)
+                  << " ns/serialize(buffer)=" << (bufferSeconds * 1e9 / messages)
+                  << " allocations/serialize=" << (static_cast<double>(resultAllocations) / messages)
+                  << " ns/parse=" << (parseSeconds * 1e9 / messages)
+                  << " ns/parse(reuse)=" << (parseIntoSeconds * 1e9 / messages)
+                  << " checksum=" << checksum << "\n";
+    }
+
+    // Delta stream: a tick moves the front-view clock, latencies and sensor freshness, as a live
+    // publisher does, and every decoded envelope must match the encoded one.
+    {
+        tools::IoEnvelopeDeltaEncoder encoder;
+        tools::IoEnvelopeDeltaDecoder decoder;
+        ExternalIoEnvelope tick = envelope;
+        ExternalIoEnvelope decoded;
+        std::string payload;
+        std::string full;
+        std::string error;
+        std::uint64_t deltaBytes = 0;
+        std::uint64_t fullBytes = 0;
+        double encodeSeconds = 0.0;
+        double decodeSeconds = 0.0;
+        bool deltaMatches = true;
+        for (int message = 0; message < messages; ++message)
+        {
+            tick.frontView.timestampMs += 20U;
+            tick.frontView.sequence += 1U;
+            tick.frontView.frameAgeMs = 5.0 + (message % 7);
+            tick.frontView.latencyMs = 12.0 + (message % 5);
+            for (auto &stream : tick.frontViewStreams)
+            {
+                stream.timestampMs = tick.frontView.timestampMs;
+                stream.sequence += 1U;
+            }
+            for (auto &sensor : tick.sensors)
+            {
+                sensor.freshnessSeconds = 0.02 * (message % 3);
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            encoder.encode(tick, payload);
+            auto stop = std::chrono::steady_clock::now();
+            encodeSeconds += std::chrono::duration<double>(stop - start).count();
+
+            start = std::chrono::steady_clock::now();
+            deltaMatches = decoder.decode(payload, decoded, error) && deltaMatches;
+            stop = std::chrono::steady_clock::now();
+            decodeSeconds += std::chrono::duration<double>(stop - start).count();
+
+            tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, tick, full);
+            deltaBytes += payload.size();
+            fullBytes += full.size();
+            tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, decoded, payload);
+            deltaMatches = deltaMatches && payload == full;
+        }
+        std::cout << "IO envelope benchmark: format=delta messages=" << messages
+                  << " bytes/tick=" << (static_cast<double>(deltaBytes) / messages)
+                  << " full_bytes/tick=" << (static_cast<double>(fullBytes) / messages)
+                  << " ns/encode=" << (encodeSeconds * 1e9 / messages)
+                  << " ns/decode=" << (decodeSeconds * 1e9 / messages) << "\n";
+        if (!deltaMatches)
+        {
+            std::cerr << "Delta stream failed to reconstruct an envelope: " << error << "\n";
+            return 1;
+        }
+    }
+
+    if (!matches)
+    {
+        std::cerr << "Buffer serializer diverged from serializeExternalIoEnvelope().\n";
+        return 1;
+    }
+    if (bufferAllocations != 0)
+    {
+        std::cerr << "Buffer serializer allocated " << bufferAllocations << " times in steady state.\n";
+        return 1;
+    }
+    if (!parsed)
+    {
+        std::cerr << "Parser failed to round-trip serialized envelopes.\n";
+        return 1;
+    }
+    if (parseAllocations != 0)
+    {
+        std::cerr << "Reusing parser allocated " << parseAllocations << " times in steady state.\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,5 +1,7 @@
+#include "tools/io_envelope_stream.h"
 #include "tools/io_packager.h"
 
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -12,7 +14,8 @@ void printUsage()
 {
     std::cerr << "Usage: AirTraceIoPackager [--list-formats] "
                  "--in-format <format> --out-format <format> "
-                 "--input <path|-> --output <path|->\n";
+                 "--input <path|-> --output <path|-> "
+                 "[--in-framing <newline|length>] [--out-framing <newline|length>] [--workers <n>]\n";
 }
 
 void printFormats()
@@ -76,6 +79,64 @@ bool writeAll(const std::string &path, const std::string &content)
     file << content;
     return static_cast<bool>(file);
 }
+
+tools::IoEnvelopeFraming defaultFraming(tools::IoEnvelopeFormat format)
+{
+    return format == tools::IoEnvelopeFormat::Json ? tools::IoEnvelopeFraming::Newline
+                                                   : tools::IoEnvelopeFraming::LengthPrefixed;
+}
+
+// Converts a stream of framed envelopes. A file input with more than one worker is mapped and
+// decoded in parallel chunks; stdin is read through a bounded window.
+int runStream(const std::string &inputPath, const std::string &outputPath, const tools::IoEnvelopeStreamOptions &options)
+{
+    const int outputFd = outputPath == "-" ? 1 : tools::openIoEnvelopeStreamFile(outputPath, true);
+    if (outputFd < 0)
+    {
+        std::cerr << "Failed to open output: " << outputPath << "\n";
+        return 1;
+    }
+
+    tools::IoEnvelopeStreamResult result;
+    if (inputPath != "-" && options.workers > 1)
+    {
+        tools::IoEnvelopeArchive archive;
+        std::string error;
+        if (!archive.open(inputPath, error))
+        {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        result = tools::convertExternalIoEnvelopeArchive(archive.bytes(), outputFd, options);
+    }
+    else
+    {
+        const int inputFd = inputPath == "-" ? 0 : tools::openIoEnvelopeStreamFile(inputPath, false);
+        if (inputFd < 0)
+        {
+            std::cerr << "Failed to read input payload: " << inputPath << "\n";
+            return 1;
+        }
+        result = tools::convertExternalIoEnvelopeStream(inputFd, outputFd, options);
+        if (inputFd != 0)
+        {
+            tools::closeIoEnvelopeStreamFile(inputFd);
+        }
+    }
+    if (outputFd != 1)
+    {
+        tools::closeIoEnvelopeStreamFile(outputFd);
+    }
+
+    if (!result.ok)
+    {
+        std::cerr << "Conversion failed: " << result.error << "\n";
+        return 1;
+    }
+    std::cerr << "Converted " << result.records << " envelopes (" << result.bytesIn << " -> " << result.bytesOut
+              << " bytes)\n";
+    return 0;
+}
 } // namespace
 
 int main(int argc, char **argv)
@@ -84,6 +145,9 @@ int main(int argc, char **argv)
     std::string outputPath = "-";
     std::string inputFormatText;
     std::string outputFormatText;
+    std::string inputFramingText;
+    std::string outputFramingText;
+    std::size_t workers = 1;
     bool listFormats = false;
 
     for (int idx = 1; idx < argc; ++idx)
@@ -114,6 +178,21 @@ int main(int argc, char **argv)
             outputFormatText = argv[++idx];
             continue;
         }
+        if (arg == "--in-framing" && idx + 1 < argc)
+        {
+            inputFramingText = argv[++idx];
+            continue;
+        }
+        if (arg == "--out-framing" && idx + 1 < argc)
+        {
+            outputFramingText = argv[++idx];
+            continue;
+        }
+        if (arg == "--workers" && idx + 1 < argc)
+        {
+            workers = static_cast<std::size_t>(std::strtoul(argv[++idx], nullptr, 10));
+            continue;
+        }
         printUsage();
         return 1;
     }
@@ -143,6 +222,27 @@ int main(int argc, char **argv)
         return 1;
     }
 
+    if (!inputFramingText.empty() || !outputFramingText.empty() || workers > 1)
+    {
+        tools::IoEnvelopeStreamOptions options;
+        tools::parseIoEnvelopeFormat(inputFormatText, options.inputFormat);
+        tools::parseIoEnvelopeFormat(outputFormatText, options.outputFormat);
+        options.inputFraming = defaultFraming(options.inputFormat);
+        options.outputFraming = defaultFraming(options.outputFormat);
+        if (!inputFramingText.empty() && !tools::parseIoEnvelopeFraming(inputFramingText, options.inputFraming))
+        {
+            std::cerr << "Unsupported input framing: " << inputFramingText << "\n";
+            return 1;
+        }
+        if (!outputFramingText.empty() && !tools::parseIoEnvelopeFraming(outputFramingText, options.outputFraming))
+        {
+            std::cerr << "Unsupported output framing: " << outputFramingText << "\n";
+            return 1;
+        }
+        options.workers = workers;
+        return runStream(inputPath, outputPath, options);
+    }
+
     std::string inputPayload;
     if (!readAll(inputPath, inputPayload))
     {
@@ -0,0 +1,144 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "core/mode_manager.h"
+#include "core/random_streams.h"
+#include "core/sensors.h"
+#include "core/state.h"
+
+namespace
+{
+std::atomic<std::uint64_t> allocationCount{0};
+}
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+int main(int argc, char **argv)
+{
+    int steps = 20000;
+    if (argc > 1)
+    {
+        steps = std::stoi(argv[1]);
+    }
+    if (steps <= 0)
+    {
+        std::cerr << "Usage: AirTraceModeDecideBench [steps>0]\n";
+        return 1;
+    }
+
+    const SensorConfig sensorConfig{10.0, 0.5, 0.02, 0.0, 10000.0};
+    GpsSensor gps(sensorConfig);
+    ThermalSensor thermal(sensorConfig);
+    DeadReckoningSensor deadReckoning(sensorConfig);
+    ImuSensor imu(sensorConfig);
+    RadarSensor radar(sensorConfig);
+    VisionSensor vision(sensorConfig);
+    LidarSensor lidar(sensorConfig);
+    MagnetometerSensor magnetometer(sensorConfig);
+    BarometerSensor baro(sensorConfig);
+    std::vector<SensorBase *> sensors{&gps, &thermal, &radar, &deadReckoning, &imu, &vision, &lidar, &magnetometer, &baro};
+
+    ModeManagerConfig modeConfig;
+    modeConfig.minHealthyCount = 2;
+    modeConfig.minDwellSteps = 2;
+    modeConfig.maxStaleCount = 3;
+    modeConfig.maxLowConfidenceCount = 3;
+    modeConfig.lockoutSteps = 4;
+    modeConfig.maxDisagreementCount = 3;
+    modeConfig.disagreementThreshold = 50.0;
+    modeConfig.historyWindow = 8;
+    ModeManager manager(modeConfig);
+    ModeManager compactManager(modeConfig);
+
+    State9 state{};
+    state.position = {100.0, 200.0, 300.0};
+    state.velocity = {10.0, 5.0, 0.0};
+    const double dt = 0.1;
+    const int warmupSteps = 200;
+
+    std::uint64_t decideAllocations = 0;
+    double decideSeconds = 0.0;
+    double compactSeconds = 0.0;
+    std::uint64_t detailBuilds = 0;
+    std::uint64_t checksum = 0;
+    bool compactMatches = true;
+    for (int step = 0; step < warmupSteps + steps; ++step)
+    {
+        state = integrateState(state, dt);
+        for (auto *sensor : sensors)
+        {
+            CounterNoiseSource noise({7ULL, 0U, sensor->getStreamId(), static_cast<std::uint32_t>(step)});
+            sensor->sample(state, dt, noise);
+        }
+
+        const std::uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+        const ModeDecision &decision = manager.decide(sensors);
+        const auto stop = std::chrono::steady_clock::now();
+        const std::uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+        const std::uint64_t compactAllocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        const auto compactStart = std::chrono::steady_clock::now();
+        const CompactModeDecision &compact = compactManager.decideCompact(sensors);
+        const auto compactStop = std::chrono::steady_clock::now();
+        const std::uint64_t compactAllocations =
+            allocationCount.load(std::memory_order_relaxed) - compactAllocationsBefore;
+        // Typical consumer: only materialize the detail when the decision changes.
+        if (compact.changed)
+        {
+            compactManager.getLastDecisionDetail();
+            detailBuilds += 1;
+        }
+
+        compactMatches = compactMatches && compact.mode == decision.mode;
+        checksum = checksum * 31U + static_cast<std::uint64_t>(decision.mode);
+        if (step >= warmupSteps)
+        {
+            decideAllocations += allocations + compactAllocations;
+            decideSeconds += std::chrono::duration<double>(stop - start).count();
+            compactSeconds += std::chrono::duration<double>(compactStop - compactStart).count();
+        }
+    }
+
+    std::cout << "Mode decide benchmark: steps=" << steps
+              << " ns/decide=" << (decideSeconds * 1e9 / steps)
+              << " ns/decideCompact=" << (compactSeconds * 1e9 / steps)
+              << " detailBuilds=" << detailBuilds
+              << " allocations/decide=" << (static_cast<double>(decideAllocations) / steps)
+              << " checksum=" << checksum << "\n";
+    if (!compactMatches)
+    {
+        std::cerr << "decideCompact() diverged from decide().\n";
+        return 1;
+    }
+    if (decideAllocations != 0)
+    {
+        std::cerr << "decide() allocated " << decideAllocations << " times in steady state.\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/cpu_features.h"
+#include "core/motion_models.h"
+#include "core/state.h"
+
+namespace
+{
+struct BenchResult
+{
+    double trackStepsPerSecond = 0.0;
+    std::uint64_t checksum = 0;
+};
+
+State9Batch makeTracks(std::size_t count, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> position(-1000.0, 1000.0);
+    std::uniform_real_distribution<double> velocity(-40.0, 40.0);
+    std::uniform_real_distribution<double> acceleration(-3.0, 3.0);
+    State9Batch batch;
+    batch.reserve(count);
+    for (std::size_t idx = 0; idx < count; ++idx)
+    {
+        State9 state{};
+        state.position = {position(rng), position(rng), position(rng) * 0.1 + 500.0};
+        state.velocity = {velocity(rng), velocity(rng), velocity(rng) * 0.1};
+        state.acceleration = {acceleration(rng), acceleration(rng), acceleration(rng)};
+        batch.push_back(state);
+    }
+    return batch;
+}
+
+std::uint64_t checksumBatch(const State9Batch &batch)
+{
+    std::uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&](const std::vector<double> &values)
+    {
+        for (double value : values)
+        {
+            std::uint64_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            hash ^= bits;
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(batch.positionX);
+    mix(batch.positionY);
+    mix(batch.positionZ);
+    mix(batch.velocityX);
+    mix(batch.velocityY);
+    mix(batch.velocityZ);
+    mix(batch.time);
+    return hash;
+}
+
+BenchResult runBench(SimdLevel level, MotionModelType model, std::size_t tracks, int steps)
+{
+    const MotionBounds bounds{{-5000.0, -5000.0, 0.0}, {5000.0, 5000.0, 12000.0}, 250.0, 30.0, 3.0};
+    const ManeuverParams maneuvers{2.0, 0.1};
+    State9Batch batch = makeTracks(tracks, 42U);
+    std::mt19937 rng(7U);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; ++step)
+    {
+        stepMotionModels(batch, model, 0.02, bounds, maneuvers, rng, level);
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    BenchResult result;
+    const double seconds = std::chrono::duration<double>(stop - start).count();
+    result.trackStepsPerSecond = seconds > 0.0 ? (static_cast<double>(tracks) * steps) / seconds : 0.0;
+    result.checksum = checksumBatch(batch);
+    return result;
+}
+
+const char *modelName(MotionModelType model)
+{
+    switch (model)
+    {
+    case MotionModelType::ConstantVelocity:
+        return "constant_velocity";
+    case MotionModelType::ConstantAcceleration:
+        return "constant_acceleration";
+    case MotionModelType::CoordinatedTurn:
+        return "coordinated_turn";
+    case MotionModelType::RandomManeuver:
+        return "random_maneuver";
+    default:
+        return "unknown";
+    }
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::size_t tracks = 10000;
+    int steps = 500;
+    if (argc > 1)
+    {
+        tracks = static_cast<std::size_t>(std::stoul(argv[1]));
+    }
+    if (argc > 2)
+    {
+        steps = std::stoi(argv[2]);
+    }
+    if (tracks == 0 || steps <= 0)
+    {
+        std::cerr << "Usage: AirTraceMotionBench [tracks>0] [steps>0]\n";
+        return 1;
+    }
+
+    std::cout << "Motion kernel benchmark: tracks=" << tracks << " steps=" << steps
+              << " detected=" << simdLevelName(detectSimdLevel()) << "\n";
+
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::Sse4, SimdLevel::Avx2, SimdLevel::Avx512};
+    const MotionModelType models[] = {
+        MotionModelType::ConstantVelocity,
+        MotionModelType::ConstantAcceleration,
+        MotionModelType::CoordinatedTurn,
+        MotionModelType::RandomManeuver};
+
+    bool deterministic = true;
+    for (MotionModelType model : models)
+    {
+        std::uint64_t referenceChecksum = 0;
+        for (SimdLevel level : levels)
+        {
+            if (!simdLevelSupported(level))
+            {
+                std::cout << "  " << modelName(model) << " " << simdLevelName(level) << ": unsupported\n";
+                continue;
+            }
+            BenchResult result = runBench(level, model, tracks, steps);
+            if (level == SimdLevel::Scalar)
+            {
+                referenceChecksum = result.checksum;
+            }
+            const bool matches = result.checksum == referenceChecksum;
+            deterministic = deterministic && matches;
+            std::cout << "  " << modelName(model) << " " << simdLevelName(level)
+                      << ": steps/sec=" << static_cast<std::uint64_t>(result.trackStepsPerSecond)
+                      << " checksum=" << std::hex << result.checksum << std::dec
+                      << (matches ? "" : " MISMATCH") << "\n";
+        }
+    }
+
+    if (!deterministic)
+    {
+        std::cerr << "Kernel outputs diverged across SIMD levels.\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,16 +1,23 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
 #include <random>
+#include <thread>
 #include <vector>
 
-#include "core/hash.h"
+#include "core/imm_filter.h"
 #include "core/mode_manager.h"
 #include "core/mode_scheduler.h"
 #include "core/motion_models.h"
+#include "core/random_streams.h"
+#include "core/sensor_sampling.h"
 #include "core/sensors.h"
 #include "core/sim_config.h"
 #include "core/state.h"
+#include "tools/dataset_integrity.h"
 #include "tools/sim_config_loader.h"
 
 namespace
@@ -84,18 +91,6 @@ MotionModelType cycleModel(int step)
     }
 }
 
-std::vector<unsigned char> readFileBytes(const std::string &path, std::string &error)
-{
-    std::ifstream file(path, std::ios::binary);
-    if (!file)
-    {
-        error = "unable to open";
-        return {};
-    }
-    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    return data;
-}
-
 bool hasPermission(const SimConfig::PolicyConfig &policy, const std::string &permission)
 {
     auto it = policy.rolePermissions.find(policy.activeRole);
@@ -130,48 +125,17 @@ DatasetCheckResult validateCelestialDataset(const SimConfig &cfg)
         return result;
     }
 
-    const std::string catalogPath = cfg.dataset.celestialCatalogPath;
-    const std::string ephPath = cfg.dataset.celestialEphemerisPath;
-    std::string error;
-
-    std::vector<unsigned char> catalog = readFileBytes(catalogPath, error);
-    if (catalog.empty())
+    tools::DatasetIntegrityOptions options;
+    options.maxSizeMB = cfg.dataset.maxSizeMB;
+    options.workers = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    const tools::DatasetIntegrityResult integrity = tools::verifyDatasetFiles(
+        {{"catalog", cfg.dataset.celestialCatalogPath, cfg.dataset.celestialCatalogHash},
+         {"ephemeris", cfg.dataset.celestialEphemerisPath, cfg.dataset.celestialEphemerisHash}},
+        options);
+    if (!integrity.ok)
     {
         result.ok = false;
-        result.message = "catalog " + error;
-        return result;
-    }
-    std::vector<unsigned char> ephemeris = readFileBytes(ephPath, error);
-    if (ephemeris.empty())
-    {
-        result.ok = false;
-        result.message = "ephemeris " + error;
-        return result;
-    }
-
-    if (cfg.dataset.maxSizeMB > 0.0)
-    {
-        double totalSizeMB = (static_cast<double>(catalog.size()) + static_cast<double>(ephemeris.size())) / (1024.0 * 1024.0);
-        if (totalSizeMB > cfg.dataset.maxSizeMB)
-        {
-            result.ok = false;
-            result.message = "dataset size exceeds limit";
-            return result;
-        }
-    }
-
-    std::string catalogHash = sha256Hex(catalog);
-    if (!hashEquals(cfg.dataset.celestialCatalogHash, catalogHash))
-    {
-        result.ok = false;
-        result.message = "catalog hash mismatch";
-        return result;
-    }
-    std::string ephemerisHash = sha256Hex(ephemeris);
-    if (!hashEquals(cfg.dataset.celestialEphemerisHash, ephemerisHash))
-    {
-        result.ok = false;
-        result.message = "ephemeris hash mismatch";
+        result.message = integrity.message;
         return result;
     }
 
@@ -183,7 +147,11 @@ int main(int argc, char **argv)
 {
     ConfigPathResult config = resolveConfigPath(argc, argv);
 
-    ConfigResult loaded = loadSimConfig(config.path);
+    // A snapshot path opts into the compiled config cache.
+    const char *snapshotPath = std::getenv("AIRTRACE_CONFIG_SNAPSHOT");
+    ConfigResult loaded = (snapshotPath != nullptr && snapshotPath[0] != '\0')
+                              ? loadSimConfigCached(config.path, snapshotPath)
+                              : loadSimConfig(config.path);
     if (!loaded.ok)
     {
         std::cerr << "Config issues:\n";
@@ -203,7 +171,6 @@ int main(int argc, char **argv)
     }
 
     const SimConfig &cfg = loaded.config;
-    std::mt19937 rng(cfg.seed);
     State9 state = cfg.initialState;
 
     bool celestialAllowed = false;
@@ -270,27 +237,62 @@ int main(int argc, char **argv)
 
     ModeScheduler scheduler(cfg.scheduler);
 
+    const std::size_t hardwareThreads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    SensorSamplingStage samplingStage(std::min(hardwareThreads, sensors.size()));
+    samplingStage.setClock([]()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    });
+    const std::size_t gpsTask = samplingStage.addTask(gps, state);
+    const std::size_t thermalTask = samplingStage.addTask(thermal, state);
+    const std::size_t radarTask = samplingStage.addTask(radar, state);
+    const std::size_t deadReckoningTask = samplingStage.addTask(deadReckoning, state);
+    const std::size_t imuTask = samplingStage.addTask(imu, state);
+    const std::size_t visionTask = samplingStage.addTask(vision, state);
+    const std::size_t lidarTask = samplingStage.addTask(lidar, state);
+    const std::size_t magnetometerTask = samplingStage.addTask(magnetometer, state);
+    const std::size_t baroTask = samplingStage.addTask(baro, state);
+    const std::size_t celestialTask = celestialAllowed ? samplingStage.addTask(celestial, state) : 0;
+
+    // Estimates which motion model the target is flying from GPS fixes alone.
+    ImmConfig immConfig;
+    immConfig.turnRateDeg = bounds.maxTurnRateDeg;
+    immConfig.filter.positionStd = std::max(1.0, gpsCfg.noiseStd);
+    ImmFilterBank imm(immConfig);
+    imm.addTrack(makeTrackEstimate(state, 25.0, 4.0, 1.0));
+    std::vector<Measurement> immMeasurements(1);
+
     double dt = cfg.dt;
     for (int i = 0; i < cfg.steps; ++i)
     {
         MotionModelType model = cycleModel(i);
-        state = stepMotionModel(state, model, dt, bounds, maneuvers, rng);
-
-        Measurement gpsMeas = gps.sample(state, dt, rng);
-        Measurement thermMeas = thermal.sample(state, dt, rng);
-        Measurement radarMeas = radar.sample(state, dt, rng);
-        Measurement drMeas = deadReckoning.sample(state, dt, rng);
-        Measurement imuMeas = imu.sample(state, dt, rng);
-        Measurement visionMeas = vision.sample(state, dt, rng);
-        Measurement lidarMeas = lidar.sample(state, dt, rng);
-        Measurement magMeas = magnetometer.sample(state, dt, rng);
-        Measurement baroMeas = baro.sample(state, dt, rng);
+        // Every producer draws from its own (seed, entity, stream, step) counter stream, so the
+        // sampling order and worker count do not affect any measurement.
+        const std::uint32_t stepIndex = static_cast<std::uint32_t>(i);
+        CounterNoiseSource motionNoise({cfg.seed, 0U, randomStreamId("motion"), stepIndex});
+        state = stepMotionModel(state, model, dt, bounds, maneuvers, motionNoise);
+
+        samplingStage.run(dt, cfg.seed, stepIndex);
+        const Measurement &gpsMeas = samplingStage.measurement(gpsTask);
+        const Measurement &thermMeas = samplingStage.measurement(thermalTask);
+        const Measurement &radarMeas = samplingStage.measurement(radarTask);
+        const Measurement &drMeas = samplingStage.measurement(deadReckoningTask);
+        const Measurement &imuMeas = samplingStage.measurement(imuTask);
+        const Measurement &visionMeas = samplingStage.measurement(visionTask);
+        const Measurement &lidarMeas = samplingStage.measurement(lidarTask);
+        const Measurement &magMeas = samplingStage.measurement(magnetometerTask);
+        const Measurement &baroMeas = samplingStage.measurement(baroTask);
         Measurement celestialMeas;
         if (celestialAllowed)
         {
-            celestialMeas = celestial.sample(state, dt, rng);
+            celestialMeas = samplingStage.measurement(celestialTask);
         }
 
+        imm.predict(dt);
+        immMeasurements[0] = gpsMeas;
+        imm.update(immMeasurements);
+        const MotionModelType immModel = imm.mostLikelyModel(0);
+
         ModeDecisionDetail detail = modeManager.decideDetailed(sensors);
         std::vector<PipelineRequest> requests = {
             {"primary_scan", ModeType::Primary, true, false, cfg.scheduler.primaryBudgetMs, 0.0},
@@ -301,6 +303,8 @@ int main(int argc, char **argv)
         Projection2D xz = projectXZ(state);
 
         std::cout << "Step " << i << " | model=" << static_cast<int>(model)
+                  << " | imm_model=" << static_cast<int>(immModel)
+                  << " | imm_p=" << imm.modelProbability(0, immModel)
                   << " | mode=" << detail.selectedMode
                   << " | conf=" << detail.confidence
                   << " | pos=(" << state.position.x << ", " << state.position.y << ", " << state.position.z << ")"
@@ -378,6 +382,12 @@ int main(int argc, char **argv)
         std::cout << "\n";
     }
 
+    std::cout << "Sensor sampling (workers=" << samplingStage.workerCount() << "):";
+    for (const auto &timing : samplingStage.timings())
+    {
+        std::cout << " " << timing.sensorName << "=" << (timing.seconds * 1000.0) << "ms/" << timing.samples;
+    }
+    std::cout << "\n";
     std::cout << "Simulation complete.\n";
     return 0;
 }
@@ -0,0 +1,219 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/imm_filter.h"
+#include "core/state.h"
+#include "core/track_filter.h"
+
+namespace
+{
+std::atomic<std::uint64_t> allocationCount{0};
+}
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+std::vector<TrackEstimate> makeEstimates(std::size_t count, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> position(-1000.0, 1000.0);
+    std::uniform_real_distribution<double> velocity(-40.0, 40.0);
+    std::vector<TrackEstimate> estimates;
+    estimates.reserve(count);
+    for (std::size_t idx = 0; idx < count; ++idx)
+    {
+        State9 state{};
+        state.position = {position(rng), position(rng), position(rng) * 0.1 + 500.0};
+        state.velocity = {velocity(rng), velocity(rng), velocity(rng) * 0.1};
+        estimates.push_back(makeTrackEstimate(state, 100.0, 25.0, 4.0));
+    }
+    return estimates;
+}
+
+// Every fourth track receives a position fix each step.
+void makeMeasurements(const TrackFilterBatch &batch, int step, std::vector<Measurement> &measurements)
+{
+    for (std::size_t idx = 0; idx < batch.size(); ++idx)
+    {
+        Measurement &measurement = measurements[idx];
+        measurement.valid = (idx + static_cast<std::size_t>(step)) % 4 == 0;
+        measurement.position = Vec3{batch.state[0][idx] + 1.0, batch.state[1][idx] - 1.0, batch.state[2][idx]};
+    }
+}
+
+std::uint64_t checksumBatch(const TrackFilterBatch &batch)
+{
+    std::uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&](const std::vector<double> &values)
+    {
+        for (double value : values)
+        {
+            std::uint64_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            hash ^= bits;
+            hash *= 1099511628211ULL;
+        }
+    };
+    for (const auto &component : batch.state)
+    {
+        mix(component);
+    }
+    for (const auto &entry : batch.covariance)
+    {
+        mix(entry);
+    }
+    return hash;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::size_t tracks = 4096;
+    int steps = 200;
+    if (argc > 1)
+    {
+        tracks = static_cast<std::size_t>(std::stoul(argv[1]));
+    }
+    if (argc > 2)
+    {
+        steps = std::stoi(argv[2]);
+    }
+    if (tracks == 0 || steps <= 0)
+    {
+        std::cerr << "Usage: AirTraceTrackFilterBench [tracks>0] [steps>0]\n";
+        return 1;
+    }
+
+    const TrackFilterConfig config;
+    const double dt = 0.05;
+    const std::vector<TrackEstimate> initial = makeEstimates(tracks, 42U);
+    std::vector<Measurement> measurements(tracks);
+
+    TrackFilterBatch batch;
+    batch.reserve(tracks);
+    for (const auto &estimate : initial)
+    {
+        batch.push_back(estimate);
+    }
+    double predictSeconds = 0.0;
+    double updateSeconds = 0.0;
+    for (int step = 0; step < steps; ++step)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        predictTracks(batch, dt, config);
+        const auto predicted = std::chrono::steady_clock::now();
+        makeMeasurements(batch, step, measurements);
+        const auto updateStart = std::chrono::steady_clock::now();
+        updateTracks(batch, measurements, config);
+        const auto stop = std::chrono::steady_clock::now();
+        predictSeconds += std::chrono::duration<double>(predicted - start).count();
+        updateSeconds += std::chrono::duration<double>(stop - updateStart).count();
+    }
+
+    // Same workload one track at a time, for comparison and as a determinism check.
+    TrackFilterBatch reference;
+    reference.reserve(tracks);
+    for (const auto &estimate : initial)
+    {
+        reference.push_back(estimate);
+    }
+    std::vector<TrackEstimate> singles = initial;
+    double singleSeconds = 0.0;
+    for (int step = 0; step < steps; ++step)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (auto &estimate : singles)
+        {
+            predictTrack(estimate, dt, config);
+        }
+        const auto stop = std::chrono::steady_clock::now();
+        singleSeconds += std::chrono::duration<double>(stop - start).count();
+        for (std::size_t idx = 0; idx < tracks; ++idx)
+        {
+            reference.set(idx, singles[idx]);
+        }
+        makeMeasurements(reference, step, measurements);
+        for (std::size_t idx = 0; idx < tracks; ++idx)
+        {
+            updateTrack(singles[idx], measurements[idx], config);
+            reference.set(idx, singles[idx]);
+        }
+    }
+
+    const double trackSteps = static_cast<double>(tracks) * steps;
+    const std::uint64_t checksum = checksumBatch(batch);
+    const bool matches = checksum == checksumBatch(reference);
+    std::cout << "Track filter benchmark: tracks=" << tracks << " steps=" << steps
+              << " ns/predict(batch)=" << (predictSeconds * 1e9 / trackSteps)
+              << " ns/predict(single)=" << (singleSeconds * 1e9 / trackSteps)
+              << " ns/update=" << (updateSeconds * 1e9 / (trackSteps / 4.0))
+              << " checksum=" << std::hex << checksum << std::dec
+              << (matches ? "" : " MISMATCH") << "\n";
+    if (!matches)
+    {
+        std::cerr << "Batched filter diverged from the per-track path.\n";
+        return 1;
+    }
+
+    // IMM bank over the same tracks; buffers are sized up front, so steady-state steps must not
+    // allocate.
+    ImmFilterBank imm;
+    imm.reserve(tracks);
+    for (const auto &estimate : initial)
+    {
+        imm.addTrack(estimate);
+    }
+    TrackFilterBatch combined;
+    combined.resize(tracks);
+    double immSeconds = 0.0;
+    std::uint64_t immAllocations = 0;
+    for (int step = 0; step < steps; ++step)
+    {
+        imm.combine(combined);
+        makeMeasurements(combined, step, measurements);
+        const std::uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+        imm.predict(dt);
+        imm.update(measurements);
+        imm.combine(combined);
+        const auto stop = std::chrono::steady_clock::now();
+        immAllocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        immSeconds += std::chrono::duration<double>(stop - start).count();
+    }
+    std::cout << "IMM benchmark: models=" << kImmModelCount
+              << " ns/track-step=" << (immSeconds * 1e9 / trackSteps)
+              << " allocations/step=" << (static_cast<double>(immAllocations) / steps) << "\n";
+    if (immAllocations != 0)
+    {
+        std::cerr << "IMM predict/update allocated " << immAllocations << " times.\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef CORE_CPU_FEATURES_H
+#define CORE_CPU_FEATURES_H
+
+// Instruction-set levels for batch kernels. Levels are ordered; a CPU that supports a level
+// also supports every lower level.
+enum class SimdLevel
+{
+    Scalar,
+    Sse4,
+    Avx2,
+    Avx512
+};
+
+struct CpuFeatures
+{
+    bool sse41 = false;
+    bool avx2 = false;
+    bool avx512f = false;
+    bool sha = false;
+};
+
+// Detected once per process (CPUID + OS register-state support); safe to call from any thread.
+const CpuFeatures &cpuFeatures();
+SimdLevel detectSimdLevel();
+bool simdLevelSupported(SimdLevel level);
+const char *simdLevelName(SimdLevel level);
+
+#endif // CORE_CPU_FEATURES_H
@@ -0,0 +1,204 @@
+#ifndef CORE_FIXED_MATRIX_H
+#define CORE_FIXED_MATRIX_H
+
+#include <cmath>
+#include <cstddef>
+
+// Row-major matrix with compile-time dimensions, stored inline (no heap). Sized for small filter
+// algebra; products are plain triple loops so the compiler can unroll them for fixed sizes.
+template <std::size_t Rows, std::size_t Cols>
+struct Matrix
+{
+    static constexpr std::size_t rows = Rows;
+    static constexpr std::size_t cols = Cols;
+
+    double values[Rows * Cols] = {};
+
+    double &operator()(std::size_t row, std::size_t col)
+    {
+        return values[row * Cols + col];
+    }
+
+    double operator()(std::size_t row, std::size_t col) const
+    {
+        return values[row * Cols + col];
+    }
+
+    static Matrix zero()
+    {
+        return Matrix{};
+    }
+
+    static Matrix identity()
+    {
+        static_assert(Rows == Cols, "identity requires a square matrix");
+        Matrix result{};
+        for (std::size_t idx = 0; idx < Rows; ++idx)
+        {
+            result(idx, idx) = 1.0;
+        }
+        return result;
+    }
+};
+
+template <std::size_t N>
+using Vector = Matrix<N, 1>;
+
+template <std::size_t Rows, std::size_t Inner, std::size_t Cols>
+Matrix<Rows, Cols> operator*(const Matrix<Rows, Inner> &lhs, const Matrix<Inner, Cols> &rhs)
+{
+    Matrix<Rows, Cols> result{};
+    for (std::size_t row = 0; row < Rows; ++row)
+    {
+        for (std::size_t inner = 0; inner < Inner; ++inner)
+        {
+            const double scale = lhs(row, inner);
+            for (std::size_t col = 0; col < Cols; ++col)
+            {
+                result(row, col) += scale * rhs(inner, col);
+            }
+        }
+    }
+    return result;
+}
+
+template <std::size_t Rows, std::size_t Cols>
+Matrix<Rows, Cols> operator+(const Matrix<Rows, Cols> &lhs, const Matrix<Rows, Cols> &rhs)
+{
+    Matrix<Rows, Cols> result{};
+    for (std::size_t idx = 0; idx < Rows * Cols; ++idx)
+    {
+        result.values[idx] = lhs.values[idx] + rhs.values[idx];
+    }
+    return result;
+}
+
+template <std::size_t Rows, std::size_t Cols>
+Matrix<Rows, Cols> operator-(const Matrix<Rows, Cols> &lhs, const Matrix<Rows, Cols> &rhs)
+{
+    Matrix<Rows, Cols> result{};
+    for (std::size_t idx = 0; idx < Rows * Cols; ++idx)
+    {
+        result.values[idx] = lhs.values[idx] - rhs.values[idx];
+    }
+    return result;
+}
+
+template <std::size_t Rows, std::size_t Cols>
+Matrix<Cols, Rows> transpose(const Matrix<Rows, Cols> &matrix)
+{
+    Matrix<Cols, Rows> result{};
+    for (std::size_t row = 0; row < Rows; ++row)
+    {
+        for (std::size_t col = 0; col < Cols; ++col)
+        {
+            result(col, row) = matrix(row, col);
+        }
+    }
+    return result;
+}
+
+// Gauss-Jordan inverse with partial pivoting. Returns false (leaving `out` unspecified) when a
+// pivot falls below `epsilon`, which the filter treats as a rejected update.
+template <std::size_t N>
+bool invert(const Matrix<N, N> &matrix, Matrix<N, N> &out, double epsilon = 1e-12)
+{
+    Matrix<N, N> work = matrix;
+    out = Matrix<N, N>::identity();
+    for (std::size_t col = 0; col < N; ++col)
+    {
+        std::size_t pivot = col;
+        for (std::size_t row = col + 1; row < N; ++row)
+        {
+            if (std::fabs(work(row, col)) > std::fabs(work(pivot, col)))
+            {
+                pivot = row;
+            }
+        }
+        if (!(std::fabs(work(pivot, col)) > epsilon))
+        {
+            return false;
+        }
+        if (pivot != col)
+        {
+            for (std::size_t idx = 0; idx < N; ++idx)
+            {
+                double swap = work(col, idx);
+                work(col, idx) = work(pivot, idx);
+                work(pivot, idx) = swap;
+                swap = out(col, idx);
+                out(col, idx) = out(pivot, idx);
+                out(pivot, idx) = swap;
+            }
+        }
+        const double scale = 1.0 / work(col, col);
+        for (std::size_t idx = 0; idx < N; ++idx)
+        {
+            work(col, idx) *= scale;
+            out(col, idx) *= scale;
+        }
+        for (std::size_t row = 0; row < N; ++row)
+        {
+            if (row == col)
+            {
+                continue;
+            }
+            const double factor = work(row, col);
+            if (factor == 0.0)
+            {
+                continue;
+            }
+            for (std::size_t idx = 0; idx < N; ++idx)
+            {
+                work(row, idx) -= factor * work(col, idx);
+                out(row, idx) -= factor * out(col, idx);
+            }
+        }
+    }
+    return true;
+}
+
+// Determinant by Gaussian elimination with partial pivoting.
+template <std::size_t N>
+double determinant(const Matrix<N, N> &matrix)
+{
+    Matrix<N, N> work = matrix;
+    double result = 1.0;
+    for (std::size_t col = 0; col < N; ++col)
+    {
+        std::size_t pivot = col;
+        for (std::size_t row = col + 1; row < N; ++row)
+        {
+            if (std::fabs(work(row, col)) > std::fabs(work(pivot, col)))
+            {
+                pivot = row;
+            }
+        }
+        if (work(pivot, col) == 0.0)
+        {
+            return 0.0;
+        }
+        if (pivot != col)
+        {
+            for (std::size_t idx = 0; idx < N; ++idx)
+            {
+                const double swap = work(col, idx);
+                work(col, idx) = work(pivot, idx);
+                work(pivot, idx) = swap;
+            }
+            result = -result;
+        }
+        result *= work(col, col);
+        for (std::size_t row = col + 1; row < N; ++row)
+        {
+            const double factor = work(row, col) / work(col, col);
+            for (std::size_t idx = col; idx < N; ++idx)
+            {
+                work(row, idx) -= factor * work(col, idx);
+            }
+        }
+    }
+    return result;
+}
+
+#endif // CORE_FIXED_MATRIX_H
@@ -1,9 +1,76 @@
 #ifndef CORE_HASH_H
 #define CORE_HASH_H
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
+// Block compression implementations. Every backend produces identical digests.
+enum class Sha256Backend
+{
+    Portable,
+    // x86 SHA extensions (SHA-NI), selected when CPUID reports them.
+    X86Sha
+};
+
+Sha256Backend detectSha256Backend();
+bool sha256BackendSupported(Sha256Backend backend);
+const char *sha256BackendName(Sha256Backend backend);
+
+// Incremental SHA-256: any sequence of update() calls hashes the same as one call over the
+// concatenated bytes, so large files and streams can be hashed without holding them in memory.
+// Full 64-byte blocks are compressed straight from the caller's buffer.
+class Sha256
+{
+public:
+    using Digest = std::array<unsigned char, 32>;
+
+    Sha256();
+    // An unsupported backend falls back to the portable one.
+    explicit Sha256(Sha256Backend backend);
+
+    void update(const void *data, std::size_t size);
+    // Pads and returns the digest, then resets for reuse.
+    Digest finish();
+    std::string finishHex();
+    void reset();
+    std::uint64_t bytesHashed() const;
+    Sha256Backend backend() const;
+
+private:
+    Sha256Backend compressBackend;
+    std::array<std::uint32_t, 8> state{};
+    std::array<unsigned char, 64> pending{};
+    std::size_t pendingBytes = 0;
+    std::uint64_t totalBytes = 0;
+};
+
+// Multi-buffer implementations for sha256Batch(). Every one produces the digests Sha256 would.
+enum class Sha256BatchBackend
+{
+    // One message after another through Sha256 and its block backend.
+    Serial,
+    // Two messages at once through the SHA extensions, their rounds interleaved.
+    X86Shax2,
+    // Eight messages at once, one per 32-bit lane of the AVX2 registers.
+    X86Avx2x8
+};
+
+Sha256BatchBackend detectSha256BatchBackend();
+bool sha256BatchBackendSupported(Sha256BatchBackend backend);
+const char *sha256BatchBackendName(Sha256BatchBackend backend);
+
+// Hashes independent messages (digests[i] is the SHA-256 of messages[i]). Meant for many short
+// inputs such as audit records, where a lone message cannot fill the vector lanes. An unsupported
+// backend falls back to Serial.
+std::vector<Sha256::Digest> sha256Batch(const std::vector<std::string_view> &messages);
+std::vector<Sha256::Digest> sha256Batch(const std::vector<std::string_view> &messages, Sha256BatchBackend backend);
+
+std::string sha256DigestHex(const Sha256::Digest &digest);
+std::string sha256Hex(const void *data, std::size_t size);
 std::string sha256Hex(const std::vector<unsigned char> &data);
 bool hashEquals(const std::string &expectedHex, const std::string &actualHex);
 
@@ -0,0 +1,95 @@
+#ifndef CORE_IMM_FILTER_H
+#define CORE_IMM_FILTER_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "core/motion_models.h"
+#include "core/track_filter.h"
+
+// One model-matched filter per MotionModelType, indexed by the enum value.
+constexpr std::size_t kImmModelCount = 4;
+
+struct ImmConfig
+{
+    // Measurement noise and the ConstantAcceleration model's jerk density.
+    TrackFilterConfig filter{};
+    // White-acceleration density (m^2/s^3) for the ConstantVelocity and CoordinatedTurn models.
+    double velocityNoiseDensity = 0.5;
+    // Turn rate assumed by the CoordinatedTurn model, as MotionBounds::maxTurnRateDeg.
+    double turnRateDeg = 3.0;
+    // Jerk density for the RandomManeuver model; large, so it absorbs sudden acceleration changes.
+    double maneuverJerkDensity = 50.0;
+    // Markov model-switch probabilities, transition[from][to]; each row must sum to 1.
+    double transition[kImmModelCount][kImmModelCount] = {
+        {0.94, 0.02, 0.02, 0.02},
+        {0.02, 0.94, 0.02, 0.02},
+        {0.02, 0.02, 0.94, 0.02},
+        {0.02, 0.02, 0.02, 0.94}};
+    double initialProbability[kImmModelCount] = {0.25, 0.25, 0.25, 0.25};
+    // Floor applied to model probabilities so a model can always recover; must be > 0.
+    double minProbability = 1e-6;
+};
+
+// Checks the Markov parameters: transition entries in [0, 1] with every row summing to 1 and
+// every column nonzero (so each model can be reached), initial probabilities in [0, 1] summing to
+// 1, and 0 < minProbability <= 1 / kImmModelCount.
+bool validateImmConfig(const ImmConfig &config);
+
+// Interacting Multiple Model estimator over many tracks. Each model keeps a TrackFilterBatch;
+// mixing, model-matched prediction, and combination run component by component across all
+// tracks. Buffers are sized by addTrack()/reserve(); predict(), update(), and combine() do not
+// allocate.
+class ImmFilterBank
+{
+public:
+    // A config that fails validateImmConfig() has its transition matrix, initial probabilities,
+    // and probability floor replaced by the defaults; configValid() reports it.
+    explicit ImmFilterBank(ImmConfig config = {});
+
+    std::size_t size() const;
+    void reserve(std::size_t count);
+    void clear();
+    // Starts a track with every model at `initial` and the configured prior probabilities.
+    std::size_t addTrack(const TrackEstimate &initial);
+
+    // Markov mixing followed by each model's prediction over dt.
+    void predict(double dt);
+    // measurements[i] updates track i (invalid measurements leave the predicted probabilities).
+    // Model probabilities are reweighted by each model's measurement likelihood. Returns the
+    // number of tracks updated.
+    std::size_t update(const std::vector<Measurement> &measurements);
+
+    double modelProbability(std::size_t track, MotionModelType model) const;
+    MotionModelType mostLikelyModel(std::size_t track) const;
+    const TrackFilterBatch &modelEstimates(MotionModelType model) const;
+    TrackEstimate combinedEstimate(std::size_t track) const;
+    // Probability-weighted estimates for every track; `out` is resized to size().
+    void combine(TrackFilterBatch &out) const;
+
+    const ImmConfig &getConfig() const;
+    bool configValid() const;
+
+private:
+    struct ModelTransition
+    {
+        TrackCovariance transition{};
+        TrackCovariance noise{};
+    };
+
+    void buildTransitions(double dt);
+
+    ImmConfig config;
+    bool validConfig = true;
+    double transitionDt = -1.0;
+    std::array<ModelTransition, kImmModelCount> transitions{};
+    std::array<TrackFilterBatch, kImmModelCount> models;
+    std::array<std::vector<double>, kImmModelCount> probability;
+    // Scratch reused every step.
+    std::array<TrackFilterBatch, kImmModelCount> mixed;
+    std::array<std::vector<double>, kImmModelCount> predictedProbability;
+    std::array<std::vector<double>, kImmModelCount * kImmModelCount> mixingWeight;
+};
+
+#endif // CORE_IMM_FILTER_H
@@ -1,6 +1,7 @@
 #ifndef CORE_MODE_MANAGER_H
 #define CORE_MODE_MANAGER_H
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -16,6 +17,23 @@ struct TrendHistory
     int sum = 0;
 };
 
+// Fields the residual check reads, copied from the selected status so changes can be detected
+// by value (a sensor may rewrite its measurement without advancing its timestamp).
+struct MeasurementSummary
+{
+    bool present = false;
+    double time = 0.0;
+    std::uint8_t fields = 0;
+    Vec3 position{};
+    Vec3 velocity{};
+    double range = 0.0;
+    double altitude = 0.0;
+    double heading = 0.0;
+    double bearing = 0.0;
+    // Derived once per update.
+    double positionRange = 0.0;
+};
+
 enum class TrackingMode
 {
     GpsIns,
@@ -42,6 +60,31 @@ struct ModeDecision
     std::string reason;
 };
 
+// Order matters: codes up to SwitchUnhealthy are prefixes completed by the mode name.
+enum class DecisionReason : std::uint8_t
+{
+    Enter,
+    Maintain,
+    Dwell,
+    Switch,
+    SwitchUnhealthy,
+    NoSensors,
+    AuthUnavailable,
+    AuthDenied,
+    InvalidLadder
+};
+
+// String-free decision. Bit i of contributorMask is the sensor ModeManager::sensorName(i);
+// `changed` is set when mode or reason differs from the previous decision.
+struct CompactModeDecision
+{
+    TrackingMode mode = TrackingMode::Hold;
+    DecisionReason reason = DecisionReason::NoSensors;
+    std::uint64_t contributorMask = 0;
+    double confidence = 0.0;
+    bool changed = false;
+};
+
 struct ModeManagerConfig
 {
     int minHealthyCount = 2;
@@ -83,29 +126,123 @@ struct ModeManagerConfig
         "hold"};
 };
 
+// Sensor and mode names are interned to small integer IDs when the manager is built (sensor names
+// first seen in decide() are interned once on arrival), and all per-sensor counters live in flat
+// arrays indexed by that ID. Once every sensor and history window has been seen, decide() reuses
+// its buffers and performs no heap allocations.
 class ModeManager
 {
 public:
     explicit ModeManager(ModeManagerConfig config = {});
-    ModeDecision decide(const std::vector<SensorBase *> &sensors);
+    // Returned references stay valid until the next decide call. The detail is only built when
+    // getLastDecisionDetail() or decideDetailed() asks for it.
+    const CompactModeDecision &decideCompact(const std::vector<SensorBase *> &sensors);
+    const ModeDecision &decide(const std::vector<SensorBase *> &sensors);
     ModeDecisionDetail decideDetailed(const std::vector<SensorBase *> &sensors);
     static std::string modeName(TrackingMode mode);
+    static const char *decisionReasonName(DecisionReason reason);
+    static void writeDecisionReason(const CompactModeDecision &decision, std::string &out);
+    const std::string &sensorName(std::size_t sensorId) const;
     const ModeDecisionDetail &getLastDecisionDetail() const;
 
+    // Pair residuals computed since construction. A pair is recomputed only when a rung reads it
+    // and one of its sensors produced a different measurement since the last computation.
+    std::uint64_t residualUpdateCount() const;
+
 private:
+    struct ResidualPair
+    {
+        int first = -1;
+        int second = -1;
+        // Summary versions the cached values were computed from.
+        std::uint64_t firstVersion = ~std::uint64_t{0};
+        std::uint64_t secondVersion = ~std::uint64_t{0};
+        bool aligned = false;
+        bool hasResidual = false;
+        double residual = 0.0;
+    };
+
+    struct SensorTrack
+    {
+        bool permitted = true;
+        int healthyCount = 0;
+        int staleCount = 0;
+        int lowConfidenceCount = 0;
+        int disagreementCount = 0;
+        TrendHistory staleHistory{};
+        TrendHistory lowConfidenceHistory{};
+        TrendHistory disagreementHistory{};
+        int lockoutRemaining = 0;
+        const char *lockoutReason = nullptr;
+        // Per-decide scratch.
+        bool seen = false;
+        bool healthyNow = false;
+        bool conflict = false;
+        const char *ineligible = nullptr;
+        double bestConfidence = 0.0;
+        const SensorStatus *status = nullptr;
+        bool summaryChecked = false;
+        MeasurementSummary summary{};
+        std::uint64_t summaryVersion = 0;
+    };
+
+    // One compiled ladder entry: required sensors as ID list and bitmask, authorization resolved
+    // once from the (immutable) config.
+    struct LadderRung
+    {
+        std::string name;
+        TrackingMode mode = TrackingMode::Hold;
+        bool hold = false;
+        std::vector<int> required;
+        std::uint64_t requiredMask = 0;
+        // Indices into residualPairs, in the (i, j > i) order of `required`.
+        std::vector<std::size_t> residualPairs;
+        const char *authReason = nullptr;
+        bool authDenied = false;
+    };
+
+    struct DisqualifiedRecord
+    {
+        std::size_t rung = 0;
+        int sensor = -1;
+        const char *source = nullptr;
+        const char *reason = nullptr;
+    };
+
+    int internSensor(const std::string &name);
+    void bindSensors(const std::vector<SensorBase *> &sensors);
+    const char *ineligibleReason(int sensorId) const;
+    void setLockout(SensorTrack &track, const char *reason);
+    std::size_t internResidualPair(int first, int second);
+    void refreshSummary(SensorTrack &track);
+    const ResidualPair &residualPair(std::size_t index);
+    void publishDetail() const;
+    void reserveDetailCapacity();
+
     ModeManagerConfig config;
     TrackingMode currentMode = TrackingMode::Hold;
     int dwellSteps = 0;
-    std::unordered_map<std::string, int> healthyCounts;
-    std::unordered_map<std::string, int> staleCounts;
-    std::unordered_map<std::string, int> lowConfidenceCounts;
-    std::unordered_map<std::string, int> disagreementCounts;
-    std::unordered_map<std::string, TrendHistory> staleHistory;
-    std::unordered_map<std::string, TrendHistory> lowConfidenceHistory;
-    std::unordered_map<std::string, TrendHistory> disagreementHistory;
-    std::unordered_map<std::string, int> lockoutRemaining;
-    std::unordered_map<std::string, std::string> lockoutReasons;
-    ModeDecisionDetail lastDecisionDetail{};
+    std::unordered_map<std::string, int> sensorIds;
+    std::vector<std::string> sensorNames;
+    std::vector<SensorTrack> tracks;
+    int celestialId = -1;
+    std::uint64_t ladderSensorMask = 0;
+    std::vector<LadderRung> ladder;
+    std::vector<std::vector<int>> modeRequired;
+    std::vector<ResidualPair> residualPairs;
+    std::uint64_t residualUpdates = 0;
+    std::vector<const SensorBase *> boundSensors;
+    std::vector<int> boundIds;
+    std::vector<DisqualifiedRecord> disqualified;
+    std::size_t maxDisqualified = 0;
+    mutable std::vector<ModeDecisionDetail::DisqualifiedSource> disqualifiedSpare;
+    mutable std::vector<ModeDecisionDetail::LockoutState> lockoutSpare;
+    CompactModeDecision lastCompact{};
+    const char *lastDowngradeReason = nullptr;
+    bool hasDecided = false;
+    ModeDecision lastDecision{TrackingMode::Hold, {}};
+    mutable ModeDecisionDetail lastDecisionDetail{};
+    mutable bool detailStale = false;
 };
 
 #endif // CORE_MODE_MANAGER_H
@@ -3,6 +3,8 @@
 
 #include <random>
 
+#include "core/cpu_features.h"
+#include "core/random_streams.h"
 #include "core/state.h"
 
 enum class MotionModelType
@@ -34,5 +36,39 @@ State9 stepMotionModel(const State9 &state,
                        const MotionBounds &bounds,
                        const ManeuverParams &params,
                        std::mt19937 &rng);
+// Same kinematics; RandomManeuver draws one event and three gaussians from `noise`.
+State9 stepMotionModel(const State9 &state,
+                       MotionModelType model,
+                       double dt,
+                       const MotionBounds &bounds,
+                       const ManeuverParams &params,
+                       NoiseSource &noise);
+
+// Advances every track in the batch with the same motion model and clamps it to bounds in a
+// single pass. Deterministic models match stepMotionModel per track exactly; RandomManeuver
+// draws from one distribution pair per call, in track order. The kernel is selected by CPUID
+// at first use; every SimdLevel produces bit-identical results.
+void stepMotionModels(State9Batch &batch,
+                      MotionModelType model,
+                      double dt,
+                      const MotionBounds &bounds,
+                      const ManeuverParams &params,
+                      std::mt19937 &rng);
+// Runs a specific kernel level; levels above detectSimdLevel() fall back to the detected level.
+void stepMotionModels(State9Batch &batch,
+                      MotionModelType model,
+                      double dt,
+                      const MotionBounds &bounds,
+                      const ManeuverParams &params,
+                      std::mt19937 &rng,
+                      SimdLevel level);
+// Counter-based variant: track i draws from stream entity streamBase.entityId + i (block 0 for the
+// maneuver event, blocks 1-2 for acceleration), so results do not depend on batch partitioning.
+void stepMotionModels(State9Batch &batch,
+                      MotionModelType model,
+                      double dt,
+                      const MotionBounds &bounds,
+                      const ManeuverParams &params,
+                      const RandomStreamKey &streamBase);
 
 #endif // CORE_MOTION_MODELS_H
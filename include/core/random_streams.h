@@ -0,0 +1,120 @@
+#ifndef CORE_RANDOM_STREAMS_H
+#define CORE_RANDOM_STREAMS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+// Identifies one independent random stream. Every (seed, entity, stream, step) tuple maps to its
+// own Philox4x32-10 counter space, so draws do not depend on call order or on which thread
+// performs them.
+struct RandomStreamKey
+{
+    std::uint64_t seed = 0;
+    std::uint32_t entityId = 0;
+    std::uint32_t streamId = 0;
+    std::uint32_t step = 0;
+};
+
+// Stable 32-bit stream identifier for a named producer (sensor name, "motion", and so on).
+std::uint32_t randomStreamId(const std::string &name);
+
+// Philox4x32-10 block function (Salmon et al., SC'11).
+std::array<std::uint32_t, 4> philox4x32(const std::array<std::uint32_t, 4> &counter,
+                                        const std::array<std::uint32_t, 2> &key);
+
+// Stateless draws: `draw` selects the counter block inside the stream. Do not mix these with a
+// CounterRng over the same key, which walks the same blocks from zero.
+double counterUniform(const RandomStreamKey &key, std::uint32_t draw);
+void counterGaussianPair(const RandomStreamKey &key, std::uint32_t draw, double &first, double &second);
+
+// Batched stateless draws across consecutive entities: element i uses entityId = base.entityId + i.
+void gaussianAcrossEntities(const RandomStreamKey &base,
+                            std::uint32_t draw,
+                            double stddev,
+                            double *out,
+                            std::size_t count);
+void bernoulliAcrossEntities(const RandomStreamKey &base,
+                             std::uint32_t draw,
+                             double probability,
+                             std::uint8_t *out,
+                             std::size_t count);
+
+// Sequential generator over one stream. Satisfies UniformRandomBitGenerator so it can also drive
+// std distributions.
+class CounterRng
+{
+public:
+    using result_type = std::uint32_t;
+
+    explicit CounterRng(const RandomStreamKey &key);
+
+    static constexpr result_type min()
+    {
+        return 0U;
+    }
+    static constexpr result_type max()
+    {
+        return 0xFFFFFFFFU;
+    }
+
+    result_type operator()();
+    double uniform();
+    double gaussian(double stddev);
+    bool bernoulli(double probability);
+    void fillGaussian(double *out, std::size_t count, double stddev);
+    const RandomStreamKey &key() const;
+
+private:
+    void refill();
+
+    RandomStreamKey streamKey;
+    std::uint32_t block = 0;
+    std::array<std::uint32_t, 4> words{};
+    std::size_t wordIndex = 4;
+    bool hasSpare = false;
+    double spare = 0.0;
+};
+
+// Noise interface used by sensors and motion models. Zero/negative stddev and probability draw
+// nothing and return 0/false.
+class NoiseSource
+{
+public:
+    virtual ~NoiseSource() = default;
+    virtual double gaussian(double stddev) = 0;
+    virtual bool event(double probability) = 0;
+    // Shared engine behind the legacy std::mt19937 APIs, or nullptr for counter streams.
+    virtual std::mt19937 *legacyEngine()
+    {
+        return nullptr;
+    }
+};
+
+// Reproduces the historical shared-std::mt19937 draws exactly (one distribution per draw).
+class Mt19937NoiseSource : public NoiseSource
+{
+public:
+    explicit Mt19937NoiseSource(std::mt19937 &rng);
+    double gaussian(double stddev) override;
+    bool event(double probability) override;
+    std::mt19937 *legacyEngine() override;
+
+private:
+    std::mt19937 &rng;
+};
+
+class CounterNoiseSource : public NoiseSource
+{
+public:
+    explicit CounterNoiseSource(const RandomStreamKey &key);
+    double gaussian(double stddev) override;
+    bool event(double probability) override;
+
+private:
+    CounterRng rng;
+};
+
+#endif // CORE_RANDOM_STREAMS_H
@@ -0,0 +1,70 @@
+#ifndef CORE_SENSOR_SAMPLING_H
+#define CORE_SENSOR_SAMPLING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "core/sensors.h"
+#include "core/state.h"
+#include "core/work_stealing_pool.h"
+
+struct SensorSamplingTask
+{
+    SensorBase *sensor = nullptr;
+    const State9 *state = nullptr;
+    std::uint32_t entityId = 0;
+};
+
+struct SensorSamplingTiming
+{
+    std::string sensorName;
+    double seconds = 0.0;
+    std::size_t samples = 0;
+};
+
+// Samples every registered (sensor, target) pair once per step across a work-stealing pool and
+// joins before returning, so ModeManager::decideDetailed always sees a complete step. Each pair
+// draws noise from the counter stream (seed, entityId, sensor stream id, step), which makes the
+// measurements independent of worker count and scheduling. Pairs that share a sensor instance
+// run sequentially, in registration order, on one worker.
+class SensorSamplingStage
+{
+public:
+    // Monotonic seconds; injected so core stays free of wall-clock access.
+    using Clock = std::function<double()>;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    explicit SensorSamplingStage(std::size_t workerCount);
+
+    // Returns the task index, or npos without registering anything when the sensor cannot draw
+    // from a counter stream (see SensorBase::supportsNoiseSource()).
+    std::size_t addTask(SensorBase &sensor, const State9 &state, std::uint32_t entityId = 0);
+    void clearTasks();
+    void setClock(Clock clock);
+
+    void run(double dt, std::uint64_t seed, std::uint32_t step);
+
+    std::size_t workerCount() const;
+    const std::vector<SensorSamplingTask> &tasks() const;
+    const std::vector<Measurement> &measurements() const;
+    const Measurement &measurement(std::size_t taskIndex) const;
+    // Accumulated per sensor name (first-registration order) since the last clearTasks().
+    std::vector<SensorSamplingTiming> timings() const;
+
+private:
+    void rebuildGroups();
+
+    WorkStealingPool pool;
+    Clock clock;
+    std::vector<SensorSamplingTask> taskList;
+    std::vector<Measurement> results;
+    std::vector<std::vector<std::size_t>> groups;
+    std::vector<double> groupSeconds;
+    std::vector<std::size_t> groupSamples;
+    bool groupsDirty = false;
+};
+
+#endif // CORE_SENSOR_SAMPLING_H
@@ -6,6 +6,7 @@
 #include <string>
 
 #include "core/provenance.h"
+#include "core/random_streams.h"
 #include "core/state.h"
 
 struct Measurement
@@ -51,18 +52,30 @@ public:
     virtual ~SensorBase() = default;
 
     Measurement sample(const State9 &state, double dt, std::mt19937 &rng);
+    // Independent of other sensors when `noise` is a per-sensor CounterNoiseSource, so sensors may
+    // be sampled concurrently and in any order.
+    Measurement sample(const State9 &state, double dt, NoiseSource &noise);
     const std::string &getName() const;
+    std::uint32_t getStreamId() const;
     const SensorStatus &getStatus() const;
     void setProvenance(ProvenanceTag tag);
     ProvenanceTag getProvenance() const;
+    // True when the sensor overrides the NoiseSource generator. Sensors written only against the
+    // std::mt19937 generator cannot draw from a counter stream and are refused by
+    // SensorSamplingStage::addTask().
+    virtual bool supportsNoiseSource() const;
 
 protected:
-    virtual Measurement generateMeasurement(const State9 &state, std::mt19937 &rng) = 0;
+    // Built-in sensors override the NoiseSource form. The std::mt19937 form is kept for sensors
+    // written against the legacy API and is only reachable from the std::mt19937 sample().
+    virtual Measurement generateMeasurement(const State9 &state, NoiseSource &noise);
+    virtual Measurement generateMeasurement(const State9 &state, std::mt19937 &rng);
     void recordFailure(const std::string &reason);
     void recordSuccess();
 
     SensorConfig config;
     std::string name;
+    std::uint32_t streamId = 0;
     SensorStatus status;
     double timeAccumulator;
     ProvenanceTag provenance = ProvenanceTag::Operational;
@@ -72,9 +85,10 @@ class GpsSensor : public SensorBase
 {
 public:
     explicit GpsSensor(const SensorConfig &config);
+    bool supportsNoiseSource() const override;
 
 protected:
-    Measurement generateMeasurement(const State9 &state, std::mt19937 &rng) override;
+    Measurement generateMeasurement(const State9 &state, NoiseSource &noise) override;
 
 private:
     Vec3 bias;
@@ -84,18 +98,20 @@ class ThermalSensor : public SensorBase
 {
 public:
     explicit ThermalSensor(const SensorConfig &config);
+    bool supportsNoiseSource() const override;
 
 protected:
-    Measurement generateMeasurement(const State9 &state, std::mt19937 &rng) override;
+    Measurement generateMeasurement(const State9 &state, NoiseSource &noise) override;
 };
 
 class DeadReckoningSensor : public SensorBase
 {
 public:
     explicit DeadReckoningSensor(const SensorConfig &config);
+    bool supportsNoiseSource() const override;
 
 protected:
-    Measurement generateMeasurement(const State9 &state, std::mt19937 &rng) override;
+    Measurement generateMeasurement(const State9 &state, NoiseSource &noise) override;
 
 private:
     Vec3 drift;
@@ -105,9 +121,10 @@ class ImuSensor : public SensorBase
 {
 public:
     explicit ImuSensor(const SensorConfig &config);
+    bool supportsNoiseSource() const override;
 
 protected:
-    Measurement generateMeasurement(const State9 &state, std::mt19937 &rng) override;
+    Measurement generateMeasurement(const State9 &state, NoiseSource &noise) override;
 
 private:
     Vec3 bias;
@@ -117,36 +134,40 @@ class RadarSensor : public SensorBase
 {
 public:
     explicit RadarSensor(const SensorConfig &config);
+    bool supportsNoiseSource() const override;
 
 protected:
-    Measurement generateMeasurement(const State9 &state, std::mt19937 &rng) override;
+    Measurement generateMeasurement(const State9 &state, NoiseSource &noise) override;
 };
 
 class VisionSensor : public SensorBase
 {
 public:
     explicit VisionSensor(const SensorConfig &config);
+    bool supportsNoiseSource() const override;
 
 protected:
-    Measurement generateMeasurement(const State9 &state, std::mt19937 &rng) override;
+    Measurement generateMeasurement(const State9 &state, NoiseSource &noise) override;
 };
 
 class LidarSensor : public SensorBase
 {
 public:
     explicit LidarSensor(const SensorConfig &config);
+    bool supportsNoiseSource() const override;
 
 protected:
-    Measurement generateMeasurement(const State9 &state, std::mt19937 &rng) override;
+    Measurement generateMeasurement(const State9 &state, NoiseSource &noise) override;
 };
 
 class MagnetometerSensor : public SensorBase
 {
 public:
     explicit MagnetometerSensor(const SensorConfig &config);
+    bool supportsNoiseSource() const override;
 
 protected:
-    Measurement generateMeasurement(const State9 &state, std::mt19937 &rng) override;
+    Measurement generateMeasurement(const State9 &state, NoiseSource &noise) override;
 
 private:
     double bias;
@@ -156,9 +177,10 @@ class BarometerSensor : public SensorBase
 {
 public:
     explicit BarometerSensor(const SensorConfig &config);
+    bool supportsNoiseSource() const override;
 
 protected:
-    Measurement generateMeasurement(const State9 &state, std::mt19937 &rng) override;
+    Measurement generateMeasurement(const State9 &state, NoiseSource &noise) override;
 
 private:
     double drift;
@@ -168,9 +190,10 @@ class CelestialSensor : public SensorBase
 {
 public:
     explicit CelestialSensor(const SensorConfig &config);
+    bool supportsNoiseSource() const override;
 
 protected:
-    Measurement generateMeasurement(const State9 &state, std::mt19937 &rng) override;
+    Measurement generateMeasurement(const State9 &state, NoiseSource &noise) override;
 
 private:
     Vec3 bias;
@@ -1,7 +1,9 @@
 #ifndef CORE_STATE_H
 #define CORE_STATE_H
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 struct Vec3
 {
@@ -18,6 +20,31 @@ struct State9
     double time;
 };
 
+// Structure-of-arrays container for many State9 tracks. Each component is stored in its own
+// contiguous array so batch kernels can stream through one quantity at a time.
+struct State9Batch
+{
+    std::vector<double> positionX;
+    std::vector<double> positionY;
+    std::vector<double> positionZ;
+    std::vector<double> velocityX;
+    std::vector<double> velocityY;
+    std::vector<double> velocityZ;
+    std::vector<double> accelerationX;
+    std::vector<double> accelerationY;
+    std::vector<double> accelerationZ;
+    std::vector<double> time;
+
+    std::size_t size() const;
+    bool empty() const;
+    void reserve(std::size_t count);
+    void resize(std::size_t count);
+    void clear();
+    void push_back(const State9 &state);
+    State9 get(std::size_t index) const;
+    void set(std::size_t index, const State9 &state);
+};
+
 struct Projection2D
 {
     double x;
@@ -26,6 +53,8 @@ struct Projection2D
 };
 
 State9 integrateState(const State9 &state, double dt);
+// Advances every track in the batch in place; per-track results match integrateState exactly.
+void integrateStates(State9Batch &batch, double dt);
 Projection2D projectXY(const State9 &state);
 Projection2D projectXZ(const State9 &state);
 Projection2D projectYZ(const State9 &state);
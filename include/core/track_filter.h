@@ -0,0 +1,182 @@
+#ifndef CORE_TRACK_FILTER_H
+#define CORE_TRACK_FILTER_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "core/fixed_matrix.h"
+#include "core/sensors.h"
+#include "core/state.h"
+
+// Constant-acceleration Kalman filter over State9. State order matches State9:
+// position x/y/z, velocity x/y/z, acceleration x/y/z.
+constexpr std::size_t kTrackStateDim = 9;
+using TrackVector = Vector<kTrackStateDim>;
+using TrackCovariance = Matrix<kTrackStateDim, kTrackStateDim>;
+
+struct TrackFilterConfig
+{
+    // White-jerk spectral density (m^2/s^5) driving the process noise.
+    double jerkSpectralDensity = 1.0;
+    double positionStd = 5.0;
+    double rangeStd = 10.0;
+    double altitudeStd = 2.0;
+    double headingStd = 0.05;
+};
+
+struct TrackEstimate
+{
+    TrackVector state{};
+    TrackCovariance covariance{};
+    double time = 0.0;
+};
+
+TrackEstimate makeTrackEstimate(const State9 &state,
+                                double positionVariance,
+                                double velocityVariance,
+                                double accelerationVariance);
+State9 trackState(const TrackEstimate &estimate);
+
+void predictTrack(TrackEstimate &estimate, double dt, const TrackFilterConfig &config);
+
+// Measurement models. linearize() fills the innovation z - h(x) and the Jacobian of h at x, and
+// returns false when the model is undefined at x (the update is then skipped).
+struct GpsPositionModel
+{
+    static constexpr std::size_t dim = 3;
+    using Observation = Vec3;
+    static bool linearize(const TrackVector &state, const Observation &observation,
+                          Vector<dim> &innovation, Matrix<dim, kTrackStateDim> &jacobian);
+};
+
+// Slant range from the origin, as RadarSensor reports it.
+struct RadarRangeModel
+{
+    static constexpr std::size_t dim = 1;
+    using Observation = double;
+    static bool linearize(const TrackVector &state, const Observation &observation,
+                          Vector<dim> &innovation, Matrix<dim, kTrackStateDim> &jacobian);
+};
+
+struct BaroAltitudeModel
+{
+    static constexpr std::size_t dim = 1;
+    using Observation = double;
+    static bool linearize(const TrackVector &state, const Observation &observation,
+                          Vector<dim> &innovation, Matrix<dim, kTrackStateDim> &jacobian);
+};
+
+// Course over ground, atan2(vy, vx); the innovation is wrapped to [-pi, pi].
+struct MagHeadingModel
+{
+    static constexpr std::size_t dim = 1;
+    using Observation = double;
+    static bool linearize(const TrackVector &state, const Observation &observation,
+                          Vector<dim> &innovation, Matrix<dim, kTrackStateDim> &jacobian);
+};
+
+// Joseph-form update: P = (I - KH) P (I - KH)^T + K R K^T, which keeps P positive semi-definite
+// under rounding. Returns false if the innovation covariance is singular. When `logLikelihood` is
+// set, the Gaussian log-likelihood of the innovation is added to it (used for model weighting).
+template <std::size_t M>
+bool kalmanUpdate(TrackEstimate &estimate,
+                  const Vector<M> &innovation,
+                  const Matrix<M, kTrackStateDim> &jacobian,
+                  const Matrix<M, M> &noise,
+                  double *logLikelihood = nullptr)
+{
+    const Matrix<kTrackStateDim, M> jacobianT = transpose(jacobian);
+    const Matrix<kTrackStateDim, M> crossCovariance = estimate.covariance * jacobianT;
+    const Matrix<M, M> innovationCovariance = jacobian * crossCovariance + noise;
+    Matrix<M, M> innovationInverse{};
+    if (!invert(innovationCovariance, innovationInverse))
+    {
+        return false;
+    }
+    if (logLikelihood != nullptr)
+    {
+        const double mahalanobis = (transpose(innovation) * innovationInverse * innovation)(0, 0);
+        *logLikelihood -= 0.5 * (mahalanobis + std::log(determinant(innovationCovariance)) +
+                                 static_cast<double>(M) * std::log(2.0 * 3.141592653589793));
+    }
+    const Matrix<kTrackStateDim, M> gain = crossCovariance * innovationInverse;
+    estimate.state = estimate.state + gain * innovation;
+    const TrackCovariance reduction = TrackCovariance::identity() - gain * jacobian;
+    estimate.covariance = reduction * estimate.covariance * transpose(reduction) +
+                          gain * noise * transpose(gain);
+    // Mirror the upper triangle so P is exactly symmetric, matching TrackFilterBatch storage.
+    for (std::size_t row = 0; row < kTrackStateDim; ++row)
+    {
+        for (std::size_t col = row + 1; col < kTrackStateDim; ++col)
+        {
+            estimate.covariance(col, row) = estimate.covariance(row, col);
+        }
+    }
+    return true;
+}
+
+template <typename Model>
+bool updateTrack(TrackEstimate &estimate,
+                 const typename Model::Observation &observation,
+                 double stddev,
+                 double *logLikelihood = nullptr)
+{
+    Vector<Model::dim> innovation{};
+    Matrix<Model::dim, kTrackStateDim> jacobian{};
+    if (!Model::linearize(estimate.state, observation, innovation, jacobian))
+    {
+        return false;
+    }
+    Matrix<Model::dim, Model::dim> noise{};
+    for (std::size_t idx = 0; idx < Model::dim; ++idx)
+    {
+        noise(idx, idx) = stddev * stddev;
+    }
+    return kalmanUpdate(estimate, innovation, jacobian, noise, logLikelihood);
+}
+
+// Applies every field present in a valid measurement, in the order position, range, altitude,
+// heading. Returns the number of model updates applied.
+std::size_t updateTrack(TrackEstimate &estimate,
+                        const Measurement &measurement,
+                        const TrackFilterConfig &config,
+                        double *logLikelihood = nullptr);
+
+// Structure-of-arrays filter bank: one contiguous array per state component and per
+// upper-triangle covariance entry, so predict streams every track through the same coefficients.
+struct TrackFilterBatch
+{
+    static constexpr std::size_t kCovarianceTerms = kTrackStateDim * (kTrackStateDim + 1) / 2;
+
+    // Row-major upper-triangle slot for (row, col); symmetric, so arguments may come in any order.
+    static constexpr std::size_t covarianceIndex(std::size_t row, std::size_t col)
+    {
+        return row <= col ? row * kTrackStateDim - row * (row - 1) / 2 + (col - row)
+                          : covarianceIndex(col, row);
+    }
+
+    std::array<std::vector<double>, kTrackStateDim> state;
+    std::array<std::vector<double>, kCovarianceTerms> covariance;
+    std::vector<double> time;
+
+    std::size_t size() const;
+    bool empty() const;
+    void reserve(std::size_t count);
+    void resize(std::size_t count);
+    void clear();
+    void push_back(const TrackEstimate &estimate);
+    TrackEstimate get(std::size_t index) const;
+    void set(std::size_t index, const TrackEstimate &estimate);
+};
+
+// Per-track results are bit-identical to predictTrack.
+void predictTracks(TrackFilterBatch &batch, double dt, const TrackFilterConfig &config);
+// measurements[i] updates track i (invalid measurements are skipped, as are entries beyond the
+// batch). Results match updateTrack per track. Returns the number of model updates applied.
+std::size_t updateTracks(TrackFilterBatch &batch,
+                         const std::vector<Measurement> &measurements,
+                         const TrackFilterConfig &config);
+
+#endif // CORE_TRACK_FILTER_H
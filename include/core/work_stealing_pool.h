@@ -0,0 +1,55 @@
+#ifndef CORE_WORK_STEALING_POOL_H
+#define CORE_WORK_STEALING_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool with one deque per worker. parallelFor() deals indices round-robin, workers
+// drain their own deque from the back and steal from the front of the others, and the call
+// returns only after every index has run (a per-call barrier). A pool of 0 or 1 workers runs
+// inline on the calling thread. Tasks must not throw.
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void(std::size_t index, std::size_t worker)>;
+
+    explicit WorkStealingPool(std::size_t workerCount);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    std::size_t workerCount() const;
+    void parallelFor(std::size_t count, const Task &task);
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<std::size_t> items;
+    };
+
+    void workerLoop(std::size_t worker);
+    bool takeWork(std::size_t worker, std::size_t &index);
+
+    std::size_t workers = 0;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    std::mutex stateMutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const Task *currentTask = nullptr;
+    std::uint64_t generation = 0;
+    std::size_t remaining = 0;
+    std::size_t activeWorkers = 0;
+    bool stopping = false;
+};
+
+#endif // CORE_WORK_STEALING_POOL_H
@@ -1,6 +1,7 @@
 #ifndef TOOLS_AUDIT_LOG_H
 #define TOOLS_AUDIT_LOG_H
 
+#include <cstddef>
 #include <string>
 
 namespace tools
@@ -14,10 +15,36 @@ struct AuditLogConfig
     std::string runId;
     std::string configVersion;
     unsigned int seed = 0;
+    // Hand records to a background writer that appends everything accumulated since its last write
+    // in one call, keeping the file open. Records are hash-chained and sized when logged, so order
+    // and retention match synchronous writes; flushAuditLog() waits for them to reach the file.
+    bool asyncWrites = false;
+    // Async only: fsync the file after each group, so durability costs one sync per group rather
+    // than per record.
+    bool syncEachCommit = false;
+    // Async only: a group is written once it reaches groupCommitBytes or its oldest record has
+    // waited groupCommitIntervalMs, whichever comes first.
+    std::size_t groupCommitBytes = 64 * 1024;
+    unsigned int groupCommitIntervalMs = 5;
+    // Before a record would take the log past this size, the log is renamed to the next segment
+    // ("<logPath>.000001", ...) and a hash-chained entry describing it is appended to
+    // "<logPath>.manifest". Capped at the 5 MiB retention limit; 0 keeps one file that stops
+    // accepting records at that limit.
+    std::size_t rotateBytes = 0;
 };
 
 bool initializeAuditLog(const AuditLogConfig &config, std::string &status);
+// With asyncWrites, true means the record was accepted; a later write failure marks the log
+// unhealthy and fails the next call.
 bool logAuditEvent(const std::string &eventType, const std::string &message, const std::string &detail);
+// Blocks until every record logged before the call is written (and synced when configured).
+// Returns auditLogHealthy(); a no-op for synchronous logs.
+bool flushAuditLog();
+// Checks a rotated log's manifest: entries are numbered from 1 and hash-chained, and every segment
+// still matches its recorded size, record count, boundary entry hashes, and SHA-256, with an
+// unbroken record chain inside and across segment boundaries (only an audit_start record with an
+// empty prev_hash may restart it). True when nothing has been rotated yet.
+bool verifyAuditLogSegments(const std::string &logPath, std::string &error);
 void setAuditRole(const std::string &role);
 void setAuditRunContext(const std::string &runId, const std::string &configVersion, unsigned int seed);
 std::string auditLogStatus();
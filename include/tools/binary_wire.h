@@ -0,0 +1,56 @@
+#ifndef TOOLS_BINARY_WIRE_H
+#define TOOLS_BINARY_WIRE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace tools
+{
+// Little-endian wire primitives for the binary envelope and federation frame codecs: LEB128
+// varints for counts and integers, zigzag for signed values, raw IEEE-754 bytes for doubles, and
+// varint-length-prefixed strings. Byte order is fixed whatever the host order.
+class BinaryWriter
+{
+public:
+    explicit BinaryWriter(std::string &out);
+
+    void bytes(std::string_view data);
+    void byte(std::uint8_t value);
+    void varint(std::uint64_t value);
+    void zigzag(std::int64_t value);
+    void real(double value);
+    void text(std::string_view value);
+
+private:
+    std::string &out;
+};
+
+// Reads what BinaryWriter wrote. Every call returns false instead of reading past the end (and
+// marks the reader truncated) or on an overlong or non-minimal varint, so callers can tell a short
+// payload from a malformed one.
+class BinaryReader
+{
+public:
+    explicit BinaryReader(std::string_view in);
+
+    bool bytes(std::size_t count, std::string_view &out);
+    bool byte(std::uint8_t &value);
+    bool varint(std::uint64_t &value);
+    bool zigzag(std::int64_t &value);
+    bool real(double &value);
+    bool text(std::string_view &value);
+    bool text(std::string &value);
+
+    std::size_t remaining() const;
+    bool truncated() const;
+
+private:
+    std::string_view in;
+    std::size_t pos = 0;
+    bool ranOut = false;
+};
+} // namespace tools
+
+#endif // TOOLS_BINARY_WIRE_H
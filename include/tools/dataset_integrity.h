@@ -0,0 +1,51 @@
+#ifndef TOOLS_DATASET_INTEGRITY_H
+#define TOOLS_DATASET_INTEGRITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tools
+{
+// Prefix of the chunked digest form "sha256-chunked:<chunk KiB>:<hex>", whose hex is the SHA-256
+// of the concatenated 32-byte SHA-256 digests of each chunk in file order (the last chunk may be
+// short). Unlike a whole-file digest its chunks can be hashed in parallel.
+inline constexpr std::string_view kDatasetChunkedHashPrefix = "sha256-chunked:";
+
+struct DatasetFile
+{
+    // Prefixes error messages, e.g. "catalog".
+    std::string label;
+    std::string path;
+    // Whole-file SHA-256 hex, or the chunked form.
+    std::string expectedHash;
+};
+
+struct DatasetIntegrityOptions
+{
+    // Combined size limit across all files; 0 disables it.
+    double maxSizeMB = 0.0;
+    std::size_t workers = 1;
+};
+
+struct DatasetIntegrityResult
+{
+    bool ok = false;
+    std::string message;
+    std::uint64_t totalBytes = 0;
+};
+
+// Checks the size limit from the file sizes before opening any file, then maps every file
+// read-only and hashes all files at once on a work-stealing pool: one task per whole-file digest
+// and one per chunk of a chunked digest. Errors name the first failing file in list order
+// ("<label> unable to open", "<label> is empty", "<label> hash format invalid",
+// "dataset size exceeds limit", "<label> hash mismatch").
+DatasetIntegrityResult verifyDatasetFiles(const std::vector<DatasetFile> &files, const DatasetIntegrityOptions &options);
+
+// Renders the chunked digest form of bytes; chunkKiB is clamped to [1, 1048576].
+std::string chunkedDatasetHash(std::string_view bytes, std::size_t chunkKiB, std::size_t workers = 1);
+} // namespace tools
+
+#endif // TOOLS_DATASET_INTEGRITY_H
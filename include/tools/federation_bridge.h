@@ -1,13 +1,17 @@
 #ifndef TOOLS_FEDERATION_BRIDGE_H
 #define TOOLS_FEDERATION_BRIDGE_H
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <memory>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 #include "core/external_io_envelope.h"
+#include "tools/federation_route_table.h"
+#include "tools/io_packager.h"
 
 namespace tools
 {
@@ -82,22 +86,86 @@ struct FederationFanoutResult
     std::vector<FederationEventFrame> frames{};
 };
 
+struct FederationPublishOutcome
+{
+    bool ok = false;
+    std::string error;
+    std::size_t firstFrame = 0;
+    std::size_t frameCount = 0;
+};
+
+// Caller-owned output of publishBatch(): outcomes[i] says which frames envelope i produced. Frames
+// are overwritten in place, so an arena reused across batches keeps its string capacity; only the
+// first frameCount entries of `frames` belong to the latest batch.
+struct FederationFrameArena
+{
+    std::vector<FederationEventFrame> frames{};
+    std::size_t frameCount = 0;
+    std::vector<FederationPublishOutcome> outcomes{};
+};
+
 class FederationBridge
 {
 public:
+    // Validates the config and resolves endpoints, key trust, and attestation policy once; an
+    // invalid config makes every publish fail closed with the validation error.
     explicit FederationBridge(FederationBridgeConfig config);
+    // Shares route sequences and source timestamps with every bridge on the same table, so workers
+    // publishing in parallel never reuse a route sequence. The table's endpoint count must match the
+    // config's active endpoints; a null table gives the bridge a private one.
+    FederationBridge(FederationBridgeConfig config, std::shared_ptr<FederationRouteTable> routeTable);
     FederationBridgeResult publish(const ExternalIoEnvelope &envelope);
+    // Reports the first failing check: envelope fields, config, and source policy; timestamps, key
+    // window, and latency budget; logical-tick overflow; endpoint trust, attestation, and
+    // serialization; then, under the route lease, source-timestamp regression and sequence
+    // overflow, which can only fail on a route an earlier publish created. A rejected envelope never
+    // adds a route to the table.
     FederationFanoutResult publishFanout(const ExternalIoEnvelope &envelope);
+    // Same frames, route sequencing, rejections, and audit events as calling publishFanout() on each
+    // envelope in order; a rejected envelope does not stop the batch. Returns the number published.
+    std::size_t publishBatch(const ExternalIoEnvelope *envelopes, std::size_t count, FederationFrameArena &arena);
+    std::size_t publishBatch(const std::vector<ExternalIoEnvelope> &envelopes, FederationFrameArena &arena);
 
 private:
+    struct EndpointPlan
+    {
+        std::string endpointId;
+        std::string payloadFormat;
+        IoEnvelopeFormat format = IoEnvelopeFormat::Json;
+        bool keyTrusted = true;
+        bool attestationSatisfied = true;
+    };
+
+    // Shared by publishFanout() and publishBatch(), so both reject in the order described above.
+    bool publishInto(const ExternalIoEnvelope &envelope,
+                     std::vector<FederationEventFrame> &frames,
+                     std::size_t &frameCount,
+                     std::string &error);
+    FederationRouteTable::Lease routeState(const std::string &platformProfile, const std::string &sourceId);
+
     FederationBridgeConfig config_{};
     std::uint64_t nextLogicalTick_ = 0;
+    std::string configError_{};
+    std::string federateId_{};
+    std::string federateKeyId_{};
+    std::string federateContext_{};
     std::vector<std::string> allowedSourcesNormalized_{};
-    std::unordered_map<std::string, std::uint64_t> routeSequenceByKeyAndEndpoint_{};
-    std::unordered_map<std::string, std::uint64_t> lastSourceTimestampByKey_{};
+    std::vector<EndpointPlan> endpoints_{};
+    std::shared_ptr<FederationRouteTable> routeTable_{};
+    // Raw "<platform_profile>/<source_id>" to its route handle, so repeat routes skip key
+    // normalization and never touch the shared table's index.
+    FlatRouteIndex routeAliases_{};
+    std::string sourceScratch_{};
+    std::string aliasScratch_{};
 };
 
+// Binary payloads (ie_bin_v1) are carried base64-encoded, flagged by "payload_encoding":"base64".
 std::string serializeFederationEventFrameJson(const FederationEventFrame &frame);
+// Versioned little-endian frame with the payload carried as raw length-prefixed bytes, so a binary
+// envelope crosses the link without escaping or base64 overhead. parse rejects truncated, trailing,
+// or unknown-version input and leaves `error` set.
+std::string serializeFederationEventFrameBinary(const FederationEventFrame &frame);
+bool parseFederationEventFrameBinary(std::string_view bytes, FederationEventFrame &frame, std::string &error);
 } // namespace tools
 
 #endif // TOOLS_FEDERATION_BRIDGE_H
@@ -0,0 +1,136 @@
+#ifndef TOOLS_FEDERATION_PUBLISH_QUEUE_H
+#define TOOLS_FEDERATION_PUBLISH_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tools/federation_bridge.h"
+
+namespace tools
+{
+enum class FederationQueueOverflow
+{
+    // The producer yields briefly, then sleeps until the egress thread frees a slot.
+    Block,
+    // The envelope is handed to the drop hook and enqueue() returns false.
+    DropNewest
+};
+
+struct FederationPublishQueueConfig
+{
+    // Rounded up to a power of two.
+    std::size_t capacity = 1024;
+    // Most envelopes handed to FederationBridge::publishBatch() at once.
+    std::size_t maxBatch = 64;
+    FederationQueueOverflow overflow = FederationQueueOverflow::Block;
+};
+
+struct FederationQueueStats
+{
+    static constexpr std::size_t kLatencyBuckets = 40;
+
+    std::uint64_t enqueued = 0;
+    std::uint64_t dropped = 0;
+    std::uint64_t published = 0;
+    std::uint64_t rejected = 0;
+    // Block-mode enqueue() calls that found the ring full, each counted once however long it waited.
+    std::uint64_t backpressureWaits = 0;
+    // latencyNs[i] counts envelopes whose enqueue-to-emit time fell in [2^i, 2^(i+1)) ns; bucket 0
+    // also holds 0 ns and the last bucket everything slower.
+    std::array<std::uint64_t, kLatencyBuckets> latencyNs{};
+
+    // Upper bound in ns of the bucket holding the given quantile (0..1); 0 when nothing was emitted.
+    std::uint64_t latencyQuantileNs(double quantile) const;
+};
+
+// Multi-producer front end for a FederationBridge. enqueue() claims a slot in a bounded ring with a
+// compare-and-swap and takes a lock only to wake an idle egress thread or, under Block with the
+// ring full, to sleep until a slot frees up, so producers do not wait on framing, serialization,
+// or audit logging. One egress thread owns the bridge (and with it every route sequence and source
+// timestamp), drains the ring in batches through publishBatch(), and calls the sinks; when idle it
+// sleeps until woken rather than polling. Frames for a route keep the order their envelopes
+// claimed slots in. Sinks and hooks must not throw; the frame and reject sinks run on the egress
+// thread, the drop hook on the producer's.
+class FederationPublishQueue
+{
+public:
+    using FrameSink = std::function<void(const FederationEventFrame &frame)>;
+    using RejectSink = std::function<void(const ExternalIoEnvelope &envelope, const std::string &error)>;
+    using DropHook = std::function<void(const ExternalIoEnvelope &envelope)>;
+
+    FederationPublishQueue(FederationBridgeConfig bridgeConfig,
+                           FederationPublishQueueConfig queueConfig,
+                           FrameSink frameSink,
+                           RejectSink rejectSink = RejectSink(),
+                           DropHook dropHook = DropHook());
+    // Publishes everything already enqueued, then stops the egress thread. No enqueue() may race it.
+    ~FederationPublishQueue();
+
+    FederationPublishQueue(const FederationPublishQueue &) = delete;
+    FederationPublishQueue &operator=(const FederationPublishQueue &) = delete;
+
+    // Copies the envelope into the ring. Returns false only when DropNewest discards it.
+    bool enqueue(const ExternalIoEnvelope &envelope);
+    // Blocks until every envelope enqueued before the call has been published or rejected.
+    void flush();
+    FederationQueueStats stats() const;
+
+private:
+    struct Slot
+    {
+        std::atomic<std::uint64_t> sequence{0};
+        ExternalIoEnvelope envelope{};
+        std::chrono::steady_clock::time_point enqueuedAt{};
+    };
+
+    bool tryEnqueue(const ExternalIoEnvelope &envelope);
+    bool ringFull() const;
+    void waitForSpace();
+    bool tryDequeue(ExternalIoEnvelope &envelope, std::chrono::steady_clock::time_point &enqueuedAt);
+    void egressLoop();
+    void recordLatency(std::chrono::steady_clock::duration latency);
+
+    FederationBridge bridge_;
+    FederationPublishQueueConfig config_;
+    FrameSink frameSink_;
+    RejectSink rejectSink_;
+    DropHook dropHook_;
+
+    std::unique_ptr<Slot[]> slots_;
+    std::uint64_t mask_ = 0;
+    alignas(64) std::atomic<std::uint64_t> enqueuePos_{0};
+    // Consumer-side ring position, and how far the egress thread has published.
+    alignas(64) std::uint64_t dequeuePos_ = 0;
+    std::atomic<std::uint64_t> emittedPos_{0};
+
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> egressIdle_{false};
+    std::atomic<int> flushWaiters_{0};
+    std::atomic<int> spaceWaiters_{0};
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    std::condition_variable space_;
+    std::condition_variable drained_;
+
+    std::atomic<std::uint64_t> enqueuedCount_{0};
+    std::atomic<std::uint64_t> droppedCount_{0};
+    std::atomic<std::uint64_t> publishedCount_{0};
+    std::atomic<std::uint64_t> rejectedCount_{0};
+    std::atomic<std::uint64_t> backpressureCount_{0};
+    std::array<std::atomic<std::uint64_t>, FederationQueueStats::kLatencyBuckets> latencyBuckets_{};
+
+    std::thread egress_;
+};
+} // namespace tools
+
+#endif // TOOLS_FEDERATION_PUBLISH_QUEUE_H
@@ -0,0 +1,98 @@
+#ifndef TOOLS_FEDERATION_ROUTE_TABLE_H
+#define TOOLS_FEDERATION_ROUTE_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tools
+{
+// Open-addressing string -> 64-bit handle map with linear probing. Each slot keeps the key's full
+// hash beside its handle, so a probe compares key bytes only on a hash match, and the slot array
+// stays at most half full. Not synchronized.
+class FlatRouteIndex
+{
+public:
+    static std::uint64_t hash(std::string_view key);
+
+    bool find(std::string_view key, std::uint64_t keyHash, std::uint64_t &handle) const;
+    // The key must not be present yet.
+    void insert(std::string_view key, std::uint64_t keyHash, std::uint64_t handle);
+    std::size_t size() const;
+
+private:
+    struct Slot
+    {
+        std::uint64_t hash = 0;
+        std::uint64_t handle = 0;
+        // Index into keys + 1; 0 marks an empty slot.
+        std::uint32_t key = 0;
+    };
+
+    void grow();
+
+    std::vector<Slot> slots;
+    std::vector<std::string> keys;
+    std::size_t slotMask = 0;
+};
+
+// Route state for a federation bridge, interned by normalized route key. A handle packs the route's
+// shard (high 32 bits) and its index within the shard, and stays valid for the table's lifetime.
+// Shards are picked by route-key hash and each has its own lock, so bridges that share one table
+// (to keep route sequences unique across workers) contend only on routes that share a shard.
+class FederationRouteTable
+{
+public:
+    using Handle = std::uint64_t;
+
+    struct Entry
+    {
+        std::string routeKey;
+        // One per endpoint, in the bridge's endpoint order.
+        std::vector<std::uint64_t> sequences{};
+        std::uint64_t lastSourceTimestampMs = 0;
+        bool hasSourceTimestamp = false;
+    };
+
+    // Holds the route's shard lock until destroyed.
+    class Lease
+    {
+    public:
+        Entry &entry() const;
+
+    private:
+        friend class FederationRouteTable;
+        Lease(std::unique_lock<std::mutex> lock, Entry &entry);
+
+        std::unique_lock<std::mutex> lock;
+        Entry *routeEntry = nullptr;
+    };
+
+    // shardCount is rounded up to a power of two.
+    explicit FederationRouteTable(std::size_t endpointCount, std::size_t shardCount = 1);
+
+    Handle intern(const std::string &routeKey);
+    Lease acquire(Handle handle);
+    std::size_t endpointCount() const;
+    std::size_t shardCount() const;
+    std::size_t size() const;
+
+private:
+    struct Shard
+    {
+        mutable std::mutex mutex;
+        FlatRouteIndex index;
+        std::vector<Entry> entries;
+    };
+
+    std::size_t endpoints = 0;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::size_t shardMask = 0;
+};
+} // namespace tools
+
+#endif // TOOLS_FEDERATION_ROUTE_TABLE_H
@@ -0,0 +1,137 @@
+#ifndef TOOLS_IO_ENVELOPE_STREAM_H
+#define TOOLS_IO_ENVELOPE_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "tools/io_packager.h"
+#include "tools/mapped_file.h"
+
+namespace tools
+{
+// How envelope payloads are delimited in a stream or archive.
+enum class IoEnvelopeFraming
+{
+    // One payload per line (NDJSON for ie_json_v1). Blank lines and a trailing '\r' are skipped;
+    // the last line may omit its '\n'. Only JSON payloads are newline-free, so KV and binary need
+    // length framing.
+    Newline,
+    // Each payload preceded by its byte length as a 4-byte little-endian integer.
+    LengthPrefixed
+};
+
+constexpr std::size_t kIoEnvelopeMaxRecordBytes = 16 * 1024 * 1024;
+
+bool parseIoEnvelopeFraming(const std::string &text, IoEnvelopeFraming &framing);
+std::string ioEnvelopeFramingName(IoEnvelopeFraming framing);
+bool isIoEnvelopeFramingSupported(IoEnvelopeFormat format, IoEnvelopeFraming framing);
+
+// Opens a file for streaming (write truncates or creates); returns -1 on failure.
+int openIoEnvelopeStreamFile(const std::string &path, bool forWrite);
+void closeIoEnvelopeStreamFile(int fd);
+
+// Pulls framed records from a file descriptor it does not own through one read window. The window
+// grows only to fit the largest record seen, capped at maxRecordBytes, so memory stays bounded
+// however long the stream is.
+class IoEnvelopeStreamReader
+{
+public:
+    IoEnvelopeStreamReader(int fd, IoEnvelopeFraming framing, std::size_t maxRecordBytes = kIoEnvelopeMaxRecordBytes);
+
+    // The view stays valid until the next call. Returns false at end of stream or on error.
+    bool next(std::string_view &record);
+    bool failed() const;
+    const std::string &error() const;
+    std::uint64_t records() const;
+    std::uint64_t bytesRead() const;
+
+private:
+    bool fill(std::size_t needed);
+    bool fail(const std::string &message);
+
+    int fd = -1;
+    IoEnvelopeFraming framing = IoEnvelopeFraming::Newline;
+    std::size_t maxRecordBytes = kIoEnvelopeMaxRecordBytes;
+    std::string window;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    bool eof = false;
+    std::string errorText;
+    std::uint64_t recordCount = 0;
+    std::uint64_t byteCount = 0;
+};
+
+// Frames payloads into a buffer and writes it to a file descriptor it does not own whenever the
+// buffer passes flushBytes. The destructor flushes; call flush() to see whether that succeeded.
+class IoEnvelopeStreamWriter
+{
+public:
+    IoEnvelopeStreamWriter(int fd, IoEnvelopeFraming framing, std::size_t flushBytes = 64 * 1024);
+    ~IoEnvelopeStreamWriter();
+
+    IoEnvelopeStreamWriter(const IoEnvelopeStreamWriter &) = delete;
+    IoEnvelopeStreamWriter &operator=(const IoEnvelopeStreamWriter &) = delete;
+
+    bool write(std::string_view payload);
+    bool flush();
+    bool failed() const;
+    const std::string &error() const;
+    std::uint64_t records() const;
+    std::uint64_t bytesWritten() const;
+
+private:
+    int fd = -1;
+    IoEnvelopeFraming framing = IoEnvelopeFraming::Newline;
+    std::size_t flushBytes = 0;
+    std::string buffer;
+    std::string errorText;
+    std::uint64_t recordCount = 0;
+    std::uint64_t byteCount = 0;
+};
+
+// Read-only memory-mapped view of a whole archive file.
+class IoEnvelopeArchive
+{
+public:
+    bool open(const std::string &path, std::string &error);
+    void close();
+    std::string_view bytes() const;
+
+private:
+    MappedFile file;
+};
+
+struct IoEnvelopeStreamOptions
+{
+    IoEnvelopeFormat inputFormat = IoEnvelopeFormat::Json;
+    IoEnvelopeFraming inputFraming = IoEnvelopeFraming::Newline;
+    IoEnvelopeFormat outputFormat = IoEnvelopeFormat::Json;
+    IoEnvelopeFraming outputFraming = IoEnvelopeFraming::Newline;
+    std::size_t maxRecordBytes = kIoEnvelopeMaxRecordBytes;
+    // Archive conversion only: chunks decoded at once, and the target input bytes per chunk.
+    std::size_t workers = 1;
+    std::size_t chunkBytes = 1024 * 1024;
+};
+
+struct IoEnvelopeStreamResult
+{
+    bool ok = false;
+    std::string error;
+    std::uint64_t records = 0;
+    std::uint64_t bytesIn = 0;
+    std::uint64_t bytesOut = 0;
+};
+
+// Both conversions stop at the first bad record ("record <n>: <reason>", counting from 0) after
+// writing every record before it, so their output is identical for the same input.
+IoEnvelopeStreamResult convertExternalIoEnvelopeStream(int inputFd, int outputFd, const IoEnvelopeStreamOptions &options);
+// Splits the archive into record-aligned chunks, converts up to `workers` chunks in parallel, and
+// writes their output in archive order. Memory is bounded by workers x chunk output.
+IoEnvelopeStreamResult convertExternalIoEnvelopeArchive(std::string_view archive,
+                                                        int outputFd,
+                                                        const IoEnvelopeStreamOptions &options);
+} // namespace tools
+
+#endif // TOOLS_IO_ENVELOPE_STREAM_H
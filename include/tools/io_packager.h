@@ -1,7 +1,9 @@
 #ifndef TOOLS_IO_PACKAGER_H
 #define TOOLS_IO_PACKAGER_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "core/external_io_envelope.h"
@@ -11,7 +13,10 @@ namespace tools
 enum class IoEnvelopeFormat
 {
     Json,
-    KeyValue
+    KeyValue,
+    // Versioned little-endian encoding: varint counts and integers, length-prefixed strings, raw
+    // IEEE doubles. Contributor lists round-trip item by item, including items holding commas.
+    Binary
 };
 
 struct IoEnvelopeParseResult
@@ -41,8 +46,19 @@ std::string ioEnvelopeFormatName(IoEnvelopeFormat format);
 
 IoEnvelopeParseResult parseExternalIoEnvelope(const std::string &formatName, const std::string &payload);
 IoEnvelopeParseResult parseExternalIoEnvelope(IoEnvelopeFormat format, const std::string &payload);
+// Parses into `envelope`, reusing its string and vector capacity; accepts and rejects exactly what
+// the overloads above do, with the same error text. Takes any byte range, so it can be driven
+// directly by a fuzzer. Well-formed payloads parse without allocating once `envelope` has held a
+// payload of the same shape.
+bool parseExternalIoEnvelope(IoEnvelopeFormat format,
+                             std::string_view payload,
+                             ExternalIoEnvelope &envelope,
+                             std::string &error);
 IoEnvelopeSerializeResult serializeExternalIoEnvelope(const std::string &formatName, const ExternalIoEnvelope &envelope);
 IoEnvelopeSerializeResult serializeExternalIoEnvelope(IoEnvelopeFormat format, const ExternalIoEnvelope &envelope);
+// Writes the payload into `payload` (cleared first, capacity kept) in canonical key order; output is
+// byte-identical to the overloads above. Reusing one buffer makes steady-state calls allocation-free.
+bool serializeExternalIoEnvelope(IoEnvelopeFormat format, const ExternalIoEnvelope &envelope, std::string &payload);
 IoEnvelopeSerializeResult convertExternalIoEnvelope(
     const std::string &payload,
     const std::string &inputFormatName,
@@ -51,6 +67,51 @@ IoEnvelopeSerializeResult convertExternalIoEnvelope(
     const std::string &payload,
     IoEnvelopeFormat inputFormat,
     IoEnvelopeFormat outputFormat);
+
+// Stateful envelope stream codec for links that carry one envelope per tick. Each payload is either
+// a keyframe (a full ie_bin_v1 envelope) or a delta holding only the fields that changed since the
+// previous envelope, and carries a sequence number. Keyframes go out first, every keyframeInterval
+// payloads (0 disables the periodic ones), and after requestKeyframe(). Decoding yields exactly
+// the envelope that was encoded.
+class IoEnvelopeDeltaEncoder
+{
+public:
+    explicit IoEnvelopeDeltaEncoder(std::uint32_t keyframeInterval = 64);
+
+    // Writes the next payload into `payload` (cleared first, capacity kept).
+    void encode(const ExternalIoEnvelope &envelope, std::string &payload);
+    // Makes the next payload a keyframe, e.g. when the receiver reports a gap.
+    void requestKeyframe();
+    // Sequence number the next payload will carry.
+    std::uint64_t sequence() const;
+
+private:
+    std::uint32_t keyframeInterval = 0;
+    std::uint32_t sinceKeyframe = 0;
+    std::uint64_t nextSequence = 0;
+    bool havePrevious = false;
+    bool keyframeRequested = false;
+    ExternalIoEnvelope previous{};
+};
+
+// Applies payloads in order. A sequence gap or any malformed payload (bad header, unknown frame
+// kind, or body) fails and leaves the decoder rejecting deltas until the next keyframe;
+// needsKeyframe() reports that state so the caller can ask the sender to resync. A failed decode
+// leaves `envelope` untouched.
+class IoEnvelopeDeltaDecoder
+{
+public:
+    bool decode(std::string_view payload, ExternalIoEnvelope &envelope, std::string &error);
+    bool needsKeyframe() const;
+    // Sequence number of the last payload applied.
+    std::uint64_t sequence() const;
+
+private:
+    bool awaitingKeyframe = true;
+    std::uint64_t lastSequence = 0;
+    ExternalIoEnvelope previous{};
+    ExternalIoEnvelope working{};
+};
 } // namespace tools
 
 #endif // TOOLS_IO_PACKAGER_H
@@ -0,0 +1,41 @@
+#ifndef TOOLS_MAPPED_FILE_H
+#define TOOLS_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace tools
+{
+enum class MappedFileStatus
+{
+    Ok,
+    OpenFailed,
+    // The size could not be read, or the path is not a regular file.
+    StatFailed,
+    MapFailed
+};
+
+// Read-only memory map of a whole regular file (mmap on POSIX, MapViewOfFile on Windows), with
+// sequential-access hints. An empty file opens as an empty view without a mapping.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Unmaps any previous file first; the view stays empty on failure.
+    MappedFileStatus open(const std::string &path);
+    void close();
+    std::string_view bytes() const;
+
+private:
+    const char *mapped = nullptr;
+    std::size_t mappedSize = 0;
+};
+} // namespace tools
+
+#endif // TOOLS_MAPPED_FILE_H
@@ -0,0 +1,41 @@
+#ifndef TOOLS_PERFECT_HASH_H
+#define TOOLS_PERFECT_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tools
+{
+// Perfect hash over a fixed key set (hash-and-displace): every key is bucketed by one hash, and
+// each bucket stores the displacement that sends its keys to free slots. find() therefore costs one
+// hash, two table reads, and a single string comparison, whatever the key count. Built once from a
+// schema; lookups are read-only and safe to share across threads.
+class PerfectHashIndex
+{
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    PerfectHashIndex() = default;
+    // Positions in `keySet` become the values find() returns; a repeated key resolves to its first.
+    explicit PerfectHashIndex(std::vector<std::string> keySet);
+
+    std::size_t find(std::string_view key) const;
+    std::size_t size() const;
+    const std::string &key(std::size_t index) const;
+
+private:
+    static std::uint64_t hash(std::string_view key);
+    std::size_t slotFor(std::uint64_t keyHash, std::uint32_t displacement) const;
+
+    std::vector<std::string> keys;
+    std::vector<std::uint32_t> displacements;
+    // Key index + 1 per slot; 0 marks an empty slot.
+    std::vector<std::uint32_t> slots;
+    std::size_t slotMask = 0;
+};
+} // namespace tools
+
+#endif // TOOLS_PERFECT_HASH_H
@@ -7,4 +7,10 @@
 
 ConfigResult loadSimConfig(const std::string &path);
 
+// Same result as loadSimConfig(), but reuses the compiled snapshot at snapshotPath when it was
+// written by this build from identical config text, skipping parsing and validation. Otherwise
+// the config is compiled and, if valid, its snapshot (re)written. Adapter registry and plugin
+// checks depend on files and time outside the config, so they run on every load.
+ConfigResult loadSimConfigCached(const std::string &path, const std::string &snapshotPath, bool *fromSnapshot = nullptr);
+
 #endif // TOOLS_SIM_CONFIG_LOADER_H
@@ -0,0 +1,28 @@
+#ifndef TOOLS_SIM_CONFIG_SNAPSHOT_H
+#define TOOLS_SIM_CONFIG_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "core/sim_config.h"
+
+namespace tools
+{
+// Bump whenever the header or field encoding changes. Loader defaults and validation rules are
+// covered by the schema ID instead, which CMake hashes from the SimConfig, loader, and snapshot
+// sources at configure time.
+constexpr std::uint32_t kSimConfigSnapshotFormat = 1;
+
+// Binary image of a parsed, validated SimConfig, bound to the SHA-256 of the config text it was
+// compiled from: magic, format, tools contract version, schema ID, sizeof(SimConfig), source
+// hash, every field in declaration order (maps sorted by key), then a SHA-256 trailer over all of it.
+std::string encodeSimConfigSnapshot(const SimConfig &config, const std::string &sourceHash);
+
+// Fails on another magic, format, contract version, or schema ID, a different source hash, a bad
+// trailer, or malformed or trailing field bytes; config is only written on success. The loader
+// still re-validates a decoded config before trusting it.
+bool decodeSimConfigSnapshot(std::string_view bytes, const std::string &sourceHash, SimConfig &config);
+} // namespace tools
+
+#endif // TOOLS_SIM_CONFIG_SNAPSHOT_H
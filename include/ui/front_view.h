@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "core/random_streams.h"
 #include "core/sim_config.h"
 
 struct FrontViewFrameResult
@@ -53,6 +54,18 @@ bool frontViewGenerateFrame(const SimConfig::FrontViewConfig &config,
                             const std::string &streamId = "primary",
                             unsigned int streamIndex = 1,
                             unsigned int streamCount = 1);
+// Draws the same jitter sequence from a counter stream, typically keyed by
+// (seed, streamIndex, randomStreamId("front_view"), sequence), so frames can be generated per
+// stream without sharing an engine.
+bool frontViewGenerateFrame(const SimConfig::FrontViewConfig &config,
+                            const std::string &mode,
+                            unsigned int sequence,
+                            CounterRng &rng,
+                            FrontViewFrameResult &result,
+                            std::string &reason,
+                            const std::string &streamId = "primary",
+                            unsigned int streamIndex = 1,
+                            unsigned int streamCount = 1);
 bool frontViewCycleFrames(const SimConfig::FrontViewConfig &config,
                           bool cycleAllModes,
                           std::mt19937 &rng,
@@ -0,0 +1,125 @@
+#include "core/cpu_features.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define AIRTRACE_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace
+{
+#if defined(AIRTRACE_X86)
+void cpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4])
+{
+#if defined(_MSC_VER)
+    int values[4] = {0, 0, 0, 0};
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int idx = 0; idx < 4; ++idx)
+    {
+        regs[idx] = static_cast<unsigned int>(values[idx]);
+    }
+#else
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+    __get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+}
+
+unsigned long long readXcr0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int eax = 0;
+    unsigned int edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+CpuFeatures detectFeatures()
+{
+    CpuFeatures features;
+#if defined(AIRTRACE_X86)
+    unsigned int regs[4] = {0, 0, 0, 0};
+    cpuid(0, 0, regs);
+    const unsigned int maxLeaf = regs[0];
+    if (maxLeaf < 1)
+    {
+        return features;
+    }
+
+    cpuid(1, 0, regs);
+    const unsigned int leaf1Ecx = regs[2];
+    features.sse41 = (leaf1Ecx & (1U << 19)) != 0;
+    const bool osxsave = (leaf1Ecx & (1U << 27)) != 0;
+    const bool avx = (leaf1Ecx & (1U << 28)) != 0;
+
+    unsigned int leaf7Ebx = 0;
+    if (maxLeaf >= 7)
+    {
+        cpuid(7, 0, regs);
+        leaf7Ebx = regs[1];
+    }
+    features.sha = (leaf7Ebx & (1U << 29)) != 0;
+
+    // Wide registers are only usable when the OS saves their state on context switch.
+    const unsigned long long xcr0 = osxsave ? readXcr0() : 0ULL;
+    const bool ymmState = (xcr0 & 0x6ULL) == 0x6ULL;
+    const bool zmmState = (xcr0 & 0xE6ULL) == 0xE6ULL;
+    features.avx2 = avx && ymmState && (leaf7Ebx & (1U << 5)) != 0;
+    features.avx512f = features.avx2 && zmmState && (leaf7Ebx & (1U << 16)) != 0;
+#endif
+    return features;
+}
+} // namespace
+
+const CpuFeatures &cpuFeatures()
+{
+    static const CpuFeatures features = detectFeatures();
+    return features;
+}
+
+SimdLevel detectSimdLevel()
+{
+    const CpuFeatures &features = cpuFeatures();
+    if (features.avx512f)
+    {
+        return SimdLevel::Avx512;
+    }
+    if (features.avx2)
+    {
+        return SimdLevel::Avx2;
+    }
+    if (features.sse41)
+    {
+        return SimdLevel::Sse4;
+    }
+    return SimdLevel::Scalar;
+}
+
+bool simdLevelSupported(SimdLevel level)
+{
+    return static_cast<int>(level) <= static_cast<int>(detectSimdLevel());
+}
+
+const char *simdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Scalar:
+        return "scalar";
+    case SimdLevel::Sse4:
+        return "sse4";
+    case SimdLevel::Avx2:
+        return "avx2";
+    case SimdLevel::Avx512:
+        return "avx512";
+    default:
+        return "unknown";
+    }
+}
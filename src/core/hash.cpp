@@ -1,9 +1,24 @@
 #include "core/hash.h"
 
+#include "core/cpu_features.h"
+
+#include <algorithm>
 #include <array>
 #include <cstdint>
-#include <iomanip>
-#include <sstream>
+#include <cstring>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define AIRTRACE_X86_SHA 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define AIRTRACE_TARGET_SHA __attribute__((target("sha,sse4.1,ssse3")))
+#define AIRTRACE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define AIRTRACE_TARGET_SHA
+#define AIRTRACE_TARGET_AVX2
+#endif
+#endif
 
 namespace
 {
@@ -60,52 +75,21 @@ uint32_t smallSigma1(uint32_t x)
     return rotr(x, 17U) ^ rotr(x, 19U) ^ (x >> 10U);
 }
 
-std::string toHex(const std::array<uint32_t, 8> &state)
-{
-    std::ostringstream out;
-    out << std::hex << std::setfill('0');
-    for (uint32_t value : state)
-    {
-        out << std::setw(8) << value;
-    }
-    return out.str();
-}
-} // namespace
+constexpr std::array<uint32_t, 8> kInitialState = {
+    0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU, 0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U};
 
-std::string sha256Hex(const std::vector<unsigned char> &data)
+void compressPortable(std::array<uint32_t, 8> &state, const unsigned char *blocks, std::size_t blockCount)
 {
-    std::array<uint32_t, 8> state = {
-        0x6a09e667U,
-        0xbb67ae85U,
-        0x3c6ef372U,
-        0xa54ff53aU,
-        0x510e527fU,
-        0x9b05688cU,
-        0x1f83d9abU,
-        0x5be0cd19U};
-
-    std::vector<unsigned char> buffer = data;
-    uint64_t bitLen = static_cast<uint64_t>(buffer.size()) * 8U;
-    buffer.push_back(0x80U);
-    while ((buffer.size() % 64U) != 56U)
-    {
-        buffer.push_back(0x00U);
-    }
-    for (int i = 7; i >= 0; --i)
-    {
-        buffer.push_back(static_cast<unsigned char>((bitLen >> (i * 8)) & 0xFFU));
-    }
-
     std::array<uint32_t, 64> w{};
-    for (size_t offset = 0; offset < buffer.size(); offset += 64U)
+    for (std::size_t block = 0; block < blockCount; ++block)
     {
+        const unsigned char *data = blocks + block * 64U;
         for (size_t i = 0; i < 16U; ++i)
         {
-            size_t index = offset + i * 4U;
-            w[i] = (static_cast<uint32_t>(buffer[index]) << 24U) |
-                   (static_cast<uint32_t>(buffer[index + 1]) << 16U) |
-                   (static_cast<uint32_t>(buffer[index + 2]) << 8U) |
-                   (static_cast<uint32_t>(buffer[index + 3]));
+            w[i] = (static_cast<uint32_t>(data[i * 4U]) << 24U) |
+                   (static_cast<uint32_t>(data[i * 4U + 1]) << 16U) |
+                   (static_cast<uint32_t>(data[i * 4U + 2]) << 8U) |
+                   (static_cast<uint32_t>(data[i * 4U + 3]));
         }
         for (size_t i = 16U; i < 64U; ++i)
         {
@@ -144,8 +128,512 @@ std::string sha256Hex(const std::vector<unsigned char> &data)
         state[6] += g;
         state[7] += h;
     }
+}
+
+#if defined(AIRTRACE_X86_SHA)
+// SHA-NI keeps the state as ABEF/CDGH lane pairs and runs two rounds per sha256rnds2. The message
+// schedule is computed a 4-word group at a time: W[g] = msg2(msg1(W[g-4], W[g-3]) +
+// W[g-2..g-1] shifted by one word, W[g-1]).
+AIRTRACE_TARGET_SHA void compressX86Sha(std::array<uint32_t, 8> &state, const unsigned char *blocks, std::size_t blockCount)
+{
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+    __m128i dcba = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&state[0]));
+    __m128i hgfe = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&state[4]));
+    dcba = _mm_shuffle_epi32(dcba, 0xB1);
+    hgfe = _mm_shuffle_epi32(hgfe, 0x1B);
+    __m128i abef = _mm_alignr_epi8(dcba, hgfe, 8);
+    __m128i cdgh = _mm_blend_epi16(hgfe, dcba, 0xF0);
+
+    for (std::size_t block = 0; block < blockCount; ++block)
+    {
+        const unsigned char *data = blocks + block * 64U;
+        const __m128i abefSaved = abef;
+        const __m128i cdghSaved = cdgh;
+        __m128i words[4];
+        for (int group = 0; group < 16; ++group)
+        {
+            __m128i &current = words[group & 3];
+            if (group < 4)
+            {
+                current = _mm_shuffle_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + group * 16)), byteSwap);
+            }
+            else
+            {
+                const __m128i &last = words[(group - 1) & 3];
+                current = _mm_sha256msg1_epu32(current, words[(group - 3) & 3]);
+                current = _mm_add_epi32(current, _mm_alignr_epi8(last, words[(group - 2) & 3], 4));
+                current = _mm_sha256msg2_epu32(current, last);
+            }
+            __m128i scheduled = _mm_add_epi32(
+                current, _mm_loadu_si128(reinterpret_cast<const __m128i *>(&kTable[static_cast<std::size_t>(group) * 4U])));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, scheduled);
+            scheduled = _mm_shuffle_epi32(scheduled, 0x0E);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, scheduled);
+        }
+        abef = _mm_add_epi32(abef, abefSaved);
+        cdgh = _mm_add_epi32(cdgh, cdghSaved);
+    }
+
+    const __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+    const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(&state[0]), _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(&state[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+#endif
+
+#if defined(AIRTRACE_X86_SHA)
+// Eight-lane message schedule and rounds: lane i of every register belongs to the message in
+// lane i, so one instruction advances eight independent hashes.
+AIRTRACE_TARGET_AVX2 __m256i rotr8(__m256i value, int bits)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(value, bits), _mm256_slli_epi32(value, 32 - bits));
+}
+
+AIRTRACE_TARGET_AVX2 void compressX86Avx2x8(std::array<std::array<uint32_t, 8>, 8> &states,
+                                            const unsigned char *const *blocks)
+{
+    alignas(32) uint32_t transposed[8][8];
+    __m256i vars[8];
+    for (std::size_t word = 0; word < 8; ++word)
+    {
+        for (std::size_t lane = 0; lane < 8; ++lane)
+        {
+            transposed[word][lane] = states[lane][word];
+        }
+        vars[word] = _mm256_load_si256(reinterpret_cast<const __m256i *>(transposed[word]));
+    }
+    __m256i a = vars[0], b = vars[1], c = vars[2], d = vars[3], e = vars[4], f = vars[5], g = vars[6], h = vars[7];
+
+    alignas(32) uint32_t lanes[16][8];
+    for (std::size_t lane = 0; lane < 8; ++lane)
+    {
+        const unsigned char *data = blocks[lane];
+        for (std::size_t word = 0; word < 16; ++word)
+        {
+            const unsigned char *bytes = data + word * 4U;
+            lanes[word][lane] = (static_cast<uint32_t>(bytes[0]) << 24U) | (static_cast<uint32_t>(bytes[1]) << 16U) |
+                                (static_cast<uint32_t>(bytes[2]) << 8U) | static_cast<uint32_t>(bytes[3]);
+        }
+    }
+    __m256i w[16];
+    for (std::size_t word = 0; word < 16; ++word)
+    {
+        w[word] = _mm256_load_si256(reinterpret_cast<const __m256i *>(lanes[word]));
+    }
+
+    for (std::size_t round = 0; round < 64; ++round)
+    {
+        __m256i &current = w[round & 15U];
+        if (round >= 16)
+        {
+            const __m256i w15 = w[(round - 15) & 15U];
+            const __m256i w2 = w[(round - 2) & 15U];
+            const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr8(w15, 7), rotr8(w15, 18)), _mm256_srli_epi32(w15, 3));
+            const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr8(w2, 17), rotr8(w2, 19)), _mm256_srli_epi32(w2, 10));
+            current = _mm256_add_epi32(_mm256_add_epi32(current, s0), _mm256_add_epi32(w[(round - 7) & 15U], s1));
+        }
+        const __m256i sigma1 = _mm256_xor_si256(_mm256_xor_si256(rotr8(e, 6), rotr8(e, 11)), rotr8(e, 25));
+        const __m256i choose = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const __m256i temp1 = _mm256_add_epi32(
+            _mm256_add_epi32(_mm256_add_epi32(h, sigma1), _mm256_add_epi32(choose, current)),
+            _mm256_set1_epi32(static_cast<int>(kTable[round])));
+        const __m256i sigma0 = _mm256_xor_si256(_mm256_xor_si256(rotr8(a, 2), rotr8(a, 13)), rotr8(a, 22));
+        const __m256i majority = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        const __m256i temp2 = _mm256_add_epi32(sigma0, majority);
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, temp1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(temp1, temp2);
+    }
+
+    const __m256i results[8] = {a, b, c, d, e, f, g, h};
+    for (std::size_t word = 0; word < 8; ++word)
+    {
+        _mm256_store_si256(reinterpret_cast<__m256i *>(transposed[word]), _mm256_add_epi32(vars[word], results[word]));
+        for (std::size_t lane = 0; lane < 8; ++lane)
+        {
+            states[lane][word] = transposed[word][lane];
+        }
+    }
+}
+#endif
+
+#if defined(AIRTRACE_X86_SHA)
+// compressX86Sha over two messages with their rounds interleaved, so each sha256rnds2 issues while
+// the other message's previous one is still in flight.
+AIRTRACE_TARGET_SHA void compressX86Shax2(std::array<std::array<uint32_t, 8>, 2> &states,
+                                          const unsigned char *const *blocks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+    __m128i abef[2];
+    __m128i cdgh[2];
+    __m128i words[2][4];
+    for (std::size_t lane = 0; lane < 2; ++lane)
+    {
+        const __m128i dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&states[lane][0])), 0xB1);
+        const __m128i hgfe = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&states[lane][4])), 0x1B);
+        abef[lane] = _mm_alignr_epi8(dcba, hgfe, 8);
+        cdgh[lane] = _mm_blend_epi16(hgfe, dcba, 0xF0);
+    }
+    const __m128i abefSaved[2] = {abef[0], abef[1]};
+    const __m128i cdghSaved[2] = {cdgh[0], cdgh[1]};
+
+    for (int group = 0; group < 16; ++group)
+    {
+        const __m128i constants =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(&kTable[static_cast<std::size_t>(group) * 4U]));
+        __m128i scheduled[2];
+        for (std::size_t lane = 0; lane < 2; ++lane)
+        {
+            __m128i &current = words[lane][group & 3];
+            if (group < 4)
+            {
+                current = _mm_shuffle_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(blocks[lane] + group * 16)), byteSwap);
+            }
+            else
+            {
+                const __m128i &last = words[lane][(group - 1) & 3];
+                current = _mm_sha256msg1_epu32(current, words[lane][(group - 3) & 3]);
+                current = _mm_add_epi32(current, _mm_alignr_epi8(last, words[lane][(group - 2) & 3], 4));
+                current = _mm_sha256msg2_epu32(current, last);
+            }
+            scheduled[lane] = _mm_add_epi32(current, constants);
+        }
+        cdgh[0] = _mm_sha256rnds2_epu32(cdgh[0], abef[0], scheduled[0]);
+        cdgh[1] = _mm_sha256rnds2_epu32(cdgh[1], abef[1], scheduled[1]);
+        abef[0] = _mm_sha256rnds2_epu32(abef[0], cdgh[0], _mm_shuffle_epi32(scheduled[0], 0x0E));
+        abef[1] = _mm_sha256rnds2_epu32(abef[1], cdgh[1], _mm_shuffle_epi32(scheduled[1], 0x0E));
+    }
+
+    for (std::size_t lane = 0; lane < 2; ++lane)
+    {
+        const __m128i feba = _mm_shuffle_epi32(_mm_add_epi32(abef[lane], abefSaved[lane]), 0x1B);
+        const __m128i dchg = _mm_shuffle_epi32(_mm_add_epi32(cdgh[lane], cdghSaved[lane]), 0xB1);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&states[lane][0]), _mm_blend_epi16(feba, dchg, 0xF0));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&states[lane][4]), _mm_alignr_epi8(dchg, feba, 8));
+    }
+}
+#endif
+
+Sha256::Digest digestFromState(const std::array<uint32_t, 8> &state)
+{
+    Sha256::Digest digest{};
+    for (std::size_t i = 0; i < state.size(); ++i)
+    {
+        digest[i * 4U] = static_cast<unsigned char>(state[i] >> 24U);
+        digest[i * 4U + 1] = static_cast<unsigned char>(state[i] >> 16U);
+        digest[i * 4U + 2] = static_cast<unsigned char>(state[i] >> 8U);
+        digest[i * 4U + 3] = static_cast<unsigned char>(state[i]);
+    }
+    return digest;
+}
+
+// One lane of a multi-buffer pass: a message's whole blocks are read in place, and its one or two
+// padded final blocks from `tail`.
+struct BatchLane
+{
+    const unsigned char *data = nullptr;
+    std::size_t message = 0;
+    std::size_t block = 0;
+    std::size_t fullBlocks = 0;
+    std::size_t blockCount = 0;
+    alignas(64) unsigned char tail[128];
+
+    void load(std::size_t index, std::string_view bytes)
+    {
+        data = reinterpret_cast<const unsigned char *>(bytes.data());
+        message = index;
+        block = 0;
+        fullBlocks = bytes.size() / 64U;
+        const std::size_t remainder = bytes.size() % 64U;
+        const std::size_t tailBytes = remainder < 56U ? 64U : 128U;
+        blockCount = fullBlocks + tailBytes / 64U;
+        std::memset(tail, 0, sizeof(tail));
+        if (remainder > 0)
+        {
+            std::memcpy(tail, data + fullBlocks * 64U, remainder);
+        }
+        tail[remainder] = 0x80U;
+        const std::uint64_t bitLength = static_cast<std::uint64_t>(bytes.size()) * 8U;
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            tail[tailBytes - 1U - i] = static_cast<unsigned char>((bitLength >> (i * 8U)) & 0xFFU);
+        }
+    }
+
+    const unsigned char *currentBlock() const
+    {
+        return block < fullBlocks ? data + block * 64U : tail + (block - fullBlocks) * 64U;
+    }
+};
+
+// Keeps every lane busy: when a lane's message runs out of blocks its digest is stored and the
+// next unhashed message takes the lane, so short and long messages mix without idling lanes
+// until the batch runs dry. Idle lanes compress a zero block whose result is discarded.
+template <std::size_t Lanes, typename Kernel>
+void hashInLanes(const std::vector<std::string_view> &messages, std::vector<Sha256::Digest> &digests, Kernel kernel)
+{
+    static const unsigned char kIdleBlock[64] = {};
+    std::array<BatchLane, Lanes> lanes;
+    std::array<bool, Lanes> busy{};
+    std::array<std::array<uint32_t, 8>, Lanes> states{};
+    const unsigned char *blocks[Lanes];
+    std::size_t next = 0;
+    std::size_t active = 0;
+    for (std::size_t lane = 0; lane < Lanes && next < messages.size(); ++lane, ++next)
+    {
+        lanes[lane].load(next, messages[next]);
+        states[lane] = kInitialState;
+        busy[lane] = true;
+        ++active;
+    }
+    while (active > 0)
+    {
+        for (std::size_t lane = 0; lane < Lanes; ++lane)
+        {
+            blocks[lane] = busy[lane] ? lanes[lane].currentBlock() : kIdleBlock;
+        }
+        kernel(states, blocks);
+        for (std::size_t lane = 0; lane < Lanes; ++lane)
+        {
+            if (!busy[lane] || ++lanes[lane].block < lanes[lane].blockCount)
+            {
+                continue;
+            }
+            digests[lanes[lane].message] = digestFromState(states[lane]);
+            if (next < messages.size())
+            {
+                lanes[lane].load(next, messages[next]);
+                states[lane] = kInitialState;
+                ++next;
+            }
+            else
+            {
+                busy[lane] = false;
+                --active;
+            }
+        }
+    }
+}
+
+void compress(Sha256Backend backend, std::array<uint32_t, 8> &state, const unsigned char *blocks, std::size_t blockCount)
+{
+#if defined(AIRTRACE_X86_SHA)
+    if (backend == Sha256Backend::X86Sha)
+    {
+        compressX86Sha(state, blocks, blockCount);
+        return;
+    }
+#endif
+    (void)backend;
+    compressPortable(state, blocks, blockCount);
+}
+} // namespace
+
+Sha256Backend detectSha256Backend()
+{
+    // SHA-NI shipped on SSE4.1-capable cores only, but the shuffles need both, so check both.
+    const CpuFeatures &features = cpuFeatures();
+    return (features.sha && features.sse41) ? Sha256Backend::X86Sha : Sha256Backend::Portable;
+}
+
+bool sha256BackendSupported(Sha256Backend backend)
+{
+    return backend == Sha256Backend::Portable || detectSha256Backend() == backend;
+}
+
+const char *sha256BackendName(Sha256Backend backend)
+{
+    switch (backend)
+    {
+    case Sha256Backend::Portable:
+        return "portable";
+    case Sha256Backend::X86Sha:
+        return "x86_sha";
+    default:
+        return "unknown";
+    }
+}
+
+Sha256BatchBackend detectSha256BatchBackend()
+{
+    // Where both exist, SHA-NI beats eight AVX2 lanes even one message at a time.
+    if (detectSha256Backend() == Sha256Backend::X86Sha)
+    {
+        return Sha256BatchBackend::X86Shax2;
+    }
+    return cpuFeatures().avx2 ? Sha256BatchBackend::X86Avx2x8 : Sha256BatchBackend::Serial;
+}
 
-    return toHex(state);
+bool sha256BatchBackendSupported(Sha256BatchBackend backend)
+{
+    switch (backend)
+    {
+    case Sha256BatchBackend::Serial:
+        return true;
+    case Sha256BatchBackend::X86Shax2:
+        return detectSha256Backend() == Sha256Backend::X86Sha;
+    case Sha256BatchBackend::X86Avx2x8:
+        return cpuFeatures().avx2;
+    default:
+        return false;
+    }
+}
+
+const char *sha256BatchBackendName(Sha256BatchBackend backend)
+{
+    switch (backend)
+    {
+    case Sha256BatchBackend::Serial:
+        return "serial";
+    case Sha256BatchBackend::X86Shax2:
+        return "x86_sha_x2";
+    case Sha256BatchBackend::X86Avx2x8:
+        return "x86_avx2x8";
+    default:
+        return "unknown";
+    }
+}
+
+Sha256::Sha256()
+    : Sha256(detectSha256Backend())
+{
+}
+
+Sha256::Sha256(Sha256Backend backend)
+    : compressBackend(sha256BackendSupported(backend) ? backend : Sha256Backend::Portable)
+{
+    reset();
+}
+
+void Sha256::reset()
+{
+    state = kInitialState;
+    pendingBytes = 0;
+    totalBytes = 0;
+}
+
+void Sha256::update(const void *data, std::size_t size)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    totalBytes += size;
+    if (pendingBytes > 0)
+    {
+        const std::size_t take = std::min(size, pending.size() - pendingBytes);
+        std::memcpy(pending.data() + pendingBytes, bytes, take);
+        pendingBytes += take;
+        bytes += take;
+        size -= take;
+        if (pendingBytes < pending.size())
+        {
+            return;
+        }
+        compress(compressBackend, state, pending.data(), 1);
+        pendingBytes = 0;
+    }
+    const std::size_t blockCount = size / 64U;
+    if (blockCount > 0)
+    {
+        compress(compressBackend, state, bytes, blockCount);
+        bytes += blockCount * 64U;
+        size -= blockCount * 64U;
+    }
+    if (size > 0)
+    {
+        std::memcpy(pending.data(), bytes, size);
+        pendingBytes = size;
+    }
+}
+
+Sha256::Digest Sha256::finish()
+{
+    const std::uint64_t bitLength = totalBytes * 8U;
+    unsigned char padding[72] = {0x80U};
+    const std::size_t padBytes = (pendingBytes < 56U ? 56U : 120U) - pendingBytes;
+    for (int i = 0; i < 8; ++i)
+    {
+        padding[padBytes + static_cast<std::size_t>(i)] = static_cast<unsigned char>((bitLength >> ((7 - i) * 8)) & 0xFFU);
+    }
+    update(padding, padBytes + 8U);
+
+    const Digest digest = digestFromState(state);
+    reset();
+    return digest;
+}
+
+std::string Sha256::finishHex()
+{
+    return sha256DigestHex(finish());
+}
+
+std::uint64_t Sha256::bytesHashed() const
+{
+    return totalBytes;
+}
+
+Sha256Backend Sha256::backend() const
+{
+    return compressBackend;
+}
+
+std::string sha256DigestHex(const Sha256::Digest &digest)
+{
+    static const char kHex[] = "0123456789abcdef";
+    std::string hex(digest.size() * 2U, '0');
+    for (std::size_t i = 0; i < digest.size(); ++i)
+    {
+        hex[i * 2U] = kHex[digest[i] >> 4U];
+        hex[i * 2U + 1] = kHex[digest[i] & 0x0FU];
+    }
+    return hex;
+}
+
+std::string sha256Hex(const void *data, std::size_t size)
+{
+    Sha256 hasher;
+    hasher.update(data, size);
+    return hasher.finishHex();
+}
+
+std::string sha256Hex(const std::vector<unsigned char> &data)
+{
+    return sha256Hex(data.data(), data.size());
+}
+
+std::vector<Sha256::Digest> sha256Batch(const std::vector<std::string_view> &messages)
+{
+    return sha256Batch(messages, detectSha256BatchBackend());
+}
+
+std::vector<Sha256::Digest> sha256Batch(const std::vector<std::string_view> &messages, Sha256BatchBackend backend)
+{
+    std::vector<Sha256::Digest> digests(messages.size());
+#if defined(AIRTRACE_X86_SHA)
+    if (backend == Sha256BatchBackend::X86Shax2 && sha256BatchBackendSupported(backend))
+    {
+        hashInLanes<2>(messages, digests, compressX86Shax2);
+        return digests;
+    }
+    if (backend == Sha256BatchBackend::X86Avx2x8 && sha256BatchBackendSupported(backend))
+    {
+        hashInLanes<8>(messages, digests, compressX86Avx2x8);
+        return digests;
+    }
+#endif
+    (void)backend;
+    Sha256 hasher;
+    for (std::size_t idx = 0; idx < messages.size(); ++idx)
+    {
+        hasher.update(messages[idx].data(), messages[idx].size());
+        digests[idx] = hasher.finish();
+    }
+    return digests;
 }
 
 bool hashEquals(const std::string &expectedHex, const std::string &actualHex)
@@ -0,0 +1,533 @@
+#include "core/imm_filter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+constexpr double kPi = 3.141592653589793;
+
+// State index = derivative * 3 + axis, as in TrackEstimate.
+std::size_t stateIndex(std::size_t derivative, std::size_t axis)
+{
+    return derivative * 3 + axis;
+}
+
+void setConstantAcceleration(TrackCovariance &transition, TrackCovariance &noise, double dt, double jerkDensity)
+{
+    const double dt2 = dt * dt;
+    const double dt3 = dt2 * dt;
+    const double table[3][3] = {
+        {dt3 * dt2 / 20.0, dt2 * dt2 / 8.0, dt3 / 6.0},
+        {dt2 * dt2 / 8.0, dt3 / 3.0, dt2 / 2.0},
+        {dt3 / 6.0, dt2 / 2.0, dt}};
+    transition = TrackCovariance::identity();
+    noise = TrackCovariance{};
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        transition(stateIndex(0, axis), stateIndex(1, axis)) = dt;
+        transition(stateIndex(0, axis), stateIndex(2, axis)) = 0.5 * dt2;
+        transition(stateIndex(1, axis), stateIndex(2, axis)) = dt;
+        for (std::size_t row = 0; row < 3; ++row)
+        {
+            for (std::size_t col = 0; col < 3; ++col)
+            {
+                noise(stateIndex(row, axis), stateIndex(col, axis)) = jerkDensity * table[row][col];
+            }
+        }
+    }
+}
+
+// Velocity-driven models drop acceleration and take white-acceleration noise on position/velocity.
+void setVelocityNoise(TrackCovariance &noise, double dt, double density)
+{
+    const double dt2 = dt * dt;
+    noise = TrackCovariance{};
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        noise(stateIndex(0, axis), stateIndex(0, axis)) = density * dt2 * dt / 3.0;
+        noise(stateIndex(0, axis), stateIndex(1, axis)) = density * dt2 / 2.0;
+        noise(stateIndex(1, axis), stateIndex(0, axis)) = density * dt2 / 2.0;
+        noise(stateIndex(1, axis), stateIndex(1, axis)) = density * dt;
+    }
+}
+
+void setConstantVelocity(TrackCovariance &transition, TrackCovariance &noise, double dt, double density)
+{
+    transition = TrackCovariance{};
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        transition(stateIndex(0, axis), stateIndex(0, axis)) = 1.0;
+        transition(stateIndex(0, axis), stateIndex(1, axis)) = dt;
+        transition(stateIndex(1, axis), stateIndex(1, axis)) = 1.0;
+    }
+    setVelocityNoise(noise, dt, density);
+}
+
+// Matches stepMotionModel: rotate horizontal velocity by the turn angle, then integrate it.
+void setCoordinatedTurn(TrackCovariance &transition, TrackCovariance &noise, double dt, double turnRateDeg, double density)
+{
+    const double angle = turnRateDeg * (kPi / 180.0) * dt;
+    const double c = std::cos(angle);
+    const double s = std::sin(angle);
+    transition = TrackCovariance{};
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        transition(stateIndex(0, axis), stateIndex(0, axis)) = 1.0;
+    }
+    transition(stateIndex(1, 0), stateIndex(1, 0)) = c;
+    transition(stateIndex(1, 0), stateIndex(1, 1)) = -s;
+    transition(stateIndex(1, 1), stateIndex(1, 0)) = s;
+    transition(stateIndex(1, 1), stateIndex(1, 1)) = c;
+    transition(stateIndex(1, 2), stateIndex(1, 2)) = 1.0;
+    transition(stateIndex(0, 0), stateIndex(1, 0)) = dt * c;
+    transition(stateIndex(0, 0), stateIndex(1, 1)) = -dt * s;
+    transition(stateIndex(0, 1), stateIndex(1, 0)) = dt * s;
+    transition(stateIndex(0, 1), stateIndex(1, 1)) = dt * c;
+    transition(stateIndex(0, 2), stateIndex(1, 2)) = dt;
+    setVelocityNoise(noise, dt, density);
+}
+
+// out = F in, P_out = F P_in F^T + Q, one lane pass per nonzero coefficient.
+void transitionLanes(const TrackCovariance &transition,
+                     const TrackCovariance &noise,
+                     const TrackFilterBatch &in,
+                     TrackFilterBatch &out,
+                     std::size_t count)
+{
+    for (std::size_t row = 0; row < kTrackStateDim; ++row)
+    {
+        double *dst = out.state[row].data();
+        std::fill(dst, dst + count, 0.0);
+        for (std::size_t k = 0; k < kTrackStateDim; ++k)
+        {
+            const double coefficient = transition(row, k);
+            if (coefficient == 0.0)
+            {
+                continue;
+            }
+            const double *src = in.state[k].data();
+            for (std::size_t lane = 0; lane < count; ++lane)
+            {
+                dst[lane] += coefficient * src[lane];
+            }
+        }
+    }
+    for (std::size_t row = 0; row < kTrackStateDim; ++row)
+    {
+        for (std::size_t col = row; col < kTrackStateDim; ++col)
+        {
+            double *dst = out.covariance[TrackFilterBatch::covarianceIndex(row, col)].data();
+            std::fill(dst, dst + count, noise(row, col));
+            for (std::size_t k = 0; k < kTrackStateDim; ++k)
+            {
+                const double rowCoefficient = transition(row, k);
+                if (rowCoefficient == 0.0)
+                {
+                    continue;
+                }
+                for (std::size_t l = 0; l < kTrackStateDim; ++l)
+                {
+                    const double colCoefficient = transition(col, l);
+                    if (colCoefficient == 0.0)
+                    {
+                        continue;
+                    }
+                    const double coefficient = rowCoefficient * colCoefficient;
+                    const double *src = in.covariance[TrackFilterBatch::covarianceIndex(k, l)].data();
+                    for (std::size_t lane = 0; lane < count; ++lane)
+                    {
+                        dst[lane] += coefficient * src[lane];
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool isProbability(double value)
+{
+    return value >= 0.0 && value <= 1.0;
+}
+
+bool sumsToOne(double sum)
+{
+    return std::fabs(sum - 1.0) <= 1e-9;
+}
+} // namespace
+
+bool validateImmConfig(const ImmConfig &config)
+{
+    double columnSum[kImmModelCount] = {};
+    double initialSum = 0.0;
+    for (std::size_t from = 0; from < kImmModelCount; ++from)
+    {
+        double rowSum = 0.0;
+        for (std::size_t to = 0; to < kImmModelCount; ++to)
+        {
+            const double entry = config.transition[from][to];
+            if (!isProbability(entry))
+            {
+                return false;
+            }
+            rowSum += entry;
+            columnSum[to] += entry;
+        }
+        if (!sumsToOne(rowSum) || !isProbability(config.initialProbability[from]))
+        {
+            return false;
+        }
+        initialSum += config.initialProbability[from];
+    }
+    for (double sum : columnSum)
+    {
+        if (sum <= 0.0)
+        {
+            return false;
+        }
+    }
+    // Above 1 / kImmModelCount the floor could not hold for every model at once.
+    return sumsToOne(initialSum) && config.minProbability > 0.0 &&
+           config.minProbability <= 1.0 / static_cast<double>(kImmModelCount);
+}
+
+ImmFilterBank::ImmFilterBank(ImmConfig config)
+    : config(config),
+      validConfig(validateImmConfig(config))
+{
+    if (!validConfig)
+    {
+        const ImmConfig defaults;
+        std::copy(&defaults.transition[0][0], &defaults.transition[0][0] + kImmModelCount * kImmModelCount,
+                  &this->config.transition[0][0]);
+        std::copy(defaults.initialProbability, defaults.initialProbability + kImmModelCount,
+                  this->config.initialProbability);
+        this->config.minProbability = defaults.minProbability;
+    }
+}
+
+std::size_t ImmFilterBank::size() const
+{
+    return models[0].size();
+}
+
+void ImmFilterBank::reserve(std::size_t count)
+{
+    for (std::size_t model = 0; model < kImmModelCount; ++model)
+    {
+        models[model].reserve(count);
+        mixed[model].reserve(count);
+        probability[model].reserve(count);
+        predictedProbability[model].reserve(count);
+    }
+    for (auto &weights : mixingWeight)
+    {
+        weights.reserve(count);
+    }
+}
+
+void ImmFilterBank::clear()
+{
+    for (std::size_t model = 0; model < kImmModelCount; ++model)
+    {
+        models[model].clear();
+        mixed[model].clear();
+        probability[model].clear();
+        predictedProbability[model].clear();
+    }
+    for (auto &weights : mixingWeight)
+    {
+        weights.clear();
+    }
+}
+
+std::size_t ImmFilterBank::addTrack(const TrackEstimate &initial)
+{
+    const std::size_t index = size();
+    for (std::size_t model = 0; model < kImmModelCount; ++model)
+    {
+        models[model].push_back(initial);
+        mixed[model].resize(index + 1);
+        probability[model].push_back(config.initialProbability[model]);
+        predictedProbability[model].push_back(0.0);
+    }
+    for (auto &weights : mixingWeight)
+    {
+        weights.push_back(0.0);
+    }
+    return index;
+}
+
+void ImmFilterBank::buildTransitions(double dt)
+{
+    if (dt == transitionDt)
+    {
+        return;
+    }
+    const auto slot = [](MotionModelType model)
+    {
+        return static_cast<std::size_t>(model);
+    };
+    ModelTransition &cv = transitions[slot(MotionModelType::ConstantVelocity)];
+    setConstantVelocity(cv.transition, cv.noise, dt, config.velocityNoiseDensity);
+    ModelTransition &ca = transitions[slot(MotionModelType::ConstantAcceleration)];
+    setConstantAcceleration(ca.transition, ca.noise, dt, config.filter.jerkSpectralDensity);
+    ModelTransition &ct = transitions[slot(MotionModelType::CoordinatedTurn)];
+    setCoordinatedTurn(ct.transition, ct.noise, dt, config.turnRateDeg, config.velocityNoiseDensity);
+    ModelTransition &rm = transitions[slot(MotionModelType::RandomManeuver)];
+    setConstantAcceleration(rm.transition, rm.noise, dt, config.maneuverJerkDensity);
+    transitionDt = dt;
+}
+
+void ImmFilterBank::predict(double dt)
+{
+    buildTransitions(dt);
+    const std::size_t count = size();
+
+    // c_j = sum_i p_ij mu_i and mixing weights mu_{i|j} = p_ij mu_i / c_j.
+    for (std::size_t to = 0; to < kImmModelCount; ++to)
+    {
+        double *predicted = predictedProbability[to].data();
+        std::fill(predicted, predicted + count, 0.0);
+        for (std::size_t from = 0; from < kImmModelCount; ++from)
+        {
+            const double switchProbability = config.transition[from][to];
+            const double *prior = probability[from].data();
+            double *weight = mixingWeight[from * kImmModelCount + to].data();
+            for (std::size_t lane = 0; lane < count; ++lane)
+            {
+                weight[lane] = switchProbability * prior[lane];
+                predicted[lane] += weight[lane];
+            }
+        }
+        for (std::size_t from = 0; from < kImmModelCount; ++from)
+        {
+            double *weight = mixingWeight[from * kImmModelCount + to].data();
+            for (std::size_t lane = 0; lane < count; ++lane)
+            {
+                // A model nothing can switch into this step keeps its own estimate unmixed.
+                weight[lane] = predicted[lane] > 0.0 ? weight[lane] / predicted[lane] : (from == to ? 1.0 : 0.0);
+            }
+        }
+    }
+
+    // Mixed initial conditions per target model, from the previous step's model estimates.
+    for (std::size_t to = 0; to < kImmModelCount; ++to)
+    {
+        TrackFilterBatch &target = mixed[to];
+        for (std::size_t row = 0; row < kTrackStateDim; ++row)
+        {
+            double *dst = target.state[row].data();
+            std::fill(dst, dst + count, 0.0);
+            for (std::size_t from = 0; from < kImmModelCount; ++from)
+            {
+                const double *weight = mixingWeight[from * kImmModelCount + to].data();
+                const double *src = models[from].state[row].data();
+                for (std::size_t lane = 0; lane < count; ++lane)
+                {
+                    dst[lane] += weight[lane] * src[lane];
+                }
+            }
+        }
+        for (std::size_t row = 0; row < kTrackStateDim; ++row)
+        {
+            for (std::size_t col = row; col < kTrackStateDim; ++col)
+            {
+                double *dst = target.covariance[TrackFilterBatch::covarianceIndex(row, col)].data();
+                const double *meanRow = target.state[row].data();
+                const double *meanCol = target.state[col].data();
+                std::fill(dst, dst + count, 0.0);
+                for (std::size_t from = 0; from < kImmModelCount; ++from)
+                {
+                    const double *weight = mixingWeight[from * kImmModelCount + to].data();
+                    const double *src = models[from].covariance[TrackFilterBatch::covarianceIndex(row, col)].data();
+                    const double *stateRow = models[from].state[row].data();
+                    const double *stateCol = models[from].state[col].data();
+                    for (std::size_t lane = 0; lane < count; ++lane)
+                    {
+                        const double spread = (stateRow[lane] - meanRow[lane]) * (stateCol[lane] - meanCol[lane]);
+                        dst[lane] += weight[lane] * (src[lane] + spread);
+                    }
+                }
+            }
+        }
+    }
+
+    for (std::size_t model = 0; model < kImmModelCount; ++model)
+    {
+        transitionLanes(transitions[model].transition, transitions[model].noise, mixed[model], models[model], count);
+        double *time = models[model].time.data();
+        for (std::size_t lane = 0; lane < count; ++lane)
+        {
+            time[lane] += dt;
+        }
+        std::copy(predictedProbability[model].begin(), predictedProbability[model].end(), probability[model].begin());
+    }
+}
+
+std::size_t ImmFilterBank::update(const std::vector<Measurement> &measurements)
+{
+    // Updates are sparse per step, so each measured track is gathered per model into stack
+    // matrices and run through the shared Joseph-form update.
+    const std::size_t count = std::min(size(), measurements.size());
+    std::size_t updated = 0;
+    for (std::size_t track = 0; track < count; ++track)
+    {
+        const Measurement &measurement = measurements[track];
+        if (!measurement.valid)
+        {
+            continue;
+        }
+        double logLikelihood[kImmModelCount] = {};
+        bool applied[kImmModelCount] = {};
+        bool anyApplied = false;
+        for (std::size_t model = 0; model < kImmModelCount; ++model)
+        {
+            TrackEstimate estimate = models[model].get(track);
+            if (updateTrack(estimate, measurement, config.filter, &logLikelihood[model]) > 0)
+            {
+                models[model].set(track, estimate);
+                applied[model] = true;
+                anyApplied = true;
+            }
+        }
+        if (!anyApplied)
+        {
+            continue;
+        }
+        double best = -std::numeric_limits<double>::infinity();
+        double worst = std::numeric_limits<double>::infinity();
+        for (std::size_t model = 0; model < kImmModelCount; ++model)
+        {
+            if (applied[model])
+            {
+                best = std::max(best, logLikelihood[model]);
+                worst = std::min(worst, logLikelihood[model]);
+            }
+        }
+        double total = 0.0;
+        double weights[kImmModelCount] = {};
+        for (std::size_t model = 0; model < kImmModelCount; ++model)
+        {
+            // A model the measurement could not update gets no credit over the worst one that could.
+            const double likelihood = applied[model] ? logLikelihood[model] : worst;
+            weights[model] = probability[model][track] * std::exp(likelihood - best);
+            total += weights[model];
+        }
+        double floored = 0.0;
+        for (std::size_t model = 0; model < kImmModelCount; ++model)
+        {
+            weights[model] = total > 0.0 ? std::max(weights[model] / total, config.minProbability)
+                                         : config.initialProbability[model];
+            floored += weights[model];
+        }
+        for (std::size_t model = 0; model < kImmModelCount; ++model)
+        {
+            probability[model][track] = weights[model] / floored;
+        }
+        ++updated;
+    }
+    return updated;
+}
+
+double ImmFilterBank::modelProbability(std::size_t track, MotionModelType model) const
+{
+    return probability[static_cast<std::size_t>(model)][track];
+}
+
+MotionModelType ImmFilterBank::mostLikelyModel(std::size_t track) const
+{
+    std::size_t best = 0;
+    for (std::size_t model = 1; model < kImmModelCount; ++model)
+    {
+        if (probability[model][track] > probability[best][track])
+        {
+            best = model;
+        }
+    }
+    return static_cast<MotionModelType>(best);
+}
+
+const TrackFilterBatch &ImmFilterBank::modelEstimates(MotionModelType model) const
+{
+    return models[static_cast<std::size_t>(model)];
+}
+
+TrackEstimate ImmFilterBank::combinedEstimate(std::size_t track) const
+{
+    TrackEstimate combined;
+    TrackEstimate perModel[kImmModelCount];
+    for (std::size_t model = 0; model < kImmModelCount; ++model)
+    {
+        perModel[model] = models[model].get(track);
+        for (std::size_t row = 0; row < kTrackStateDim; ++row)
+        {
+            combined.state(row, 0) += probability[model][track] * perModel[model].state(row, 0);
+        }
+    }
+    for (std::size_t model = 0; model < kImmModelCount; ++model)
+    {
+        const TrackVector spread = perModel[model].state - combined.state;
+        const TrackCovariance term = perModel[model].covariance + spread * transpose(spread);
+        for (std::size_t idx = 0; idx < kTrackStateDim * kTrackStateDim; ++idx)
+        {
+            combined.covariance.values[idx] += probability[model][track] * term.values[idx];
+        }
+    }
+    combined.time = perModel[0].time;
+    return combined;
+}
+
+void ImmFilterBank::combine(TrackFilterBatch &out) const
+{
+    const std::size_t count = size();
+    out.resize(count);
+    for (std::size_t row = 0; row < kTrackStateDim; ++row)
+    {
+        double *dst = out.state[row].data();
+        std::fill(dst, dst + count, 0.0);
+        for (std::size_t model = 0; model < kImmModelCount; ++model)
+        {
+            const double *weight = probability[model].data();
+            const double *src = models[model].state[row].data();
+            for (std::size_t lane = 0; lane < count; ++lane)
+            {
+                dst[lane] += weight[lane] * src[lane];
+            }
+        }
+    }
+    for (std::size_t row = 0; row < kTrackStateDim; ++row)
+    {
+        for (std::size_t col = row; col < kTrackStateDim; ++col)
+        {
+            double *dst = out.covariance[TrackFilterBatch::covarianceIndex(row, col)].data();
+            const double *meanRow = out.state[row].data();
+            const double *meanCol = out.state[col].data();
+            std::fill(dst, dst + count, 0.0);
+            for (std::size_t model = 0; model < kImmModelCount; ++model)
+            {
+                const double *weight = probability[model].data();
+                const double *src = models[model].covariance[TrackFilterBatch::covarianceIndex(row, col)].data();
+                const double *stateRow = models[model].state[row].data();
+                const double *stateCol = models[model].state[col].data();
+                for (std::size_t lane = 0; lane < count; ++lane)
+                {
+                    const double spread = (stateRow[lane] - meanRow[lane]) * (stateCol[lane] - meanCol[lane]);
+                    dst[lane] += weight[lane] * (src[lane] + spread);
+                }
+            }
+        }
+    }
+    std::copy(models[0].time.begin(), models[0].time.end(), out.time.begin());
+}
+
+const ImmConfig &ImmFilterBank::getConfig() const
+{
+    return config;
+}
+
+bool ImmFilterBank::configValid() const
+{
+    return validConfig;
+}
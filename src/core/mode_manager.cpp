@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <optional>
 
 namespace
@@ -19,61 +20,131 @@ double normalizeAngle(double radians)
     return radians;
 }
 
-std::optional<double> residualBetween(const SensorStatus &a, const SensorStatus &b, double maxAgeSeconds)
+enum SummaryField : std::uint8_t
+{
+    kSummaryPosition = 1U << 0,
+    kSummaryVelocity = 1U << 1,
+    kSummaryRange = 1U << 2,
+    kSummaryAltitude = 1U << 3,
+    kSummaryHeading = 1U << 4,
+    kSummaryBearing = 1U << 5
+};
+
+MeasurementSummary summarize(const SensorStatus *status)
+{
+    MeasurementSummary summary;
+    if (status == nullptr)
+    {
+        return summary;
+    }
+    summary.time = status->lastMeasurementTime;
+    summary.present = status->hasMeasurement;
+    if (!summary.present)
+    {
+        return summary;
+    }
+    const Measurement &measurement = status->lastMeasurement;
+    if (measurement.position)
+    {
+        summary.fields |= kSummaryPosition;
+        summary.position = *measurement.position;
+    }
+    if (measurement.velocity)
+    {
+        summary.fields |= kSummaryVelocity;
+        summary.velocity = *measurement.velocity;
+    }
+    if (measurement.range)
+    {
+        summary.fields |= kSummaryRange;
+        summary.range = *measurement.range;
+    }
+    if (measurement.altitude)
+    {
+        summary.fields |= kSummaryAltitude;
+        summary.altitude = *measurement.altitude;
+    }
+    if (measurement.heading)
+    {
+        summary.fields |= kSummaryHeading;
+        summary.heading = *measurement.heading;
+    }
+    if (measurement.bearing)
+    {
+        summary.fields |= kSummaryBearing;
+        summary.bearing = *measurement.bearing;
+    }
+    return summary;
+}
+
+bool sameVec(const Vec3 &a, const Vec3 &b)
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+// Raw fields only; positionRange follows from position.
+bool sameMeasurement(const MeasurementSummary &a, const MeasurementSummary &b)
+{
+    if (a.present != b.present || a.time != b.time || a.fields != b.fields)
+    {
+        return false;
+    }
+    return ((a.fields & kSummaryPosition) == 0 || sameVec(a.position, b.position)) &&
+           ((a.fields & kSummaryVelocity) == 0 || sameVec(a.velocity, b.velocity)) &&
+           ((a.fields & kSummaryRange) == 0 || a.range == b.range) &&
+           ((a.fields & kSummaryAltitude) == 0 || a.altitude == b.altitude) &&
+           ((a.fields & kSummaryHeading) == 0 || a.heading == b.heading) &&
+           ((a.fields & kSummaryBearing) == 0 || a.bearing == b.bearing);
+}
+
+std::optional<double> residualBetween(const MeasurementSummary &a, const MeasurementSummary &b, double maxAgeSeconds)
 {
     if (maxAgeSeconds > 0.0)
     {
-        double ageDelta = std::fabs(a.lastMeasurementTime - b.lastMeasurementTime);
+        double ageDelta = std::fabs(a.time - b.time);
         if (ageDelta > maxAgeSeconds)
         {
             return std::nullopt;
         }
     }
-    if (a.hasMeasurement && b.hasMeasurement && a.lastMeasurement.position && b.lastMeasurement.position)
+    if (!a.present || !b.present)
+    {
+        return std::nullopt;
+    }
+    const std::uint8_t both = a.fields & b.fields;
+    if (both & kSummaryPosition)
     {
-        Vec3 delta{
-            a.lastMeasurement.position->x - b.lastMeasurement.position->x,
-            a.lastMeasurement.position->y - b.lastMeasurement.position->y,
-            a.lastMeasurement.position->z - b.lastMeasurement.position->z};
+        Vec3 delta{a.position.x - b.position.x, a.position.y - b.position.y, a.position.z - b.position.z};
         return std::sqrt(delta.x * delta.x + delta.y * delta.y + delta.z * delta.z);
     }
-    if (a.hasMeasurement && b.hasMeasurement && a.lastMeasurement.velocity && b.lastMeasurement.velocity)
+    if (both & kSummaryVelocity)
     {
-        Vec3 delta{
-            a.lastMeasurement.velocity->x - b.lastMeasurement.velocity->x,
-            a.lastMeasurement.velocity->y - b.lastMeasurement.velocity->y,
-            a.lastMeasurement.velocity->z - b.lastMeasurement.velocity->z};
+        Vec3 delta{a.velocity.x - b.velocity.x, a.velocity.y - b.velocity.y, a.velocity.z - b.velocity.z};
         return std::sqrt(delta.x * delta.x + delta.y * delta.y + delta.z * delta.z);
     }
-    if (a.hasMeasurement && b.hasMeasurement && a.lastMeasurement.range && b.lastMeasurement.position)
+    if ((a.fields & kSummaryRange) && (b.fields & kSummaryPosition))
     {
-        double range = std::sqrt(b.lastMeasurement.position->x * b.lastMeasurement.position->x +
-                                 b.lastMeasurement.position->y * b.lastMeasurement.position->y +
-                                 b.lastMeasurement.position->z * b.lastMeasurement.position->z);
-        return std::fabs(*a.lastMeasurement.range - range);
+        return std::fabs(a.range - b.positionRange);
     }
-    if (a.hasMeasurement && b.hasMeasurement && b.lastMeasurement.range && a.lastMeasurement.position)
+    if ((b.fields & kSummaryRange) && (a.fields & kSummaryPosition))
     {
-        double range = std::sqrt(a.lastMeasurement.position->x * a.lastMeasurement.position->x +
-                                 a.lastMeasurement.position->y * a.lastMeasurement.position->y +
-                                 a.lastMeasurement.position->z * a.lastMeasurement.position->z);
-        return std::fabs(*b.lastMeasurement.range - range);
+        return std::fabs(b.range - a.positionRange);
     }
-    if (a.hasMeasurement && b.hasMeasurement && a.lastMeasurement.altitude && b.lastMeasurement.position)
+    if ((a.fields & kSummaryAltitude) && (b.fields & kSummaryPosition))
     {
-        return std::fabs(*a.lastMeasurement.altitude - b.lastMeasurement.position->z);
+        return std::fabs(a.altitude - b.position.z);
     }
-    if (a.hasMeasurement && b.hasMeasurement && b.lastMeasurement.altitude && a.lastMeasurement.position)
+    if ((b.fields & kSummaryAltitude) && (a.fields & kSummaryPosition))
     {
-        return std::fabs(*b.lastMeasurement.altitude - a.lastMeasurement.position->z);
+        return std::fabs(b.altitude - a.position.z);
     }
-    if (a.hasMeasurement && b.hasMeasurement && a.lastMeasurement.heading && b.lastMeasurement.heading)
+    if (both & kSummaryHeading)
     {
-        return std::fabs(normalizeAngle(*a.lastMeasurement.heading - *b.lastMeasurement.heading));
+        return std::fabs(normalizeAngle(a.heading - b.heading));
     }
-    if (a.hasMeasurement && b.hasMeasurement && a.lastMeasurement.bearing && b.lastMeasurement.bearing)
+    if (both & kSummaryBearing)
     {
-        return std::fabs(normalizeAngle(*a.lastMeasurement.bearing - *b.lastMeasurement.bearing));
+        return std::fabs(normalizeAngle(a.bearing - b.bearing));
     }
     return std::nullopt;
 }
@@ -94,17 +165,17 @@ bool isAllowedProvenance(const ModeManagerConfig &config, ProvenanceTag tag)
     return false;
 }
 
-bool alignedInTime(const SensorStatus &a, const SensorStatus &b, double maxAgeSeconds)
+bool alignedInTime(const MeasurementSummary &a, const MeasurementSummary &b, double maxAgeSeconds)
 {
     if (maxAgeSeconds <= 0.0)
     {
         return true;
     }
-    if (!a.hasMeasurement || !b.hasMeasurement)
+    if (!a.present || !b.present)
     {
         return false;
     }
-    double ageDelta = std::fabs(a.lastMeasurementTime - b.lastMeasurementTime);
+    double ageDelta = std::fabs(a.time - b.time);
     return ageDelta <= maxAgeSeconds;
 }
 
@@ -196,7 +267,7 @@ std::vector<std::string> requiredSensorsForMode(const std::string &modeName)
     return {};
 }
 
-bool modeAuthorized(const ModeManagerConfig &config, const std::string &modeName, std::string &reason)
+bool modeAuthorized(const ModeManagerConfig &config, const std::string &modeName, const char *&reason)
 {
     if (!config.authorizationRequired)
     {
@@ -287,49 +358,82 @@ TrackingMode modeFromName(const std::string &modeName)
     return TrackingMode::Hold;
 }
 
-ModeDecisionDetail buildDecisionDetail(const std::string &modeName,
-                                      const std::string &reason,
-                                      const std::vector<SensorBase *> &sensors)
+constexpr std::size_t kTrackingModeCount = static_cast<std::size_t>(TrackingMode::Hold) + 1;
+
+const char *modeLiteral(TrackingMode mode)
 {
-    ModeDecisionDetail detail;
-    detail.selectedMode = modeName;
-    detail.reason = reason;
-    detail.contributors = requiredSensorsForMode(modeName);
-    double confidence = 1.0;
-    for (const auto &sensorName : detail.contributors)
+    switch (mode)
     {
-        double bestConfidence = 0.0;
-        for (auto *sensor : sensors)
-        {
-            if (sensor && sensor->getName() == sensorName)
-            {
-                bestConfidence = std::max(bestConfidence, sensor->getStatus().confidence);
-            }
-        }
-        confidence = std::min(confidence, bestConfidence);
+    case TrackingMode::GpsIns:
+        return "gps_ins";
+    case TrackingMode::Gps:
+        return "gps";
+    case TrackingMode::Vio:
+        return "vio";
+    case TrackingMode::Lio:
+        return "lio";
+    case TrackingMode::RadarInertial:
+        return "radar_inertial";
+    case TrackingMode::Thermal:
+        return "thermal";
+    case TrackingMode::Radar:
+        return "radar";
+    case TrackingMode::Vision:
+        return "vision";
+    case TrackingMode::Lidar:
+        return "lidar";
+    case TrackingMode::MagBaro:
+        return "mag_baro";
+    case TrackingMode::Magnetometer:
+        return "magnetometer";
+    case TrackingMode::Baro:
+        return "baro";
+    case TrackingMode::Celestial:
+        return "celestial";
+    case TrackingMode::DeadReckoning:
+        return "dead_reckoning";
+    case TrackingMode::Inertial:
+        return "imu";
+    case TrackingMode::Hold:
+        return "hold";
+    default:
+        return "unknown";
     }
-    if (detail.contributors.empty())
+}
+
+constexpr std::size_t kDetailStringCapacity = 32;
+
+// Parks surplus elements in `spare` instead of destroying them, so their string buffers are
+// reused the next time the list grows.
+template <typename T>
+void resizeRetaining(std::vector<T> &items, std::vector<T> &spare, std::size_t count)
+{
+    while (items.size() > count)
+    {
+        spare.push_back(std::move(items.back()));
+        items.pop_back();
+    }
+    while (items.size() < count)
     {
-        confidence = 0.0;
+        if (spare.empty())
+        {
+            items.emplace_back();
+            continue;
+        }
+        items.push_back(std::move(spare.back()));
+        spare.pop_back();
     }
-    detail.confidence = confidence;
-    return detail;
 }
 
-void setLockout(std::unordered_map<std::string, int> &remaining,
-                std::unordered_map<std::string, std::string> &reasons,
-                const std::string &name,
-                int steps,
-                const std::string &reason)
+void updateStreak(int &count, int flag)
 {
-    if (steps <= 0)
+    if (flag == 1)
     {
-        return;
+        count += 1;
     }
-    remaining[name] = steps;
-    if (reasons.find(name) == reasons.end())
+    else
     {
-        reasons[name] = reason;
+        count = 0;
     }
 }
 } // namespace
@@ -337,353 +441,455 @@ void setLockout(std::unordered_map<std::string, int> &remaining,
 ModeManager::ModeManager(ModeManagerConfig config)
     : config(config)
 {
+    modeRequired.resize(kTrackingModeCount);
+    for (std::size_t idx = 0; idx < kTrackingModeCount; ++idx)
+    {
+        for (const auto &sensorName : requiredSensorsForMode(modeLiteral(static_cast<TrackingMode>(idx))))
+        {
+            modeRequired[idx].push_back(internSensor(sensorName));
+        }
+    }
+    celestialId = internSensor("celestial");
+
+    ladder.reserve(this->config.ladderOrder.size());
+    for (const auto &name : this->config.ladderOrder)
+    {
+        LadderRung rung;
+        rung.name = name;
+        rung.hold = name == "hold";
+        rung.mode = modeFromName(name);
+        for (const auto &sensorName : requiredSensorsForMode(name))
+        {
+            const int sensorId = internSensor(sensorName);
+            rung.required.push_back(sensorId);
+            // Built-in sensors are interned first, so every required ID fits in the mask.
+            rung.requiredMask |= std::uint64_t{1} << sensorId;
+        }
+        ladderSensorMask |= rung.requiredMask;
+        for (std::size_t i = 0; i < rung.required.size(); ++i)
+        {
+            for (std::size_t j = i + 1; j < rung.required.size(); ++j)
+            {
+                rung.residualPairs.push_back(internResidualPair(rung.required[i], rung.required[j]));
+            }
+        }
+        if (!rung.hold && !modeAuthorized(this->config, name, rung.authReason))
+        {
+            rung.authDenied = std::strcmp(rung.authReason, "auth_denied") == 0;
+        }
+        maxDisqualified += std::max<std::size_t>(1, rung.required.size());
+        ladder.push_back(std::move(rung));
+    }
+    disqualified.reserve(maxDisqualified);
+    reserveDetailCapacity();
 }
 
-ModeDecision ModeManager::decide(const std::vector<SensorBase *> &sensors)
+std::size_t ModeManager::internResidualPair(int first, int second)
 {
-    for (auto &entry : lockoutRemaining)
+    for (std::size_t index = 0; index < residualPairs.size(); ++index)
     {
-        if (entry.second > 0)
+        const ResidualPair &pair = residualPairs[index];
+        if ((pair.first == first && pair.second == second) || (pair.first == second && pair.second == first))
         {
-            entry.second -= 1;
+            return index;
         }
     }
+    ResidualPair pair;
+    pair.first = first;
+    pair.second = second;
+    residualPairs.push_back(pair);
+    return residualPairs.size() - 1;
+}
+
+void ModeManager::refreshSummary(SensorTrack &track)
+{
+    if (track.summaryChecked)
+    {
+        return;
+    }
+    track.summaryChecked = true;
+    MeasurementSummary summary = summarize(track.status);
+    if (sameMeasurement(summary, track.summary))
+    {
+        return;
+    }
+    if (summary.fields & kSummaryPosition)
+    {
+        summary.positionRange = std::sqrt(summary.position.x * summary.position.x +
+                                          summary.position.y * summary.position.y +
+                                          summary.position.z * summary.position.z);
+    }
+    track.summary = summary;
+    track.summaryVersion += 1;
+}
+
+const ModeManager::ResidualPair &ModeManager::residualPair(std::size_t index)
+{
+    ResidualPair &pair = residualPairs[index];
+    SensorTrack &trackA = tracks[static_cast<std::size_t>(pair.first)];
+    SensorTrack &trackB = tracks[static_cast<std::size_t>(pair.second)];
+    refreshSummary(trackA);
+    refreshSummary(trackB);
+    if (pair.firstVersion == trackA.summaryVersion && pair.secondVersion == trackB.summaryVersion)
+    {
+        return pair;
+    }
+    pair.aligned = alignedInTime(trackA.summary, trackB.summary, config.maxResidualAgeSeconds);
+    std::optional<double> residual = residualBetween(trackA.summary, trackB.summary, config.maxResidualAgeSeconds);
+    pair.hasResidual = residual.has_value();
+    pair.residual = residual.value_or(0.0);
+    pair.firstVersion = trackA.summaryVersion;
+    pair.secondVersion = trackB.summaryVersion;
+    residualUpdates += 1;
+    return pair;
+}
+
+std::uint64_t ModeManager::residualUpdateCount() const
+{
+    return residualUpdates;
+}
+
+void ModeManager::reserveDetailCapacity()
+{
+    // Pre-size every detail list for its worst case so later decisions never grow them.
+    std::vector<ModeDecisionDetail::DisqualifiedSource> &sources = lastDecisionDetail.disqualifiedSources;
+    sources.reserve(maxDisqualified);
+    disqualifiedSpare.reserve(maxDisqualified);
+    while (sources.size() + disqualifiedSpare.size() < maxDisqualified)
+    {
+        ModeDecisionDetail::DisqualifiedSource entry;
+        entry.mode.reserve(kDetailStringCapacity);
+        entry.source.reserve(kDetailStringCapacity);
+        entry.reason.reserve(kDetailStringCapacity);
+        disqualifiedSpare.push_back(std::move(entry));
+    }
 
-    auto permitted = [&](const std::string &name) -> bool
+    std::vector<ModeDecisionDetail::LockoutState> &lockouts = lastDecisionDetail.lockouts;
+    lockouts.reserve(tracks.size());
+    lockoutSpare.reserve(tracks.size());
+    while (lockouts.size() + lockoutSpare.size() < tracks.size())
+    {
+        ModeDecisionDetail::LockoutState entry;
+        entry.source.reserve(kDetailStringCapacity);
+        entry.reason.reserve(kDetailStringCapacity);
+        lockoutSpare.push_back(std::move(entry));
+    }
+    lastDecisionDetail.contributors.reserve(2);
+    lastDecisionDetail.selectedMode.reserve(kDetailStringCapacity);
+    lastDecisionDetail.reason.reserve(kDetailStringCapacity);
+    lastDecisionDetail.downgradeReason.reserve(kDetailStringCapacity);
+    lastDecision.reason.reserve(kDetailStringCapacity);
+}
+
+int ModeManager::internSensor(const std::string &name)
+{
+    auto it = sensorIds.find(name);
+    if (it != sensorIds.end())
     {
-        if (config.permittedSensors.empty())
+        return it->second;
+    }
+    const int id = static_cast<int>(sensorNames.size());
+    sensorIds.emplace(name, id);
+    sensorNames.push_back(name);
+    SensorTrack track;
+    if (!config.permittedSensors.empty())
+    {
+        track.permitted = std::find(config.permittedSensors.begin(), config.permittedSensors.end(), name) !=
+                          config.permittedSensors.end();
+    }
+    tracks.push_back(track);
+    return id;
+}
+
+void ModeManager::bindSensors(const std::vector<SensorBase *> &sensors)
+{
+    bool same = boundSensors.size() == sensors.size();
+    for (std::size_t idx = 0; same && idx < sensors.size(); ++idx)
+    {
+        same = boundSensors[idx] == sensors[idx];
+    }
+    if (same)
+    {
+        return;
+    }
+    boundSensors.assign(sensors.begin(), sensors.end());
+    boundIds.assign(sensors.size(), -1);
+    for (std::size_t idx = 0; idx < sensors.size(); ++idx)
+    {
+        if (sensors[idx])
         {
-            return true;
+            boundIds[idx] = internSensor(sensors[idx]->getName());
         }
-        for (const auto &allowed : config.permittedSensors)
+    }
+    reserveDetailCapacity();
+}
+
+void ModeManager::setLockout(SensorTrack &track, const char *reason)
+{
+    if (config.lockoutSteps <= 0)
+    {
+        return;
+    }
+    track.lockoutRemaining = config.lockoutSteps;
+    if (track.lockoutReason == nullptr)
+    {
+        track.lockoutReason = reason;
+    }
+}
+
+const char *ModeManager::ineligibleReason(int sensorId) const
+{
+    if (config.allowedProvenances.empty())
+    {
+        return "provenance_unconfigured";
+    }
+    if (sensorId == celestialId && !config.celestialDatasetAvailable)
+    {
+        return "dataset_unavailable";
+    }
+    if (sensorId == celestialId && !config.celestialAllowed)
+    {
+        return "celestial_disallowed";
+    }
+    const SensorTrack &track = tracks[static_cast<std::size_t>(sensorId)];
+    if (!track.permitted)
+    {
+        return "not_permitted";
+    }
+    if (track.lockoutRemaining > 0)
+    {
+        return "lockout";
+    }
+    if (!track.seen)
+    {
+        return "missing";
+    }
+    const SensorStatus &status = *track.status;
+    if (!status.hasMeasurement)
+    {
+        return "no_measurement";
+    }
+    ProvenanceTag tag = status.lastMeasurement.provenance;
+    if (tag == ProvenanceTag::Unknown)
+    {
+        return (config.provenanceUnknownAction == UnknownProvenanceAction::Hold)
+                   ? "provenance_unknown_hold"
+                   : "provenance_unknown";
+    }
+    if (!isAllowedProvenance(config, tag))
+    {
+        return "provenance_denied";
+    }
+    if (status.timeSinceLastValid > config.maxDataAgeSeconds)
+    {
+        return "stale";
+    }
+    if (status.confidence < config.minConfidence)
+    {
+        return "low_confidence";
+    }
+    if (track.healthyCount < config.minHealthyCount)
+    {
+        return "unhealthy_count";
+    }
+    return nullptr;
+}
+
+const CompactModeDecision &ModeManager::decideCompact(const std::vector<SensorBase *> &sensors)
+{
+    bindSensors(sensors);
+
+    for (auto &track : tracks)
+    {
+        if (track.lockoutRemaining > 0)
         {
-            if (allowed == name)
-            {
-                return true;
-            }
+            track.lockoutRemaining -= 1;
         }
-        return false;
-    };
+        track.seen = false;
+        track.healthyNow = false;
+        track.conflict = false;
+        track.summaryChecked = false;
+        track.bestConfidence = 0.0;
+        track.status = nullptr;
+    }
 
-    std::unordered_map<std::string, bool> healthyNow;
-    std::unordered_map<std::string, SensorStatus> statusByName;
-    for (auto *sensor : sensors)
+    for (std::size_t idx = 0; idx < sensors.size(); ++idx)
     {
+        const SensorBase *sensor = sensors[idx];
         if (!sensor)
         {
             continue;
         }
-        const std::string &name = sensor->getName();
-        bool &seenHealthy = healthyNow[name];
+        SensorTrack &track = tracks[static_cast<std::size_t>(boundIds[idx])];
         const SensorStatus &status = sensor->getStatus();
-        seenHealthy = seenHealthy || status.healthy;
-        auto it = statusByName.find(name);
-        if (it == statusByName.end())
+        track.healthyNow = track.healthyNow || status.healthy;
+        track.bestConfidence = std::max(track.bestConfidence, status.confidence);
+        if (!track.seen)
         {
-            statusByName[name] = status;
+            track.seen = true;
+            track.status = &status;
         }
-        else
+        else if (status.timeSinceLastValid < track.status->timeSinceLastValid)
         {
-            SensorStatus &current = it->second;
-            if (status.timeSinceLastValid < current.timeSinceLastValid)
-            {
-                current = status;
-            }
-            else if (status.timeSinceLastValid == current.timeSinceLastValid &&
-                     status.confidence > current.confidence)
-            {
-                current = status;
-            }
+            track.status = &status;
+        }
+        else if (status.timeSinceLastValid == track.status->timeSinceLastValid &&
+                 status.confidence > track.status->confidence)
+        {
+            track.status = &status;
         }
 
         int staleFlag = (status.timeSinceLastValid > config.maxDataAgeSeconds) ? 1 : 0;
         if (config.historyWindow > 0)
         {
-            pushHistory(staleHistory[name], staleFlag, config.historyWindow);
+            pushHistory(track.staleHistory, staleFlag, config.historyWindow);
         }
         else if (config.maxStaleCount > 0)
         {
-            int &count = staleCounts[name];
-            if (staleFlag == 1)
-            {
-                count += 1;
-            }
-            else
-            {
-                count = 0;
-            }
+            updateStreak(track.staleCount, staleFlag);
         }
 
         int lowConfidenceFlag = (status.confidence < config.minConfidence) ? 1 : 0;
         if (config.historyWindow > 0)
         {
-            pushHistory(lowConfidenceHistory[name], lowConfidenceFlag, config.historyWindow);
+            pushHistory(track.lowConfidenceHistory, lowConfidenceFlag, config.historyWindow);
         }
         else if (config.maxLowConfidenceCount > 0)
         {
-            int &count = lowConfidenceCounts[name];
-            if (lowConfidenceFlag == 1)
-            {
-                count += 1;
-            }
-            else
-            {
-                count = 0;
-            }
+            updateStreak(track.lowConfidenceCount, lowConfidenceFlag);
         }
     }
 
-    for (const auto &entry : healthyNow)
-    {
-        int &count = healthyCounts[entry.first];
-        count = entry.second ? (count + 1) : 0;
-    }
-    for (auto &entry : healthyCounts)
+    for (auto &track : tracks)
     {
-        if (healthyNow.find(entry.first) == healthyNow.end())
-        {
-            entry.second = 0;
-        }
+        track.healthyCount = (track.seen && track.healthyNow) ? (track.healthyCount + 1) : 0;
     }
 
     if (config.lockoutSteps > 0)
     {
-        for (const auto &entry : statusByName)
+        for (auto &track : tracks)
         {
-            const std::string &name = entry.first;
+            if (!track.seen)
+            {
+                continue;
+            }
             if (config.maxStaleCount > 0)
             {
-                int staleCount = 0;
-                if (config.historyWindow > 0)
-                {
-                    staleCount = staleHistory[name].sum;
-                }
-                else
-                {
-                    staleCount = staleCounts[name];
-                }
+                int staleCount = (config.historyWindow > 0) ? track.staleHistory.sum : track.staleCount;
                 if (staleCount >= config.maxStaleCount)
                 {
-                    setLockout(lockoutRemaining, lockoutReasons, name, config.lockoutSteps, "stale");
+                    setLockout(track, "stale");
                 }
             }
             if (config.maxLowConfidenceCount > 0)
             {
-                int lowCount = 0;
-                if (config.historyWindow > 0)
-                {
-                    lowCount = lowConfidenceHistory[name].sum;
-                }
-                else
-                {
-                    lowCount = lowConfidenceCounts[name];
-                }
+                int lowCount = (config.historyWindow > 0) ? track.lowConfidenceHistory.sum : track.lowConfidenceCount;
                 if (lowCount >= config.maxLowConfidenceCount)
                 {
-                    setLockout(lockoutRemaining, lockoutReasons, name, config.lockoutSteps, "low_confidence");
+                    setLockout(track, "low_confidence");
                 }
             }
         }
     }
 
-    auto eligibleSensor = [&](const std::string &name, std::string &reason) -> bool
+    // Evaluate each ladder sensor once per step; rungs then reduce to mask tests.
+    std::uint64_t eligibleMask = 0;
+    for (std::uint64_t pending = ladderSensorMask; pending != 0; pending &= pending - 1)
     {
-        if (config.allowedProvenances.empty())
-        {
-            reason = "provenance_unconfigured";
-            return false;
-        }
-        if (name == "celestial" && !config.celestialDatasetAvailable)
-        {
-            reason = "dataset_unavailable";
-            return false;
-        }
-        if (name == "celestial" && !config.celestialAllowed)
-        {
-            reason = "celestial_disallowed";
-            return false;
-        }
-        if (!permitted(name))
+        int sensorId = 0;
+        while (((pending >> sensorId) & 1U) == 0)
         {
-            reason = "not_permitted";
-            return false;
+            ++sensorId;
         }
-        auto lockoutIt = lockoutRemaining.find(name);
-        if (lockoutIt != lockoutRemaining.end() && lockoutIt->second > 0)
+        SensorTrack &track = tracks[static_cast<std::size_t>(sensorId)];
+        track.ineligible = ineligibleReason(sensorId);
+        if (track.ineligible == nullptr)
         {
-            reason = "lockout";
-            return false;
+            eligibleMask |= std::uint64_t{1} << sensorId;
         }
-        auto statusIt = statusByName.find(name);
-        if (statusIt == statusByName.end())
-        {
-            reason = "missing";
-            return false;
-        }
-        const SensorStatus &status = statusIt->second;
-        if (!status.hasMeasurement)
-        {
-            reason = "no_measurement";
-            return false;
-        }
-        ProvenanceTag tag = status.lastMeasurement.provenance;
-        if (tag == ProvenanceTag::Unknown)
-        {
-            reason = (config.provenanceUnknownAction == UnknownProvenanceAction::Hold)
-                         ? "provenance_unknown_hold"
-                         : "provenance_unknown";
-            return false;
-        }
-        if (!isAllowedProvenance(config, tag))
-        {
-            reason = "provenance_denied";
-            return false;
-        }
-        if (status.timeSinceLastValid > config.maxDataAgeSeconds)
-        {
-            reason = "stale";
-            return false;
-        }
-        if (status.confidence < config.minConfidence)
-        {
-            reason = "low_confidence";
-            return false;
-        }
-        auto it = healthyCounts.find(name);
-        if (it == healthyCounts.end())
-        {
-            reason = "unhealthy_count";
-            return false;
-        }
-        if (it->second < config.minHealthyCount)
-        {
-            reason = "unhealthy_count";
-            return false;
-        }
-        reason.clear();
-        return true;
-    };
+    }
 
     TrackingMode desiredMode = TrackingMode::Hold;
-    std::string desiredReason = "no_modes";
-    std::string denialReason;
+    const char *denialReason = nullptr;
     bool authDenied = false;
     bool invalidLadder = false;
-    std::unordered_map<std::string, bool> conflictNow;
-    const std::vector<std::string> &ladder = config.ladderOrder;
-    std::vector<ModeDecisionDetail::DisqualifiedSource> disqualifiedSources;
-    for (const auto &modeName : ladder)
+    disqualified.clear();
+    for (std::size_t rungIndex = 0; rungIndex < ladder.size(); ++rungIndex)
     {
-        if (modeName == "hold")
+        const LadderRung &rung = ladder[rungIndex];
+        if (rung.hold)
         {
             continue;
         }
-        std::string authReason;
-        if (!modeAuthorized(config, modeName, authReason))
+        if (rung.authReason != nullptr)
         {
-            disqualifiedSources.push_back({modeName, "authorization", authReason});
-            denialReason = authReason;
-            if (authReason == "auth_denied")
-            {
-                authDenied = true;
-            }
+            disqualified.push_back({rungIndex, -1, "authorization", rung.authReason});
+            denialReason = rung.authReason;
+            authDenied = authDenied || rung.authDenied;
             continue;
         }
-        std::vector<std::string> required = requiredSensorsForMode(modeName);
+        const std::vector<int> &required = rung.required;
         if (required.empty())
         {
             denialReason = "invalid_mode";
-            disqualifiedSources.push_back({modeName, "mode", "invalid_mode"});
+            disqualified.push_back({rungIndex, -1, "mode", "invalid_mode"});
             invalidLadder = true;
             break;
         }
-        bool eligible = true;
-        for (const auto &sensorName : required)
+        if ((rung.requiredMask & ~eligibleMask) != 0)
         {
-            std::string reason;
-            if (!eligibleSensor(sensorName, reason))
+            // Report the first ineligible sensor in ladder order, as the detail always has.
+            for (int sensorId : required)
             {
-                disqualifiedSources.push_back({modeName, sensorName, reason});
-                if (denialReason.empty() && reason.rfind("provenance_", 0) == 0)
+                const char *reason = tracks[static_cast<std::size_t>(sensorId)].ineligible;
+                if (reason != nullptr)
                 {
-                    denialReason = reason;
+                    disqualified.push_back({rungIndex, sensorId, nullptr, reason});
+                    if (denialReason == nullptr && std::strncmp(reason, "provenance_", 11) == 0)
+                    {
+                        denialReason = reason;
+                    }
+                    break;
                 }
-                eligible = false;
-                break;
             }
-        }
-        if (!eligible)
-        {
             continue;
         }
         if (config.disagreementThreshold > 0.0 && required.size() > 1)
         {
             bool conflict = false;
             bool unaligned = false;
-            for (size_t i = 0; i < required.size(); ++i)
+            for (std::size_t pairIndex : rung.residualPairs)
             {
-                auto itA = statusByName.find(required[i]);
-                if (itA == statusByName.end())
+                const ResidualPair &pair = residualPair(pairIndex);
+                if (!pair.aligned)
                 {
+                    unaligned = true;
                     continue;
                 }
-                for (size_t j = i + 1; j < required.size(); ++j)
+                if (pair.hasResidual && pair.residual > config.disagreementThreshold)
                 {
-                    auto itB = statusByName.find(required[j]);
-                    if (itB == statusByName.end())
-                    {
-                        continue;
-                    }
-                    if (!alignedInTime(itA->second, itB->second, config.maxResidualAgeSeconds))
-                    {
-                        unaligned = true;
-                        continue;
-                    }
-                    std::optional<double> residual = residualBetween(itA->second, itB->second, config.maxResidualAgeSeconds);
-                    if (residual && *residual > config.disagreementThreshold)
-                    {
-                        conflict = true;
-                        conflictNow[required[i]] = true;
-                        conflictNow[required[j]] = true;
-                    }
+                    conflict = true;
+                    tracks[static_cast<std::size_t>(pair.first)].conflict = true;
+                    tracks[static_cast<std::size_t>(pair.second)].conflict = true;
                 }
             }
-            if (conflict)
+            if (conflict || unaligned)
             {
-                denialReason = "residual_conflict";
-                for (const auto &sensorName : required)
+                denialReason = conflict ? "residual_conflict" : "residual_unaligned";
+                for (int sensorId : required)
                 {
-                    disqualifiedSources.push_back({modeName, sensorName, "residual_conflict"});
-                }
-                continue;
-            }
-            if (unaligned)
-            {
-                denialReason = "residual_unaligned";
-                for (const auto &sensorName : required)
-                {
-                    disqualifiedSources.push_back({modeName, sensorName, "residual_unaligned"});
+                    disqualified.push_back({rungIndex, sensorId, nullptr, denialReason});
                 }
                 continue;
             }
         }
         if (!config.provenanceAllowMixed && required.size() > 1)
         {
-            std::optional<ProvenanceTag> firstTag;
+            const ProvenanceTag firstTag = tracks[static_cast<std::size_t>(required.front())].status->lastMeasurement.provenance;
             bool mixed = false;
-            for (const auto &sensorName : required)
+            for (int sensorId : required)
             {
-                auto it = statusByName.find(sensorName);
-                if (it == statusByName.end())
-                {
-                    continue;
-                }
-                ProvenanceTag tag = it->second.lastMeasurement.provenance;
-                if (!firstTag.has_value())
-                {
-                    firstTag = tag;
-                }
-                else if (firstTag.value() != tag)
+                if (tracks[static_cast<std::size_t>(sensorId)].status->lastMeasurement.provenance != firstTag)
                 {
                     mixed = true;
                     break;
@@ -692,242 +898,244 @@ ModeDecision ModeManager::decide(const std::vector<SensorBase *> &sensors)
             if (mixed)
             {
                 denialReason = "provenance_mixed";
-                for (const auto &sensorName : required)
+                for (int sensorId : required)
                 {
-                    disqualifiedSources.push_back({modeName, sensorName, "provenance_mixed"});
+                    disqualified.push_back({rungIndex, sensorId, nullptr, "provenance_mixed"});
                 }
                 continue;
             }
         }
-        desiredMode = modeFromName(modeName);
-        desiredReason = modeName + "_eligible";
+        desiredMode = rung.mode;
         break;
     }
 
     if (config.maxDisagreementCount > 0)
     {
-        for (const auto &entry : statusByName)
+        for (auto &track : tracks)
         {
-            const std::string &name = entry.first;
-            int conflictFlag = conflictNow[name] ? 1 : 0;
-            if (config.historyWindow > 0)
-            {
-                pushHistory(disagreementHistory[name], conflictFlag, config.historyWindow);
-            }
-            else
+            if (!track.seen)
             {
-                int &count = disagreementCounts[name];
-                if (conflictFlag == 1)
-                {
-                    count += 1;
-                }
-                else
-                {
-                    count = 0;
-                }
+                continue;
             }
+            int conflictFlag = track.conflict ? 1 : 0;
             int countValue = 0;
             if (config.historyWindow > 0)
             {
-                countValue = disagreementHistory[name].sum;
+                pushHistory(track.disagreementHistory, conflictFlag, config.historyWindow);
+                countValue = track.disagreementHistory.sum;
             }
             else
             {
-                countValue = disagreementCounts[name];
+                updateStreak(track.disagreementCount, conflictFlag);
+                countValue = track.disagreementCount;
             }
             if (config.lockoutSteps > 0 && countValue >= config.maxDisagreementCount)
             {
-                setLockout(lockoutRemaining, lockoutReasons, name, config.lockoutSteps, "disagreement");
+                setLockout(track, "disagreement");
             }
         }
     }
 
-    auto finalizeDetail = [&](ModeDecisionDetail &detail)
-    {
-        detail.disqualifiedSources = disqualifiedSources;
-        detail.lockouts.clear();
-        for (const auto &entry : lockoutRemaining)
-        {
-            if (entry.second > 0)
-            {
-                ModeDecisionDetail::LockoutState lockout;
-                lockout.source = entry.first;
-                lockout.remainingSteps = entry.second;
-                auto reasonIt = lockoutReasons.find(entry.first);
-                if (reasonIt != lockoutReasons.end())
-                {
-                    lockout.reason = reasonIt->second;
-                }
-                detail.lockouts.push_back(lockout);
-            }
-        }
-    };
-
+    CompactModeDecision decision{};
     if (invalidLadder)
     {
         currentMode = TrackingMode::Hold;
         dwellSteps = 0;
-        ModeDecision decision{TrackingMode::Hold, "invalid_ladder"};
-        lastDecisionDetail = buildDecisionDetail("hold", decision.reason, sensors);
-        lastDecisionDetail.downgradeReason = "invalid_ladder";
-        finalizeDetail(lastDecisionDetail);
-        return decision;
+        decision.reason = DecisionReason::InvalidLadder;
+        denialReason = "invalid_ladder";
     }
-
-    if (desiredMode == TrackingMode::Hold)
+    else if (desiredMode == TrackingMode::Hold)
     {
         currentMode = TrackingMode::Hold;
         dwellSteps = 0;
-        std::string finalReason = "no_sensors";
+        decision.reason = DecisionReason::NoSensors;
         if (config.authorizationRequired && !config.authorizationVerified)
         {
-            finalReason = "auth_unavailable";
+            decision.reason = DecisionReason::AuthUnavailable;
         }
         else if (authDenied)
         {
-            finalReason = "auth_denied";
-        }
-        ModeDecision decision{TrackingMode::Hold, finalReason};
-        lastDecisionDetail = buildDecisionDetail("hold", decision.reason, sensors);
-        if (!denialReason.empty())
-        {
-            lastDecisionDetail.downgradeReason = denialReason;
+            decision.reason = DecisionReason::AuthDenied;
         }
-        finalizeDetail(lastDecisionDetail);
-        return decision;
     }
-
-    if (currentMode == TrackingMode::Hold)
+    else if (currentMode == TrackingMode::Hold)
     {
         currentMode = desiredMode;
         dwellSteps = 0;
-        ModeDecision decision{currentMode, "enter_" + modeName(currentMode)};
-        lastDecisionDetail = buildDecisionDetail(modeName(currentMode), decision.reason, sensors);
-        if (!denialReason.empty())
-        {
-            lastDecisionDetail.downgradeReason = denialReason;
-        }
-        finalizeDetail(lastDecisionDetail);
-        return decision;
+        decision.reason = DecisionReason::Enter;
     }
-
-    std::string currentModeName = modeName(currentMode);
-    bool currentEligible = false;
-    std::vector<std::string> required = requiredSensorsForMode(currentModeName);
-    if (!required.empty())
+    else if (currentMode == desiredMode)
     {
-        currentEligible = true;
-        for (const auto &sensorName : required)
+        dwellSteps += 1;
+        decision.reason = DecisionReason::Maintain;
+    }
+    else
+    {
+        const std::vector<int> &required = modeRequired[static_cast<std::size_t>(currentMode)];
+        bool currentEligible = !required.empty();
+        for (int sensorId : required)
         {
-            std::string reason;
-            if (!eligibleSensor(sensorName, reason))
+            if (ineligibleReason(sensorId) != nullptr)
             {
                 currentEligible = false;
                 break;
             }
         }
+        if (!currentEligible)
+        {
+            currentMode = desiredMode;
+            dwellSteps = 0;
+            decision.reason = DecisionReason::SwitchUnhealthy;
+        }
+        else if (dwellSteps < config.minDwellSteps)
+        {
+            dwellSteps += 1;
+            decision.reason = DecisionReason::Dwell;
+        }
+        else
+        {
+            currentMode = desiredMode;
+            dwellSteps = 0;
+            decision.reason = DecisionReason::Switch;
+        }
     }
 
-    if (currentMode == desiredMode)
+    decision.mode = currentMode;
+    const std::vector<int> &contributors = modeRequired[static_cast<std::size_t>(currentMode)];
+    decision.confidence = contributors.empty() ? 0.0 : 1.0;
+    for (int sensorId : contributors)
+    {
+        decision.contributorMask |= std::uint64_t{1} << sensorId;
+        decision.confidence = std::min(decision.confidence, tracks[static_cast<std::size_t>(sensorId)].bestConfidence);
+    }
+    decision.changed = !hasDecided || decision.mode != lastCompact.mode || decision.reason != lastCompact.reason;
+    hasDecided = true;
+    lastCompact = decision;
+    lastDowngradeReason = denialReason;
+    detailStale = true;
+    return lastCompact;
+}
+
+const ModeDecision &ModeManager::decide(const std::vector<SensorBase *> &sensors)
+{
+    const CompactModeDecision &decision = decideCompact(sensors);
+    lastDecision.mode = decision.mode;
+    writeDecisionReason(decision, lastDecision.reason);
+    return lastDecision;
+}
+
+void ModeManager::writeDecisionReason(const CompactModeDecision &decision, std::string &out)
+{
+    out.assign(decisionReasonName(decision.reason));
+    if (decision.reason <= DecisionReason::SwitchUnhealthy)
     {
-        dwellSteps += 1;
-        ModeDecision decision{currentMode, "maintain_" + modeName(currentMode)};
-        lastDecisionDetail = buildDecisionDetail(modeName(currentMode), decision.reason, sensors);
-        if (!denialReason.empty())
-        {
-            lastDecisionDetail.downgradeReason = denialReason;
-        }
-        finalizeDetail(lastDecisionDetail);
-        return decision;
+        out.append(modeLiteral(decision.mode));
     }
+}
+
+void ModeManager::publishDetail() const
+{
+    // Strings and vectors are overwritten in place so their capacity carries across decisions.
+    ModeDecisionDetail &detail = lastDecisionDetail;
+    detail.selectedMode.assign(modeLiteral(lastCompact.mode));
+    writeDecisionReason(lastCompact, detail.reason);
+    detail.downgradeReason.assign(lastDowngradeReason != nullptr ? lastDowngradeReason : "");
+    detail.confidence = lastCompact.confidence;
 
-    if (!currentEligible)
+    const std::vector<int> &contributors = modeRequired[static_cast<std::size_t>(lastCompact.mode)];
+    detail.contributors.resize(contributors.size());
+    for (std::size_t idx = 0; idx < contributors.size(); ++idx)
     {
-        currentMode = desiredMode;
-        dwellSteps = 0;
-        ModeDecision decision{currentMode, "switch_unhealthy_" + modeName(currentMode)};
-        lastDecisionDetail = buildDecisionDetail(modeName(currentMode), decision.reason, sensors);
-        if (!denialReason.empty())
-        {
-            lastDecisionDetail.downgradeReason = denialReason;
-        }
-        finalizeDetail(lastDecisionDetail);
-        return decision;
+        detail.contributors[idx].assign(sensorNames[static_cast<std::size_t>(contributors[idx])]);
     }
 
-    if (dwellSteps < config.minDwellSteps)
+    resizeRetaining(detail.disqualifiedSources, disqualifiedSpare, disqualified.size());
+    for (std::size_t idx = 0; idx < disqualified.size(); ++idx)
     {
-        dwellSteps += 1;
-        ModeDecision decision{currentMode, "dwell_" + modeName(currentMode)};
-        lastDecisionDetail = buildDecisionDetail(modeName(currentMode), decision.reason, sensors);
-        if (!denialReason.empty())
+        const DisqualifiedRecord &record = disqualified[idx];
+        ModeDecisionDetail::DisqualifiedSource &entry = detail.disqualifiedSources[idx];
+        entry.mode.assign(ladder[record.rung].name);
+        if (record.sensor >= 0)
+        {
+            entry.source.assign(sensorNames[static_cast<std::size_t>(record.sensor)]);
+        }
+        else
         {
-            lastDecisionDetail.downgradeReason = denialReason;
+            entry.source.assign(record.source);
         }
-        finalizeDetail(lastDecisionDetail);
-        return decision;
+        entry.reason.assign(record.reason);
     }
 
-    currentMode = desiredMode;
-    dwellSteps = 0;
-    ModeDecision decision{currentMode, "switch_" + modeName(currentMode)};
-    lastDecisionDetail = buildDecisionDetail(modeName(currentMode), decision.reason, sensors);
-    if (!denialReason.empty())
+    std::size_t lockoutCount = 0;
+    for (const auto &track : tracks)
     {
-        lastDecisionDetail.downgradeReason = denialReason;
+        lockoutCount += track.lockoutRemaining > 0 ? 1 : 0;
+    }
+    resizeRetaining(detail.lockouts, lockoutSpare, lockoutCount);
+    std::size_t slot = 0;
+    for (std::size_t sensorId = 0; sensorId < tracks.size(); ++sensorId)
+    {
+        const SensorTrack &track = tracks[sensorId];
+        if (track.lockoutRemaining <= 0)
+        {
+            continue;
+        }
+        ModeDecisionDetail::LockoutState &lockout = detail.lockouts[slot++];
+        lockout.source.assign(sensorNames[sensorId]);
+        lockout.remainingSteps = track.lockoutRemaining;
+        lockout.reason.assign(track.lockoutReason != nullptr ? track.lockoutReason : "");
     }
-    finalizeDetail(lastDecisionDetail);
-    return decision;
 }
 
 ModeDecisionDetail ModeManager::decideDetailed(const std::vector<SensorBase *> &sensors)
 {
     decide(sensors);
-    return lastDecisionDetail;
+    return getLastDecisionDetail();
 }
 
 const ModeDecisionDetail &ModeManager::getLastDecisionDetail() const
 {
+    if (detailStale)
+    {
+        publishDetail();
+        detailStale = false;
+    }
     return lastDecisionDetail;
 }
 
-std::string ModeManager::modeName(TrackingMode mode)
+const std::string &ModeManager::sensorName(std::size_t sensorId) const
 {
-    switch (mode)
-    {
-    case TrackingMode::GpsIns:
-        return "gps_ins";
-    case TrackingMode::Gps:
-        return "gps";
-    case TrackingMode::Vio:
-        return "vio";
-    case TrackingMode::Lio:
-        return "lio";
-    case TrackingMode::RadarInertial:
-        return "radar_inertial";
-    case TrackingMode::Thermal:
-        return "thermal";
-    case TrackingMode::Radar:
-        return "radar";
-    case TrackingMode::Vision:
-        return "vision";
-    case TrackingMode::Lidar:
-        return "lidar";
-    case TrackingMode::MagBaro:
-        return "mag_baro";
-    case TrackingMode::Magnetometer:
-        return "magnetometer";
-    case TrackingMode::Baro:
-        return "baro";
-    case TrackingMode::Celestial:
-        return "celestial";
-    case TrackingMode::DeadReckoning:
-        return "dead_reckoning";
-    case TrackingMode::Inertial:
-        return "imu";
-    case TrackingMode::Hold:
-        return "hold";
+    return sensorNames.at(sensorId);
+}
+
+const char *ModeManager::decisionReasonName(DecisionReason reason)
+{
+    switch (reason)
+    {
+    case DecisionReason::Enter:
+        return "enter_";
+    case DecisionReason::Maintain:
+        return "maintain_";
+    case DecisionReason::Dwell:
+        return "dwell_";
+    case DecisionReason::Switch:
+        return "switch_";
+    case DecisionReason::SwitchUnhealthy:
+        return "switch_unhealthy_";
+    case DecisionReason::NoSensors:
+        return "no_sensors";
+    case DecisionReason::AuthUnavailable:
+        return "auth_unavailable";
+    case DecisionReason::AuthDenied:
+        return "auth_denied";
+    case DecisionReason::InvalidLadder:
+        return "invalid_ladder";
     default:
         return "unknown";
     }
 }
+
+std::string ModeManager::modeName(TrackingMode mode)
+{
+    return modeLiteral(mode);
+}
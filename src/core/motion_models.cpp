@@ -3,6 +3,20 @@
 #include <algorithm>
 #include <cmath>
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define AIRTRACE_X86_KERNELS 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define AIRTRACE_TARGET_SSE4 __attribute__((target("sse4.1")))
+#define AIRTRACE_TARGET_AVX2 __attribute__((target("avx2")))
+#define AIRTRACE_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define AIRTRACE_TARGET_SSE4
+#define AIRTRACE_TARGET_AVX2
+#define AIRTRACE_TARGET_AVX512
+#endif
+#endif
+
 namespace
 {
 double clampValue(double value, double minValue, double maxValue)
@@ -10,33 +24,55 @@ double clampValue(double value, double minValue, double maxValue)
     return std::max(minValue, std::min(value, maxValue));
 }
 
-double magnitude(const Vec3 &v)
-{
-    return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
-}
-
-Vec3 clampVectorMagnitude(const Vec3 &v, double maxMagnitude)
+void clampComponentsMagnitude(double &x, double &y, double &z, double maxMagnitude)
 {
-    double mag = magnitude(v);
+    double mag = std::sqrt(x * x + y * y + z * z);
     if (mag <= maxMagnitude || mag == 0.0)
     {
-        return v;
+        return;
     }
     double scale = maxMagnitude / mag;
-    return {v.x * scale, v.y * scale, v.z * scale};
+    x *= scale;
+    y *= scale;
+    z *= scale;
 }
 
-Vec3 applyTurn(const Vec3 &velocity, double turnRateDeg, double dt)
+Vec3 clampVectorMagnitude(const Vec3 &v, double maxMagnitude)
+{
+    Vec3 clamped = v;
+    clampComponentsMagnitude(clamped.x, clamped.y, clamped.z, maxMagnitude);
+    return clamped;
+}
+
+// A coordinated turn rotates the horizontal velocity by a fixed angle each step. Rotating by
+// cos/sin of that angle is equivalent to re-deriving heading with atan2, but needs only
+// multiplies and adds per track, which every kernel level evaluates in the same order.
+struct TurnRotation
+{
+    double cosAngle;
+    double sinAngle;
+};
+
+TurnRotation turnRotation(double turnRateDeg, double dt)
 {
-    double speed = std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
-    if (speed == 0.0)
-    {
-        return velocity;
-    }
     double turnRateRad = turnRateDeg * (3.14159265358979323846 / 180.0);
-    double heading = std::atan2(velocity.y, velocity.x);
-    double newHeading = heading + turnRateRad * dt;
-    return {speed * std::cos(newHeading), speed * std::sin(newHeading), velocity.z};
+    double angle = turnRateRad * dt;
+    return {std::cos(angle), std::sin(angle)};
+}
+
+void turnComponents(double &vx, double &vy, const TurnRotation &rotation)
+{
+    double turnedX = vx * rotation.cosAngle - vy * rotation.sinAngle;
+    double turnedY = vx * rotation.sinAngle + vy * rotation.cosAngle;
+    vx = turnedX;
+    vy = turnedY;
+}
+
+Vec3 applyTurn(const Vec3 &velocity, double turnRateDeg, double dt)
+{
+    Vec3 turned = velocity;
+    turnComponents(turned.x, turned.y, turnRotation(turnRateDeg, dt));
+    return turned;
 }
 
 State9 clampState(const State9 &state, const MotionBounds &bounds)
@@ -50,6 +86,351 @@ State9 clampState(const State9 &state, const MotionBounds &bounds)
     next.position.z = clampValue(next.position.z, bounds.minPosition.z, bounds.maxPosition.z);
     return next;
 }
+
+// Batch kernels. Every level performs the same IEEE operations in the same order (no fused
+// multiply-add, correctly rounded sqrt/div, min/max operand order matching clampValue), so
+// all levels produce bit-identical tracks and sim.seed replays do not depend on the host CPU.
+struct MotionKernelArgs
+{
+    double *px;
+    double *py;
+    double *pz;
+    double *vx;
+    double *vy;
+    double *vz;
+    double *ax;
+    double *ay;
+    double *az;
+    double *t;
+    std::size_t count;
+    double dt;
+    bool rotate;
+    TurnRotation rotation;
+    bool zeroAcceleration;
+    MotionBounds bounds;
+};
+
+using MotionKernel = void (*)(const MotionKernelArgs &args, std::size_t begin);
+
+void stepTrackScalar(const MotionKernelArgs &args, std::size_t i)
+{
+    const double dt = args.dt;
+    if (args.rotate)
+    {
+        turnComponents(args.vx[i], args.vy[i], args.rotation);
+    }
+    if (args.zeroAcceleration)
+    {
+        args.ax[i] = 0.0;
+        args.ay[i] = 0.0;
+        args.az[i] = 0.0;
+    }
+
+    args.px[i] += args.vx[i] * dt + 0.5 * args.ax[i] * dt * dt;
+    args.py[i] += args.vy[i] * dt + 0.5 * args.ay[i] * dt * dt;
+    args.pz[i] += args.vz[i] * dt + 0.5 * args.az[i] * dt * dt;
+    args.vx[i] += args.ax[i] * dt;
+    args.vy[i] += args.ay[i] * dt;
+    args.vz[i] += args.az[i] * dt;
+    args.t[i] += dt;
+
+    clampComponentsMagnitude(args.vx[i], args.vy[i], args.vz[i], args.bounds.maxSpeed);
+    clampComponentsMagnitude(args.ax[i], args.ay[i], args.az[i], args.bounds.maxAcceleration);
+    args.px[i] = clampValue(args.px[i], args.bounds.minPosition.x, args.bounds.maxPosition.x);
+    args.py[i] = clampValue(args.py[i], args.bounds.minPosition.y, args.bounds.maxPosition.y);
+    args.pz[i] = clampValue(args.pz[i], args.bounds.minPosition.z, args.bounds.maxPosition.z);
+}
+
+void stepKernelScalar(const MotionKernelArgs &args, std::size_t begin)
+{
+    for (std::size_t i = begin; i < args.count; ++i)
+    {
+        stepTrackScalar(args, i);
+    }
+}
+
+#if defined(AIRTRACE_X86_KERNELS)
+AIRTRACE_TARGET_SSE4 void clampMagnitudeSse4(__m128d &x, __m128d &y, __m128d &z, __m128d maxMagnitude)
+{
+    const __m128d mag = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(x, x), _mm_mul_pd(y, y)), _mm_mul_pd(z, z)));
+    const __m128d keep = _mm_or_pd(_mm_cmple_pd(mag, maxMagnitude), _mm_cmpeq_pd(mag, _mm_setzero_pd()));
+    const __m128d scale = _mm_div_pd(maxMagnitude, mag);
+    x = _mm_blendv_pd(_mm_mul_pd(x, scale), x, keep);
+    y = _mm_blendv_pd(_mm_mul_pd(y, scale), y, keep);
+    z = _mm_blendv_pd(_mm_mul_pd(z, scale), z, keep);
+}
+
+AIRTRACE_TARGET_SSE4 void stepKernelSse4(const MotionKernelArgs &args, std::size_t begin)
+{
+    const __m128d dt = _mm_set1_pd(args.dt);
+    const __m128d half = _mm_set1_pd(0.5);
+    const __m128d cosAngle = _mm_set1_pd(args.rotation.cosAngle);
+    const __m128d sinAngle = _mm_set1_pd(args.rotation.sinAngle);
+    const __m128d maxSpeed = _mm_set1_pd(args.bounds.maxSpeed);
+    const __m128d maxAcceleration = _mm_set1_pd(args.bounds.maxAcceleration);
+    const __m128d minX = _mm_set1_pd(args.bounds.minPosition.x);
+    const __m128d minY = _mm_set1_pd(args.bounds.minPosition.y);
+    const __m128d minZ = _mm_set1_pd(args.bounds.minPosition.z);
+    const __m128d maxX = _mm_set1_pd(args.bounds.maxPosition.x);
+    const __m128d maxY = _mm_set1_pd(args.bounds.maxPosition.y);
+    const __m128d maxZ = _mm_set1_pd(args.bounds.maxPosition.z);
+
+    std::size_t i = begin;
+    for (; i + 2 <= args.count; i += 2)
+    {
+        __m128d vx = _mm_loadu_pd(args.vx + i);
+        __m128d vy = _mm_loadu_pd(args.vy + i);
+        __m128d vz = _mm_loadu_pd(args.vz + i);
+        if (args.rotate)
+        {
+            const __m128d turnedX = _mm_sub_pd(_mm_mul_pd(vx, cosAngle), _mm_mul_pd(vy, sinAngle));
+            const __m128d turnedY = _mm_add_pd(_mm_mul_pd(vx, sinAngle), _mm_mul_pd(vy, cosAngle));
+            vx = turnedX;
+            vy = turnedY;
+        }
+        __m128d ax = args.zeroAcceleration ? _mm_setzero_pd() : _mm_loadu_pd(args.ax + i);
+        __m128d ay = args.zeroAcceleration ? _mm_setzero_pd() : _mm_loadu_pd(args.ay + i);
+        __m128d az = args.zeroAcceleration ? _mm_setzero_pd() : _mm_loadu_pd(args.az + i);
+
+        __m128d px = _mm_loadu_pd(args.px + i);
+        __m128d py = _mm_loadu_pd(args.py + i);
+        __m128d pz = _mm_loadu_pd(args.pz + i);
+        px = _mm_add_pd(px, _mm_add_pd(_mm_mul_pd(vx, dt), _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(half, ax), dt), dt)));
+        py = _mm_add_pd(py, _mm_add_pd(_mm_mul_pd(vy, dt), _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(half, ay), dt), dt)));
+        pz = _mm_add_pd(pz, _mm_add_pd(_mm_mul_pd(vz, dt), _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(half, az), dt), dt)));
+        vx = _mm_add_pd(vx, _mm_mul_pd(ax, dt));
+        vy = _mm_add_pd(vy, _mm_mul_pd(ay, dt));
+        vz = _mm_add_pd(vz, _mm_mul_pd(az, dt));
+        const __m128d t = _mm_add_pd(_mm_loadu_pd(args.t + i), dt);
+
+        clampMagnitudeSse4(vx, vy, vz, maxSpeed);
+        clampMagnitudeSse4(ax, ay, az, maxAcceleration);
+        px = _mm_max_pd(_mm_min_pd(maxX, px), minX);
+        py = _mm_max_pd(_mm_min_pd(maxY, py), minY);
+        pz = _mm_max_pd(_mm_min_pd(maxZ, pz), minZ);
+
+        _mm_storeu_pd(args.px + i, px);
+        _mm_storeu_pd(args.py + i, py);
+        _mm_storeu_pd(args.pz + i, pz);
+        _mm_storeu_pd(args.vx + i, vx);
+        _mm_storeu_pd(args.vy + i, vy);
+        _mm_storeu_pd(args.vz + i, vz);
+        _mm_storeu_pd(args.ax + i, ax);
+        _mm_storeu_pd(args.ay + i, ay);
+        _mm_storeu_pd(args.az + i, az);
+        _mm_storeu_pd(args.t + i, t);
+    }
+    stepKernelScalar(args, i);
+}
+
+AIRTRACE_TARGET_AVX2 void clampMagnitudeAvx2(__m256d &x, __m256d &y, __m256d &z, __m256d maxMagnitude)
+{
+    const __m256d mag = _mm256_sqrt_pd(
+        _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z)));
+    const __m256d keep = _mm256_or_pd(_mm256_cmp_pd(mag, maxMagnitude, _CMP_LE_OQ),
+                                      _mm256_cmp_pd(mag, _mm256_setzero_pd(), _CMP_EQ_OQ));
+    const __m256d scale = _mm256_div_pd(maxMagnitude, mag);
+    x = _mm256_blendv_pd(_mm256_mul_pd(x, scale), x, keep);
+    y = _mm256_blendv_pd(_mm256_mul_pd(y, scale), y, keep);
+    z = _mm256_blendv_pd(_mm256_mul_pd(z, scale), z, keep);
+}
+
+AIRTRACE_TARGET_AVX2 void stepKernelAvx2(const MotionKernelArgs &args, std::size_t begin)
+{
+    const __m256d dt = _mm256_set1_pd(args.dt);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d cosAngle = _mm256_set1_pd(args.rotation.cosAngle);
+    const __m256d sinAngle = _mm256_set1_pd(args.rotation.sinAngle);
+    const __m256d maxSpeed = _mm256_set1_pd(args.bounds.maxSpeed);
+    const __m256d maxAcceleration = _mm256_set1_pd(args.bounds.maxAcceleration);
+    const __m256d minX = _mm256_set1_pd(args.bounds.minPosition.x);
+    const __m256d minY = _mm256_set1_pd(args.bounds.minPosition.y);
+    const __m256d minZ = _mm256_set1_pd(args.bounds.minPosition.z);
+    const __m256d maxX = _mm256_set1_pd(args.bounds.maxPosition.x);
+    const __m256d maxY = _mm256_set1_pd(args.bounds.maxPosition.y);
+    const __m256d maxZ = _mm256_set1_pd(args.bounds.maxPosition.z);
+
+    std::size_t i = begin;
+    for (; i + 4 <= args.count; i += 4)
+    {
+        __m256d vx = _mm256_loadu_pd(args.vx + i);
+        __m256d vy = _mm256_loadu_pd(args.vy + i);
+        __m256d vz = _mm256_loadu_pd(args.vz + i);
+        if (args.rotate)
+        {
+            const __m256d turnedX = _mm256_sub_pd(_mm256_mul_pd(vx, cosAngle), _mm256_mul_pd(vy, sinAngle));
+            const __m256d turnedY = _mm256_add_pd(_mm256_mul_pd(vx, sinAngle), _mm256_mul_pd(vy, cosAngle));
+            vx = turnedX;
+            vy = turnedY;
+        }
+        __m256d ax = args.zeroAcceleration ? _mm256_setzero_pd() : _mm256_loadu_pd(args.ax + i);
+        __m256d ay = args.zeroAcceleration ? _mm256_setzero_pd() : _mm256_loadu_pd(args.ay + i);
+        __m256d az = args.zeroAcceleration ? _mm256_setzero_pd() : _mm256_loadu_pd(args.az + i);
+
+        __m256d px = _mm256_loadu_pd(args.px + i);
+        __m256d py = _mm256_loadu_pd(args.py + i);
+        __m256d pz = _mm256_loadu_pd(args.pz + i);
+        px = _mm256_add_pd(px, _mm256_add_pd(_mm256_mul_pd(vx, dt),
+                                             _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(half, ax), dt), dt)));
+        py = _mm256_add_pd(py, _mm256_add_pd(_mm256_mul_pd(vy, dt),
+                                             _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(half, ay), dt), dt)));
+        pz = _mm256_add_pd(pz, _mm256_add_pd(_mm256_mul_pd(vz, dt),
+                                             _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(half, az), dt), dt)));
+        vx = _mm256_add_pd(vx, _mm256_mul_pd(ax, dt));
+        vy = _mm256_add_pd(vy, _mm256_mul_pd(ay, dt));
+        vz = _mm256_add_pd(vz, _mm256_mul_pd(az, dt));
+        const __m256d t = _mm256_add_pd(_mm256_loadu_pd(args.t + i), dt);
+
+        clampMagnitudeAvx2(vx, vy, vz, maxSpeed);
+        clampMagnitudeAvx2(ax, ay, az, maxAcceleration);
+        px = _mm256_max_pd(_mm256_min_pd(maxX, px), minX);
+        py = _mm256_max_pd(_mm256_min_pd(maxY, py), minY);
+        pz = _mm256_max_pd(_mm256_min_pd(maxZ, pz), minZ);
+
+        _mm256_storeu_pd(args.px + i, px);
+        _mm256_storeu_pd(args.py + i, py);
+        _mm256_storeu_pd(args.pz + i, pz);
+        _mm256_storeu_pd(args.vx + i, vx);
+        _mm256_storeu_pd(args.vy + i, vy);
+        _mm256_storeu_pd(args.vz + i, vz);
+        _mm256_storeu_pd(args.ax + i, ax);
+        _mm256_storeu_pd(args.ay + i, ay);
+        _mm256_storeu_pd(args.az + i, az);
+        _mm256_storeu_pd(args.t + i, t);
+    }
+    stepKernelScalar(args, i);
+}
+
+AIRTRACE_TARGET_AVX512 void clampMagnitudeAvx512(__m512d &x, __m512d &y, __m512d &z, __m512d maxMagnitude)
+{
+    const __m512d mag = _mm512_sqrt_pd(
+        _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(x, x), _mm512_mul_pd(y, y)), _mm512_mul_pd(z, z)));
+    const __mmask8 keep = static_cast<__mmask8>(_mm512_cmp_pd_mask(mag, maxMagnitude, _CMP_LE_OQ) |
+                                                _mm512_cmp_pd_mask(mag, _mm512_setzero_pd(), _CMP_EQ_OQ));
+    const __m512d scale = _mm512_div_pd(maxMagnitude, mag);
+    x = _mm512_mask_blend_pd(keep, _mm512_mul_pd(x, scale), x);
+    y = _mm512_mask_blend_pd(keep, _mm512_mul_pd(y, scale), y);
+    z = _mm512_mask_blend_pd(keep, _mm512_mul_pd(z, scale), z);
+}
+
+AIRTRACE_TARGET_AVX512 void stepKernelAvx512(const MotionKernelArgs &args, std::size_t begin)
+{
+    const __m512d dt = _mm512_set1_pd(args.dt);
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d cosAngle = _mm512_set1_pd(args.rotation.cosAngle);
+    const __m512d sinAngle = _mm512_set1_pd(args.rotation.sinAngle);
+    const __m512d maxSpeed = _mm512_set1_pd(args.bounds.maxSpeed);
+    const __m512d maxAcceleration = _mm512_set1_pd(args.bounds.maxAcceleration);
+    const __m512d minX = _mm512_set1_pd(args.bounds.minPosition.x);
+    const __m512d minY = _mm512_set1_pd(args.bounds.minPosition.y);
+    const __m512d minZ = _mm512_set1_pd(args.bounds.minPosition.z);
+    const __m512d maxX = _mm512_set1_pd(args.bounds.maxPosition.x);
+    const __m512d maxY = _mm512_set1_pd(args.bounds.maxPosition.y);
+    const __m512d maxZ = _mm512_set1_pd(args.bounds.maxPosition.z);
+
+    std::size_t i = begin;
+    for (; i + 8 <= args.count; i += 8)
+    {
+        __m512d vx = _mm512_loadu_pd(args.vx + i);
+        __m512d vy = _mm512_loadu_pd(args.vy + i);
+        __m512d vz = _mm512_loadu_pd(args.vz + i);
+        if (args.rotate)
+        {
+            const __m512d turnedX = _mm512_sub_pd(_mm512_mul_pd(vx, cosAngle), _mm512_mul_pd(vy, sinAngle));
+            const __m512d turnedY = _mm512_add_pd(_mm512_mul_pd(vx, sinAngle), _mm512_mul_pd(vy, cosAngle));
+            vx = turnedX;
+            vy = turnedY;
+        }
+        __m512d ax = args.zeroAcceleration ? _mm512_setzero_pd() : _mm512_loadu_pd(args.ax + i);
+        __m512d ay = args.zeroAcceleration ? _mm512_setzero_pd() : _mm512_loadu_pd(args.ay + i);
+        __m512d az = args.zeroAcceleration ? _mm512_setzero_pd() : _mm512_loadu_pd(args.az + i);
+
+        __m512d px = _mm512_loadu_pd(args.px + i);
+        __m512d py = _mm512_loadu_pd(args.py + i);
+        __m512d pz = _mm512_loadu_pd(args.pz + i);
+        px = _mm512_add_pd(px, _mm512_add_pd(_mm512_mul_pd(vx, dt),
+                                             _mm512_mul_pd(_mm512_mul_pd(_mm512_mul_pd(half, ax), dt), dt)));
+        py = _mm512_add_pd(py, _mm512_add_pd(_mm512_mul_pd(vy, dt),
+                                             _mm512_mul_pd(_mm512_mul_pd(_mm512_mul_pd(half, ay), dt), dt)));
+        pz = _mm512_add_pd(pz, _mm512_add_pd(_mm512_mul_pd(vz, dt),
+                                             _mm512_mul_pd(_mm512_mul_pd(_mm512_mul_pd(half, az), dt), dt)));
+        vx = _mm512_add_pd(vx, _mm512_mul_pd(ax, dt));
+        vy = _mm512_add_pd(vy, _mm512_mul_pd(ay, dt));
+        vz = _mm512_add_pd(vz, _mm512_mul_pd(az, dt));
+        const __m512d t = _mm512_add_pd(_mm512_loadu_pd(args.t + i), dt);
+
+        clampMagnitudeAvx512(vx, vy, vz, maxSpeed);
+        clampMagnitudeAvx512(ax, ay, az, maxAcceleration);
+        px = _mm512_max_pd(_mm512_min_pd(maxX, px), minX);
+        py = _mm512_max_pd(_mm512_min_pd(maxY, py), minY);
+        pz = _mm512_max_pd(_mm512_min_pd(maxZ, pz), minZ);
+
+        _mm512_storeu_pd(args.px + i, px);
+        _mm512_storeu_pd(args.py + i, py);
+        _mm512_storeu_pd(args.pz + i, pz);
+        _mm512_storeu_pd(args.vx + i, vx);
+        _mm512_storeu_pd(args.vy + i, vy);
+        _mm512_storeu_pd(args.vz + i, vz);
+        _mm512_storeu_pd(args.ax + i, ax);
+        _mm512_storeu_pd(args.ay + i, ay);
+        _mm512_storeu_pd(args.az + i, az);
+        _mm512_storeu_pd(args.t + i, t);
+    }
+    stepKernelScalar(args, i);
+}
+#endif
+
+MotionKernel kernelForLevel(SimdLevel level)
+{
+#if defined(AIRTRACE_X86_KERNELS)
+    switch (level)
+    {
+    case SimdLevel::Avx512:
+        return stepKernelAvx512;
+    case SimdLevel::Avx2:
+        return stepKernelAvx2;
+    case SimdLevel::Sse4:
+        return stepKernelSse4;
+    default:
+        break;
+    }
+#else
+    (void)level;
+#endif
+    return stepKernelScalar;
+}
+
+MotionKernelArgs makeKernelArgs(State9Batch &batch, MotionModelType model, double dt, const MotionBounds &bounds)
+{
+    MotionKernelArgs args{};
+    args.px = batch.positionX.data();
+    args.py = batch.positionY.data();
+    args.pz = batch.positionZ.data();
+    args.vx = batch.velocityX.data();
+    args.vy = batch.velocityY.data();
+    args.vz = batch.velocityZ.data();
+    args.ax = batch.accelerationX.data();
+    args.ay = batch.accelerationY.data();
+    args.az = batch.accelerationZ.data();
+    args.t = batch.time.data();
+    args.count = batch.size();
+    args.dt = dt;
+    args.rotate = model == MotionModelType::CoordinatedTurn;
+    args.rotation = args.rotate ? turnRotation(bounds.maxTurnRateDeg, dt) : TurnRotation{1.0, 0.0};
+    args.zeroAcceleration = model == MotionModelType::ConstantVelocity || model == MotionModelType::CoordinatedTurn;
+    args.bounds = bounds;
+    return args;
+}
+
+void runKernel(const MotionKernelArgs &args, SimdLevel level)
+{
+    SimdLevel supported = detectSimdLevel();
+    if (static_cast<int>(level) > static_cast<int>(supported))
+    {
+        level = supported;
+    }
+    kernelForLevel(level)(args, 0);
+}
 } // namespace
 
 State9 stepMotionModel(const State9 &state,
@@ -87,3 +468,106 @@ State9 stepMotionModel(const State9 &state,
     next = integrateState(next, dt);
     return clampState(next, bounds);
 }
+
+State9 stepMotionModel(const State9 &state,
+                       MotionModelType model,
+                       double dt,
+                       const MotionBounds &bounds,
+                       const ManeuverParams &params,
+                       NoiseSource &noise)
+{
+    State9 next = state;
+    switch (model)
+    {
+    case MotionModelType::ConstantVelocity:
+        next.acceleration = {0.0, 0.0, 0.0};
+        break;
+    case MotionModelType::ConstantAcceleration:
+        break;
+    case MotionModelType::CoordinatedTurn:
+        next.velocity = applyTurn(state.velocity, bounds.maxTurnRateDeg, dt);
+        next.acceleration = {0.0, 0.0, 0.0};
+        break;
+    case MotionModelType::RandomManeuver:
+        if (noise.event(params.maneuverProbability))
+        {
+            const double ax = noise.gaussian(params.randomAccelStd);
+            const double ay = noise.gaussian(params.randomAccelStd);
+            const double az = noise.gaussian(params.randomAccelStd);
+            next.acceleration = {ax, ay, az};
+        }
+        break;
+    default:
+        break;
+    }
+
+    next = integrateState(next, dt);
+    return clampState(next, bounds);
+}
+
+void stepMotionModels(State9Batch &batch,
+                      MotionModelType model,
+                      double dt,
+                      const MotionBounds &bounds,
+                      const ManeuverParams &params,
+                      std::mt19937 &rng)
+{
+    stepMotionModels(batch, model, dt, bounds, params, rng, detectSimdLevel());
+}
+
+void stepMotionModels(State9Batch &batch,
+                      MotionModelType model,
+                      double dt,
+                      const MotionBounds &bounds,
+                      const ManeuverParams &params,
+                      std::mt19937 &rng,
+                      SimdLevel level)
+{
+    MotionKernelArgs args = makeKernelArgs(batch, model, dt, bounds);
+    if (model == MotionModelType::RandomManeuver)
+    {
+        // Random draws stay sequential in track order; the kinematics then run vectorized.
+        std::normal_distribution<double> accelNoise(0.0, params.randomAccelStd);
+        std::bernoulli_distribution maneuverChance(params.maneuverProbability);
+        for (std::size_t i = 0; i < args.count; ++i)
+        {
+            if (maneuverChance(rng))
+            {
+                args.ax[i] = accelNoise(rng);
+                args.ay[i] = accelNoise(rng);
+                args.az[i] = accelNoise(rng);
+            }
+        }
+    }
+    runKernel(args, level);
+}
+
+void stepMotionModels(State9Batch &batch,
+                      MotionModelType model,
+                      double dt,
+                      const MotionBounds &bounds,
+                      const ManeuverParams &params,
+                      const RandomStreamKey &streamBase)
+{
+    MotionKernelArgs args = makeKernelArgs(batch, model, dt, bounds);
+    if (model == MotionModelType::RandomManeuver && params.maneuverProbability > 0.0)
+    {
+        // Each track owns its stream, so these draws have no cross-track dependency.
+        RandomStreamKey key = streamBase;
+        for (std::size_t i = 0; i < args.count; ++i)
+        {
+            key.entityId = streamBase.entityId + static_cast<std::uint32_t>(i);
+            if (counterUniform(key, 0) >= params.maneuverProbability)
+            {
+                continue;
+            }
+            double unused = 0.0;
+            counterGaussianPair(key, 1, args.ax[i], args.ay[i]);
+            counterGaussianPair(key, 2, args.az[i], unused);
+            args.ax[i] *= params.randomAccelStd;
+            args.ay[i] *= params.randomAccelStd;
+            args.az[i] *= params.randomAccelStd;
+        }
+    }
+    runKernel(args, detectSimdLevel());
+}
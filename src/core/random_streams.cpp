@@ -0,0 +1,238 @@
+#include "core/random_streams.h"
+
+#include <cmath>
+
+namespace
+{
+constexpr std::uint32_t kPhiloxM0 = 0xD2511F53U;
+constexpr std::uint32_t kPhiloxM1 = 0xCD9E8D57U;
+constexpr std::uint32_t kPhiloxW0 = 0x9E3779B9U;
+constexpr std::uint32_t kPhiloxW1 = 0xBB67AE85U;
+constexpr double kTwoPi = 6.283185307179586;
+
+std::array<std::uint32_t, 4> streamCounter(const RandomStreamKey &key, std::uint32_t block)
+{
+    return {block, key.entityId, key.streamId, key.step};
+}
+
+std::array<std::uint32_t, 2> streamSeed(const RandomStreamKey &key)
+{
+    return {static_cast<std::uint32_t>(key.seed & 0xFFFFFFFFULL), static_cast<std::uint32_t>(key.seed >> 32)};
+}
+
+double uniformFromWords(std::uint32_t high, std::uint32_t low)
+{
+    const std::uint64_t bits = ((static_cast<std::uint64_t>(high) << 32) | low) >> 11;
+    return static_cast<double>(bits) * (1.0 / 9007199254740992.0);
+}
+
+// Box-Muller over one Philox block; 1 - u keeps the log argument in (0, 1].
+void boxMuller(const std::array<std::uint32_t, 4> &words, double &first, double &second)
+{
+    const double u1 = 1.0 - uniformFromWords(words[0], words[1]);
+    const double u2 = uniformFromWords(words[2], words[3]);
+    const double radius = std::sqrt(-2.0 * std::log(u1));
+    const double angle = kTwoPi * u2;
+    first = radius * std::cos(angle);
+    second = radius * std::sin(angle);
+}
+} // namespace
+
+std::uint32_t randomStreamId(const std::string &name)
+{
+    std::uint32_t hash = 2166136261U;
+    for (unsigned char c : name)
+    {
+        hash ^= c;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+std::array<std::uint32_t, 4> philox4x32(const std::array<std::uint32_t, 4> &counter,
+                                        const std::array<std::uint32_t, 2> &key)
+{
+    std::array<std::uint32_t, 4> ctr = counter;
+    std::uint32_t k0 = key[0];
+    std::uint32_t k1 = key[1];
+    for (int round = 0; round < 10; ++round)
+    {
+        if (round > 0)
+        {
+            k0 += kPhiloxW0;
+            k1 += kPhiloxW1;
+        }
+        const std::uint64_t product0 = static_cast<std::uint64_t>(kPhiloxM0) * ctr[0];
+        const std::uint64_t product1 = static_cast<std::uint64_t>(kPhiloxM1) * ctr[2];
+        const std::uint32_t hi0 = static_cast<std::uint32_t>(product0 >> 32);
+        const std::uint32_t lo0 = static_cast<std::uint32_t>(product0);
+        const std::uint32_t hi1 = static_cast<std::uint32_t>(product1 >> 32);
+        const std::uint32_t lo1 = static_cast<std::uint32_t>(product1);
+        ctr = {hi1 ^ ctr[1] ^ k0, lo1, hi0 ^ ctr[3] ^ k1, lo0};
+    }
+    return ctr;
+}
+
+double counterUniform(const RandomStreamKey &key, std::uint32_t draw)
+{
+    const std::array<std::uint32_t, 4> words = philox4x32(streamCounter(key, draw), streamSeed(key));
+    return uniformFromWords(words[0], words[1]);
+}
+
+void counterGaussianPair(const RandomStreamKey &key, std::uint32_t draw, double &first, double &second)
+{
+    boxMuller(philox4x32(streamCounter(key, draw), streamSeed(key)), first, second);
+}
+
+void gaussianAcrossEntities(const RandomStreamKey &base,
+                            std::uint32_t draw,
+                            double stddev,
+                            double *out,
+                            std::size_t count)
+{
+    RandomStreamKey key = base;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        key.entityId = base.entityId + static_cast<std::uint32_t>(i);
+        if (stddev <= 0.0)
+        {
+            out[i] = 0.0;
+            continue;
+        }
+        double first = 0.0;
+        double second = 0.0;
+        counterGaussianPair(key, draw, first, second);
+        out[i] = first * stddev;
+    }
+}
+
+void bernoulliAcrossEntities(const RandomStreamKey &base,
+                             std::uint32_t draw,
+                             double probability,
+                             std::uint8_t *out,
+                             std::size_t count)
+{
+    RandomStreamKey key = base;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        key.entityId = base.entityId + static_cast<std::uint32_t>(i);
+        out[i] = (probability > 0.0 && counterUniform(key, draw) < probability) ? 1U : 0U;
+    }
+}
+
+CounterRng::CounterRng(const RandomStreamKey &key)
+    : streamKey(key)
+{
+}
+
+void CounterRng::refill()
+{
+    words = philox4x32(streamCounter(streamKey, block), streamSeed(streamKey));
+    block += 1;
+    wordIndex = 0;
+}
+
+CounterRng::result_type CounterRng::operator()()
+{
+    if (wordIndex >= words.size())
+    {
+        refill();
+    }
+    return words[wordIndex++];
+}
+
+double CounterRng::uniform()
+{
+    const std::uint32_t high = (*this)();
+    const std::uint32_t low = (*this)();
+    return uniformFromWords(high, low);
+}
+
+double CounterRng::gaussian(double stddev)
+{
+    if (stddev <= 0.0)
+    {
+        return 0.0;
+    }
+    if (hasSpare)
+    {
+        hasSpare = false;
+        return spare * stddev;
+    }
+    std::array<std::uint32_t, 4> block4{};
+    for (auto &word : block4)
+    {
+        word = (*this)();
+    }
+    double first = 0.0;
+    boxMuller(block4, first, spare);
+    hasSpare = true;
+    return first * stddev;
+}
+
+bool CounterRng::bernoulli(double probability)
+{
+    if (probability <= 0.0)
+    {
+        return false;
+    }
+    return uniform() < probability;
+}
+
+void CounterRng::fillGaussian(double *out, std::size_t count, double stddev)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        out[i] = gaussian(stddev);
+    }
+}
+
+const RandomStreamKey &CounterRng::key() const
+{
+    return streamKey;
+}
+
+Mt19937NoiseSource::Mt19937NoiseSource(std::mt19937 &rng)
+    : rng(rng)
+{
+}
+
+double Mt19937NoiseSource::gaussian(double stddev)
+{
+    if (stddev <= 0.0)
+    {
+        return 0.0;
+    }
+    std::normal_distribution<double> noise(0.0, stddev);
+    return noise(rng);
+}
+
+bool Mt19937NoiseSource::event(double probability)
+{
+    if (probability <= 0.0)
+    {
+        return false;
+    }
+    std::bernoulli_distribution chance(probability);
+    return chance(rng);
+}
+
+std::mt19937 *Mt19937NoiseSource::legacyEngine()
+{
+    return &rng;
+}
+
+CounterNoiseSource::CounterNoiseSource(const RandomStreamKey &key)
+    : rng(key)
+{
+}
+
+double CounterNoiseSource::gaussian(double stddev)
+{
+    return rng.gaussian(stddev);
+}
+
+bool CounterNoiseSource::event(double probability)
+{
+    return rng.bernoulli(probability);
+}
@@ -0,0 +1,126 @@
+#include "core/sensor_sampling.h"
+
+#include <unordered_map>
+#include <utility>
+
+SensorSamplingStage::SensorSamplingStage(std::size_t workerCount)
+    : pool(workerCount)
+{
+}
+
+std::size_t SensorSamplingStage::addTask(SensorBase &sensor, const State9 &state, std::uint32_t entityId)
+{
+    if (!sensor.supportsNoiseSource())
+    {
+        return npos;
+    }
+    taskList.push_back({&sensor, &state, entityId});
+    results.emplace_back();
+    groupsDirty = true;
+    return taskList.size() - 1;
+}
+
+void SensorSamplingStage::clearTasks()
+{
+    taskList.clear();
+    results.clear();
+    groups.clear();
+    groupSeconds.clear();
+    groupSamples.clear();
+    groupsDirty = false;
+}
+
+void SensorSamplingStage::setClock(Clock clock)
+{
+    this->clock = std::move(clock);
+}
+
+void SensorSamplingStage::rebuildGroups()
+{
+    // Existing groups keep their position so accumulated timings stay attached to their sensor.
+    std::unordered_map<const SensorBase *, std::size_t> groupBySensor;
+    for (std::size_t group = 0; group < groups.size(); ++group)
+    {
+        groupBySensor.emplace(taskList[groups[group].front()].sensor, group);
+        groups[group].clear();
+    }
+    for (std::size_t index = 0; index < taskList.size(); ++index)
+    {
+        auto inserted = groupBySensor.emplace(taskList[index].sensor, groups.size());
+        if (inserted.second)
+        {
+            groups.emplace_back();
+            groupSeconds.push_back(0.0);
+            groupSamples.push_back(0);
+        }
+        groups[inserted.first->second].push_back(index);
+    }
+    groupsDirty = false;
+}
+
+void SensorSamplingStage::run(double dt, std::uint64_t seed, std::uint32_t step)
+{
+    if (groupsDirty)
+    {
+        rebuildGroups();
+    }
+
+    pool.parallelFor(groups.size(), [&](std::size_t group, std::size_t)
+    {
+        const double start = clock ? clock() : 0.0;
+        for (std::size_t index : groups[group])
+        {
+            const SensorSamplingTask &task = taskList[index];
+            CounterNoiseSource noise({seed, task.entityId, task.sensor->getStreamId(), step});
+            results[index] = task.sensor->sample(*task.state, dt, noise);
+        }
+        if (clock)
+        {
+            groupSeconds[group] += clock() - start;
+        }
+        groupSamples[group] += groups[group].size();
+    });
+}
+
+std::size_t SensorSamplingStage::workerCount() const
+{
+    return pool.workerCount();
+}
+
+const std::vector<SensorSamplingTask> &SensorSamplingStage::tasks() const
+{
+    return taskList;
+}
+
+const std::vector<Measurement> &SensorSamplingStage::measurements() const
+{
+    return results;
+}
+
+const Measurement &SensorSamplingStage::measurement(std::size_t taskIndex) const
+{
+    return results.at(taskIndex);
+}
+
+std::vector<SensorSamplingTiming> SensorSamplingStage::timings() const
+{
+    std::vector<SensorSamplingTiming> summary;
+    std::unordered_map<std::string, std::size_t> slotByName;
+    for (std::size_t group = 0; group < groups.size(); ++group)
+    {
+        if (groups[group].empty())
+        {
+            continue;
+        }
+        const std::string &name = taskList[groups[group].front()].sensor->getName();
+        auto inserted = slotByName.emplace(name, summary.size());
+        if (inserted.second)
+        {
+            summary.push_back({name, 0.0, 0});
+        }
+        SensorSamplingTiming &timing = summary[inserted.first->second];
+        timing.seconds += groupSeconds[group];
+        timing.samples += groupSamples[group];
+    }
+    return summary;
+}
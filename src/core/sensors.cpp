@@ -6,26 +6,6 @@ namespace
 {
 constexpr double kPi = 3.141592653589793;
 
-double gaussianNoise(double stddev, std::mt19937 &rng)
-{
-    if (stddev <= 0.0)
-    {
-        return 0.0;
-    }
-    std::normal_distribution<double> noise(0.0, stddev);
-    return noise(rng);
-}
-
-bool randomEvent(double probability, std::mt19937 &rng)
-{
-    if (probability <= 0.0)
-    {
-        return false;
-    }
-    std::bernoulli_distribution chance(probability);
-    return chance(rng);
-}
-
 double normalizeAngle(double angleRad)
 {
     double wrapped = std::fmod(angleRad + kPi, 2.0 * kPi);
@@ -38,11 +18,21 @@ double normalizeAngle(double angleRad)
 } // namespace
 
 SensorBase::SensorBase(std::string name, SensorConfig config)
-    : config(config), name(std::move(name)), timeAccumulator(0.0), provenance(ProvenanceTag::Operational)
+    : config(config),
+      name(std::move(name)),
+      timeAccumulator(0.0),
+      provenance(ProvenanceTag::Operational)
 {
+    streamId = randomStreamId(this->name);
 }
 
 Measurement SensorBase::sample(const State9 &state, double dt, std::mt19937 &rng)
+{
+    Mt19937NoiseSource noise(rng);
+    return sample(state, dt, noise);
+}
+
+Measurement SensorBase::sample(const State9 &state, double dt, NoiseSource &noise)
 {
     Measurement measurement;
     measurement.provenance = provenance;
@@ -56,13 +46,13 @@ Measurement SensorBase::sample(const State9 &state, double dt, std::mt19937 &rng
     }
     timeAccumulator = 0.0;
 
-    if (!status.available || randomEvent(config.dropoutProbability, rng))
+    if (!status.available || noise.event(config.dropoutProbability))
     {
         recordFailure("dropout");
         return measurement;
     }
 
-    measurement = generateMeasurement(state, rng);
+    measurement = generateMeasurement(state, noise);
     measurement.provenance = provenance;
     if (!measurement.valid)
     {
@@ -77,11 +67,35 @@ Measurement SensorBase::sample(const State9 &state, double dt, std::mt19937 &rng
     return measurement;
 }
 
+Measurement SensorBase::generateMeasurement(const State9 &state, NoiseSource &noise)
+{
+    std::mt19937 *engine = noise.legacyEngine();
+    if (engine == nullptr)
+    {
+        Measurement measurement;
+        measurement.note = "noise_source_unsupported";
+        return measurement;
+    }
+    return generateMeasurement(state, *engine);
+}
+
+Measurement SensorBase::generateMeasurement(const State9 &, std::mt19937 &)
+{
+    Measurement measurement;
+    measurement.note = "generator_missing";
+    return measurement;
+}
+
 const std::string &SensorBase::getName() const
 {
     return name;
 }
 
+std::uint32_t SensorBase::getStreamId() const
+{
+    return streamId;
+}
+
 const SensorStatus &SensorBase::getStatus() const
 {
     return status;
@@ -97,6 +111,11 @@ ProvenanceTag SensorBase::getProvenance() const
     return provenance;
 }
 
+bool SensorBase::supportsNoiseSource() const
+{
+    return false;
+}
+
 void SensorBase::recordFailure(const std::string &reason)
 {
     status.missedUpdates += 1;
@@ -121,11 +140,16 @@ GpsSensor::GpsSensor(const SensorConfig &config)
 {
 }
 
-Measurement GpsSensor::generateMeasurement(const State9 &state, std::mt19937 &rng)
+bool GpsSensor::supportsNoiseSource() const
+{
+    return true;
+}
+
+Measurement GpsSensor::generateMeasurement(const State9 &state, NoiseSource &noise)
 {
     Measurement measurement;
 
-    if (randomEvent(config.falsePositiveProbability, rng))
+    if (noise.event(config.falsePositiveProbability))
     {
         measurement.position = Vec3{state.position.x + 100.0, state.position.y - 100.0, state.position.z + 50.0};
         measurement.valid = true;
@@ -133,14 +157,14 @@ Measurement GpsSensor::generateMeasurement(const State9 &state, std::mt19937 &rn
         return measurement;
     }
 
-    bias.x += gaussianNoise(config.noiseStd * 0.1, rng);
-    bias.y += gaussianNoise(config.noiseStd * 0.1, rng);
-    bias.z += gaussianNoise(config.noiseStd * 0.1, rng);
+    bias.x += noise.gaussian(config.noiseStd * 0.1);
+    bias.y += noise.gaussian(config.noiseStd * 0.1);
+    bias.z += noise.gaussian(config.noiseStd * 0.1);
 
     measurement.position = Vec3{
-        state.position.x + bias.x + gaussianNoise(config.noiseStd, rng),
-        state.position.y + bias.y + gaussianNoise(config.noiseStd, rng),
-        state.position.z + bias.z + gaussianNoise(config.noiseStd, rng)};
+        state.position.x + bias.x + noise.gaussian(config.noiseStd),
+        state.position.y + bias.y + noise.gaussian(config.noiseStd),
+        state.position.z + bias.z + noise.gaussian(config.noiseStd)};
     measurement.valid = true;
     return measurement;
 }
@@ -150,7 +174,12 @@ ThermalSensor::ThermalSensor(const SensorConfig &config)
 {
 }
 
-Measurement ThermalSensor::generateMeasurement(const State9 &state, std::mt19937 &rng)
+bool ThermalSensor::supportsNoiseSource() const
+{
+    return true;
+}
+
+Measurement ThermalSensor::generateMeasurement(const State9 &state, NoiseSource &noise)
 {
     Measurement measurement;
     double range = std::sqrt(state.position.x * state.position.x +
@@ -164,7 +193,7 @@ Measurement ThermalSensor::generateMeasurement(const State9 &state, std::mt19937
         return measurement;
     }
 
-    if (randomEvent(config.falsePositiveProbability, rng))
+    if (noise.event(config.falsePositiveProbability))
     {
         measurement.position = Vec3{state.position.x + 30.0, state.position.y - 30.0, state.position.z + 10.0};
         measurement.valid = true;
@@ -173,9 +202,9 @@ Measurement ThermalSensor::generateMeasurement(const State9 &state, std::mt19937
     }
 
     measurement.position = Vec3{
-        state.position.x + gaussianNoise(config.noiseStd, rng),
-        state.position.y + gaussianNoise(config.noiseStd, rng),
-        state.position.z + gaussianNoise(config.noiseStd, rng)};
+        state.position.x + noise.gaussian(config.noiseStd),
+        state.position.y + noise.gaussian(config.noiseStd),
+        state.position.z + noise.gaussian(config.noiseStd)};
     measurement.valid = true;
     return measurement;
 }
@@ -185,12 +214,17 @@ DeadReckoningSensor::DeadReckoningSensor(const SensorConfig &config)
 {
 }
 
-Measurement DeadReckoningSensor::generateMeasurement(const State9 &state, std::mt19937 &rng)
+bool DeadReckoningSensor::supportsNoiseSource() const
+{
+    return true;
+}
+
+Measurement DeadReckoningSensor::generateMeasurement(const State9 &state, NoiseSource &noise)
 {
     Measurement measurement;
-    drift.x += gaussianNoise(config.noiseStd * 0.2, rng);
-    drift.y += gaussianNoise(config.noiseStd * 0.2, rng);
-    drift.z += gaussianNoise(config.noiseStd * 0.2, rng);
+    drift.x += noise.gaussian(config.noiseStd * 0.2);
+    drift.y += noise.gaussian(config.noiseStd * 0.2);
+    drift.z += noise.gaussian(config.noiseStd * 0.2);
 
     measurement.position = Vec3{
         state.position.x + drift.x,
@@ -205,17 +239,22 @@ ImuSensor::ImuSensor(const SensorConfig &config)
 {
 }
 
-Measurement ImuSensor::generateMeasurement(const State9 &state, std::mt19937 &rng)
+bool ImuSensor::supportsNoiseSource() const
+{
+    return true;
+}
+
+Measurement ImuSensor::generateMeasurement(const State9 &state, NoiseSource &noise)
 {
     Measurement measurement;
-    bias.x += gaussianNoise(config.noiseStd * 0.05, rng);
-    bias.y += gaussianNoise(config.noiseStd * 0.05, rng);
-    bias.z += gaussianNoise(config.noiseStd * 0.05, rng);
+    bias.x += noise.gaussian(config.noiseStd * 0.05);
+    bias.y += noise.gaussian(config.noiseStd * 0.05);
+    bias.z += noise.gaussian(config.noiseStd * 0.05);
 
     measurement.velocity = Vec3{
-        state.velocity.x + bias.x + gaussianNoise(config.noiseStd, rng),
-        state.velocity.y + bias.y + gaussianNoise(config.noiseStd, rng),
-        state.velocity.z + bias.z + gaussianNoise(config.noiseStd, rng)};
+        state.velocity.x + bias.x + noise.gaussian(config.noiseStd),
+        state.velocity.y + bias.y + noise.gaussian(config.noiseStd),
+        state.velocity.z + bias.z + noise.gaussian(config.noiseStd)};
     measurement.valid = true;
     return measurement;
 }
@@ -225,7 +264,12 @@ RadarSensor::RadarSensor(const SensorConfig &config)
 {
 }
 
-Measurement RadarSensor::generateMeasurement(const State9 &state, std::mt19937 &rng)
+bool RadarSensor::supportsNoiseSource() const
+{
+    return true;
+}
+
+Measurement RadarSensor::generateMeasurement(const State9 &state, NoiseSource &noise)
 {
     Measurement measurement;
     double range = std::sqrt(state.position.x * state.position.x +
@@ -239,8 +283,8 @@ Measurement RadarSensor::generateMeasurement(const State9 &state, std::mt19937 &
     }
 
     double bearing = std::atan2(state.position.y, state.position.x);
-    measurement.range = range + gaussianNoise(config.noiseStd, rng);
-    measurement.bearing = bearing + gaussianNoise(config.noiseStd * 0.01, rng);
+    measurement.range = range + noise.gaussian(config.noiseStd);
+    measurement.bearing = bearing + noise.gaussian(config.noiseStd * 0.01);
     measurement.valid = true;
     return measurement;
 }
@@ -250,7 +294,12 @@ VisionSensor::VisionSensor(const SensorConfig &config)
 {
 }
 
-Measurement VisionSensor::generateMeasurement(const State9 &state, std::mt19937 &rng)
+bool VisionSensor::supportsNoiseSource() const
+{
+    return true;
+}
+
+Measurement VisionSensor::generateMeasurement(const State9 &state, NoiseSource &noise)
 {
     Measurement measurement;
     double range = std::sqrt(state.position.x * state.position.x +
@@ -263,7 +312,7 @@ Measurement VisionSensor::generateMeasurement(const State9 &state, std::mt19937
         return measurement;
     }
 
-    if (randomEvent(config.falsePositiveProbability, rng))
+    if (noise.event(config.falsePositiveProbability))
     {
         measurement.position = Vec3{state.position.x + 20.0, state.position.y - 15.0, state.position.z + 5.0};
         measurement.valid = true;
@@ -272,9 +321,9 @@ Measurement VisionSensor::generateMeasurement(const State9 &state, std::mt19937
     }
 
     measurement.position = Vec3{
-        state.position.x + gaussianNoise(config.noiseStd, rng),
-        state.position.y + gaussianNoise(config.noiseStd, rng),
-        state.position.z + gaussianNoise(config.noiseStd, rng)};
+        state.position.x + noise.gaussian(config.noiseStd),
+        state.position.y + noise.gaussian(config.noiseStd),
+        state.position.z + noise.gaussian(config.noiseStd)};
     measurement.valid = true;
     return measurement;
 }
@@ -284,7 +333,12 @@ LidarSensor::LidarSensor(const SensorConfig &config)
 {
 }
 
-Measurement LidarSensor::generateMeasurement(const State9 &state, std::mt19937 &rng)
+bool LidarSensor::supportsNoiseSource() const
+{
+    return true;
+}
+
+Measurement LidarSensor::generateMeasurement(const State9 &state, NoiseSource &noise)
 {
     Measurement measurement;
     double range = std::sqrt(state.position.x * state.position.x +
@@ -299,7 +353,7 @@ Measurement LidarSensor::generateMeasurement(const State9 &state, std::mt19937 &
 
     double bearing = std::atan2(state.position.y, state.position.x);
 
-    if (randomEvent(config.falsePositiveProbability, rng))
+    if (noise.event(config.falsePositiveProbability))
     {
         measurement.range = range + 25.0;
         measurement.bearing = normalizeAngle(bearing + 0.15);
@@ -308,8 +362,8 @@ Measurement LidarSensor::generateMeasurement(const State9 &state, std::mt19937 &
         return measurement;
     }
 
-    measurement.range = range + gaussianNoise(config.noiseStd * 0.5, rng);
-    measurement.bearing = normalizeAngle(bearing + gaussianNoise(config.noiseStd * 0.005, rng));
+    measurement.range = range + noise.gaussian(config.noiseStd * 0.5);
+    measurement.bearing = normalizeAngle(bearing + noise.gaussian(config.noiseStd * 0.005));
     measurement.valid = true;
     return measurement;
 }
@@ -319,7 +373,12 @@ MagnetometerSensor::MagnetometerSensor(const SensorConfig &config)
 {
 }
 
-Measurement MagnetometerSensor::generateMeasurement(const State9 &state, std::mt19937 &rng)
+bool MagnetometerSensor::supportsNoiseSource() const
+{
+    return true;
+}
+
+Measurement MagnetometerSensor::generateMeasurement(const State9 &state, NoiseSource &noise)
 {
     Measurement measurement;
     double speed = std::sqrt(state.velocity.x * state.velocity.x +
@@ -332,9 +391,9 @@ Measurement MagnetometerSensor::generateMeasurement(const State9 &state, std::mt
         return measurement;
     }
 
-    bias += gaussianNoise(config.noiseStd * 0.01, rng);
+    bias += noise.gaussian(config.noiseStd * 0.01);
     double heading = std::atan2(state.velocity.y, state.velocity.x);
-    measurement.heading = normalizeAngle(heading + bias + gaussianNoise(config.noiseStd * 0.1, rng));
+    measurement.heading = normalizeAngle(heading + bias + noise.gaussian(config.noiseStd * 0.1));
     measurement.valid = true;
     return measurement;
 }
@@ -344,7 +403,12 @@ BarometerSensor::BarometerSensor(const SensorConfig &config)
 {
 }
 
-Measurement BarometerSensor::generateMeasurement(const State9 &state, std::mt19937 &rng)
+bool BarometerSensor::supportsNoiseSource() const
+{
+    return true;
+}
+
+Measurement BarometerSensor::generateMeasurement(const State9 &state, NoiseSource &noise)
 {
     Measurement measurement;
     if (config.maxRange > 0.0 && std::fabs(state.position.z) > config.maxRange)
@@ -354,8 +418,8 @@ Measurement BarometerSensor::generateMeasurement(const State9 &state, std::mt199
         return measurement;
     }
 
-    drift += gaussianNoise(config.noiseStd * 0.05, rng);
-    measurement.altitude = state.position.z + drift + gaussianNoise(config.noiseStd, rng);
+    drift += noise.gaussian(config.noiseStd * 0.05);
+    measurement.altitude = state.position.z + drift + noise.gaussian(config.noiseStd);
     measurement.valid = true;
     return measurement;
 }
@@ -365,11 +429,16 @@ CelestialSensor::CelestialSensor(const SensorConfig &config)
 {
 }
 
-Measurement CelestialSensor::generateMeasurement(const State9 &state, std::mt19937 &rng)
+bool CelestialSensor::supportsNoiseSource() const
+{
+    return true;
+}
+
+Measurement CelestialSensor::generateMeasurement(const State9 &state, NoiseSource &noise)
 {
     Measurement measurement;
 
-    if (randomEvent(config.falsePositiveProbability, rng))
+    if (noise.event(config.falsePositiveProbability))
     {
         measurement.position = Vec3{state.position.x - 12.0, state.position.y + 18.0, state.position.z - 6.0};
         measurement.valid = true;
@@ -377,14 +446,14 @@ Measurement CelestialSensor::generateMeasurement(const State9 &state, std::mt199
         return measurement;
     }
 
-    bias.x += gaussianNoise(config.noiseStd * 0.02, rng);
-    bias.y += gaussianNoise(config.noiseStd * 0.02, rng);
-    bias.z += gaussianNoise(config.noiseStd * 0.02, rng);
+    bias.x += noise.gaussian(config.noiseStd * 0.02);
+    bias.y += noise.gaussian(config.noiseStd * 0.02);
+    bias.z += noise.gaussian(config.noiseStd * 0.02);
 
     measurement.position = Vec3{
-        state.position.x + bias.x + gaussianNoise(config.noiseStd, rng),
-        state.position.y + bias.y + gaussianNoise(config.noiseStd, rng),
-        state.position.z + bias.z + gaussianNoise(config.noiseStd, rng)};
+        state.position.x + bias.x + noise.gaussian(config.noiseStd),
+        state.position.y + bias.y + noise.gaussian(config.noiseStd),
+        state.position.z + bias.z + noise.gaussian(config.noiseStd)};
     measurement.valid = true;
     return measurement;
 }
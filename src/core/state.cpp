@@ -15,6 +15,115 @@ State9 integrateState(const State9 &state, double dt)
     return next;
 }
 
+void integrateStates(State9Batch &batch, double dt)
+{
+    const std::size_t count = batch.size();
+    double *px = batch.positionX.data();
+    double *py = batch.positionY.data();
+    double *pz = batch.positionZ.data();
+    double *vx = batch.velocityX.data();
+    double *vy = batch.velocityY.data();
+    double *vz = batch.velocityZ.data();
+    const double *ax = batch.accelerationX.data();
+    const double *ay = batch.accelerationY.data();
+    const double *az = batch.accelerationZ.data();
+    double *t = batch.time.data();
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        px[i] += vx[i] * dt + 0.5 * ax[i] * dt * dt;
+        py[i] += vy[i] * dt + 0.5 * ay[i] * dt * dt;
+        pz[i] += vz[i] * dt + 0.5 * az[i] * dt * dt;
+
+        vx[i] += ax[i] * dt;
+        vy[i] += ay[i] * dt;
+        vz[i] += az[i] * dt;
+
+        t[i] += dt;
+    }
+}
+
+std::size_t State9Batch::size() const
+{
+    return time.size();
+}
+
+bool State9Batch::empty() const
+{
+    return time.empty();
+}
+
+void State9Batch::reserve(std::size_t count)
+{
+    positionX.reserve(count);
+    positionY.reserve(count);
+    positionZ.reserve(count);
+    velocityX.reserve(count);
+    velocityY.reserve(count);
+    velocityZ.reserve(count);
+    accelerationX.reserve(count);
+    accelerationY.reserve(count);
+    accelerationZ.reserve(count);
+    time.reserve(count);
+}
+
+void State9Batch::resize(std::size_t count)
+{
+    positionX.resize(count, 0.0);
+    positionY.resize(count, 0.0);
+    positionZ.resize(count, 0.0);
+    velocityX.resize(count, 0.0);
+    velocityY.resize(count, 0.0);
+    velocityZ.resize(count, 0.0);
+    accelerationX.resize(count, 0.0);
+    accelerationY.resize(count, 0.0);
+    accelerationZ.resize(count, 0.0);
+    time.resize(count, 0.0);
+}
+
+void State9Batch::clear()
+{
+    resize(0);
+}
+
+void State9Batch::push_back(const State9 &state)
+{
+    positionX.push_back(state.position.x);
+    positionY.push_back(state.position.y);
+    positionZ.push_back(state.position.z);
+    velocityX.push_back(state.velocity.x);
+    velocityY.push_back(state.velocity.y);
+    velocityZ.push_back(state.velocity.z);
+    accelerationX.push_back(state.acceleration.x);
+    accelerationY.push_back(state.acceleration.y);
+    accelerationZ.push_back(state.acceleration.z);
+    time.push_back(state.time);
+}
+
+State9 State9Batch::get(std::size_t index) const
+{
+    State9 state{};
+    state.position = {positionX[index], positionY[index], positionZ[index]};
+    state.velocity = {velocityX[index], velocityY[index], velocityZ[index]};
+    state.acceleration = {accelerationX[index], accelerationY[index], accelerationZ[index]};
+    state.time = time[index];
+    return state;
+}
+
+void State9Batch::set(std::size_t index, const State9 &state)
+{
+    positionX[index] = state.position.x;
+    positionY[index] = state.position.y;
+    positionZ[index] = state.position.z;
+    velocityX[index] = state.velocity.x;
+    velocityY[index] = state.velocity.y;
+    velocityZ[index] = state.velocity.z;
+    accelerationX[index] = state.acceleration.x;
+    accelerationY[index] = state.acceleration.y;
+    accelerationZ[index] = state.acceleration.z;
+    time[index] = state.time;
+}
+
 Projection2D projectXY(const State9 &state)
 {
     return {state.position.x, state.position.y, "XY"};
@@ -0,0 +1,403 @@
+#include "core/track_filter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr double kPi = 3.141592653589793;
+constexpr double kMinRange = 1e-6;
+constexpr double kMinSpeedSquared = 1e-6;
+
+double wrapAngle(double radians)
+{
+    while (radians > kPi)
+    {
+        radians -= 2.0 * kPi;
+    }
+    while (radians < -kPi)
+    {
+        radians += 2.0 * kPi;
+    }
+    return radians;
+}
+
+// State index i = derivative * 3 + axis.
+std::size_t axisOf(std::size_t index)
+{
+    return index % 3;
+}
+
+std::size_t derivativeOf(std::size_t index)
+{
+    return index / 3;
+}
+
+// Transition coefficient F(i, k) for i, k on the same axis, indexed by derivative(k) - derivative(i).
+struct TransitionCoefficients
+{
+    double byGap[3];
+};
+
+TransitionCoefficients transitionCoefficients(double dt)
+{
+    return {{1.0, dt, 0.5 * dt * dt}};
+}
+
+// White-jerk process noise for one axis, indexed by derivative.
+double processNoise(std::size_t row, std::size_t col, double dt, double density)
+{
+    if (axisOf(row) != axisOf(col))
+    {
+        return 0.0;
+    }
+    const double dt2 = dt * dt;
+    const double dt3 = dt2 * dt;
+    const double table[3][3] = {
+        {dt3 * dt2 / 20.0, dt2 * dt2 / 8.0, dt3 / 6.0},
+        {dt2 * dt2 / 8.0, dt3 / 3.0, dt2 / 2.0},
+        {dt3 / 6.0, dt2 / 2.0, dt}};
+    return density * table[derivativeOf(row)][derivativeOf(col)];
+}
+
+// In-place x = F x and P = F P F^T + Q over `count` lanes. Every output entry is its own input
+// plus terms of strictly higher derivative order, so processing entries by increasing derivative
+// (sum) reads only values not yet overwritten. Each term is a separate pass over the lanes,
+// which keeps the inner loop a plain multiply-add the compiler vectorizes.
+void predictLanes(double *const *state, double *const *covariance, std::size_t count, double dt, double density)
+{
+    const TransitionCoefficients transition = transitionCoefficients(dt);
+
+    for (std::size_t derivative = 0; derivative < 3; ++derivative)
+    {
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            const std::size_t row = derivative * 3 + axis;
+            double *out = state[row];
+            for (std::size_t higher = derivative + 1; higher < 3; ++higher)
+            {
+                const double coefficient = transition.byGap[higher - derivative];
+                const double *in = state[higher * 3 + axis];
+                for (std::size_t lane = 0; lane < count; ++lane)
+                {
+                    out[lane] += coefficient * in[lane];
+                }
+            }
+        }
+    }
+
+    for (std::size_t derivativeSum = 0; derivativeSum <= 4; ++derivativeSum)
+    {
+        for (std::size_t row = 0; row < kTrackStateDim; ++row)
+        {
+            for (std::size_t col = row; col < kTrackStateDim; ++col)
+            {
+                if (derivativeOf(row) + derivativeOf(col) != derivativeSum)
+                {
+                    continue;
+                }
+                double *out = covariance[TrackFilterBatch::covarianceIndex(row, col)];
+                for (std::size_t k = derivativeOf(row); k < 3; ++k)
+                {
+                    const std::size_t source = k * 3 + axisOf(row);
+                    const double rowCoefficient = transition.byGap[k - derivativeOf(row)];
+                    for (std::size_t l = derivativeOf(col); l < 3; ++l)
+                    {
+                        const std::size_t sourceCol = l * 3 + axisOf(col);
+                        if (source == row && sourceCol == col)
+                        {
+                            continue;
+                        }
+                        const double coefficient = rowCoefficient * transition.byGap[l - derivativeOf(col)];
+                        const double *in = covariance[TrackFilterBatch::covarianceIndex(source, sourceCol)];
+                        for (std::size_t lane = 0; lane < count; ++lane)
+                        {
+                            out[lane] += coefficient * in[lane];
+                        }
+                    }
+                }
+                const double noise = processNoise(row, col, dt, density);
+                if (noise != 0.0)
+                {
+                    for (std::size_t lane = 0; lane < count; ++lane)
+                    {
+                        out[lane] += noise;
+                    }
+                }
+            }
+        }
+    }
+}
+} // namespace
+
+TrackEstimate makeTrackEstimate(const State9 &state,
+                                double positionVariance,
+                                double velocityVariance,
+                                double accelerationVariance)
+{
+    TrackEstimate estimate;
+    const Vec3 components[3] = {state.position, state.velocity, state.acceleration};
+    const double variances[3] = {positionVariance, velocityVariance, accelerationVariance};
+    for (std::size_t derivative = 0; derivative < 3; ++derivative)
+    {
+        estimate.state(derivative * 3 + 0, 0) = components[derivative].x;
+        estimate.state(derivative * 3 + 1, 0) = components[derivative].y;
+        estimate.state(derivative * 3 + 2, 0) = components[derivative].z;
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            const std::size_t index = derivative * 3 + axis;
+            estimate.covariance(index, index) = variances[derivative];
+        }
+    }
+    estimate.time = state.time;
+    return estimate;
+}
+
+State9 trackState(const TrackEstimate &estimate)
+{
+    State9 state{};
+    state.position = {estimate.state(0, 0), estimate.state(1, 0), estimate.state(2, 0)};
+    state.velocity = {estimate.state(3, 0), estimate.state(4, 0), estimate.state(5, 0)};
+    state.acceleration = {estimate.state(6, 0), estimate.state(7, 0), estimate.state(8, 0)};
+    state.time = estimate.time;
+    return state;
+}
+
+void predictTrack(TrackEstimate &estimate, double dt, const TrackFilterConfig &config)
+{
+    // A one-lane run of the batch kernel, so single and batched predictions agree bit for bit.
+    double lanes[TrackFilterBatch::kCovarianceTerms];
+    double *stateLanes[kTrackStateDim];
+    double *covarianceLanes[TrackFilterBatch::kCovarianceTerms];
+    for (std::size_t row = 0; row < kTrackStateDim; ++row)
+    {
+        stateLanes[row] = &estimate.state.values[row];
+        for (std::size_t col = row; col < kTrackStateDim; ++col)
+        {
+            const std::size_t slot = TrackFilterBatch::covarianceIndex(row, col);
+            lanes[slot] = estimate.covariance(row, col);
+            covarianceLanes[slot] = &lanes[slot];
+        }
+    }
+    predictLanes(stateLanes, covarianceLanes, 1, dt, config.jerkSpectralDensity);
+    for (std::size_t row = 0; row < kTrackStateDim; ++row)
+    {
+        for (std::size_t col = row; col < kTrackStateDim; ++col)
+        {
+            const double value = lanes[TrackFilterBatch::covarianceIndex(row, col)];
+            estimate.covariance(row, col) = value;
+            estimate.covariance(col, row) = value;
+        }
+    }
+    estimate.time += dt;
+}
+
+bool GpsPositionModel::linearize(const TrackVector &state, const Observation &observation,
+                                 Vector<dim> &innovation, Matrix<dim, kTrackStateDim> &jacobian)
+{
+    innovation(0, 0) = observation.x - state(0, 0);
+    innovation(1, 0) = observation.y - state(1, 0);
+    innovation(2, 0) = observation.z - state(2, 0);
+    jacobian = Matrix<dim, kTrackStateDim>{};
+    jacobian(0, 0) = 1.0;
+    jacobian(1, 1) = 1.0;
+    jacobian(2, 2) = 1.0;
+    return true;
+}
+
+bool RadarRangeModel::linearize(const TrackVector &state, const Observation &observation,
+                                Vector<dim> &innovation, Matrix<dim, kTrackStateDim> &jacobian)
+{
+    const double x = state(0, 0);
+    const double y = state(1, 0);
+    const double z = state(2, 0);
+    const double range = std::sqrt(x * x + y * y + z * z);
+    if (!(range > kMinRange))
+    {
+        return false;
+    }
+    innovation(0, 0) = observation - range;
+    jacobian = Matrix<dim, kTrackStateDim>{};
+    jacobian(0, 0) = x / range;
+    jacobian(0, 1) = y / range;
+    jacobian(0, 2) = z / range;
+    return true;
+}
+
+bool BaroAltitudeModel::linearize(const TrackVector &state, const Observation &observation,
+                                  Vector<dim> &innovation, Matrix<dim, kTrackStateDim> &jacobian)
+{
+    innovation(0, 0) = observation - state(2, 0);
+    jacobian = Matrix<dim, kTrackStateDim>{};
+    jacobian(0, 2) = 1.0;
+    return true;
+}
+
+bool MagHeadingModel::linearize(const TrackVector &state, const Observation &observation,
+                                Vector<dim> &innovation, Matrix<dim, kTrackStateDim> &jacobian)
+{
+    const double vx = state(3, 0);
+    const double vy = state(4, 0);
+    const double speedSquared = vx * vx + vy * vy;
+    if (!(speedSquared > kMinSpeedSquared))
+    {
+        return false;
+    }
+    innovation(0, 0) = wrapAngle(observation - std::atan2(vy, vx));
+    jacobian = Matrix<dim, kTrackStateDim>{};
+    jacobian(0, 3) = -vy / speedSquared;
+    jacobian(0, 4) = vx / speedSquared;
+    return true;
+}
+
+std::size_t updateTrack(TrackEstimate &estimate,
+                        const Measurement &measurement,
+                        const TrackFilterConfig &config,
+                        double *logLikelihood)
+{
+    if (!measurement.valid)
+    {
+        return 0;
+    }
+    std::size_t applied = 0;
+    if (measurement.position && updateTrack<GpsPositionModel>(estimate, *measurement.position, config.positionStd, logLikelihood))
+    {
+        ++applied;
+    }
+    if (measurement.range && updateTrack<RadarRangeModel>(estimate, *measurement.range, config.rangeStd, logLikelihood))
+    {
+        ++applied;
+    }
+    if (measurement.altitude && updateTrack<BaroAltitudeModel>(estimate, *measurement.altitude, config.altitudeStd, logLikelihood))
+    {
+        ++applied;
+    }
+    if (measurement.heading && updateTrack<MagHeadingModel>(estimate, *measurement.heading, config.headingStd, logLikelihood))
+    {
+        ++applied;
+    }
+    return applied;
+}
+
+std::size_t TrackFilterBatch::size() const
+{
+    return time.size();
+}
+
+bool TrackFilterBatch::empty() const
+{
+    return time.empty();
+}
+
+void TrackFilterBatch::reserve(std::size_t count)
+{
+    for (auto &component : state)
+    {
+        component.reserve(count);
+    }
+    for (auto &entry : covariance)
+    {
+        entry.reserve(count);
+    }
+    time.reserve(count);
+}
+
+void TrackFilterBatch::resize(std::size_t count)
+{
+    for (auto &component : state)
+    {
+        component.resize(count, 0.0);
+    }
+    for (auto &entry : covariance)
+    {
+        entry.resize(count, 0.0);
+    }
+    time.resize(count, 0.0);
+}
+
+void TrackFilterBatch::clear()
+{
+    resize(0);
+}
+
+void TrackFilterBatch::push_back(const TrackEstimate &estimate)
+{
+    resize(size() + 1);
+    set(size() - 1, estimate);
+}
+
+TrackEstimate TrackFilterBatch::get(std::size_t index) const
+{
+    TrackEstimate estimate;
+    for (std::size_t row = 0; row < kTrackStateDim; ++row)
+    {
+        estimate.state(row, 0) = state[row][index];
+        for (std::size_t col = row; col < kTrackStateDim; ++col)
+        {
+            const double value = covariance[covarianceIndex(row, col)][index];
+            estimate.covariance(row, col) = value;
+            estimate.covariance(col, row) = value;
+        }
+    }
+    estimate.time = time[index];
+    return estimate;
+}
+
+void TrackFilterBatch::set(std::size_t index, const TrackEstimate &estimate)
+{
+    for (std::size_t row = 0; row < kTrackStateDim; ++row)
+    {
+        state[row][index] = estimate.state(row, 0);
+        for (std::size_t col = row; col < kTrackStateDim; ++col)
+        {
+            covariance[covarianceIndex(row, col)][index] = estimate.covariance(row, col);
+        }
+    }
+    time[index] = estimate.time;
+}
+
+void predictTracks(TrackFilterBatch &batch, double dt, const TrackFilterConfig &config)
+{
+    const std::size_t count = batch.size();
+    double *stateLanes[kTrackStateDim];
+    double *covarianceLanes[TrackFilterBatch::kCovarianceTerms];
+    for (std::size_t row = 0; row < kTrackStateDim; ++row)
+    {
+        stateLanes[row] = batch.state[row].data();
+    }
+    for (std::size_t slot = 0; slot < TrackFilterBatch::kCovarianceTerms; ++slot)
+    {
+        covarianceLanes[slot] = batch.covariance[slot].data();
+    }
+    predictLanes(stateLanes, covarianceLanes, count, dt, config.jerkSpectralDensity);
+    for (std::size_t lane = 0; lane < count; ++lane)
+    {
+        batch.time[lane] += dt;
+    }
+}
+
+std::size_t updateTracks(TrackFilterBatch &batch,
+                         const std::vector<Measurement> &measurements,
+                         const TrackFilterConfig &config)
+{
+    // Updates are sparse (only tracks that got a measurement this step), so each one is gathered
+    // into a stack TrackEstimate, run through the fixed-size update, and scattered back.
+    const std::size_t count = std::min(batch.size(), measurements.size());
+    std::size_t applied = 0;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const Measurement &measurement = measurements[index];
+        if (!measurement.valid)
+        {
+            continue;
+        }
+        TrackEstimate estimate = batch.get(index);
+        const std::size_t updates = updateTrack(estimate, measurement, config);
+        if (updates > 0)
+        {
+            batch.set(index, estimate);
+            applied += updates;
+        }
+    }
+    return applied;
+}
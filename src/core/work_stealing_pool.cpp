@@ -0,0 +1,133 @@
+#include "core/work_stealing_pool.h"
+
+WorkStealingPool::WorkStealingPool(std::size_t workerCount)
+    : workers(workerCount)
+{
+    if (workers <= 1)
+    {
+        return;
+    }
+    queues.reserve(workers);
+    for (std::size_t worker = 0; worker < workers; ++worker)
+    {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    threads.reserve(workers);
+    for (std::size_t worker = 0; worker < workers; ++worker)
+    {
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, worker);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+std::size_t WorkStealingPool::workerCount() const
+{
+    return workers;
+}
+
+void WorkStealingPool::parallelFor(std::size_t count, const Task &task)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (threads.empty())
+    {
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            task(index, 0);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        WorkerQueue &queue = *queues[index % workers];
+        std::lock_guard<std::mutex> queueLock(queue.mutex);
+        queue.items.push_back(index);
+    }
+    currentTask = &task;
+    remaining = count;
+    ++generation;
+    wake.notify_all();
+    finished.wait(lock, [this]() { return remaining == 0 && activeWorkers == 0; });
+    currentTask = nullptr;
+}
+
+bool WorkStealingPool::takeWork(std::size_t worker, std::size_t &index)
+{
+    {
+        WorkerQueue &own = *queues[worker];
+        std::lock_guard<std::mutex> queueLock(own.mutex);
+        if (!own.items.empty())
+        {
+            index = own.items.back();
+            own.items.pop_back();
+            return true;
+        }
+    }
+    for (std::size_t offset = 1; offset < workers; ++offset)
+    {
+        WorkerQueue &victim = *queues[(worker + offset) % workers];
+        std::lock_guard<std::mutex> queueLock(victim.mutex);
+        if (!victim.items.empty())
+        {
+            index = victim.items.front();
+            victim.items.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(std::size_t worker)
+{
+    std::uint64_t seenGeneration = 0;
+    while (true)
+    {
+        const Task *task = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            wake.wait(lock, [&]() { return stopping || generation != seenGeneration; });
+            if (stopping)
+            {
+                return;
+            }
+            seenGeneration = generation;
+            task = currentTask;
+            if (task == nullptr)
+            {
+                continue;
+            }
+            ++activeWorkers;
+        }
+
+        std::size_t index = 0;
+        std::size_t completed = 0;
+        while (takeWork(worker, index))
+        {
+            (*task)(index, worker);
+            ++completed;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            remaining -= completed;
+            --activeWorkers;
+        }
+        finished.notify_all();
+    }
+}
@@ -653,8 +653,7 @@ std::string defaultAllowlistPath()
 
 std::string computeHash(const std::string &content)
 {
-    std::vector<unsigned char> data(content.begin(), content.end());
-    return sha256Hex(data);
+    return sha256Hex(content.data(), content.size());
 }
 
 std::vector<AdapterUiField> filterFieldsForSurface(const std::vector<AdapterUiField> &fields, const std::string &surface)
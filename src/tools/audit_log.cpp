@@ -3,15 +3,31 @@
 #include "core/hash.h"
 #include "core/logging.h"
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <ctime>
 #include <filesystem>
+#include <initializer_list>
 #include <fstream>
 #include <iomanip>
 #include <mutex>
 #include <sstream>
+#include <string_view>
+#include <thread>
 #include <vector>
 
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace tools
 {
 namespace
@@ -30,37 +46,74 @@ struct AuditLogState
     std::string lastHash;
     std::string status = "uninitialized";
     bool healthy = false;
+
+    // Group-commit writer; records are rendered and hash-chained into `pending` under g_mutex, and
+    // the writer thread swaps the buffer out and appends it without the lock.
+    bool async = false;
+    bool syncEachCommit = false;
+    std::size_t groupCommitBytes = 0;
+    std::chrono::milliseconds groupCommitInterval{0};
+    bool flushRequested = false;
+    int fd = -1;
+    std::uint64_t fileBytes = 0;
+    std::string pending;
+    std::uint64_t acceptedRecords = 0;
+    std::uint64_t committedRecords = 0;
+    bool stopping = false;
+
+    // Rotation; with the async writer running, only the writer thread rotates, and producers only
+    // mark where in `pending` each new segment starts.
+    std::uint64_t rotateBytes = 0;
+    std::uint64_t segmentIndex = 0;
+    std::string lastManifestHash;
+    std::vector<std::size_t> pendingRotations;
+};
+
+struct SegmentManifestEntry
+{
+    std::uint64_t index = 0;
+    std::string segment;
+    std::uint64_t bytes = 0;
+    std::uint64_t records = 0;
+    std::string firstEntryHash;
+    std::string lastEntryHash;
+    std::string segmentSha256;
+    std::string prevManifestHash;
+    std::string manifestHash;
 };
 
 AuditLogState g_state{};
 std::mutex g_mutex;
+std::condition_variable g_writerWake;
+std::condition_variable g_committed;
+std::thread g_writer;
 
-std::string escapeJson(const std::string &value)
+void appendEscapedJson(std::string &out, const std::string &value)
 {
-    std::ostringstream out;
+    static const char kHex[] = "0123456789abcdef";
     for (char ch : value)
     {
         switch (ch)
         {
-        case '"': out << "\\\""; break;
-        case '\\': out << "\\\\"; break;
-        case '\n': out << "\\n"; break;
-        case '\r': out << "\\r"; break;
-        case '\t': out << "\\t"; break;
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
         default:
             if (static_cast<unsigned char>(ch) < 0x20)
             {
-                out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
-                    << static_cast<int>(static_cast<unsigned char>(ch));
+                out += "\\u00";
+                out.push_back(kHex[(static_cast<unsigned char>(ch) >> 4) & 0x0fU]);
+                out.push_back(kHex[static_cast<unsigned char>(ch) & 0x0fU]);
             }
             else
             {
-                out << ch;
+                out.push_back(ch);
             }
             break;
         }
     }
-    return out.str();
 }
 
 bool toUtcTm(std::time_t timestamp, std::tm &out)
@@ -101,8 +154,13 @@ std::string hashFileHex(const std::string &path)
     {
         return "unavailable";
     }
-    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    return sha256Hex(data);
+    Sha256 hasher;
+    std::vector<char> chunk(64 * 1024);
+    while (file.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || file.gcount() > 0)
+    {
+        hasher.update(chunk.data(), static_cast<std::size_t>(file.gcount()));
+    }
+    return hasher.finishHex();
 }
 
 bool ensureCapacity(const std::string &path)
@@ -121,32 +179,544 @@ bool ensureCapacity(const std::string &path)
 
 std::string makeRecord(const std::string &eventType, const std::string &message, const std::string &detail, const std::string &timestamp)
 {
-    std::ostringstream payload;
-    payload << eventType << "|" << message << "|" << detail << "|" << timestamp << "|"
-            << g_state.buildId << "|" << g_state.configId << "|" << g_state.configVersion << "|"
-            << g_state.runId << "|" << g_state.seed << "|" << g_state.role << "|" << g_state.lastHash;
-    std::string payloadStr = payload.str();
-    std::vector<unsigned char> data(payloadStr.begin(), payloadStr.end());
-    std::string entryHash = sha256Hex(data);
+    const std::string seedText = std::to_string(g_state.seed);
+    std::string payload;
+    payload.reserve(eventType.size() + message.size() + detail.size() + 256);
+    const std::initializer_list<const std::string *> payloadFields = {
+        &eventType, &message, &detail, &timestamp, &g_state.buildId, &g_state.configId,
+        &g_state.configVersion, &g_state.runId, &seedText, &g_state.role};
+    for (const std::string *field : payloadFields)
+    {
+        payload += *field;
+        payload.push_back('|');
+    }
+    payload += g_state.lastHash;
+    std::string entryHash = sha256Hex(payload.data(), payload.size());
 
-    std::ostringstream out;
-    out << "{\"ts\":\"" << escapeJson(timestamp) << "\","
-        << "\"event\":\"" << escapeJson(eventType) << "\","
-        << "\"message\":\"" << escapeJson(message) << "\","
-        << "\"detail\":\"" << escapeJson(detail) << "\","
-        << "\"build_id\":\"" << escapeJson(g_state.buildId) << "\","
-        << "\"config_id\":\"" << escapeJson(g_state.configId) << "\","
-        << "\"config_version\":\"" << escapeJson(g_state.configVersion) << "\","
-        << "\"run_id\":\"" << escapeJson(g_state.runId) << "\","
-        << "\"seed\":" << g_state.seed << ","
-        << "\"role\":\"" << escapeJson(g_state.role) << "\","
-        << "\"prev_hash\":\"" << escapeJson(g_state.lastHash) << "\","
-        << "\"entry_hash\":\"" << escapeJson(entryHash) << "\"}"
-        << "\n";
+    // Rendered with appends rather than streams: records are built under g_mutex on every event.
+    std::string out;
+    out.reserve(payload.size() + 384);
+    auto field = [&out](const char *name, const std::string &value) {
+        out += name;
+        appendEscapedJson(out, value);
+        out += "\",";
+    };
+    out += "{";
+    field("\"ts\":\"", timestamp);
+    field("\"event\":\"", eventType);
+    field("\"message\":\"", message);
+    field("\"detail\":\"", detail);
+    field("\"build_id\":\"", g_state.buildId);
+    field("\"config_id\":\"", g_state.configId);
+    field("\"config_version\":\"", g_state.configVersion);
+    field("\"run_id\":\"", g_state.runId);
+    out += "\"seed\":";
+    out += seedText;
+    out += ",";
+    field("\"role\":\"", g_state.role);
+    field("\"prev_hash\":\"", g_state.lastHash);
+    out += "\"entry_hash\":\"";
+    appendEscapedJson(out, entryHash);
+    out += "\"}\n";
     g_state.lastHash = entryHash;
-    return out.str();
+    return out;
+}
+
+std::string segmentPath(const std::string &path, std::uint64_t index)
+{
+    std::string digits = std::to_string(index);
+    if (digits.size() < 6)
+    {
+        digits.insert(0, 6 - digits.size(), '0');
+    }
+    return path + "." + digits;
+}
+
+std::string manifestPath(const std::string &path)
+{
+    return path + ".manifest";
+}
+
+// Value of `"name":"..."` in one of our own records; they never escape a hash or file name.
+std::string stringField(const std::string &line, const std::string &name)
+{
+    const std::string marker = "\"" + name + "\":\"";
+    const std::size_t begin = line.find(marker);
+    if (begin == std::string::npos)
+    {
+        return std::string();
+    }
+    const std::size_t valueBegin = begin + marker.size();
+    const std::size_t end = line.find('"', valueBegin);
+    return end == std::string::npos ? std::string() : line.substr(valueBegin, end - valueBegin);
+}
+
+bool numberField(const std::string &line, const std::string &name, std::uint64_t &value)
+{
+    const std::string marker = "\"" + name + "\":";
+    const std::size_t begin = line.find(marker);
+    if (begin == std::string::npos)
+    {
+        return false;
+    }
+    std::size_t pos = begin + marker.size();
+    if (pos >= line.size() || line[pos] < '0' || line[pos] > '9')
+    {
+        return false;
+    }
+    value = 0;
+    for (; pos < line.size() && line[pos] >= '0' && line[pos] <= '9'; ++pos)
+    {
+        value = value * 10U + static_cast<std::uint64_t>(line[pos] - '0');
+    }
+    return true;
+}
+
+std::string computeManifestHash(const SegmentManifestEntry &entry)
+{
+    const std::string payload = std::to_string(entry.index) + "|" + entry.segment + "|" + std::to_string(entry.bytes) +
+                                "|" + std::to_string(entry.records) + "|" + entry.firstEntryHash + "|" +
+                                entry.lastEntryHash + "|" + entry.segmentSha256 + "|" + entry.prevManifestHash;
+    return sha256Hex(payload.data(), payload.size());
+}
+
+std::string renderManifestEntry(const SegmentManifestEntry &entry)
+{
+    return "{\"segment_index\":" + std::to_string(entry.index) + ",\"segment\":\"" + entry.segment +
+           "\",\"bytes\":" + std::to_string(entry.bytes) + ",\"records\":" + std::to_string(entry.records) +
+           ",\"first_entry_hash\":\"" + entry.firstEntryHash + "\",\"last_entry_hash\":\"" + entry.lastEntryHash +
+           "\",\"segment_sha256\":\"" + entry.segmentSha256 + "\",\"prev_manifest_hash\":\"" +
+           entry.prevManifestHash + "\",\"manifest_hash\":\"" + entry.manifestHash + "\"}\n";
+}
+
+bool parseManifestEntry(const std::string &line, SegmentManifestEntry &entry)
+{
+    entry.segment = stringField(line, "segment");
+    entry.firstEntryHash = stringField(line, "first_entry_hash");
+    entry.lastEntryHash = stringField(line, "last_entry_hash");
+    entry.segmentSha256 = stringField(line, "segment_sha256");
+    entry.prevManifestHash = stringField(line, "prev_manifest_hash");
+    entry.manifestHash = stringField(line, "manifest_hash");
+    return numberField(line, "segment_index", entry.index) && numberField(line, "bytes", entry.bytes) &&
+           numberField(line, "records", entry.records) && !entry.segment.empty() && !entry.manifestHash.empty();
+}
+
+// Reads a string value from `pos` (just past its opening quote) up to its closing quote, undoing
+// appendEscapedJson, and leaves pos after the quote.
+bool readEscapedJson(const std::string &line, std::size_t &pos, std::string &value)
+{
+    value.clear();
+    while (pos < line.size())
+    {
+        const char ch = line[pos++];
+        if (ch == '"')
+        {
+            return true;
+        }
+        if (ch != '\\')
+        {
+            value.push_back(ch);
+            continue;
+        }
+        if (pos >= line.size())
+        {
+            return false;
+        }
+        switch (line[pos++])
+        {
+        case '"': value.push_back('"'); break;
+        case '\\': value.push_back('\\'); break;
+        case 'n': value.push_back('\n'); break;
+        case 'r': value.push_back('\r'); break;
+        case 't': value.push_back('\t'); break;
+        case 'u':
+        {
+            if (pos + 4 > line.size() || line.compare(pos, 2, "00") != 0)
+            {
+                return false;
+            }
+            static const std::string kHex = "0123456789abcdef";
+            const std::size_t high = kHex.find(line[pos + 2]);
+            const std::size_t low = kHex.find(line[pos + 3]);
+            if (high == std::string::npos || low == std::string::npos)
+            {
+                return false;
+            }
+            value.push_back(static_cast<char>((high << 4U) | low));
+            pos += 4;
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return false;
+}
+
+// Rebuilds the payload makeRecord hashed for one of our records, from fields in the order it
+// writes them.
+bool recordPayload(const std::string &line, std::string &payload, std::string &entryHash)
+{
+    enum Field { Ts, Event, Message, Detail, BuildId, ConfigId, ConfigVersion, RunId, Seed, Role, PrevHash, EntryHash, Count };
+    static const char *const kNames[Count] = {"ts", "event", "message", "detail", "build_id", "config_id",
+                                              "config_version", "run_id", "seed", "role", "prev_hash", "entry_hash"};
+    std::string values[Count];
+    std::size_t pos = 1;
+    if (line.empty() || line[0] != '{')
+    {
+        return false;
+    }
+    for (int field = 0; field < Count; ++field)
+    {
+        const std::string marker = std::string("\"") + kNames[field] + "\":";
+        if (line.compare(pos, marker.size(), marker) != 0)
+        {
+            return false;
+        }
+        pos += marker.size();
+        if (field == Seed)
+        {
+            const std::size_t digits = pos;
+            while (pos < line.size() && line[pos] >= '0' && line[pos] <= '9')
+            {
+                ++pos;
+            }
+            values[field] = line.substr(digits, pos - digits);
+        }
+        else if (pos >= line.size() || line[pos++] != '"' || !readEscapedJson(line, pos, values[field]))
+        {
+            return false;
+        }
+        if (pos >= line.size() || line[pos++] != (field + 1 == Count ? '}' : ','))
+        {
+            return false;
+        }
+    }
+    payload.clear();
+    for (int field : {Event, Message, Detail, Ts, BuildId, ConfigId, ConfigVersion, RunId, Seed, Role})
+    {
+        payload += values[field];
+        payload.push_back('|');
+    }
+    payload += values[PrevHash];
+    entryHash = values[EntryHash];
+    return pos == line.size();
+}
+
+// Fills everything but the index, name, and manifest chain from the segment's bytes. When asked,
+// chainIntact reports whether every record's entry_hash matches its contents (rehashed in one
+// multi-buffer batch) and its prev_hash the entry_hash before it, which for the first record is
+// prevEntryHash (the previous segment's last entry_hash). Only an audit_start record with an empty
+// prev_hash, as initializeAuditLog writes, may begin a new chain.
+bool describeSegment(const std::string &path,
+                     SegmentManifestEntry &entry,
+                     bool *chainIntact,
+                     const std::string &prevEntryHash = std::string())
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    const std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    entry.bytes = data.size();
+    entry.records = 0;
+    entry.segmentSha256 = sha256Hex(data.data(), data.size());
+    entry.firstEntryHash.clear();
+    entry.lastEntryHash.clear();
+    std::vector<std::string> payloads;
+    std::vector<std::string> recordedHashes;
+    bool intact = true;
+    std::size_t begin = 0;
+    while (begin < data.size())
+    {
+        std::size_t end = begin;
+        while (end < data.size() && data[end] != '\n')
+        {
+            ++end;
+        }
+        const std::string line(data.begin() + static_cast<std::ptrdiff_t>(begin), data.begin() + static_cast<std::ptrdiff_t>(end));
+        begin = end + 1;
+        if (line.empty())
+        {
+            continue;
+        }
+        const std::string entryHash = stringField(line, "entry_hash");
+        if (chainIntact != nullptr)
+        {
+            const std::string prevHash = stringField(line, "prev_hash");
+            const bool chainStart = prevHash.empty() && stringField(line, "event") == "audit_start";
+            if (!chainStart && prevHash != (entry.records > 0 ? entry.lastEntryHash : prevEntryHash))
+            {
+                intact = false;
+            }
+            payloads.emplace_back();
+            recordedHashes.emplace_back();
+            if (!recordPayload(line, payloads.back(), recordedHashes.back()))
+            {
+                intact = false;
+            }
+        }
+        if (entry.records == 0)
+        {
+            entry.firstEntryHash = entryHash;
+        }
+        entry.lastEntryHash = entryHash;
+        ++entry.records;
+    }
+    if (chainIntact != nullptr)
+    {
+        const std::vector<std::string_view> messages(payloads.begin(), payloads.end());
+        const std::vector<Sha256::Digest> digests = sha256Batch(messages);
+        for (std::size_t idx = 0; idx < digests.size() && intact; ++idx)
+        {
+            intact = sha256DigestHex(digests[idx]) == recordedHashes[idx];
+        }
+        *chainIntact = intact;
+    }
+    return true;
+}
+
+// Picks up the segment numbering and manifest chain a previous run left behind.
+void loadManifestTail()
+{
+    g_state.segmentIndex = 0;
+    g_state.lastManifestHash.clear();
+    std::ifstream manifest(manifestPath(g_state.path));
+    SegmentManifestEntry entry;
+    for (std::string line; std::getline(manifest, line);)
+    {
+        if (parseManifestEntry(line, entry))
+        {
+            g_state.segmentIndex = entry.index;
+            g_state.lastManifestHash = entry.manifestHash;
+        }
+    }
+}
+
+// Renames the active log to the next segment and appends its manifest entry. Refuses to overwrite
+// an existing segment file, so a lost manifest fails closed instead of reusing numbers.
+bool rotateSegment()
+{
+    SegmentManifestEntry entry;
+    entry.index = g_state.segmentIndex + 1;
+    const std::string target = segmentPath(g_state.path, entry.index);
+    std::error_code ec;
+    if (std::filesystem::exists(target, ec))
+    {
+        return false;
+    }
+    if (!describeSegment(g_state.path, entry, nullptr))
+    {
+        return false;
+    }
+    entry.segment = std::filesystem::path(target).filename().string();
+    entry.prevManifestHash = g_state.lastManifestHash;
+    entry.manifestHash = computeManifestHash(entry);
+    std::filesystem::rename(g_state.path, target, ec);
+    if (ec)
+    {
+        return false;
+    }
+    std::ofstream manifest(manifestPath(g_state.path), std::ios::app | std::ios::binary);
+    manifest << renderManifestEntry(entry);
+    if (!manifest.flush())
+    {
+        return false;
+    }
+    g_state.segmentIndex = entry.index;
+    g_state.lastManifestHash = entry.manifestHash;
+    return true;
+}
+
+// Synchronous writes: rotates when `incomingBytes` would take the log past rotateBytes.
+bool rotateIfFull(std::uint64_t incomingBytes)
+{
+    std::error_code ec;
+    const std::uint64_t size = std::filesystem::exists(g_state.path, ec) ? std::filesystem::file_size(g_state.path, ec) : 0U;
+    if (ec || size == 0 || size + incomingBytes <= g_state.rotateBytes)
+    {
+        return true;
+    }
+    return rotateSegment();
+}
+
+int openAppend(const std::string &path)
+{
+#if defined(_WIN32)
+    return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+}
+
+void closeFile(int fd)
+{
+    if (fd < 0)
+    {
+        return;
+    }
+#if defined(_WIN32)
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+bool writeAll(int fd, const char *data, std::size_t size)
+{
+    std::size_t written = 0;
+    while (written < size)
+    {
+#if defined(_WIN32)
+        const int result = _write(fd, data + written, static_cast<unsigned int>(size - written));
+#else
+        const ssize_t result = ::write(fd, data + written, size - written);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+#endif
+        if (result <= 0)
+        {
+            return false;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    return true;
+}
+
+bool syncFile(int fd)
+{
+#if defined(_WIN32)
+    return _commit(fd) == 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
 }
 
+void writerLoop()
+{
+    std::string batch;
+    std::vector<std::size_t> rotations;
+    std::unique_lock<std::mutex> lock(g_mutex);
+    while (true)
+    {
+        g_writerWake.wait(lock, []() { return !g_state.pending.empty() || g_state.stopping; });
+        if (g_state.pending.empty())
+        {
+            break;
+        }
+        // Let the group fill rather than waking once per record.
+        (void)g_writerWake.wait_for(lock, g_state.groupCommitInterval, []() {
+            return g_state.pending.size() >= g_state.groupCommitBytes || g_state.flushRequested || g_state.stopping;
+        });
+        g_state.flushRequested = false;
+        batch.clear();
+        batch.swap(g_state.pending);
+        rotations.clear();
+        rotations.swap(g_state.pendingRotations);
+        const std::uint64_t target = g_state.acceptedRecords;
+        int fd = g_state.fd;
+        const bool sync = g_state.syncEachCommit;
+        lock.unlock();
+        bool ok = true;
+        const char *status = "write_failed";
+        std::size_t begin = 0;
+        for (std::size_t boundary : rotations)
+        {
+            ok = writeAll(fd, batch.data() + begin, boundary - begin) && (!sync || syncFile(fd));
+            if (!ok)
+            {
+                break;
+            }
+            closeFile(fd);
+            fd = -1;
+            if (!rotateSegment())
+            {
+                ok = false;
+                status = "rotation_failed";
+                break;
+            }
+            fd = openAppend(g_state.path);
+            ok = fd >= 0;
+            if (!ok)
+            {
+                break;
+            }
+            begin = boundary;
+        }
+        ok = ok && writeAll(fd, batch.data() + begin, batch.size() - begin) && (!sync || syncFile(fd));
+        lock.lock();
+        g_state.fd = fd;
+        g_state.committedRecords = target;
+        if (!ok)
+        {
+            g_state.healthy = false;
+            g_state.status = status;
+        }
+        g_committed.notify_all();
+    }
+}
+
+// Caller holds g_mutex and has stopped any previous writer.
+bool startAsyncWriter(const AuditLogConfig &config)
+{
+    g_state.fd = openAppend(g_state.path);
+    if (g_state.fd < 0)
+    {
+        return false;
+    }
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(g_state.path, ec);
+    g_state.fileBytes = ec ? 0U : static_cast<std::uint64_t>(size);
+    g_state.async = true;
+    g_state.syncEachCommit = config.syncEachCommit;
+    g_state.groupCommitBytes = std::max<std::size_t>(config.groupCommitBytes, 1);
+    g_state.groupCommitInterval = std::chrono::milliseconds(config.groupCommitIntervalMs);
+    g_state.flushRequested = false;
+    g_state.pending.clear();
+    g_state.pendingRotations.clear();
+    g_state.acceptedRecords = 0;
+    g_state.committedRecords = 0;
+    g_state.stopping = false;
+    g_writer = std::thread(writerLoop);
+    return true;
+}
+
+// Drains pending records and joins the writer; the caller must not hold g_mutex.
+void stopAsyncWriter()
+{
+    std::thread writer;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (!g_writer.joinable())
+        {
+            return;
+        }
+        g_state.stopping = true;
+        writer = std::move(g_writer);
+    }
+    g_writerWake.notify_one();
+    writer.join();
+    std::lock_guard<std::mutex> lock(g_mutex);
+    closeFile(g_state.fd);
+    g_state.fd = -1;
+    g_state.async = false;
+    g_state.stopping = false;
+}
+
+// Declared after the state it drains, so it is destroyed first at exit.
+struct AsyncWriterShutdown
+{
+    ~AsyncWriterShutdown()
+    {
+        stopAsyncWriter();
+    }
+};
+
+AsyncWriterShutdown g_writerShutdown{};
+
 class AuditLogSink final : public LogSink
 {
 public:
@@ -162,6 +732,7 @@ AuditLogSink g_sink{};
 
 bool initializeAuditLog(const AuditLogConfig &config, std::string &status)
 {
+    stopAsyncWriter();
     std::lock_guard<std::mutex> lock(g_mutex);
     g_state.path = config.logPath;
     g_state.buildId = config.buildId.empty() ? "unknown" : config.buildId;
@@ -179,8 +750,21 @@ bool initializeAuditLog(const AuditLogConfig &config, std::string &status)
         g_state.runId = config.runId;
     }
     g_state.lastHash.clear();
+    g_state.rotateBytes = std::min<std::uint64_t>(config.rotateBytes, kMaxAuditBytes);
 
-    if (!ensureCapacity(g_state.path))
+    if (g_state.rotateBytes > 0)
+    {
+        loadManifestTail();
+        if (!rotateIfFull(1))
+        {
+            g_state.healthy = false;
+            g_state.status = "rotation_failed";
+            status = g_state.status;
+            setLogSink(nullptr);
+            return false;
+        }
+    }
+    else if (!ensureCapacity(g_state.path))
     {
         g_state.healthy = false;
         g_state.status = "retention_exceeded";
@@ -206,6 +790,15 @@ bool initializeAuditLog(const AuditLogConfig &config, std::string &status)
 
     std::string record = makeRecord("audit_start", "audit log initialized", "", timestamp);
     out << record;
+    out.close();
+    if (config.asyncWrites && !startAsyncWriter(config))
+    {
+        g_state.healthy = false;
+        g_state.status = "unavailable";
+        status = g_state.status;
+        setLogSink(nullptr);
+        return false;
+    }
     return true;
 }
 
@@ -216,12 +809,47 @@ bool logAuditEvent(const std::string &eventType, const std::string &message, con
     {
         return false;
     }
-    if (!ensureCapacity(g_state.path))
+    if (g_state.async)
+    {
+        // Same retention rule as ensureCapacity(), applied to the bytes accepted so far.
+        if (g_state.rotateBytes == 0 && g_state.fileBytes >= kMaxAuditBytes)
+        {
+            g_state.healthy = false;
+            g_state.status = "retention_exceeded";
+            return false;
+        }
+        const bool groupOpened = g_state.pending.empty();
+        const std::string record = makeRecord(eventType, message, detail, utcTimestamp());
+        if (g_state.rotateBytes > 0 && g_state.fileBytes > 0 && g_state.fileBytes + record.size() > g_state.rotateBytes)
+        {
+            g_state.pendingRotations.push_back(g_state.pending.size());
+            g_state.fileBytes = 0;
+        }
+        g_state.pending += record;
+        g_state.fileBytes += record.size();
+        ++g_state.acceptedRecords;
+        const bool groupFull =
+            g_state.pending.size() >= g_state.groupCommitBytes && g_state.pending.size() - record.size() < g_state.groupCommitBytes;
+        if (groupOpened || groupFull)
+        {
+            g_writerWake.notify_one();
+        }
+        return true;
+    }
+    if (g_state.rotateBytes == 0 && !ensureCapacity(g_state.path))
     {
         g_state.healthy = false;
         g_state.status = "retention_exceeded";
         return false;
     }
+    const std::string timestamp = utcTimestamp();
+    std::string record = makeRecord(eventType, message, detail, timestamp);
+    if (g_state.rotateBytes > 0 && !rotateIfFull(record.size()))
+    {
+        g_state.healthy = false;
+        g_state.status = "rotation_failed";
+        return false;
+    }
     std::ofstream out(g_state.path, std::ios::app);
     if (!out)
     {
@@ -229,13 +857,86 @@ bool logAuditEvent(const std::string &eventType, const std::string &message, con
         g_state.status = "write_failed";
         return false;
     }
-
-    const std::string timestamp = utcTimestamp();
-    std::string record = makeRecord(eventType, message, detail, timestamp);
     out << record;
     return true;
 }
 
+bool flushAuditLog()
+{
+    std::unique_lock<std::mutex> lock(g_mutex);
+    if (g_state.async)
+    {
+        const std::uint64_t target = g_state.acceptedRecords;
+        if (g_state.committedRecords < target)
+        {
+            g_state.flushRequested = true;
+            g_writerWake.notify_one();
+        }
+        g_committed.wait(lock, [target]() { return g_state.committedRecords >= target; });
+    }
+    return g_state.healthy;
+}
+
+bool verifyAuditLogSegments(const std::string &logPath, std::string &error)
+{
+    std::ifstream manifest(manifestPath(logPath));
+    if (!manifest)
+    {
+        return true;
+    }
+    const std::filesystem::path directory = std::filesystem::path(logPath).parent_path();
+    std::string prevManifestHash;
+    std::string prevEntryHash;
+    std::uint64_t expectedIndex = 1;
+    for (std::string line; std::getline(manifest, line);)
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+        SegmentManifestEntry recorded;
+        if (!parseManifestEntry(line, recorded))
+        {
+            error = "manifest entry " + std::to_string(expectedIndex) + " malformed";
+            return false;
+        }
+        const std::string where = "segment " + std::to_string(expectedIndex) + ": ";
+        if (recorded.index != expectedIndex)
+        {
+            error = where + "index out of sequence";
+            return false;
+        }
+        if (recorded.prevManifestHash != prevManifestHash || computeManifestHash(recorded) != recorded.manifestHash)
+        {
+            error = where + "manifest chain broken";
+            return false;
+        }
+        SegmentManifestEntry actual;
+        bool chainIntact = true;
+        if (!describeSegment((directory / recorded.segment).string(), actual, &chainIntact, prevEntryHash))
+        {
+            error = where + "missing " + recorded.segment;
+            return false;
+        }
+        if (actual.bytes != recorded.bytes || actual.records != recorded.records ||
+            actual.segmentSha256 != recorded.segmentSha256 || actual.firstEntryHash != recorded.firstEntryHash ||
+            actual.lastEntryHash != recorded.lastEntryHash)
+        {
+            error = where + "contents differ from manifest";
+            return false;
+        }
+        if (!chainIntact)
+        {
+            error = where + "record chain broken";
+            return false;
+        }
+        prevManifestHash = recorded.manifestHash;
+        prevEntryHash = recorded.lastEntryHash;
+        ++expectedIndex;
+    }
+    return true;
+}
+
 void setAuditRole(const std::string &role)
 {
     std::lock_guard<std::mutex> lock(g_mutex);
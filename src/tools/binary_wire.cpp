@@ -0,0 +1,170 @@
+#include "tools/binary_wire.h"
+
+#include <cstring>
+
+namespace tools
+{
+BinaryWriter::BinaryWriter(std::string &out)
+    : out(out)
+{
+}
+
+void BinaryWriter::bytes(std::string_view data)
+{
+    out.append(data.data(), data.size());
+}
+
+void BinaryWriter::byte(std::uint8_t value)
+{
+    out.push_back(static_cast<char>(value));
+}
+
+void BinaryWriter::varint(std::uint64_t value)
+{
+    while (value >= 0x80U)
+    {
+        out.push_back(static_cast<char>((value & 0x7fU) | 0x80U));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void BinaryWriter::zigzag(std::int64_t value)
+{
+    varint((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+void BinaryWriter::real(double value)
+{
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    char raw[8];
+    for (int idx = 0; idx < 8; ++idx)
+    {
+        raw[idx] = static_cast<char>((bits >> (8 * idx)) & 0xffU);
+    }
+    out.append(raw, sizeof(raw));
+}
+
+void BinaryWriter::text(std::string_view value)
+{
+    varint(value.size());
+    out.append(value.data(), value.size());
+}
+
+BinaryReader::BinaryReader(std::string_view in)
+    : in(in)
+{
+}
+
+bool BinaryReader::bytes(std::size_t count, std::string_view &out)
+{
+    if (count > in.size() - pos)
+    {
+        ranOut = true;
+        return false;
+    }
+    out = in.substr(pos, count);
+    pos += count;
+    return true;
+}
+
+bool BinaryReader::byte(std::uint8_t &value)
+{
+    if (pos >= in.size())
+    {
+        ranOut = true;
+        return false;
+    }
+    value = static_cast<std::uint8_t>(in[pos++]);
+    return true;
+}
+
+bool BinaryReader::varint(std::uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        std::uint8_t part = 0;
+        if (!byte(part))
+        {
+            return false;
+        }
+        // Only minimal encodings are accepted, so every value has exactly one byte form; the tenth
+        // byte may only carry the top bit of a 64-bit value.
+        if ((shift > 0 && part == 0U) || (shift == 63 && part > 1U))
+        {
+            return false;
+        }
+        value |= static_cast<std::uint64_t>(part & 0x7fU) << shift;
+        if ((part & 0x80U) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BinaryReader::zigzag(std::int64_t &value)
+{
+    std::uint64_t encoded = 0;
+    if (!varint(encoded))
+    {
+        return false;
+    }
+    value = static_cast<std::int64_t>(encoded >> 1) ^ -static_cast<std::int64_t>(encoded & 1U);
+    return true;
+}
+
+bool BinaryReader::real(double &value)
+{
+    std::string_view raw;
+    if (!bytes(8, raw))
+    {
+        return false;
+    }
+    std::uint64_t bits = 0;
+    for (int idx = 0; idx < 8; ++idx)
+    {
+        bits |= static_cast<std::uint64_t>(static_cast<unsigned char>(raw[idx])) << (8 * idx);
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+bool BinaryReader::text(std::string_view &value)
+{
+    std::uint64_t length = 0;
+    if (!varint(length))
+    {
+        return false;
+    }
+    if (length > remaining())
+    {
+        ranOut = true;
+        return false;
+    }
+    return bytes(static_cast<std::size_t>(length), value);
+}
+
+bool BinaryReader::text(std::string &value)
+{
+    std::string_view view;
+    if (!text(view))
+    {
+        return false;
+    }
+    value.assign(view.data(), view.size());
+    return true;
+}
+
+std::size_t BinaryReader::remaining() const
+{
+    return in.size() - pos;
+}
+
+bool BinaryReader::truncated() const
+{
+    return ranOut;
+}
+} // namespace tools
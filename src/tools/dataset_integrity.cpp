@@ -0,0 +1,208 @@
+#include "tools/dataset_integrity.h"
+
+#include "core/hash.h"
+#include "core/work_stealing_pool.h"
+#include "tools/mapped_file.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <system_error>
+
+namespace tools
+{
+namespace
+{
+constexpr std::size_t kMaxChunkKiB = 1024 * 1024;
+
+struct HashPlan
+{
+    std::string_view bytes;
+    // 0 for a whole-file digest.
+    std::size_t chunkBytes = 0;
+    std::vector<Sha256::Digest> digests;
+};
+
+struct HashTask
+{
+    std::size_t plan = 0;
+    std::size_t chunk = 0;
+    std::size_t offset = 0;
+    std::size_t size = 0;
+};
+
+bool isHexDigit(char value)
+{
+    return (value >= '0' && value <= '9') || (value >= 'a' && value <= 'f') || (value >= 'A' && value <= 'F');
+}
+
+// Splits an expected hash into its chunk size (0 for whole-file) and hex digest.
+bool parseExpectedHash(const std::string &text, std::size_t &chunkBytes, std::string &hex)
+{
+    if (text.compare(0, kDatasetChunkedHashPrefix.size(), kDatasetChunkedHashPrefix) != 0)
+    {
+        chunkBytes = 0;
+        hex = text;
+        return true;
+    }
+    std::size_t pos = kDatasetChunkedHashPrefix.size();
+    std::size_t chunkKiB = 0;
+    const std::size_t digitsStart = pos;
+    while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+    {
+        chunkKiB = chunkKiB * 10 + static_cast<std::size_t>(text[pos] - '0');
+        if (chunkKiB > kMaxChunkKiB)
+        {
+            return false;
+        }
+        ++pos;
+    }
+    if (pos == digitsStart || chunkKiB == 0 || pos >= text.size() || text[pos] != ':')
+    {
+        return false;
+    }
+    hex = text.substr(pos + 1);
+    if (hex.size() != 64 || !std::all_of(hex.begin(), hex.end(), isHexDigit))
+    {
+        return false;
+    }
+    chunkBytes = chunkKiB * 1024;
+    return true;
+}
+
+// Hashes every plan's chunks on a pool of at most one worker per task, largest tasks first so no
+// worker is left with a big one at the end, and returns each plan's hex digest.
+std::vector<std::string> hashPlans(std::vector<HashPlan> &plans, std::size_t workers)
+{
+    std::vector<HashTask> tasks;
+    for (std::size_t planIdx = 0; planIdx < plans.size(); ++planIdx)
+    {
+        HashPlan &plan = plans[planIdx];
+        const std::size_t size = plan.bytes.size();
+        if (plan.chunkBytes == 0)
+        {
+            plan.digests.resize(1);
+            tasks.push_back({planIdx, 0, 0, size});
+            continue;
+        }
+        plan.digests.resize((size + plan.chunkBytes - 1) / plan.chunkBytes);
+        for (std::size_t chunk = 0; chunk < plan.digests.size(); ++chunk)
+        {
+            const std::size_t offset = chunk * plan.chunkBytes;
+            tasks.push_back({planIdx, chunk, offset, std::min(plan.chunkBytes, size - offset)});
+        }
+    }
+    std::stable_sort(tasks.begin(), tasks.end(), [](const HashTask &lhs, const HashTask &rhs) {
+        return lhs.size > rhs.size;
+    });
+
+    WorkStealingPool pool(std::min(workers, tasks.size()));
+    pool.parallelFor(tasks.size(), [&](std::size_t index, std::size_t) {
+        const HashTask &task = tasks[index];
+        HashPlan &plan = plans[task.plan];
+        Sha256 hasher;
+        hasher.update(plan.bytes.data() + task.offset, task.size);
+        plan.digests[task.chunk] = hasher.finish();
+    });
+
+    std::vector<std::string> hashes;
+    hashes.reserve(plans.size());
+    for (const HashPlan &plan : plans)
+    {
+        if (plan.chunkBytes == 0)
+        {
+            hashes.push_back(sha256DigestHex(plan.digests.front()));
+            continue;
+        }
+        Sha256 root;
+        for (const Sha256::Digest &digest : plan.digests)
+        {
+            root.update(digest.data(), digest.size());
+        }
+        hashes.push_back(root.finishHex());
+    }
+    return hashes;
+}
+} // namespace
+
+DatasetIntegrityResult verifyDatasetFiles(const std::vector<DatasetFile> &files, const DatasetIntegrityOptions &options)
+{
+    DatasetIntegrityResult result;
+    std::vector<HashPlan> plans(files.size());
+    std::vector<std::string> expected(files.size());
+    // Sizes come from the directory entries, so an oversized dataset is rejected before any file is
+    // opened or mapped.
+    for (std::size_t idx = 0; idx < files.size(); ++idx)
+    {
+        const DatasetFile &file = files[idx];
+        std::error_code ec;
+        const std::uintmax_t size = std::filesystem::file_size(file.path, ec);
+        if (ec)
+        {
+            result.message = file.label + " unable to open";
+            return result;
+        }
+        if (size == 0)
+        {
+            result.message = file.label + " is empty";
+            return result;
+        }
+        if (!parseExpectedHash(file.expectedHash, plans[idx].chunkBytes, expected[idx]))
+        {
+            result.message = file.label + " hash format invalid";
+            return result;
+        }
+        result.totalBytes += size;
+    }
+
+    if (options.maxSizeMB > 0.0)
+    {
+        const double totalSizeMB = static_cast<double>(result.totalBytes) / (1024.0 * 1024.0);
+        if (totalSizeMB > options.maxSizeMB)
+        {
+            result.message = "dataset size exceeds limit";
+            return result;
+        }
+    }
+
+    std::vector<std::unique_ptr<MappedFile>> mapped;
+    mapped.reserve(files.size());
+    for (std::size_t idx = 0; idx < files.size(); ++idx)
+    {
+        mapped.push_back(std::make_unique<MappedFile>());
+        if (mapped.back()->open(files[idx].path) != MappedFileStatus::Ok)
+        {
+            result.message = files[idx].label + " unable to open";
+            return result;
+        }
+        plans[idx].bytes = mapped.back()->bytes();
+        // Truncated since it was sized.
+        if (plans[idx].bytes.empty())
+        {
+            result.message = files[idx].label + " is empty";
+            return result;
+        }
+    }
+
+    const std::vector<std::string> actual = hashPlans(plans, options.workers);
+    for (std::size_t idx = 0; idx < files.size(); ++idx)
+    {
+        if (!hashEquals(expected[idx], actual[idx]))
+        {
+            result.message = files[idx].label + " hash mismatch";
+            return result;
+        }
+    }
+    result.ok = true;
+    return result;
+}
+
+std::string chunkedDatasetHash(std::string_view bytes, std::size_t chunkKiB, std::size_t workers)
+{
+    chunkKiB = std::min(std::max<std::size_t>(chunkKiB, 1), kMaxChunkKiB);
+    std::vector<HashPlan> plans(1);
+    plans.front().bytes = bytes;
+    plans.front().chunkBytes = chunkKiB * 1024;
+    return std::string(kDatasetChunkedHashPrefix) + std::to_string(chunkKiB) + ":" + hashPlans(plans, workers).front();
+}
+} // namespace tools
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "tools/audit_log.h"
+#include "tools/binary_wire.h"
 #include "tools/io_packager.h"
 
 namespace tools
@@ -38,13 +39,13 @@ bool isValidToken(const std::string &value)
     return true;
 }
 
-std::string deriveSourceId(const ExternalIoEnvelope &envelope)
+// Writes into a caller-held buffer so steady-state publishes reuse its capacity.
+void deriveSourceId(const ExternalIoEnvelope &envelope, std::string &sourceId)
 {
-    if (!envelope.frontView.sourceId.empty())
-    {
-        return toLower(envelope.frontView.sourceId);
-    }
-    return toLower(envelope.mode.activeMode);
+    sourceId = envelope.frontView.sourceId.empty() ? envelope.mode.activeMode : envelope.frontView.sourceId;
+    std::transform(sourceId.begin(), sourceId.end(), sourceId.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+    });
 }
 
 std::string buildRouteKey(
@@ -55,11 +56,6 @@ std::string buildRouteKey(
     return toLower(routeDomain) + "/" + toLower(platformProfile) + "/" + toLower(sourceId);
 }
 
-std::string buildRouteEndpointKey(const std::string &routeKey, const std::string &endpointId)
-{
-    return routeKey + "@" + toLower(endpointId);
-}
-
 std::vector<FederationBridgeConfig::EndpointConfig> activeEndpoints(const FederationBridgeConfig &config)
 {
     std::vector<FederationBridgeConfig::EndpointConfig> endpoints;
@@ -220,30 +216,117 @@ std::string jsonEscape(const std::string &value)
     }
     return escaped;
 }
+
+std::string base64Encode(const std::string &value)
+{
+    static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string encoded;
+    encoded.reserve((value.size() + 2) / 3 * 4);
+    std::size_t idx = 0;
+    for (; idx + 3 <= value.size(); idx += 3)
+    {
+        const std::uint32_t chunk = (static_cast<unsigned char>(value[idx]) << 16) |
+                                    (static_cast<unsigned char>(value[idx + 1]) << 8) |
+                                    static_cast<unsigned char>(value[idx + 2]);
+        encoded.push_back(kAlphabet[(chunk >> 18) & 0x3fU]);
+        encoded.push_back(kAlphabet[(chunk >> 12) & 0x3fU]);
+        encoded.push_back(kAlphabet[(chunk >> 6) & 0x3fU]);
+        encoded.push_back(kAlphabet[chunk & 0x3fU]);
+    }
+    if (idx < value.size())
+    {
+        std::uint32_t chunk = static_cast<unsigned char>(value[idx]) << 16;
+        if (idx + 1 < value.size())
+        {
+            chunk |= static_cast<unsigned char>(value[idx + 1]) << 8;
+        }
+        encoded.push_back(kAlphabet[(chunk >> 18) & 0x3fU]);
+        encoded.push_back(kAlphabet[(chunk >> 12) & 0x3fU]);
+        encoded.push_back(idx + 1 < value.size() ? kAlphabet[(chunk >> 6) & 0x3fU] : '=');
+        encoded.push_back('=');
+    }
+    return encoded;
+}
+
+const std::string_view kBinaryFrameMagic("ATFE", 4);
+constexpr std::uint64_t kBinaryFrameVersion = 1;
 } // namespace
 
 FederationBridge::FederationBridge(FederationBridgeConfig config)
+    : FederationBridge(std::move(config), nullptr)
+{
+}
+
+FederationBridge::FederationBridge(FederationBridgeConfig config, std::shared_ptr<FederationRouteTable> routeTable)
     : config_(std::move(config)),
-      nextLogicalTick_(config_.startLogicalTick)
+      nextLogicalTick_(config_.startLogicalTick),
+      federateId_(toLower(config_.federateId)),
+      federateKeyId_(toLower(config_.federateKeyId)),
+      federateContext_("federate=" + federateId_ + " key_id=" + federateKeyId_)
 {
     allowedSourcesNormalized_.reserve(config_.allowedSourceIds.size());
     for (const auto &sourceId : config_.allowedSourceIds)
     {
         allowedSourcesNormalized_.push_back(toLower(sourceId));
     }
+    (void)validateConfig(config_, configError_);
+
+    for (const auto &endpoint : activeEndpoints(config_))
+    {
+        EndpointPlan plan;
+        plan.endpointId = toLower(endpoint.endpointId);
+        plan.payloadFormat = endpoint.outputFormatName;
+        if (parseIoEnvelopeFormat(endpoint.outputFormatName, plan.format))
+        {
+            plan.payloadFormat = ioEnvelopeFormatName(plan.format);
+        }
+        plan.keyTrusted = endpoint.acceptedFederateKeyIds.empty();
+        for (const auto &trustedKey : endpoint.acceptedFederateKeyIds)
+        {
+            if (toLower(trustedKey) == federateKeyId_)
+            {
+                plan.keyTrusted = true;
+                break;
+            }
+        }
+        plan.attestationSatisfied = !endpoint.requireFederateAttestation ||
+                                    (config_.requireFederateAttestation && !config_.federateAttestationTag.empty());
+        endpoints_.push_back(std::move(plan));
+    }
+
+    routeTable_ = routeTable ? std::move(routeTable) : std::make_shared<FederationRouteTable>(endpoints_.size());
+    if (configError_.empty() && routeTable_->endpointCount() != endpoints_.size())
+    {
+        configError_ = "route table endpoint count mismatch";
+    }
 }
 
-FederationFanoutResult FederationBridge::publishFanout(const ExternalIoEnvelope &envelope)
+FederationRouteTable::Lease FederationBridge::routeState(const std::string &platformProfile, const std::string &sourceId)
 {
-    FederationFanoutResult result;
-    const std::string federateContext =
-        "federate=" + toLower(config_.federateId) + " key_id=" + toLower(config_.federateKeyId);
-    auto reject = [&](const std::string &reason, const std::string &detail = std::string()) -> FederationFanoutResult
+    aliasScratch_.assign(platformProfile).append(1, '/').append(sourceId);
+    const std::uint64_t aliasHash = FlatRouteIndex::hash(aliasScratch_);
+    FederationRouteTable::Handle handle = 0;
+    if (!routeAliases_.find(aliasScratch_, aliasHash, handle))
     {
-        result.error = reason;
-        const std::string mergedDetail = detail.empty() ? federateContext : (federateContext + " " + detail);
+        handle = routeTable_->intern(buildRouteKey(config_.routeDomain, platformProfile, sourceId));
+        routeAliases_.insert(aliasScratch_, aliasHash, handle);
+    }
+    return routeTable_->acquire(handle);
+}
+
+bool FederationBridge::publishInto(const ExternalIoEnvelope &envelope,
+                                   std::vector<FederationEventFrame> &frames,
+                                   std::size_t &frameCount,
+                                   std::string &error)
+{
+    const std::size_t firstFrame = frameCount;
+    auto reject = [&](const std::string &reason, const std::string &detail = std::string()) -> bool
+    {
+        frameCount = firstFrame;
+        error = reason;
+        const std::string mergedDetail = detail.empty() ? federateContext_ : (federateContext_ + " " + detail);
         (void)logAuditEvent("federation_bridge_denied", reason, mergedDetail);
-        return result;
+        return false;
     };
 
     if (envelope.metadata.schemaVersion.empty())
@@ -259,10 +342,9 @@ FederationFanoutResult FederationBridge::publishFanout(const ExternalIoEnvelope
         return reject("mode.active is required");
     }
 
-    std::string configError;
-    if (!validateConfig(config_, configError))
+    if (!configError_.empty())
     {
-        return reject(configError);
+        return reject(configError_);
     }
 
     if (config_.requireDeterministic && !envelope.metadata.deterministic)
@@ -274,7 +356,8 @@ FederationFanoutResult FederationBridge::publishFanout(const ExternalIoEnvelope
     {
         return reject("metadata.platform_profile is required");
     }
-    const std::string sourceId = deriveSourceId(envelope);
+    deriveSourceId(envelope, sourceScratch_);
+    const std::string &sourceId = sourceScratch_;
     if (!isValidToken(sourceId))
     {
         return reject("source identifier is missing or invalid");
@@ -290,12 +373,15 @@ FederationFanoutResult FederationBridge::publishFanout(const ExternalIoEnvelope
     {
         return reject("metadata.platform_profile is invalid");
     }
-    const std::string routeKey = buildRouteKey(config_.routeDomain, envelope.metadata.platformProfile, sourceId);
-    const std::vector<FederationBridgeConfig::EndpointConfig> endpoints = activeEndpoints(config_);
-    if (endpoints.empty())
+    if (endpoints_.empty())
     {
         return reject("no active endpoints");
     }
+    // Rejections before the route lease name the route without interning it, so envelopes that
+    // are turned away never add entries to a (possibly shared) route table.
+    const auto routeDetail = [&]() {
+        return "route=" + buildRouteKey(config_.routeDomain, envelope.metadata.platformProfile, sourceId);
+    };
 
     if (willOverflowMul(nextLogicalTick_, config_.tickDurationMs))
     {
@@ -310,31 +396,23 @@ FederationFanoutResult FederationBridge::publishFanout(const ExternalIoEnvelope
     if (eventTimestampMs < config_.federateKeyValidFromTimestampMs ||
         eventTimestampMs > config_.federateKeyValidUntilTimestampMs)
     {
-        return reject("federate key material not valid for event timestamp", "route=" + routeKey);
+        return reject("federate key material not valid for event timestamp", routeDetail());
     }
     const std::uint64_t sourceTimestampMs = envelope.frontView.timestampMs;
     if (config_.requireSourceTimestamp && sourceTimestampMs == 0U)
     {
-        return reject("source timestamp is required", "route=" + routeKey);
+        return reject("source timestamp is required", routeDetail());
     }
     if (sourceTimestampMs > 0U)
     {
         if (willOverflowAdd(eventTimestampMs, config_.maxFutureSkewMs))
         {
-            return reject("time-authority overflow", "route=" + routeKey);
+            return reject("time-authority overflow", routeDetail());
         }
         const std::uint64_t maxAuthorizedSourceTimestamp = eventTimestampMs + config_.maxFutureSkewMs;
         if (sourceTimestampMs > maxAuthorizedSourceTimestamp)
         {
-            return reject("source timestamp ahead of time authority", "route=" + routeKey);
-        }
-        if (config_.requireMonotonicSourceTimestamp)
-        {
-            auto lastIt = lastSourceTimestampByKey_.find(routeKey);
-            if (lastIt != lastSourceTimestampByKey_.end() && sourceTimestampMs < lastIt->second)
-            {
-                return reject("source timestamp regressed for route", "route=" + routeKey);
-            }
+            return reject("source timestamp ahead of time authority", routeDetail());
         }
     }
 
@@ -345,114 +423,145 @@ FederationFanoutResult FederationBridge::publishFanout(const ExternalIoEnvelope
     }
     if (latencyMs > config_.maxLatencyBudgetMs)
     {
-        return reject("latency budget exceeded", "route=" + routeKey);
+        return reject("latency budget exceeded", routeDetail());
+    }
+    if (willOverflowAdd(nextLogicalTick_, config_.tickStep))
+    {
+        return reject("logical tick overflow");
     }
 
-    std::vector<FederationEventFrame> frames;
-    frames.reserve(endpoints.size());
-    std::vector<std::string> routeEndpointKeys;
-    routeEndpointKeys.reserve(endpoints.size());
-    std::vector<std::uint64_t> routeSequences;
-    routeSequences.reserve(endpoints.size());
-
-    for (const auto &endpoint : endpoints)
+    for (std::size_t idx = 0; idx < endpoints_.size(); ++idx)
     {
-        const std::string normalizedEndpointId = toLower(endpoint.endpointId);
-        if (!endpoint.acceptedFederateKeyIds.empty())
+        const EndpointPlan &endpoint = endpoints_[idx];
+        if (!endpoint.keyTrusted)
         {
-            bool trustedKeyFound = false;
-            const std::string normalizedFederateKeyId = toLower(config_.federateKeyId);
-            for (const auto &trustedKey : endpoint.acceptedFederateKeyIds)
-            {
-                if (toLower(trustedKey) == normalizedFederateKeyId)
-                {
-                    trustedKeyFound = true;
-                    break;
-                }
-            }
-            if (!trustedKeyFound)
-            {
-                return reject("federate key id not trusted for endpoint", "endpoint=" + normalizedEndpointId);
-            }
+            return reject("federate key id not trusted for endpoint", "endpoint=" + endpoint.endpointId);
         }
-        if (endpoint.requireFederateAttestation)
+        if (!endpoint.attestationSatisfied)
         {
-            if (!config_.requireFederateAttestation || config_.federateAttestationTag.empty())
-            {
-                return reject("federate attestation required by endpoint policy", "endpoint=" + normalizedEndpointId);
-            }
+            return reject("federate attestation required by endpoint policy", "endpoint=" + endpoint.endpointId);
         }
-        const std::string routeEndpointKey = buildRouteEndpointKey(routeKey, normalizedEndpointId);
-        const std::uint64_t routeSequence = routeSequenceByKeyAndEndpoint_[routeEndpointKey];
-        if (routeSequence == std::numeric_limits<std::uint64_t>::max())
+
+        if (firstFrame + idx == frames.size())
+        {
+            frames.emplace_back();
+        }
+        FederationEventFrame &frame = frames[firstFrame + idx];
+        // Endpoints sharing a codec share the encoded payload.
+        std::size_t sameFormat = 0;
+        while (sameFormat < idx && endpoints_[sameFormat].format != endpoint.format)
         {
-            return reject("route sequence overflow", "endpoint=" + normalizedEndpointId);
+            ++sameFormat;
         }
-        const IoEnvelopeSerializeResult serialized = serializeExternalIoEnvelope(endpoint.outputFormatName, envelope);
-        if (!serialized.ok)
+        if (sameFormat < idx)
         {
-            return reject(serialized.error, "endpoint=" + normalizedEndpointId);
+            frame.payload = frames[firstFrame + sameFormat].payload;
         }
+        else if (!serializeExternalIoEnvelope(endpoint.format, envelope, frame.payload))
+        {
+            return reject("envelope serialization failed", "endpoint=" + endpoint.endpointId);
+        }
+    }
 
-        FederationEventFrame frame;
+    // Held until publishInto() returns, so a shared route's check-and-advance cannot interleave.
+    // Only state an earlier publish left behind can fail the checks below, so a route created
+    // here is always kept.
+    const FederationRouteTable::Lease routeLease = routeState(envelope.metadata.platformProfile, sourceId);
+    FederationRouteTable::Entry &route = routeLease.entry();
+    const std::string &routeKey = route.routeKey;
+    if (config_.requireMonotonicSourceTimestamp && sourceTimestampMs > 0U && route.hasSourceTimestamp &&
+        sourceTimestampMs < route.lastSourceTimestampMs)
+    {
+        return reject("source timestamp regressed for route", "route=" + routeKey);
+    }
+    for (std::size_t idx = 0; idx < endpoints_.size(); ++idx)
+    {
+        if (route.sequences[idx] == std::numeric_limits<std::uint64_t>::max())
+        {
+            return reject("route sequence overflow", "endpoint=" + endpoints_[idx].endpointId);
+        }
+    }
+
+    for (std::size_t idx = 0; idx < endpoints_.size(); ++idx)
+    {
+        const EndpointPlan &endpoint = endpoints_[idx];
+        FederationEventFrame &frame = frames[frameCount];
         frame.schemaVersion = "1.0.0";
         frame.interfaceId = "airtrace.federation_event";
-        frame.endpointId = normalizedEndpointId;
-        frame.federateId = toLower(config_.federateId);
-        frame.federateKeyId = toLower(config_.federateKeyId);
+        frame.endpointId = endpoint.endpointId;
+        frame.federateId = federateId_;
+        frame.federateKeyId = federateKeyId_;
         frame.federateKeyEpoch = config_.federateKeyEpoch;
         frame.federateKeyValidUntilTimestampMs = config_.federateKeyValidUntilTimestampMs;
         frame.federateAttestationTag = config_.federateAttestationTag;
         frame.routeKey = routeKey;
-        frame.routeSequence = routeSequence;
+        frame.routeSequence = route.sequences[idx];
         frame.logicalTick = nextLogicalTick_;
         frame.eventTimestampMs = eventTimestampMs;
         frame.sourceTimestampMs = sourceTimestampMs;
         frame.sourceLatencyMs = latencyMs;
         frame.latencyBudgetMs = config_.maxLatencyBudgetMs;
         frame.sourceId = sourceId;
-        frame.payloadFormat = ioEnvelopeFormatName(IoEnvelopeFormat::Json);
-        IoEnvelopeFormat parsed = IoEnvelopeFormat::Json;
-        if (parseIoEnvelopeFormat(endpoint.outputFormatName, parsed))
-        {
-            frame.payloadFormat = ioEnvelopeFormatName(parsed);
-        }
-        else
-        {
-            frame.payloadFormat = endpoint.outputFormatName;
-        }
-        frame.payload = serialized.payload;
+        frame.payloadFormat = endpoint.payloadFormat;
         frame.seed = envelope.metadata.seed;
         frame.deterministic = envelope.metadata.deterministic;
-
-        routeEndpointKeys.push_back(routeEndpointKey);
-        routeSequences.push_back(routeSequence);
-        frames.push_back(std::move(frame));
+        ++frameCount;
     }
 
-    for (std::size_t idx = 0; idx < routeEndpointKeys.size(); ++idx)
+    for (auto &sequence : route.sequences)
     {
-        routeSequenceByKeyAndEndpoint_[routeEndpointKeys[idx]] = routeSequences[idx] + 1U;
+        ++sequence;
     }
     if (sourceTimestampMs > 0U)
     {
-        lastSourceTimestampByKey_[routeKey] = sourceTimestampMs;
-    }
-
-    if (willOverflowAdd(nextLogicalTick_, config_.tickStep))
-    {
-        return reject("logical tick overflow");
+        route.lastSourceTimestampMs = sourceTimestampMs;
+        route.hasSourceTimestamp = true;
     }
     nextLogicalTick_ += config_.tickStep;
-    result.frames = std::move(frames);
-    result.ok = true;
     (void)logAuditEvent(
         "federation_bridge_publish",
         "ok",
-        federateContext + " route=" + routeKey + " endpoints=" + std::to_string(result.frames.size()));
+        federateContext_ + " route=" + routeKey + " endpoints=" + std::to_string(frameCount - firstFrame));
+    return true;
+}
+
+FederationFanoutResult FederationBridge::publishFanout(const ExternalIoEnvelope &envelope)
+{
+    FederationFanoutResult result;
+    std::size_t frameCount = 0;
+    if (!publishInto(envelope, result.frames, frameCount, result.error))
+    {
+        result.frames.clear();
+        return result;
+    }
+    result.ok = true;
     return result;
 }
 
+std::size_t FederationBridge::publishBatch(const ExternalIoEnvelope *envelopes,
+                                           std::size_t count,
+                                           FederationFrameArena &arena)
+{
+    arena.frameCount = 0;
+    arena.outcomes.resize(count);
+    std::size_t published = 0;
+    for (std::size_t idx = 0; idx < count; ++idx)
+    {
+        FederationPublishOutcome &outcome = arena.outcomes[idx];
+        outcome.error.clear();
+        outcome.firstFrame = arena.frameCount;
+        outcome.ok = publishInto(envelopes[idx], arena.frames, arena.frameCount, outcome.error);
+        outcome.frameCount = arena.frameCount - outcome.firstFrame;
+        published += outcome.ok ? 1U : 0U;
+    }
+    return published;
+}
+
+std::size_t FederationBridge::publishBatch(const std::vector<ExternalIoEnvelope> &envelopes, FederationFrameArena &arena)
+{
+    return publishBatch(envelopes.data(), envelopes.size(), arena);
+}
+
 FederationBridgeResult FederationBridge::publish(const ExternalIoEnvelope &envelope)
 {
     FederationBridgeResult result;
@@ -495,8 +604,109 @@ std::string serializeFederationEventFrameJson(const FederationEventFrame &frame)
     out << "\"payload_format\":\"" << jsonEscape(frame.payloadFormat) << "\",";
     out << "\"seed\":" << frame.seed << ",";
     out << "\"deterministic\":" << (frame.deterministic ? "true" : "false") << ",";
-    out << "\"payload\":\"" << jsonEscape(frame.payload) << "\"";
+    if (frame.payloadFormat == ioEnvelopeFormatName(IoEnvelopeFormat::Binary))
+    {
+        out << "\"payload_encoding\":\"base64\",";
+        out << "\"payload\":\"" << base64Encode(frame.payload) << "\"";
+    }
+    else
+    {
+        out << "\"payload\":\"" << jsonEscape(frame.payload) << "\"";
+    }
     out << "}";
     return out.str();
 }
+
+std::string serializeFederationEventFrameBinary(const FederationEventFrame &frame)
+{
+    std::string bytes;
+    bytes.reserve(128 + frame.payload.size());
+    BinaryWriter out(bytes);
+    out.bytes(kBinaryFrameMagic);
+    out.varint(kBinaryFrameVersion);
+    out.text(frame.schemaVersion);
+    out.text(frame.interfaceId);
+    out.text(frame.endpointId);
+    out.text(frame.federateId);
+    out.text(frame.federateKeyId);
+    out.varint(frame.federateKeyEpoch);
+    out.varint(frame.federateKeyValidUntilTimestampMs);
+    out.text(frame.federateAttestationTag);
+    out.text(frame.routeKey);
+    out.varint(frame.routeSequence);
+    out.varint(frame.logicalTick);
+    out.varint(frame.eventTimestampMs);
+    out.varint(frame.sourceTimestampMs);
+    out.real(frame.sourceLatencyMs);
+    out.real(frame.latencyBudgetMs);
+    out.text(frame.sourceId);
+    out.text(frame.payloadFormat);
+    out.text(frame.payload);
+    out.varint(frame.seed);
+    out.byte(frame.deterministic ? 1U : 0U);
+    return bytes;
+}
+
+bool parseFederationEventFrameBinary(std::string_view bytes, FederationEventFrame &frame, std::string &error)
+{
+    error.clear();
+    BinaryReader in(bytes);
+    std::string_view magic;
+    if (!in.bytes(kBinaryFrameMagic.size(), magic) || magic != kBinaryFrameMagic)
+    {
+        error = "binary frame invalid magic";
+        return false;
+    }
+    std::uint64_t version = 0;
+    if (!in.varint(version))
+    {
+        error = in.truncated() ? "binary frame truncated" : "binary frame invalid varint";
+        return false;
+    }
+    if (version != kBinaryFrameVersion)
+    {
+        error = "binary frame unsupported version: " + std::to_string(version);
+        return false;
+    }
+    std::uint64_t seed = 0;
+    std::uint8_t deterministic = 0;
+    const bool read = in.text(frame.schemaVersion) &&
+                      in.text(frame.interfaceId) &&
+                      in.text(frame.endpointId) &&
+                      in.text(frame.federateId) &&
+                      in.text(frame.federateKeyId) &&
+                      in.varint(frame.federateKeyEpoch) &&
+                      in.varint(frame.federateKeyValidUntilTimestampMs) &&
+                      in.text(frame.federateAttestationTag) &&
+                      in.text(frame.routeKey) &&
+                      in.varint(frame.routeSequence) &&
+                      in.varint(frame.logicalTick) &&
+                      in.varint(frame.eventTimestampMs) &&
+                      in.varint(frame.sourceTimestampMs) &&
+                      in.real(frame.sourceLatencyMs) &&
+                      in.real(frame.latencyBudgetMs) &&
+                      in.text(frame.sourceId) &&
+                      in.text(frame.payloadFormat) &&
+                      in.text(frame.payload) &&
+                      in.varint(seed) &&
+                      in.byte(deterministic);
+    if (!read)
+    {
+        error = in.truncated() ? "binary frame truncated" : "binary frame invalid varint";
+        return false;
+    }
+    if (seed > std::numeric_limits<unsigned int>::max() || deterministic > 1U)
+    {
+        error = "binary frame invalid value";
+        return false;
+    }
+    if (in.remaining() != 0)
+    {
+        error = "binary frame trailing bytes";
+        return false;
+    }
+    frame.seed = static_cast<unsigned int>(seed);
+    frame.deterministic = deterministic != 0U;
+    return true;
+}
 } // namespace tools
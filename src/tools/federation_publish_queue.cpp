@@ -0,0 +1,304 @@
+#include "tools/federation_publish_queue.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace tools
+{
+namespace
+{
+// Yields a Block producer makes on a full ring before it sleeps until the egress thread frees a slot.
+constexpr int kBlockSpinLimit = 64;
+
+std::size_t roundUpPowerOfTwo(std::size_t value)
+{
+    std::size_t rounded = 1;
+    while (rounded < value)
+    {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+std::size_t latencyBucket(std::uint64_t nanoseconds)
+{
+    std::size_t bucket = 0;
+    while (nanoseconds > 1U && bucket + 1 < FederationQueueStats::kLatencyBuckets)
+    {
+        nanoseconds >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+} // namespace
+
+std::uint64_t FederationQueueStats::latencyQuantileNs(double quantile) const
+{
+    std::uint64_t total = 0;
+    for (std::uint64_t count : latencyNs)
+    {
+        total += count;
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+    const double clamped = std::min(std::max(quantile, 0.0), 1.0);
+    const std::uint64_t rank = std::max<std::uint64_t>(1U, static_cast<std::uint64_t>(clamped * static_cast<double>(total) + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < latencyNs.size(); ++bucket)
+    {
+        seen += latencyNs[bucket];
+        if (seen >= rank)
+        {
+            return std::uint64_t{2} << bucket;
+        }
+    }
+    return std::uint64_t{2} << (latencyNs.size() - 1);
+}
+
+FederationPublishQueue::FederationPublishQueue(FederationBridgeConfig bridgeConfig,
+                                               FederationPublishQueueConfig queueConfig,
+                                               FrameSink frameSink,
+                                               RejectSink rejectSink,
+                                               DropHook dropHook)
+    : bridge_(std::move(bridgeConfig)),
+      config_(queueConfig),
+      frameSink_(std::move(frameSink)),
+      rejectSink_(std::move(rejectSink)),
+      dropHook_(std::move(dropHook))
+{
+    const std::size_t capacity = roundUpPowerOfTwo(std::max<std::size_t>(config_.capacity, 2));
+    config_.capacity = capacity;
+    config_.maxBatch = std::max<std::size_t>(config_.maxBatch, 1);
+    mask_ = capacity - 1;
+    slots_.reset(new Slot[capacity]);
+    for (std::size_t idx = 0; idx < capacity; ++idx)
+    {
+        slots_[idx].sequence.store(idx, std::memory_order_relaxed);
+    }
+    egress_ = std::thread(&FederationPublishQueue::egressLoop, this);
+}
+
+FederationPublishQueue::~FederationPublishQueue()
+{
+    stopping_.store(true, std::memory_order_release);
+    {
+        // Under the lock, so the egress thread cannot miss it between its recheck and its wait.
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        wake_.notify_one();
+    }
+    egress_.join();
+}
+
+bool FederationPublishQueue::enqueue(const ExternalIoEnvelope &envelope)
+{
+    int spins = 0;
+    bool blocked = false;
+    while (!tryEnqueue(envelope))
+    {
+        if (config_.overflow == FederationQueueOverflow::DropNewest)
+        {
+            droppedCount_.fetch_add(1, std::memory_order_relaxed);
+            if (dropHook_)
+            {
+                dropHook_(envelope);
+            }
+            return false;
+        }
+        if (!blocked)
+        {
+            blocked = true;
+            backpressureCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (++spins < kBlockSpinLimit)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        waitForSpace();
+        spins = 0;
+    }
+    enqueuedCount_.fetch_add(1, std::memory_order_relaxed);
+    // Pairs with the fence in egressLoop(): either this load sees the egress thread idle, or the
+    // egress thread's recheck sees this slot filled.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (egressIdle_.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        wake_.notify_one();
+    }
+    return true;
+}
+
+// Bounded MPMC ring after Vyukov, used here with one consumer: a slot whose sequence equals the
+// claimed position is free, sequence == position + 1 marks it filled, and the consumer hands it
+// back one lap later by storing position + capacity.
+bool FederationPublishQueue::tryEnqueue(const ExternalIoEnvelope &envelope)
+{
+    std::uint64_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+    while (true)
+    {
+        slot = &slots_[pos & mask_];
+        const std::uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const std::int64_t lag = static_cast<std::int64_t>(sequence - pos);
+        if (lag == 0)
+        {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (lag < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+    slot->envelope = envelope;
+    slot->enqueuedAt = std::chrono::steady_clock::now();
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool FederationPublishQueue::ringFull() const
+{
+    const std::uint64_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    return static_cast<std::int64_t>(slots_[pos & mask_].sequence.load(std::memory_order_acquire) - pos) < 0;
+}
+
+void FederationPublishQueue::waitForSpace()
+{
+    spaceWaiters_.fetch_add(1, std::memory_order_relaxed);
+    // Pairs with the fence in egressLoop(): either the egress thread sees this waiter after freeing
+    // slots, or the recheck below sees a slot it freed.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        space_.wait(lock, [&]() { return !ringFull(); });
+    }
+    spaceWaiters_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool FederationPublishQueue::tryDequeue(ExternalIoEnvelope &envelope, std::chrono::steady_clock::time_point &enqueuedAt)
+{
+    const std::uint64_t pos = dequeuePos_;
+    Slot &slot = slots_[pos & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+    {
+        return false;
+    }
+    // Swapping rather than moving keeps string and vector capacity circulating through the ring.
+    std::swap(envelope, slot.envelope);
+    enqueuedAt = slot.enqueuedAt;
+    slot.sequence.store(pos + config_.capacity, std::memory_order_release);
+    dequeuePos_ = pos + 1;
+    return true;
+}
+
+void FederationPublishQueue::flush()
+{
+    const std::uint64_t target = enqueuePos_.load(std::memory_order_acquire);
+    flushWaiters_.fetch_add(1);
+    {
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        drained_.wait(lock, [&]() { return emittedPos_.load() >= target; });
+    }
+    flushWaiters_.fetch_sub(1);
+}
+
+FederationQueueStats FederationPublishQueue::stats() const
+{
+    FederationQueueStats snapshot;
+    snapshot.enqueued = enqueuedCount_.load(std::memory_order_relaxed);
+    snapshot.dropped = droppedCount_.load(std::memory_order_relaxed);
+    snapshot.published = publishedCount_.load(std::memory_order_relaxed);
+    snapshot.rejected = rejectedCount_.load(std::memory_order_relaxed);
+    snapshot.backpressureWaits = backpressureCount_.load(std::memory_order_relaxed);
+    for (std::size_t bucket = 0; bucket < latencyBuckets_.size(); ++bucket)
+    {
+        snapshot.latencyNs[bucket] = latencyBuckets_[bucket].load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+void FederationPublishQueue::recordLatency(std::chrono::steady_clock::duration latency)
+{
+    const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+    latencyBuckets_[latencyBucket(nanoseconds > 0 ? static_cast<std::uint64_t>(nanoseconds) : 0U)].fetch_add(
+        1, std::memory_order_relaxed);
+}
+
+void FederationPublishQueue::egressLoop()
+{
+    std::vector<ExternalIoEnvelope> batch(config_.maxBatch);
+    std::vector<std::chrono::steady_clock::time_point> enqueuedAt(config_.maxBatch);
+    FederationFrameArena arena;
+    while (true)
+    {
+        std::size_t count = 0;
+        while (count < batch.size() && tryDequeue(batch[count], enqueuedAt[count]))
+        {
+            ++count;
+        }
+        if (count == 0)
+        {
+            if (stopping_.load(std::memory_order_acquire) && dequeuePos_ == enqueuePos_.load(std::memory_order_acquire))
+            {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            egressIdle_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // No timeout: enqueue() and the destructor both notify under this lock.
+            wake_.wait(lock, [&]() {
+                return slots_[dequeuePos_ & mask_].sequence.load(std::memory_order_acquire) == dequeuePos_ + 1 ||
+                       stopping_.load(std::memory_order_acquire);
+            });
+            egressIdle_.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        // The batch's slots are free again; wake producers sleeping on a full ring.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (spaceWaiters_.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            space_.notify_all();
+        }
+
+        bridge_.publishBatch(batch.data(), count, arena);
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            const FederationPublishOutcome &outcome = arena.outcomes[idx];
+            if (outcome.ok)
+            {
+                for (std::size_t frame = 0; frame < outcome.frameCount; ++frame)
+                {
+                    frameSink_(arena.frames[outcome.firstFrame + frame]);
+                }
+                publishedCount_.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                if (rejectSink_)
+                {
+                    rejectSink_(batch[idx], outcome.error);
+                }
+                rejectedCount_.fetch_add(1, std::memory_order_relaxed);
+            }
+            recordLatency(std::chrono::steady_clock::now() - enqueuedAt[idx]);
+        }
+        emittedPos_.store(dequeuePos_);
+        if (flushWaiters_.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            drained_.notify_all();
+        }
+    }
+}
+} // namespace tools
@@ -0,0 +1,187 @@
+#include "tools/federation_route_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace tools
+{
+namespace
+{
+constexpr std::uint64_t kGolden = 0x9e3779b97f4a7c15ULL;
+
+std::uint64_t mix(std::uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+std::size_t roundUpPowerOfTwo(std::size_t value)
+{
+    std::size_t rounded = 1;
+    while (rounded < value)
+    {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+} // namespace
+
+// Eight bytes per step rather than FNV's one, since route keys run to tens of bytes. Hashes only
+// need to agree within one process, so host byte order does not matter.
+std::uint64_t FlatRouteIndex::hash(std::string_view key)
+{
+    std::uint64_t state = kGolden ^ key.size();
+    std::size_t pos = 0;
+    for (; pos + 8 <= key.size(); pos += 8)
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, key.data() + pos, sizeof(word));
+        state = (state ^ mix(word)) * kGolden;
+    }
+    std::uint64_t tail = 0;
+    for (std::size_t shift = 0; pos < key.size(); ++pos, shift += 8)
+    {
+        tail |= static_cast<std::uint64_t>(static_cast<unsigned char>(key[pos])) << shift;
+    }
+    return mix(state ^ mix(tail));
+}
+
+bool FlatRouteIndex::find(std::string_view key, std::uint64_t keyHash, std::uint64_t &handle) const
+{
+    if (slots.empty())
+    {
+        return false;
+    }
+    for (std::size_t pos = keyHash & slotMask;; pos = (pos + 1) & slotMask)
+    {
+        const Slot &slot = slots[pos];
+        if (slot.key == 0)
+        {
+            return false;
+        }
+        if (slot.hash == keyHash && keys[slot.key - 1] == key)
+        {
+            handle = slot.handle;
+            return true;
+        }
+    }
+}
+
+void FlatRouteIndex::insert(std::string_view key, std::uint64_t keyHash, std::uint64_t handle)
+{
+    if ((keys.size() + 1) * 2 > slots.size())
+    {
+        grow();
+    }
+    keys.emplace_back(key);
+    std::size_t pos = keyHash & slotMask;
+    while (slots[pos].key != 0)
+    {
+        pos = (pos + 1) & slotMask;
+    }
+    slots[pos] = {keyHash, handle, static_cast<std::uint32_t>(keys.size())};
+}
+
+std::size_t FlatRouteIndex::size() const
+{
+    return keys.size();
+}
+
+void FlatRouteIndex::grow()
+{
+    std::vector<Slot> previous(std::max<std::size_t>(slots.size() * 2, 16));
+    previous.swap(slots);
+    slotMask = slots.size() - 1;
+    for (const Slot &slot : previous)
+    {
+        if (slot.key == 0)
+        {
+            continue;
+        }
+        std::size_t pos = slot.hash & slotMask;
+        while (slots[pos].key != 0)
+        {
+            pos = (pos + 1) & slotMask;
+        }
+        slots[pos] = slot;
+    }
+}
+
+FederationRouteTable::Lease::Lease(std::unique_lock<std::mutex> lock, Entry &entry)
+    : lock(std::move(lock)),
+      routeEntry(&entry)
+{
+}
+
+FederationRouteTable::Entry &FederationRouteTable::Lease::entry() const
+{
+    return *routeEntry;
+}
+
+FederationRouteTable::FederationRouteTable(std::size_t endpointCount, std::size_t shardCount)
+    : endpoints(endpointCount)
+{
+    const std::size_t count = roundUpPowerOfTwo(std::max<std::size_t>(shardCount, 1));
+    shardMask = count - 1;
+    shards.reserve(count);
+    for (std::size_t idx = 0; idx < count; ++idx)
+    {
+        shards.push_back(std::make_unique<Shard>());
+    }
+}
+
+FederationRouteTable::Handle FederationRouteTable::intern(const std::string &routeKey)
+{
+    const std::uint64_t keyHash = FlatRouteIndex::hash(routeKey);
+    // The index probes with the low bits, so shards take the high ones.
+    const std::size_t shardIndex = static_cast<std::size_t>(keyHash >> 32) & shardMask;
+    Shard &shard = *shards[shardIndex];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Handle handle = 0;
+    if (shard.index.find(routeKey, keyHash, handle))
+    {
+        return handle;
+    }
+    handle = (static_cast<Handle>(shardIndex) << 32) | shard.entries.size();
+    Entry entry;
+    entry.routeKey = routeKey;
+    entry.sequences.assign(endpoints, 0U);
+    shard.entries.push_back(std::move(entry));
+    shard.index.insert(routeKey, keyHash, handle);
+    return handle;
+}
+
+FederationRouteTable::Lease FederationRouteTable::acquire(Handle handle)
+{
+    Shard &shard = *shards[static_cast<std::size_t>(handle >> 32)];
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    Entry &entry = shard.entries[static_cast<std::size_t>(handle & 0xffffffffU)];
+    return Lease(std::move(lock), entry);
+}
+
+std::size_t FederationRouteTable::endpointCount() const
+{
+    return endpoints;
+}
+
+std::size_t FederationRouteTable::shardCount() const
+{
+    return shards.size();
+}
+
+std::size_t FederationRouteTable::size() const
+{
+    std::size_t total = 0;
+    for (const auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total += shard->entries.size();
+    }
+    return total;
+}
+} // namespace tools
@@ -0,0 +1,650 @@
+#include "tools/io_envelope_stream.h"
+
+#include "core/work_stealing_pool.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace tools
+{
+namespace
+{
+constexpr std::size_t kLengthPrefixBytes = 4;
+constexpr std::size_t kInitialWindowBytes = 64 * 1024;
+
+enum class FrameStatus
+{
+    Record,
+    End,
+    Error
+};
+
+long readSome(int fd, char *buffer, std::size_t count)
+{
+#if defined(_WIN32)
+    return _read(fd, buffer, static_cast<unsigned int>(std::min<std::size_t>(count, INT_MAX)));
+#else
+    ssize_t got = 0;
+    do
+    {
+        got = ::read(fd, buffer, count);
+    } while (got < 0 && errno == EINTR);
+    return static_cast<long>(got);
+#endif
+}
+
+bool writeAll(int fd, const char *data, std::size_t count)
+{
+    while (count > 0)
+    {
+#if defined(_WIN32)
+        int wrote = _write(fd, data, static_cast<unsigned int>(std::min<std::size_t>(count, INT_MAX)));
+#else
+        ssize_t wrote = ::write(fd, data, count);
+        if (wrote < 0 && errno == EINTR)
+        {
+            continue;
+        }
+#endif
+        if (wrote <= 0)
+        {
+            return false;
+        }
+        data += wrote;
+        count -= static_cast<std::size_t>(wrote);
+    }
+    return true;
+}
+
+std::uint32_t readLengthPrefix(const char *data)
+{
+    std::uint32_t length = 0;
+    for (std::size_t idx = 0; idx < kLengthPrefixBytes; ++idx)
+    {
+        length |= static_cast<std::uint32_t>(static_cast<unsigned char>(data[idx])) << (8 * idx);
+    }
+    return length;
+}
+
+std::string_view trimCarriageReturn(std::string_view line)
+{
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+bool appendFramedRecord(std::string &out, IoEnvelopeFraming framing, std::string_view payload, std::string &error)
+{
+    if (framing == IoEnvelopeFraming::Newline)
+    {
+        if (payload.empty() || std::memchr(payload.data(), '\n', payload.size()) != nullptr)
+        {
+            error = "payload cannot be newline framed";
+            return false;
+        }
+        out.append(payload.data(), payload.size());
+        out.push_back('\n');
+        return true;
+    }
+    if (payload.size() > UINT32_MAX)
+    {
+        error = "payload exceeds length prefix";
+        return false;
+    }
+    char prefix[kLengthPrefixBytes];
+    for (std::size_t idx = 0; idx < kLengthPrefixBytes; ++idx)
+    {
+        prefix[idx] = static_cast<char>((payload.size() >> (8 * idx)) & 0xffU);
+    }
+    out.append(prefix, sizeof(prefix));
+    out.append(payload.data(), payload.size());
+    return true;
+}
+
+// In-memory counterpart of IoEnvelopeStreamReader::next(): same records, same errors.
+FrameStatus nextArchiveRecord(std::string_view data,
+                              std::size_t &pos,
+                              IoEnvelopeFraming framing,
+                              std::size_t maxRecordBytes,
+                              std::string_view &record,
+                              std::string &error)
+{
+    if (framing == IoEnvelopeFraming::Newline)
+    {
+        while (pos < data.size())
+        {
+            const void *found = std::memchr(data.data() + pos, '\n', data.size() - pos);
+            std::size_t lineEnd = found != nullptr ? static_cast<std::size_t>(static_cast<const char *>(found) - data.data())
+                                                   : data.size();
+            std::string_view line = trimCarriageReturn(data.substr(pos, lineEnd - pos));
+            pos = found != nullptr ? lineEnd + 1 : lineEnd;
+            if (line.empty())
+            {
+                continue;
+            }
+            if (line.size() > maxRecordBytes)
+            {
+                error = "record exceeds max_record_bytes";
+                return FrameStatus::Error;
+            }
+            record = line;
+            return FrameStatus::Record;
+        }
+        return FrameStatus::End;
+    }
+    if (pos >= data.size())
+    {
+        return FrameStatus::End;
+    }
+    if (data.size() - pos < kLengthPrefixBytes)
+    {
+        error = "truncated length prefix";
+        return FrameStatus::Error;
+    }
+    std::size_t length = readLengthPrefix(data.data() + pos);
+    if (length > maxRecordBytes)
+    {
+        error = "record exceeds max_record_bytes";
+        return FrameStatus::Error;
+    }
+    if (data.size() - pos - kLengthPrefixBytes < length)
+    {
+        error = "truncated record";
+        return FrameStatus::Error;
+    }
+    record = data.substr(pos + kLengthPrefixBytes, length);
+    pos += kLengthPrefixBytes + length;
+    return FrameStatus::Record;
+}
+
+std::string recordError(std::uint64_t index, const std::string &error)
+{
+    return "record " + std::to_string(index) + ": " + error;
+}
+
+bool checkStreamOptions(const IoEnvelopeStreamOptions &options, std::string &error)
+{
+    if (!isIoEnvelopeFramingSupported(options.inputFormat, options.inputFraming))
+    {
+        error = "newline framing does not support input format: " + ioEnvelopeFormatName(options.inputFormat);
+        return false;
+    }
+    if (!isIoEnvelopeFramingSupported(options.outputFormat, options.outputFraming))
+    {
+        error = "newline framing does not support output format: " + ioEnvelopeFormatName(options.outputFormat);
+        return false;
+    }
+    return true;
+}
+
+// End of the chunk starting at `pos`: the first record boundary at or past pos + chunkBytes. A
+// framing error inside the chunk is left for the chunk's worker to report.
+std::size_t chunkEnd(std::string_view archive, std::size_t pos, const IoEnvelopeStreamOptions &options)
+{
+    std::size_t target = pos + std::max<std::size_t>(options.chunkBytes, 1);
+    if (target >= archive.size())
+    {
+        return archive.size();
+    }
+    if (options.inputFraming == IoEnvelopeFraming::Newline)
+    {
+        const void *found = std::memchr(archive.data() + target - 1, '\n', archive.size() - (target - 1));
+        return found != nullptr ? static_cast<std::size_t>(static_cast<const char *>(found) - archive.data()) + 1
+                                : archive.size();
+    }
+    while (pos < target)
+    {
+        if (archive.size() - pos < kLengthPrefixBytes)
+        {
+            return archive.size();
+        }
+        std::size_t length = readLengthPrefix(archive.data() + pos);
+        if (length > options.maxRecordBytes || archive.size() - pos - kLengthPrefixBytes < length)
+        {
+            return archive.size();
+        }
+        pos += kLengthPrefixBytes + length;
+    }
+    return pos;
+}
+
+struct ChunkJob
+{
+    std::string_view input;
+    ExternalIoEnvelope envelope{};
+    std::string payload;
+    std::string output;
+    std::string error;
+    std::uint64_t records = 0;
+    bool failed = false;
+};
+
+void convertChunk(ChunkJob &job, const IoEnvelopeStreamOptions &options)
+{
+    job.output.clear();
+    job.records = 0;
+    job.failed = false;
+    std::size_t pos = 0;
+    std::string_view record;
+    while (true)
+    {
+        FrameStatus status = nextArchiveRecord(job.input, pos, options.inputFraming, options.maxRecordBytes, record, job.error);
+        if (status == FrameStatus::End)
+        {
+            return;
+        }
+        if (status == FrameStatus::Error ||
+            !parseExternalIoEnvelope(options.inputFormat, record, job.envelope, job.error) ||
+            !serializeExternalIoEnvelope(options.outputFormat, job.envelope, job.payload) ||
+            !appendFramedRecord(job.output, options.outputFraming, job.payload, job.error))
+        {
+            job.failed = true;
+            return;
+        }
+        ++job.records;
+    }
+}
+} // namespace
+
+bool parseIoEnvelopeFraming(const std::string &text, IoEnvelopeFraming &framing)
+{
+    if (text == "newline" || text == "ndjson")
+    {
+        framing = IoEnvelopeFraming::Newline;
+        return true;
+    }
+    if (text == "length" || text == "length_prefixed")
+    {
+        framing = IoEnvelopeFraming::LengthPrefixed;
+        return true;
+    }
+    return false;
+}
+
+std::string ioEnvelopeFramingName(IoEnvelopeFraming framing)
+{
+    return framing == IoEnvelopeFraming::Newline ? "newline" : "length";
+}
+
+bool isIoEnvelopeFramingSupported(IoEnvelopeFormat format, IoEnvelopeFraming framing)
+{
+    return framing == IoEnvelopeFraming::LengthPrefixed || format == IoEnvelopeFormat::Json;
+}
+
+int openIoEnvelopeStreamFile(const std::string &path, bool forWrite)
+{
+#if defined(_WIN32)
+    int flags = forWrite ? (_O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY) : (_O_RDONLY | _O_BINARY);
+    return _open(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+#else
+    int flags = forWrite ? (O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC) : (O_RDONLY | O_CLOEXEC);
+    return ::open(path.c_str(), flags, 0644);
+#endif
+}
+
+void closeIoEnvelopeStreamFile(int fd)
+{
+    if (fd < 0)
+    {
+        return;
+    }
+#if defined(_WIN32)
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+IoEnvelopeStreamReader::IoEnvelopeStreamReader(int fd, IoEnvelopeFraming framing, std::size_t maxRecordBytes)
+    : fd(fd),
+      framing(framing),
+      maxRecordBytes(maxRecordBytes)
+{
+}
+
+bool IoEnvelopeStreamReader::next(std::string_view &record)
+{
+    if (!errorText.empty())
+    {
+        return false;
+    }
+    std::size_t scanned = 0;
+    while (true)
+    {
+        std::size_t available = end - begin;
+        if (framing == IoEnvelopeFraming::Newline)
+        {
+            const char *start = window.data() + begin;
+            const void *found = std::memchr(start + scanned, '\n', available - scanned);
+            if (found == nullptr && !eof)
+            {
+                // One byte of slack for a '\r' that trimming will drop.
+                if (available > maxRecordBytes + 1)
+                {
+                    return fail("record exceeds max_record_bytes");
+                }
+                scanned = available;
+                if (!fill(available + 1))
+                {
+                    return false;
+                }
+                continue;
+            }
+            std::size_t lineLength = found != nullptr ? static_cast<std::size_t>(static_cast<const char *>(found) - start)
+                                                      : available;
+            std::string_view line = trimCarriageReturn(std::string_view(start, lineLength));
+            begin += found != nullptr ? lineLength + 1 : lineLength;
+            scanned = 0;
+            if (line.empty())
+            {
+                if (found == nullptr)
+                {
+                    return false;
+                }
+                continue;
+            }
+            if (line.size() > maxRecordBytes)
+            {
+                return fail("record exceeds max_record_bytes");
+            }
+            record = line;
+            ++recordCount;
+            return true;
+        }
+
+        if (available < kLengthPrefixBytes)
+        {
+            if (eof)
+            {
+                return available == 0 ? false : fail("truncated length prefix");
+            }
+            if (!fill(kLengthPrefixBytes))
+            {
+                return false;
+            }
+            continue;
+        }
+        std::size_t length = readLengthPrefix(window.data() + begin);
+        if (length > maxRecordBytes)
+        {
+            return fail("record exceeds max_record_bytes");
+        }
+        if (available - kLengthPrefixBytes < length)
+        {
+            if (eof)
+            {
+                return fail("truncated record");
+            }
+            if (!fill(kLengthPrefixBytes + length))
+            {
+                return false;
+            }
+            continue;
+        }
+        record = std::string_view(window.data() + begin + kLengthPrefixBytes, length);
+        begin += kLengthPrefixBytes + length;
+        ++recordCount;
+        return true;
+    }
+}
+
+bool IoEnvelopeStreamReader::failed() const
+{
+    return !errorText.empty();
+}
+
+const std::string &IoEnvelopeStreamReader::error() const
+{
+    return errorText;
+}
+
+std::uint64_t IoEnvelopeStreamReader::records() const
+{
+    return recordCount;
+}
+
+std::uint64_t IoEnvelopeStreamReader::bytesRead() const
+{
+    return byteCount;
+}
+
+// Moves unread bytes to the front, grows the window if `needed` bytes would not fit, and performs
+// one read. Hitting end of stream is not an error; the caller sees `eof` and decides.
+bool IoEnvelopeStreamReader::fill(std::size_t needed)
+{
+    if (begin > 0)
+    {
+        std::memmove(&window[0], window.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+    if (window.size() < needed || window.size() == end)
+    {
+        std::size_t grown = std::max({needed, window.size() * 2, kInitialWindowBytes});
+        window.resize(std::min(grown, std::max(needed, maxRecordBytes + kLengthPrefixBytes)));
+    }
+    if (window.size() == end)
+    {
+        return fail("record exceeds max_record_bytes");
+    }
+    long got = readSome(fd, &window[end], window.size() - end);
+    if (got < 0)
+    {
+        return fail("read failed");
+    }
+    if (got == 0)
+    {
+        eof = true;
+    }
+    end += static_cast<std::size_t>(got);
+    byteCount += static_cast<std::uint64_t>(got);
+    return true;
+}
+
+bool IoEnvelopeStreamReader::fail(const std::string &message)
+{
+    errorText = message;
+    return false;
+}
+
+IoEnvelopeStreamWriter::IoEnvelopeStreamWriter(int fd, IoEnvelopeFraming framing, std::size_t flushBytes)
+    : fd(fd),
+      framing(framing),
+      flushBytes(flushBytes)
+{
+    buffer.reserve(flushBytes + kInitialWindowBytes);
+}
+
+IoEnvelopeStreamWriter::~IoEnvelopeStreamWriter()
+{
+    flush();
+}
+
+bool IoEnvelopeStreamWriter::write(std::string_view payload)
+{
+    if (!errorText.empty())
+    {
+        return false;
+    }
+    if (!appendFramedRecord(buffer, framing, payload, errorText))
+    {
+        return false;
+    }
+    ++recordCount;
+    return buffer.size() < flushBytes || flush();
+}
+
+bool IoEnvelopeStreamWriter::flush()
+{
+    if (!errorText.empty())
+    {
+        return false;
+    }
+    if (buffer.empty())
+    {
+        return true;
+    }
+    if (!writeAll(fd, buffer.data(), buffer.size()))
+    {
+        errorText = "write failed";
+        return false;
+    }
+    byteCount += buffer.size();
+    buffer.clear();
+    return true;
+}
+
+bool IoEnvelopeStreamWriter::failed() const
+{
+    return !errorText.empty();
+}
+
+const std::string &IoEnvelopeStreamWriter::error() const
+{
+    return errorText;
+}
+
+std::uint64_t IoEnvelopeStreamWriter::records() const
+{
+    return recordCount;
+}
+
+std::uint64_t IoEnvelopeStreamWriter::bytesWritten() const
+{
+    return byteCount;
+}
+
+bool IoEnvelopeArchive::open(const std::string &path, std::string &error)
+{
+    switch (file.open(path))
+    {
+    case MappedFileStatus::Ok:
+        return true;
+    case MappedFileStatus::OpenFailed:
+        error = "failed to open archive: " + path;
+        return false;
+    case MappedFileStatus::StatFailed:
+        error = "failed to stat archive: " + path;
+        return false;
+    case MappedFileStatus::MapFailed:
+        error = "failed to map archive: " + path;
+        return false;
+    }
+    return false;
+}
+
+void IoEnvelopeArchive::close()
+{
+    file.close();
+}
+
+std::string_view IoEnvelopeArchive::bytes() const
+{
+    return file.bytes();
+}
+
+IoEnvelopeStreamResult convertExternalIoEnvelopeStream(int inputFd, int outputFd, const IoEnvelopeStreamOptions &options)
+{
+    IoEnvelopeStreamResult result;
+    if (!checkStreamOptions(options, result.error))
+    {
+        return result;
+    }
+    IoEnvelopeStreamReader reader(inputFd, options.inputFraming, options.maxRecordBytes);
+    IoEnvelopeStreamWriter writer(outputFd, options.outputFraming);
+    ExternalIoEnvelope envelope{};
+    std::string payload;
+    std::string error;
+    std::string_view record;
+    while (reader.next(record))
+    {
+        if (!parseExternalIoEnvelope(options.inputFormat, record, envelope, error) ||
+            !serializeExternalIoEnvelope(options.outputFormat, envelope, payload))
+        {
+            result.error = recordError(reader.records() - 1, error);
+            break;
+        }
+        if (!writer.write(payload))
+        {
+            result.error = writer.error();
+            break;
+        }
+    }
+    if (result.error.empty() && reader.failed())
+    {
+        result.error = recordError(reader.records(), reader.error());
+    }
+    if (!writer.flush() && result.error.empty())
+    {
+        result.error = writer.error();
+    }
+    result.records = writer.records();
+    result.bytesIn = reader.bytesRead();
+    result.bytesOut = writer.bytesWritten();
+    result.ok = result.error.empty();
+    return result;
+}
+
+IoEnvelopeStreamResult convertExternalIoEnvelopeArchive(std::string_view archive,
+                                                        int outputFd,
+                                                        const IoEnvelopeStreamOptions &options)
+{
+    IoEnvelopeStreamResult result;
+    if (!checkStreamOptions(options, result.error))
+    {
+        return result;
+    }
+    std::size_t workers = std::max<std::size_t>(options.workers, 1);
+    std::vector<ChunkJob> jobs(workers);
+    WorkStealingPool pool(workers);
+    std::size_t pos = 0;
+    while (pos < archive.size() && result.error.empty())
+    {
+        std::size_t count = 0;
+        for (; count < workers && pos < archive.size(); ++count)
+        {
+            std::size_t next = chunkEnd(archive, pos, options);
+            jobs[count].input = archive.substr(pos, next - pos);
+            pos = next;
+        }
+        pool.parallelFor(count, [&](std::size_t index, std::size_t) { convertChunk(jobs[index], options); });
+
+        // Output goes out in archive order and stops at the first failing chunk, so the bytes
+        // written match the sequential converter's whichever chunk finished first.
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            ChunkJob &job = jobs[index];
+            if (!writeAll(outputFd, job.output.data(), job.output.size()))
+            {
+                result.error = "write failed";
+                break;
+            }
+            result.bytesIn += job.input.size();
+            result.bytesOut += job.output.size();
+            if (job.failed)
+            {
+                result.error = recordError(result.records + job.records, job.error);
+                result.records += job.records;
+                break;
+            }
+            result.records += job.records;
+        }
+    }
+    result.ok = result.error.empty();
+    return result;
+}
+} // namespace tools
@@ -1,15 +1,22 @@
 #include "tools/io_packager.h"
 
+#include <algorithm>
+#include <charconv>
 #include <cmath>
 #include <cctype>
+#include <cstdint>
 #include <cstdlib>
-#include <iomanip>
+#include <cstring>
+#include <deque>
 #include <limits>
-#include <map>
-#include <sstream>
+#include <string_view>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "tools/binary_wire.h"
+#include "tools/perfect_hash.h"
+
 namespace tools
 {
 namespace
@@ -49,7 +56,8 @@ const std::vector<BuiltinCodec> &builtinCodecs()
 {
     static const std::vector<BuiltinCodec> kCodecs = {
         {IoEnvelopeFormat::Json, "ie_json_v1", {"json"}},
-        {IoEnvelopeFormat::KeyValue, "ie_kv_v1", {"kv", "keyvalue"}}};
+        {IoEnvelopeFormat::KeyValue, "ie_kv_v1", {"kv", "keyvalue"}},
+        {IoEnvelopeFormat::Binary, "ie_bin_v1", {"bin", "binary"}}};
     return kCodecs;
 }
 
@@ -87,281 +95,232 @@ const BuiltinCodec *findCodecByName(const std::string &text)
     return nullptr;
 }
 
-bool parseBoolStrict(const std::string &value, bool &out)
+bool parseIntStrict(const std::string &value, int &out)
 {
-    const std::string lowered = toLower(value);
-    if (lowered == "true" || lowered == "1")
+    if (value.empty())
     {
-        out = true;
-        return true;
+        return false;
     }
-    if (lowered == "false" || lowered == "0")
+    char *endPtr = nullptr;
+    const long parsed = std::strtol(value.c_str(), &endPtr, 10);
+    if (endPtr == nullptr || *endPtr != '\0' ||
+        parsed < static_cast<long>(std::numeric_limits<int>::min()) ||
+        parsed > static_cast<long>(std::numeric_limits<int>::max()))
     {
-        out = false;
-        return true;
+        return false;
     }
-    return false;
+    out = static_cast<int>(parsed);
+    return true;
 }
 
-bool parseUnsignedStrict(const std::string &value, unsigned int &out)
+bool parseDoubleStrict(const std::string &value, double &out)
 {
     if (value.empty())
     {
         return false;
     }
-    for (char ch : value)
+    char *endPtr = nullptr;
+    const double parsed = std::strtod(value.c_str(), &endPtr);
+    if (endPtr == nullptr || *endPtr != '\0')
     {
-        if (!std::isdigit(static_cast<unsigned char>(ch)))
-        {
-            return false;
-        }
+        return false;
     }
-    char *endPtr = nullptr;
-    const unsigned long parsed = std::strtoul(value.c_str(), &endPtr, 10);
-    if (endPtr == nullptr || *endPtr != '\0' ||
-        parsed > static_cast<unsigned long>(std::numeric_limits<unsigned int>::max()))
+    if (!std::isfinite(parsed))
     {
         return false;
     }
-    out = static_cast<unsigned int>(parsed);
+    out = parsed;
     return true;
 }
 
-bool parseUInt64Strict(const std::string &value, std::uint64_t &out)
+
+bool equalsIgnoreCase(std::string_view text, const char *lowered)
 {
-    if (value.empty())
-    {
-        return false;
-    }
-    for (char ch : value)
+    std::size_t idx = 0;
+    for (; lowered[idx] != '\0'; ++idx)
     {
-        if (!std::isdigit(static_cast<unsigned char>(ch)))
+        if (idx >= text.size() || std::tolower(static_cast<unsigned char>(text[idx])) != lowered[idx])
         {
             return false;
         }
     }
-    char *endPtr = nullptr;
-    const unsigned long long parsed = std::strtoull(value.c_str(), &endPtr, 10);
-    if (endPtr == nullptr || *endPtr != '\0')
-    {
-        return false;
-    }
-    out = static_cast<std::uint64_t>(parsed);
-    return true;
+    return idx == text.size();
 }
 
-bool parseIntStrict(const std::string &value, int &out)
+bool parseBoolText(std::string_view text, bool &out)
 {
-    if (value.empty())
+    if (equalsIgnoreCase(text, "true") || text == "1")
     {
-        return false;
+        out = true;
+        return true;
     }
-    char *endPtr = nullptr;
-    const long parsed = std::strtol(value.c_str(), &endPtr, 10);
-    if (endPtr == nullptr || *endPtr != '\0' ||
-        parsed < static_cast<long>(std::numeric_limits<int>::min()) ||
-        parsed > static_cast<long>(std::numeric_limits<int>::max()))
+    if (equalsIgnoreCase(text, "false") || text == "0")
     {
-        return false;
+        out = false;
+        return true;
     }
-    out = static_cast<int>(parsed);
-    return true;
+    return false;
 }
 
-bool parseDoubleStrict(const std::string &value, double &out)
+bool parseUnsignedText(std::string_view text, unsigned int &out)
 {
-    if (value.empty())
-    {
-        return false;
-    }
-    char *endPtr = nullptr;
-    const double parsed = std::strtod(value.c_str(), &endPtr);
-    if (endPtr == nullptr || *endPtr != '\0')
+    const char *end = text.data() + text.size();
+    const auto parsed = std::from_chars(text.data(), end, out);
+    return !text.empty() && parsed.ec == std::errc() && parsed.ptr == end;
+}
+
+// Digits only; values past 2^64 - 1 saturate, as strtoull does.
+bool parseUInt64Text(std::string_view text, std::uint64_t &out)
+{
+    const char *end = text.data() + text.size();
+    const auto parsed = std::from_chars(text.data(), end, out);
+    if (text.empty() || parsed.ptr != end)
     {
         return false;
     }
-    if (!std::isfinite(parsed))
+    if (parsed.ec == std::errc::result_out_of_range)
     {
-        return false;
+        out = std::numeric_limits<std::uint64_t>::max();
+        return true;
     }
-    out = parsed;
-    return true;
+    return parsed.ec == std::errc();
 }
 
-std::string formatDoubleExact(double value)
+// from_chars covers plain decimal text; anything else goes through the strtol/strtod forms, which
+// also accept leading whitespace, '+', and (for doubles) hex and underflowing values.
+bool parseIntText(std::string_view text, int &out)
 {
-    std::ostringstream stream;
-    stream << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
-    return stream.str();
+    const char *end = text.data() + text.size();
+    const auto parsed = std::from_chars(text.data(), end, out);
+    if (!text.empty() && parsed.ec == std::errc() && parsed.ptr == end)
+    {
+        return true;
+    }
+    return parseIntStrict(std::string(text), out);
 }
 
-std::vector<std::string> split(const std::string &value, char delimiter)
+bool parseDoubleText(std::string_view text, double &out)
 {
-    std::vector<std::string> parts;
-    std::string current;
-    for (char ch : value)
+    double value = 0.0;
+    const char *end = text.data() + text.size();
+    const auto parsed = std::from_chars(text.data(), end, value);
+    if (!text.empty() && parsed.ec == std::errc() && parsed.ptr == end)
     {
-        if (ch == delimiter)
-        {
-            parts.push_back(current);
-            current.clear();
-        }
-        else
+        if (!std::isfinite(value))
         {
-            current.push_back(ch);
+            return false;
         }
+        out = value;
+        return true;
     }
-    parts.push_back(current);
-    return parts;
+    return parseDoubleStrict(std::string(text), out);
 }
 
-std::string kvEscape(const std::string &value)
+// A value as it sits in the payload: string contents between the quotes, or a bare JSON
+// number/literal. Escapes were validated while scanning; decoding waits for the destination field.
+struct ValueToken
 {
-    std::string escaped;
-    escaped.reserve(value.size() + 8);
-    for (char ch : value)
+    std::string_view raw;
+    bool escaped = false;
+};
+
+void decodeEscapes(std::string_view raw, std::string &out)
+{
+    out.clear();
+    for (std::size_t pos = 0; pos < raw.size(); ++pos)
     {
-        switch (ch)
+        char ch = raw[pos];
+        if (ch == '\\' && pos + 1 < raw.size())
         {
-        case '\\':
-            escaped += "\\\\";
-            break;
-        case '\n':
-            escaped += "\\n";
-            break;
-        case '\r':
-            escaped += "\\r";
-            break;
-        default:
-            escaped.push_back(ch);
-            break;
+            ch = raw[++pos];
+            ch = ch == 'n' ? '\n' : (ch == 'r' ? '\r' : (ch == 't' ? '\t' : ch));
         }
+        out.push_back(ch);
     }
-    return escaped;
 }
 
-bool kvUnescape(const std::string &value, std::string &out)
+void assignToken(const ValueToken &token, std::string &out)
 {
-    out.clear();
-    out.reserve(value.size());
-    bool escape = false;
-    for (char ch : value)
+    if (token.escaped)
     {
-        if (!escape)
-        {
-            if (ch == '\\')
-            {
-                escape = true;
-            }
-            else
-            {
-                out.push_back(ch);
-            }
-            continue;
-        }
+        decodeEscapes(token.raw, out);
+    }
+    else
+    {
+        out.assign(token.raw.data(), token.raw.size());
+    }
+}
 
-        if (ch == 'n')
-        {
-            out.push_back('\n');
-        }
-        else if (ch == 'r')
-        {
-            out.push_back('\r');
-        }
-        else if (ch == '\\')
-        {
-            out.push_back('\\');
-        }
-        else
-        {
-            return false;
-        }
-        escape = false;
+std::string_view tokenText(const ValueToken &token, std::string &scratch)
+{
+    if (!token.escaped)
+    {
+        return token.raw;
     }
-    return !escape;
+    decodeEscapes(token.raw, scratch);
+    return scratch;
 }
 
-std::string jsonEscape(const std::string &value)
+bool kvScanValue(std::string_view raw, ValueToken &token)
 {
-    std::string escaped;
-    escaped.reserve(value.size() + 8);
-    for (char ch : value)
+    token.raw = raw;
+    token.escaped = false;
+    for (std::size_t pos = 0; pos < raw.size(); ++pos)
     {
-        switch (ch)
+        if (raw[pos] != '\\')
         {
-        case '\\':
-            escaped += "\\\\";
-            break;
-        case '"':
-            escaped += "\\\"";
-            break;
-        case '\n':
-            escaped += "\\n";
-            break;
-        case '\r':
-            escaped += "\\r";
-            break;
-        case '\t':
-            escaped += "\\t";
-            break;
-        default:
-            escaped.push_back(ch);
-            break;
+            continue;
         }
+        if (++pos >= raw.size() || (raw[pos] != 'n' && raw[pos] != 'r' && raw[pos] != '\\'))
+        {
+            return false;
+        }
+        token.escaped = true;
     }
-    return escaped;
+    return true;
 }
 
-bool jsonParseString(const std::string &text, std::size_t &pos, std::string &value)
+bool jsonScanString(std::string_view text, std::size_t &pos, ValueToken &token)
 {
     if (pos >= text.size() || text[pos] != '"')
     {
         return false;
     }
-    ++pos;
-    value.clear();
+    const std::size_t start = ++pos;
+    token.escaped = false;
+    // Jump between quotes with memchr; only a backslash in between needs a closer look.
     while (pos < text.size())
     {
-        const char ch = text[pos++];
-        if (ch == '"')
+        const char *base = text.data();
+        const void *quote = std::memchr(base + pos, '"', text.size() - pos);
+        if (quote == nullptr)
         {
-            return true;
+            return false;
         }
-        if (ch != '\\')
+        const std::size_t quotePos = static_cast<const char *>(quote) - base;
+        const void *backslash = std::memchr(base + pos, '\\', quotePos - pos);
+        if (backslash == nullptr)
         {
-            value.push_back(ch);
-            continue;
+            token.raw = text.substr(start, quotePos - start);
+            pos = quotePos + 1;
+            return true;
         }
+        pos = static_cast<std::size_t>(static_cast<const char *>(backslash) - base) + 1;
         if (pos >= text.size())
         {
             return false;
         }
         const char esc = text[pos++];
-        switch (esc)
+        if (esc != '"' && esc != '\\' && esc != 'n' && esc != 'r' && esc != 't')
         {
-        case '"':
-            value.push_back('"');
-            break;
-        case '\\':
-            value.push_back('\\');
-            break;
-        case 'n':
-            value.push_back('\n');
-            break;
-        case 'r':
-            value.push_back('\r');
-            break;
-        case 't':
-            value.push_back('\t');
-            break;
-        default:
             return false;
         }
+        token.escaped = true;
     }
     return false;
 }
 
-bool jsonMatchLiteral(const std::string &text, std::size_t &pos, const char *literal)
+bool jsonMatchLiteral(std::string_view text, std::size_t &pos, const char *literal)
 {
     std::size_t idx = 0;
     while (literal[idx] != '\0')
@@ -376,7 +335,12 @@ bool jsonMatchLiteral(const std::string &text, std::size_t &pos, const char *lit
     return true;
 }
 
-bool jsonParseNumber(const std::string &text, std::size_t &pos, std::string &value)
+bool isDigit(std::string_view text, std::size_t pos)
+{
+    return pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])) != 0;
+}
+
+bool jsonScanNumber(std::string_view text, std::size_t &pos, ValueToken &token)
 {
     const std::size_t start = pos;
     if (pos < text.size() && text[pos] == '-')
@@ -391,9 +355,9 @@ bool jsonParseNumber(const std::string &text, std::size_t &pos, std::string &val
     {
         ++pos;
     }
-    else if (std::isdigit(static_cast<unsigned char>(text[pos])) != 0)
+    else if (isDigit(text, pos))
     {
-        while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])) != 0)
+        while (isDigit(text, pos))
         {
             ++pos;
         }
@@ -405,11 +369,11 @@ bool jsonParseNumber(const std::string &text, std::size_t &pos, std::string &val
     if (pos < text.size() && text[pos] == '.')
     {
         ++pos;
-        if (pos >= text.size() || std::isdigit(static_cast<unsigned char>(text[pos])) == 0)
+        if (!isDigit(text, pos))
         {
             return false;
         }
-        while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])) != 0)
+        while (isDigit(text, pos))
         {
             ++pos;
         }
@@ -421,20 +385,21 @@ bool jsonParseNumber(const std::string &text, std::size_t &pos, std::string &val
         {
             ++pos;
         }
-        if (pos >= text.size() || std::isdigit(static_cast<unsigned char>(text[pos])) == 0)
+        if (!isDigit(text, pos))
         {
             return false;
         }
-        while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])) != 0)
+        while (isDigit(text, pos))
         {
             ++pos;
         }
     }
-    value = text.substr(start, pos - start);
+    token.raw = text.substr(start, pos - start);
+    token.escaped = false;
     return true;
 }
 
-bool jsonParseValue(const std::string &text, std::size_t &pos, std::string &value, std::string &error)
+bool jsonScanValue(std::string_view text, std::size_t &pos, ValueToken &token, std::string &error)
 {
     if (pos >= text.size())
     {
@@ -444,7 +409,7 @@ bool jsonParseValue(const std::string &text, std::size_t &pos, std::string &valu
     const char ch = text[pos];
     if (ch == '"')
     {
-        if (!jsonParseString(text, pos, value))
+        if (!jsonScanString(text, pos, token))
         {
             error = "json invalid string value";
             return false;
@@ -453,31 +418,23 @@ bool jsonParseValue(const std::string &text, std::size_t &pos, std::string &valu
     }
     if (ch == '-' || std::isdigit(static_cast<unsigned char>(ch)) != 0)
     {
-        if (!jsonParseNumber(text, pos, value))
+        if (!jsonScanNumber(text, pos, token))
         {
             error = "json invalid numeric value";
             return false;
         }
         return true;
     }
-    if (ch == 't')
+    if (ch == 't' || ch == 'f')
     {
-        if (!jsonMatchLiteral(text, pos, "true"))
+        const std::size_t start = pos;
+        if (!jsonMatchLiteral(text, pos, ch == 't' ? "true" : "false"))
         {
             error = "json invalid literal";
             return false;
         }
-        value = "true";
-        return true;
-    }
-    if (ch == 'f')
-    {
-        if (!jsonMatchLiteral(text, pos, "false"))
-        {
-            error = "json invalid literal";
-            return false;
-        }
-        value = "false";
+        token.raw = text.substr(start, pos - start);
+        token.escaped = false;
         return true;
     }
     if (ch == 'n')
@@ -494,7 +451,7 @@ bool jsonParseValue(const std::string &text, std::size_t &pos, std::string &valu
     return false;
 }
 
-void jsonSkipWhitespace(const std::string &text, std::size_t &pos)
+void jsonSkipWhitespace(std::string_view text, std::size_t &pos)
 {
     while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos])) != 0)
     {
@@ -502,374 +459,1561 @@ void jsonSkipWhitespace(const std::string &text, std::size_t &pos)
     }
 }
 
-bool parseFlatJson(const std::string &payload, std::map<std::string, std::string> &out, std::string &error)
+void appendKvEscaped(std::string &out, const std::string &value)
 {
-    out.clear();
-    std::size_t pos = 0;
-    jsonSkipWhitespace(payload, pos);
-    if (pos >= payload.size() || payload[pos] != '{')
-    {
-        error = "json must start with '{'";
-        return false;
-    }
-    ++pos;
-    jsonSkipWhitespace(payload, pos);
-    if (pos < payload.size() && payload[pos] == '}')
-    {
-        ++pos;
-        return true;
-    }
-
-    while (pos < payload.size())
+    for (char ch : value)
     {
-        jsonSkipWhitespace(payload, pos);
-        std::string key;
-        if (!jsonParseString(payload, pos, key))
-        {
-            error = "json invalid key";
-            return false;
-        }
-        jsonSkipWhitespace(payload, pos);
-        if (pos >= payload.size() || payload[pos] != ':')
-        {
-            error = "json missing ':'";
-            return false;
-        }
-        ++pos;
-        jsonSkipWhitespace(payload, pos);
-
-        std::string value;
-        if (!jsonParseValue(payload, pos, value, error))
-        {
-            return false;
-        }
-        if (out.find(key) != out.end())
-        {
-            error = "json duplicate key: " + key;
-            return false;
-        }
-        out[key] = value;
-
-        jsonSkipWhitespace(payload, pos);
-        if (pos >= payload.size())
-        {
-            error = "json unexpected end";
-            return false;
-        }
-        if (payload[pos] == '}')
-        {
-            ++pos;
-            jsonSkipWhitespace(payload, pos);
-            if (pos != payload.size())
-            {
-                error = "json trailing content";
-                return false;
-            }
-            return true;
-        }
-        if (payload[pos] != ',')
+        switch (ch)
         {
-            error = "json missing ','";
-            return false;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        default:
+            out.push_back(ch);
+            break;
         }
-        ++pos;
     }
-
-    error = "json unexpected end";
-    return false;
 }
 
-void flattenEnvelope(const ExternalIoEnvelope &envelope, std::map<std::string, std::string> &flat)
+void appendJsonEscaped(std::string &out, const std::string &value)
 {
-    flat.clear();
-    flat["schema_version"] = envelope.metadata.schemaVersion;
-    flat["interface_id"] = envelope.metadata.interfaceId;
-    flat["metadata.platform_profile"] = envelope.metadata.platformProfile;
-    flat["metadata.adapter_id"] = envelope.metadata.adapterId;
-    flat["metadata.adapter_version"] = envelope.metadata.adapterVersion;
-    flat["metadata.ui_surface"] = envelope.metadata.uiSurface;
-    flat["metadata.seed"] = std::to_string(envelope.metadata.seed);
-    flat["metadata.deterministic"] = envelope.metadata.deterministic ? "true" : "false";
-
-    flat["mode.active"] = envelope.mode.activeMode;
-    flat["mode.confidence"] = formatDoubleExact(envelope.mode.confidence);
-    flat["mode.decision_reason"] = envelope.mode.decisionReason;
-    flat["mode.denial_reason"] = envelope.mode.denialReason;
-    flat["mode.ladder_status"] = envelope.mode.ladderStatus;
+    for (char ch : value)
     {
-        std::ostringstream contributors;
-        for (std::size_t idx = 0; idx < envelope.mode.contributors.size(); ++idx)
+        switch (ch)
         {
-            contributors << envelope.mode.contributors[idx];
-            if (idx + 1 < envelope.mode.contributors.size())
-            {
-                contributors << ",";
-            }
+        case '\\':
+            out += "\\\\";
+            break;
+        case '"':
+            out += "\\\"";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            out.push_back(ch);
+            break;
         }
-        flat["mode.contributors"] = contributors.str();
     }
+}
 
-    flat["sensor.count"] = std::to_string(envelope.sensors.size());
-    for (std::size_t idx = 0; idx < envelope.sensors.size(); ++idx)
+const std::string_view kBinaryEnvelopeMagic("ATIE", 4);
+constexpr std::uint64_t kBinaryEnvelopeVersion = 1;
+
+// Envelope schema. Each record type lists its fields in the byte order of their key names, which
+// is the canonical order payload keys are written in. Serializer and parser both work from these
+// tables.
+enum class FieldKind
+{
+    Text,
+    TextList,
+    Flag,
+    Unsigned,
+    Wide,
+    Signed,
+    Real
+};
+
+enum class Presence
+{
+    Optional,
+    Required
+};
+
+template <typename Record>
+struct FieldSchema
+{
+    FieldSchema(const char *name, std::string Record::*member, Presence presence)
+        : name(name), kind(FieldKind::Text), presence(presence), text(member)
+    {
+    }
+    FieldSchema(const char *name, std::vector<std::string> Record::*member, Presence presence)
+        : name(name), kind(FieldKind::TextList), presence(presence), list(member)
+    {
+    }
+    FieldSchema(const char *name, bool Record::*member, Presence presence)
+        : name(name), kind(FieldKind::Flag), presence(presence), flag(member)
+    {
+    }
+    FieldSchema(const char *name, unsigned int Record::*member, Presence presence)
+        : name(name), kind(FieldKind::Unsigned), presence(presence), number(member)
+    {
+    }
+    FieldSchema(const char *name, std::uint64_t Record::*member, Presence presence)
+        : name(name), kind(FieldKind::Wide), presence(presence), wide(member)
+    {
+    }
+    FieldSchema(const char *name, int Record::*member, Presence presence)
+        : name(name), kind(FieldKind::Signed), presence(presence), integer(member)
+    {
+    }
+    FieldSchema(const char *name, double Record::*member, Presence presence)
+        : name(name), kind(FieldKind::Real), presence(presence), real(member)
+    {
+    }
+
+    const char *name = "";
+    FieldKind kind = FieldKind::Text;
+    Presence presence = Presence::Optional;
+    std::string Record::*text = nullptr;
+    std::vector<std::string> Record::*list = nullptr;
+    bool Record::*flag = nullptr;
+    unsigned int Record::*number = nullptr;
+    std::uint64_t Record::*wide = nullptr;
+    int Record::*integer = nullptr;
+    double Record::*real = nullptr;
+};
+
+constexpr Presence kOptional = Presence::Optional;
+constexpr Presence kRequired = Presence::Required;
+
+// interface_id and schema_version sit at the top level, outside the metadata.* block.
+const FieldSchema<ExternalIoMetadata> kIdentityFields[] = {
+    {"interface_id", &ExternalIoMetadata::interfaceId, kRequired},
+    {"schema_version", &ExternalIoMetadata::schemaVersion, kRequired}};
+
+const FieldSchema<ExternalIoMetadata> kMetadataFields[] = {
+    {"adapter_id", &ExternalIoMetadata::adapterId, kRequired},
+    {"adapter_version", &ExternalIoMetadata::adapterVersion, kRequired},
+    {"deterministic", &ExternalIoMetadata::deterministic, kRequired},
+    {"platform_profile", &ExternalIoMetadata::platformProfile, kRequired},
+    {"seed", &ExternalIoMetadata::seed, kRequired},
+    {"ui_surface", &ExternalIoMetadata::uiSurface, kRequired}};
+
+const FieldSchema<ExternalIoModeRecord> kModeFields[] = {
+    {"active", &ExternalIoModeRecord::activeMode, kRequired},
+    {"confidence", &ExternalIoModeRecord::confidence, kRequired},
+    {"contributors", &ExternalIoModeRecord::contributors, kOptional},
+    {"decision_reason", &ExternalIoModeRecord::decisionReason, kOptional},
+    {"denial_reason", &ExternalIoModeRecord::denialReason, kOptional},
+    {"ladder_status", &ExternalIoModeRecord::ladderStatus, kOptional}};
+
+const FieldSchema<ExternalIoSensorRecord> kSensorFields[] = {
+    {"available", &ExternalIoSensorRecord::available, kRequired},
+    {"confidence", &ExternalIoSensorRecord::confidence, kRequired},
+    {"freshness_seconds", &ExternalIoSensorRecord::freshnessSeconds, kRequired},
+    {"has_measurement", &ExternalIoSensorRecord::hasMeasurement, kRequired},
+    {"healthy", &ExternalIoSensorRecord::healthy, kRequired},
+    {"id", &ExternalIoSensorRecord::sensorId, kRequired},
+    {"last_error", &ExternalIoSensorRecord::lastError, kOptional}};
+
+const FieldSchema<ExternalIoFrontViewRecord> kFrontViewFields[] = {
+    {"acquisition_latency_ms", &ExternalIoFrontViewRecord::acquisitionLatencyMs, kRequired},
+    {"active_mode", &ExternalIoFrontViewRecord::activeMode, kOptional},
+    {"auth_status", &ExternalIoFrontViewRecord::authStatus, kOptional},
+    {"confidence", &ExternalIoFrontViewRecord::confidence, kRequired},
+    {"drop_reason", &ExternalIoFrontViewRecord::dropReason, kOptional},
+    {"dropped_frames", &ExternalIoFrontViewRecord::droppedFrames, kRequired},
+    {"frame_age_ms", &ExternalIoFrontViewRecord::frameAgeMs, kRequired},
+    {"frame_id", &ExternalIoFrontViewRecord::frameId, kOptional},
+    {"gimbal_pitch_deg", &ExternalIoFrontViewRecord::gimbalPitchDeg, kRequired},
+    {"gimbal_pitch_rate_deg_s", &ExternalIoFrontViewRecord::gimbalPitchRateDegPerSec, kRequired},
+    {"gimbal_yaw_deg", &ExternalIoFrontViewRecord::gimbalYawDeg, kRequired},
+    {"gimbal_yaw_rate_deg_s", &ExternalIoFrontViewRecord::gimbalYawRateDegPerSec, kRequired},
+    {"latency_ms", &ExternalIoFrontViewRecord::latencyMs, kRequired},
+    {"max_concurrent_views", &ExternalIoFrontViewRecord::maxConcurrentViews, kRequired},
+    {"processing_latency_ms", &ExternalIoFrontViewRecord::processingLatencyMs, kRequired},
+    {"provenance", &ExternalIoFrontViewRecord::provenance, kOptional},
+    {"render_latency_ms", &ExternalIoFrontViewRecord::renderLatencyMs, kRequired},
+    {"sensor_type", &ExternalIoFrontViewRecord::sensorType, kOptional},
+    {"sequence", &ExternalIoFrontViewRecord::sequence, kRequired},
+    {"source_id", &ExternalIoFrontViewRecord::sourceId, kOptional},
+    {"spoof_active", &ExternalIoFrontViewRecord::spoofActive, kRequired},
+    {"stabilization_active", &ExternalIoFrontViewRecord::stabilizationActive, kRequired},
+    {"stabilization_error_deg", &ExternalIoFrontViewRecord::stabilizationErrorDeg, kRequired},
+    {"stabilization_mode", &ExternalIoFrontViewRecord::stabilizationMode, kOptional},
+    {"stream_count", &ExternalIoFrontViewRecord::streamCount, kRequired},
+    {"stream_id", &ExternalIoFrontViewRecord::streamId, kOptional},
+    {"stream_index", &ExternalIoFrontViewRecord::streamIndex, kRequired},
+    {"timestamp_ms", &ExternalIoFrontViewRecord::timestampMs, kRequired},
+    {"view_state", &ExternalIoFrontViewRecord::viewState, kOptional}};
+
+const FieldSchema<ExternalIoFrontViewStreamRecord> kFrontViewStreamFields[] = {
+    {"active_mode", &ExternalIoFrontViewStreamRecord::activeMode, kRequired},
+    {"confidence", &ExternalIoFrontViewStreamRecord::confidence, kRequired},
+    {"frame_age_ms", &ExternalIoFrontViewStreamRecord::frameAgeMs, kRequired},
+    {"frame_id", &ExternalIoFrontViewStreamRecord::frameId, kRequired},
+    {"latency_ms", &ExternalIoFrontViewStreamRecord::latencyMs, kRequired},
+    {"sensor_type", &ExternalIoFrontViewStreamRecord::sensorType, kRequired},
+    {"sequence", &ExternalIoFrontViewStreamRecord::sequence, kRequired},
+    {"stabilization_active", &ExternalIoFrontViewStreamRecord::stabilizationActive, kRequired},
+    {"stabilization_mode", &ExternalIoFrontViewStreamRecord::stabilizationMode, kRequired},
+    {"stream_id", &ExternalIoFrontViewStreamRecord::streamId, kRequired},
+    {"timestamp_ms", &ExternalIoFrontViewStreamRecord::timestampMs, kRequired}};
+
+const FieldSchema<ExternalIoEnvelope> kStatusFields[] = {
+    {"adapter_fields", &ExternalIoEnvelope::adapterFields, kOptional},
+    {"adapter_reason", &ExternalIoEnvelope::adapterReason, kOptional},
+    {"adapter_status", &ExternalIoEnvelope::adapterStatus, kOptional},
+    {"auth_status", &ExternalIoEnvelope::authStatus, kOptional},
+    {"disqualified_sources", &ExternalIoEnvelope::disqualifiedSources, kOptional},
+    {"lockout_status", &ExternalIoEnvelope::lockoutStatus, kOptional},
+    {"logging_status", &ExternalIoEnvelope::loggingStatus, kOptional},
+    {"provenance_status", &ExternalIoEnvelope::provenanceStatus, kOptional}};
+
+// Record counts are written from the vector sizes but parsed before the records are sized.
+struct RecordCounts
+{
+    unsigned int streams = 0;
+    unsigned int sensors = 0;
+};
+
+const FieldSchema<RecordCounts> kCountFields[] = {
+    {"front_view_stream.count", &RecordCounts::streams, kRequired},
+    {"sensor.count", &RecordCounts::sensors, kRequired}};
+
+template <typename Record>
+void resetField(const FieldSchema<Record> &field, Record &record)
+{
+    switch (field.kind)
+    {
+    case FieldKind::Text:
+        (record.*field.text).clear();
+        break;
+    case FieldKind::TextList:
+        (record.*field.list).clear();
+        break;
+    case FieldKind::Flag:
+        record.*field.flag = false;
+        break;
+    case FieldKind::Unsigned:
+        record.*field.number = 0;
+        break;
+    case FieldKind::Wide:
+        record.*field.wide = 0;
+        break;
+    case FieldKind::Signed:
+        record.*field.integer = 0;
+        break;
+    case FieldKind::Real:
+        record.*field.real = 0.0;
+        break;
+    }
+}
+
+template <typename Record, std::size_t N>
+void resetRecord(const FieldSchema<Record> (&schema)[N], Record &record)
+{
+    for (const auto &field : schema)
+    {
+        resetField(field, record);
+    }
+}
+
+// Writes the token into the field; returns false if the text does not parse as the field's type.
+// Comma-separated lists keep the capacity of the strings they overwrite.
+template <typename Record>
+bool assignField(const FieldSchema<Record> &field, Record &record, const ValueToken &token, std::string &scratch)
+{
+    switch (field.kind)
+    {
+    case FieldKind::Text:
+        assignToken(token, record.*field.text);
+        return true;
+    case FieldKind::TextList:
+    {
+        const std::string_view text = tokenText(token, scratch);
+        auto &items = record.*field.list;
+        if (text.empty())
+        {
+            items.clear();
+            return true;
+        }
+        std::size_t count = 0;
+        std::size_t start = 0;
+        while (true)
+        {
+            const std::size_t comma = text.find(',', start);
+            const std::string_view item = text.substr(start, comma == std::string_view::npos ? text.size() - start : comma - start);
+            if (count == items.size())
+            {
+                items.emplace_back();
+            }
+            items[count++].assign(item.data(), item.size());
+            if (comma == std::string_view::npos)
+            {
+                break;
+            }
+            start = comma + 1;
+        }
+        items.resize(count);
+        return true;
+    }
+    case FieldKind::Flag:
+        return parseBoolText(tokenText(token, scratch), record.*field.flag);
+    case FieldKind::Unsigned:
+        return parseUnsignedText(tokenText(token, scratch), record.*field.number);
+    case FieldKind::Wide:
+        return parseUInt64Text(tokenText(token, scratch), record.*field.wide);
+    case FieldKind::Signed:
+        return parseIntText(tokenText(token, scratch), record.*field.integer);
+    case FieldKind::Real:
+        return parseDoubleText(tokenText(token, scratch), record.*field.real);
+    }
+    return false;
+}
+
+// Successor of `index` when 0..count-1 are ordered as decimal strings (0, 1, 10, 11, 2, ...), so
+// indexed records come out in key order. Returns count after the last index.
+std::size_t nextKeyOrderIndex(std::size_t index, std::size_t count)
+{
+    if (index == 0)
+    {
+        return count > 1 ? 1 : count;
+    }
+    if (index <= (count - 1) / 10)
+    {
+        return index * 10;
+    }
+    while (index % 10 == 9 || index + 1 >= count)
+    {
+        index /= 10;
+        if (index == 0)
+        {
+            return count;
+        }
+    }
+    return index + 1;
+}
+
+// Appends "key": "value" pairs (JSON) or key=value lines (KV) straight into the output buffer.
+// Keys are assembled from prefix, index, and field name in place and numbers are formatted on the
+// stack, so nothing is allocated once the buffer has grown to the payload size.
+class EnvelopeWriter
+{
+public:
+    static constexpr std::size_t kNoIndex = static_cast<std::size_t>(-1);
+
+    EnvelopeWriter(IoEnvelopeFormat format, std::string &buffer)
+        : json(format != IoEnvelopeFormat::KeyValue), out(buffer)
+    {
+        if (json)
+        {
+            out.push_back('{');
+        }
+    }
+
+    void finish()
+    {
+        if (json)
+        {
+            out.push_back('}');
+        }
+    }
+
+    template <typename Record>
+    void field(const char *prefix, std::size_t index, const FieldSchema<Record> &entry, const Record &value)
+    {
+        beginValue(prefix, index, entry.name);
+        switch (entry.kind)
+        {
+        case FieldKind::Text:
+            appendText(value.*entry.text);
+            break;
+        case FieldKind::TextList:
+        {
+            const auto &items = value.*entry.list;
+            for (std::size_t idx = 0; idx < items.size(); ++idx)
+            {
+                if (idx > 0)
+                {
+                    out.push_back(',');
+                }
+                appendText(items[idx]);
+            }
+            break;
+        }
+        case FieldKind::Flag:
+            out += value.*entry.flag ? "true" : "false";
+            break;
+        case FieldKind::Unsigned:
+            appendNumber(value.*entry.number);
+            break;
+        case FieldKind::Wide:
+            appendNumber(value.*entry.wide);
+            break;
+        case FieldKind::Signed:
+            appendNumber(value.*entry.integer);
+            break;
+        case FieldKind::Real:
+            appendReal(value.*entry.real);
+            break;
+        }
+        endValue();
+    }
+
+    template <typename Record, std::size_t N>
+    void record(const char *prefix, std::size_t index, const Record &value, const FieldSchema<Record> (&schema)[N])
+    {
+        for (const auto &entry : schema)
+        {
+            field(prefix, index, entry, value);
+        }
+    }
+
+    // Indexed records followed by the "<prefix>count" key, which sorts after every digit.
+    template <typename Record, std::size_t N>
+    void records(const char *prefix, const std::vector<Record> &values, const FieldSchema<Record> (&schema)[N])
+    {
+        for (std::size_t idx = 0; idx < values.size(); idx = nextKeyOrderIndex(idx, values.size()))
+        {
+            record(prefix, idx, values[idx], schema);
+        }
+        beginValue(prefix, kNoIndex, "count");
+        appendNumber(values.size());
+        endValue();
+    }
+
+private:
+    void beginValue(const char *prefix, std::size_t index, const char *name)
+    {
+        if (json)
+        {
+            if (!first)
+            {
+                out.push_back(',');
+            }
+            out.push_back('"');
+        }
+        first = false;
+        out += prefix;
+        if (index != kNoIndex)
+        {
+            appendNumber(index);
+            out.push_back('.');
+        }
+        out += name;
+        out += json ? "\":\"" : "=";
+    }
+
+    void endValue()
+    {
+        out += json ? "\"" : "\n";
+    }
+
+    template <typename Number>
+    void appendNumber(Number value)
+    {
+        char buffer[32];
+        const auto converted = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, converted.ptr);
+    }
+
+    void appendReal(double value)
+    {
+        // General form with max_digits10 (17) significant digits, the same text as printf("%.17g").
+        char buffer[64];
+        const auto converted = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general,
+                                             std::numeric_limits<double>::max_digits10);
+        out.append(buffer, converted.ptr);
+    }
+
+    void appendText(const std::string &text)
+    {
+        if (json)
+        {
+            appendJsonEscaped(out, text);
+        }
+        else
+        {
+            appendKvEscaped(out, text);
+        }
+    }
+
+    bool json = true;
+    bool first = true;
+    std::string &out;
+};
+
+template <typename Record>
+void writeBinaryField(BinaryWriter &wire, const FieldSchema<Record> &entry, const Record &value)
+{
+    switch (entry.kind)
+    {
+    case FieldKind::Text:
+        wire.text(value.*entry.text);
+        break;
+    case FieldKind::TextList:
+    {
+        const auto &items = value.*entry.list;
+        wire.varint(items.size());
+        for (const auto &item : items)
+        {
+            wire.text(item);
+        }
+        break;
+    }
+    case FieldKind::Flag:
+        wire.byte(value.*entry.flag ? 1U : 0U);
+        break;
+    case FieldKind::Unsigned:
+        wire.varint(value.*entry.number);
+        break;
+    case FieldKind::Wide:
+        wire.varint(value.*entry.wide);
+        break;
+    case FieldKind::Signed:
+        wire.zigzag(value.*entry.integer);
+        break;
+    case FieldKind::Real:
+        wire.real(value.*entry.real);
+        break;
+    }
+}
+
+// Same visiting interface as EnvelopeWriter; prefixes and indices are implied by position, and each
+// record list is preceded by its count instead of followed by it.
+class BinaryEnvelopeWriter
+{
+public:
+    explicit BinaryEnvelopeWriter(std::string &buffer)
+        : wire(buffer)
+    {
+        wire.bytes(kBinaryEnvelopeMagic);
+        wire.varint(kBinaryEnvelopeVersion);
+    }
+
+    void finish()
+    {
+    }
+
+    template <typename Record>
+    void field(const char *, std::size_t, const FieldSchema<Record> &entry, const Record &value)
+    {
+        writeBinaryField(wire, entry, value);
+    }
+
+    template <typename Record, std::size_t N>
+    void record(const char *prefix, std::size_t index, const Record &value, const FieldSchema<Record> (&schema)[N])
+    {
+        for (const auto &entry : schema)
+        {
+            field(prefix, index, entry, value);
+        }
+    }
+
+    template <typename Record, std::size_t N>
+    void records(const char *prefix, const std::vector<Record> &values, const FieldSchema<Record> (&schema)[N])
+    {
+        wire.varint(values.size());
+        for (std::size_t idx = 0; idx < values.size(); ++idx)
+        {
+            record(prefix, idx, values[idx], schema);
+        }
+    }
+
+private:
+    BinaryWriter wire;
+};
+
+// Visits the envelope in canonical key order; the binary reader below follows the same sequence.
+template <typename Writer>
+void writeEnvelope(Writer &writer, const ExternalIoEnvelope &envelope)
+{
+    const std::size_t none = EnvelopeWriter::kNoIndex;
+    writer.record("front_view.", none, envelope.frontView, kFrontViewFields);
+    writer.records("front_view_stream.", envelope.frontViewStreams, kFrontViewStreamFields);
+    writer.field("", none, kIdentityFields[0], envelope.metadata);
+    writer.record("metadata.", none, envelope.metadata, kMetadataFields);
+    writer.record("mode.", none, envelope.mode, kModeFields);
+    writer.field("", none, kIdentityFields[1], envelope.metadata);
+    writer.records("sensor.", envelope.sensors, kSensorFields);
+    writer.record("status.", none, envelope, kStatusFields);
+    writer.finish();
+}
+
+const std::string_view kDeltaEnvelopeMagic("ATID", 4);
+constexpr std::uint64_t kDeltaEnvelopeVersion = 1;
+constexpr std::uint8_t kDeltaKeyframe = 0;
+constexpr std::uint8_t kDeltaChange = 1;
+
+// Doubles compare by bit pattern so a delta never drops a sign-of-zero change.
+template <typename Record>
+bool sameField(const FieldSchema<Record> &entry, const Record &lhs, const Record &rhs)
+{
+    switch (entry.kind)
+    {
+    case FieldKind::Text:
+        return lhs.*entry.text == rhs.*entry.text;
+    case FieldKind::TextList:
+        return lhs.*entry.list == rhs.*entry.list;
+    case FieldKind::Flag:
+        return lhs.*entry.flag == rhs.*entry.flag;
+    case FieldKind::Unsigned:
+        return lhs.*entry.number == rhs.*entry.number;
+    case FieldKind::Wide:
+        return lhs.*entry.wide == rhs.*entry.wide;
+    case FieldKind::Signed:
+        return lhs.*entry.integer == rhs.*entry.integer;
+    case FieldKind::Real:
+        return std::memcmp(&(lhs.*entry.real), &(rhs.*entry.real), sizeof(double)) == 0;
+    }
+    return false;
+}
+
+// Writes each record as a varint bitmask of the fields that differ from the previous envelope,
+// followed by those fields in schema order. Record lists carry their new count; records past the
+// previous count are written in full.
+class DeltaEnvelopeWriter
+{
+public:
+    explicit DeltaEnvelopeWriter(std::string &buffer)
+        : wire(buffer)
+    {
+    }
+
+    template <typename Record, std::size_t N>
+    void record(const Record &value, const Record &previous, const FieldSchema<Record> (&schema)[N])
+    {
+        static_assert(N <= 64, "delta field mask holds at most 64 fields");
+        std::uint64_t mask = 0;
+        for (std::size_t idx = 0; idx < N; ++idx)
+        {
+            if (!sameField(schema[idx], value, previous))
+            {
+                mask |= std::uint64_t{1} << idx;
+            }
+        }
+        wire.varint(mask);
+        for (std::size_t idx = 0; idx < N; ++idx)
+        {
+            if ((mask >> idx) & 1U)
+            {
+                writeBinaryField(wire, schema[idx], value);
+            }
+        }
+    }
+
+    template <typename Record, std::size_t N>
+    void records(const std::vector<Record> &values, const std::vector<Record> &previous, const FieldSchema<Record> (&schema)[N])
+    {
+        wire.varint(values.size());
+        for (std::size_t idx = 0; idx < values.size(); ++idx)
+        {
+            if (idx < previous.size())
+            {
+                record(values[idx], previous[idx], schema);
+                continue;
+            }
+            for (const auto &entry : schema)
+            {
+                writeBinaryField(wire, entry, values[idx]);
+            }
+        }
+    }
+
+private:
+    BinaryWriter wire;
+};
+
+void writeEnvelopeDelta(DeltaEnvelopeWriter &writer, const ExternalIoEnvelope &envelope, const ExternalIoEnvelope &previous)
+{
+    writer.record(envelope.frontView, previous.frontView, kFrontViewFields);
+    writer.records(envelope.frontViewStreams, previous.frontViewStreams, kFrontViewStreamFields);
+    writer.record(envelope.metadata, previous.metadata, kIdentityFields);
+    writer.record(envelope.metadata, previous.metadata, kMetadataFields);
+    writer.record(envelope.mode, previous.mode, kModeFields);
+    writer.records(envelope.sensors, previous.sensors, kSensorFields);
+    writer.record(envelope, previous, kStatusFields);
+}
+
+enum class FieldGroup : std::uint8_t
+{
+    Identity,
+    Metadata,
+    Mode,
+    FrontView,
+    Status,
+    Counts
+};
+
+struct TopLevelField
+{
+    FieldGroup group = FieldGroup::Identity;
+    std::uint8_t field = 0;
+    FieldKind kind = FieldKind::Text;
+    Presence presence = Presence::Optional;
+};
+
+// Required top-level keys in the order their absence is reported: text fields fail as
+// "missing key: <key>", typed fields as "invalid <key>".
+const char *const kLeadingRequiredKeys[] = {
+    "schema_version",
+    "interface_id",
+    "metadata.platform_profile",
+    "metadata.adapter_id",
+    "metadata.adapter_version",
+    "metadata.ui_surface",
+    "metadata.seed",
+    "metadata.deterministic",
+    "mode.active",
+    "mode.confidence"};
+
+// Key lookup tables, built once from the schema. Top-level keys get one bit each in the parser's
+// seen/valid masks; indexed record fields get one bit each in a per-record mask.
+struct EnvelopeKeyIndex
+{
+    PerfectHashIndex topLevel;
+    std::vector<TopLevelField> fields;
+    PerfectHashIndex sensorFields;
+    PerfectHashIndex streamFields;
+    std::vector<std::size_t> leadingChecks;
+    std::uint64_t frontViewRequired = 0;
+    std::uint64_t sensorRequired = 0;
+    std::uint64_t streamRequired = 0;
+    std::size_t sensorCount = 0;
+    std::size_t streamCount = 0;
+    std::size_t sensorId = 0;
+    std::size_t streamId = 0;
+};
+
+template <typename Record, std::size_t N>
+void addTopLevelKeys(std::vector<std::string> &keys,
+                     std::vector<TopLevelField> &fields,
+                     const char *prefix,
+                     FieldGroup group,
+                     const FieldSchema<Record> (&schema)[N])
+{
+    for (std::size_t idx = 0; idx < N; ++idx)
+    {
+        keys.push_back(std::string(prefix) + schema[idx].name);
+        fields.push_back({group, static_cast<std::uint8_t>(idx), schema[idx].kind, schema[idx].presence});
+    }
+}
+
+template <typename Record, std::size_t N>
+PerfectHashIndex recordFieldIndex(const FieldSchema<Record> (&schema)[N], std::uint64_t &required)
+{
+    static_assert(N <= 64, "record fields must fit a 64-bit mask");
+    std::vector<std::string> names;
+    required = 0;
+    for (std::size_t idx = 0; idx < N; ++idx)
+    {
+        names.push_back(schema[idx].name);
+        if (schema[idx].presence == Presence::Required)
+        {
+            required |= 1ULL << idx;
+        }
+    }
+    return PerfectHashIndex(std::move(names));
+}
+
+EnvelopeKeyIndex buildEnvelopeKeyIndex()
+{
+    static_assert(std::size(kIdentityFields) + std::size(kMetadataFields) + std::size(kModeFields) +
+                          std::size(kFrontViewFields) + std::size(kStatusFields) + std::size(kCountFields) <=
+                      64,
+                  "top-level keys must fit a 64-bit mask");
+    EnvelopeKeyIndex index;
+    std::vector<std::string> keys;
+    addTopLevelKeys(keys, index.fields, "", FieldGroup::Identity, kIdentityFields);
+    addTopLevelKeys(keys, index.fields, "metadata.", FieldGroup::Metadata, kMetadataFields);
+    addTopLevelKeys(keys, index.fields, "mode.", FieldGroup::Mode, kModeFields);
+    addTopLevelKeys(keys, index.fields, "front_view.", FieldGroup::FrontView, kFrontViewFields);
+    addTopLevelKeys(keys, index.fields, "status.", FieldGroup::Status, kStatusFields);
+    addTopLevelKeys(keys, index.fields, "", FieldGroup::Counts, kCountFields);
+    for (std::size_t id = 0; id < index.fields.size(); ++id)
+    {
+        if (index.fields[id].group == FieldGroup::FrontView && index.fields[id].presence == Presence::Required)
+        {
+            index.frontViewRequired |= 1ULL << id;
+        }
+    }
+    index.topLevel = PerfectHashIndex(std::move(keys));
+    for (const char *key : kLeadingRequiredKeys)
+    {
+        index.leadingChecks.push_back(index.topLevel.find(key));
+    }
+    index.sensorCount = index.topLevel.find("sensor.count");
+    index.streamCount = index.topLevel.find("front_view_stream.count");
+    index.sensorFields = recordFieldIndex(kSensorFields, index.sensorRequired);
+    index.streamFields = recordFieldIndex(kFrontViewStreamFields, index.streamRequired);
+    index.sensorId = index.sensorFields.find("id");
+    index.streamId = index.streamFields.find("stream_id");
+    return index;
+}
+
+const EnvelopeKeyIndex &envelopeKeyIndex()
+{
+    static const EnvelopeKeyIndex kIndex = buildEnvelopeKeyIndex();
+    return kIndex;
+}
+
+// "<prefix><index>.<name>" with the index spelled as the serializer writes it (decimal, no sign
+// or leading zeros). Other spellings are simply keys the schema does not know.
+bool splitIndexedKey(std::string_view key, std::string_view prefix, std::size_t &index, std::string_view &name)
+{
+    if (key.size() <= prefix.size() || key.substr(0, prefix.size()) != prefix)
+    {
+        return false;
+    }
+    const std::size_t start = prefix.size();
+    const std::size_t dot = key.find('.', start);
+    if (dot == std::string_view::npos || dot == start || dot - start > 9 || (key[start] == '0' && dot - start > 1))
+    {
+        return false;
+    }
+    index = 0;
+    for (std::size_t pos = start; pos < dot; ++pos)
+    {
+        if (!isDigit(key, pos))
+        {
+            return false;
+        }
+        index = index * 10 + static_cast<std::size_t>(key[pos] - '0');
+    }
+    name = key.substr(dot + 1);
+    return true;
+}
+
+// Sorts the record positions in `order` by (id, position); any record equal to its sorted
+// predecessor repeats an earlier id. Returns the lowest such position, or `none`.
+std::size_t firstRepeatedSensorId(const std::vector<ExternalIoSensorRecord> &sensors,
+                                  std::vector<std::uint32_t> &order,
+                                  std::size_t none)
+{
+    std::sort(order.begin(), order.end(), [&](std::uint32_t lhs, std::uint32_t rhs)
+    {
+        const int compared = sensors[lhs].sensorId.compare(sensors[rhs].sensorId);
+        return compared < 0 || (compared == 0 && lhs < rhs);
+    });
+    std::size_t firstDuplicate = none;
+    for (std::size_t idx = 1; idx < order.size(); ++idx)
+    {
+        if (sensors[order[idx]].sensorId == sensors[order[idx - 1]].sensorId && order[idx] < firstDuplicate)
+        {
+            firstDuplicate = order[idx];
+        }
+    }
+    return firstDuplicate;
+}
+
+// Cross-field rules every codec applies once the fields themselves have parsed.
+bool checkEnvelopeStructure(const ExternalIoEnvelope &envelope, std::string &error)
+{
+    if (envelope.mode.activeMode.empty())
+    {
+        error = "mode.active is required";
+        return false;
+    }
+    if (envelope.frontView.streamCount > 0 && envelope.frontView.streamIndex >= envelope.frontView.streamCount)
+    {
+        error = "front_view.stream_index must be less than stream_count";
+        return false;
+    }
+    if (!envelope.frontViewStreams.empty() &&
+        envelope.frontView.streamCount > 0 &&
+        envelope.frontView.streamCount != envelope.frontViewStreams.size())
     {
-        const auto &sensor = envelope.sensors[idx];
-        const std::string prefix = "sensor." + std::to_string(idx) + ".";
-        flat[prefix + "id"] = sensor.sensorId;
-        flat[prefix + "available"] = sensor.available ? "true" : "false";
-        flat[prefix + "healthy"] = sensor.healthy ? "true" : "false";
-        flat[prefix + "has_measurement"] = sensor.hasMeasurement ? "true" : "false";
-        flat[prefix + "freshness_seconds"] = formatDoubleExact(sensor.freshnessSeconds);
-        flat[prefix + "confidence"] = formatDoubleExact(sensor.confidence);
-        flat[prefix + "last_error"] = sensor.lastError;
-    }
-
-    flat["front_view.active_mode"] = envelope.frontView.activeMode;
-    flat["front_view.view_state"] = envelope.frontView.viewState;
-    flat["front_view.frame_id"] = envelope.frontView.frameId;
-    flat["front_view.source_id"] = envelope.frontView.sourceId;
-    flat["front_view.sensor_type"] = envelope.frontView.sensorType;
-    flat["front_view.sequence"] = std::to_string(envelope.frontView.sequence);
-    flat["front_view.timestamp_ms"] = std::to_string(envelope.frontView.timestampMs);
-    flat["front_view.frame_age_ms"] = formatDoubleExact(envelope.frontView.frameAgeMs);
-    flat["front_view.acquisition_latency_ms"] = formatDoubleExact(envelope.frontView.acquisitionLatencyMs);
-    flat["front_view.processing_latency_ms"] = formatDoubleExact(envelope.frontView.processingLatencyMs);
-    flat["front_view.render_latency_ms"] = formatDoubleExact(envelope.frontView.renderLatencyMs);
-    flat["front_view.latency_ms"] = formatDoubleExact(envelope.frontView.latencyMs);
-    flat["front_view.dropped_frames"] = std::to_string(envelope.frontView.droppedFrames);
-    flat["front_view.drop_reason"] = envelope.frontView.dropReason;
-    flat["front_view.spoof_active"] = envelope.frontView.spoofActive ? "true" : "false";
-    flat["front_view.confidence"] = formatDoubleExact(envelope.frontView.confidence);
-    flat["front_view.provenance"] = envelope.frontView.provenance;
-    flat["front_view.auth_status"] = envelope.frontView.authStatus;
-    flat["front_view.stream_id"] = envelope.frontView.streamId;
-    flat["front_view.stream_index"] = std::to_string(envelope.frontView.streamIndex);
-    flat["front_view.stream_count"] = std::to_string(envelope.frontView.streamCount);
-    flat["front_view.max_concurrent_views"] = std::to_string(envelope.frontView.maxConcurrentViews);
-    flat["front_view.stabilization_mode"] = envelope.frontView.stabilizationMode;
-    flat["front_view.stabilization_active"] = envelope.frontView.stabilizationActive ? "true" : "false";
-    flat["front_view.stabilization_error_deg"] = formatDoubleExact(envelope.frontView.stabilizationErrorDeg);
-    flat["front_view.gimbal_yaw_deg"] = formatDoubleExact(envelope.frontView.gimbalYawDeg);
-    flat["front_view.gimbal_pitch_deg"] = formatDoubleExact(envelope.frontView.gimbalPitchDeg);
-    flat["front_view.gimbal_yaw_rate_deg_s"] = formatDoubleExact(envelope.frontView.gimbalYawRateDegPerSec);
-    flat["front_view.gimbal_pitch_rate_deg_s"] = formatDoubleExact(envelope.frontView.gimbalPitchRateDegPerSec);
-
-    flat["front_view_stream.count"] = std::to_string(envelope.frontViewStreams.size());
-    for (std::size_t idx = 0; idx < envelope.frontViewStreams.size(); ++idx)
-    {
-        const auto &stream = envelope.frontViewStreams[idx];
-        const std::string prefix = "front_view_stream." + std::to_string(idx) + ".";
-        flat[prefix + "stream_id"] = stream.streamId;
-        flat[prefix + "active_mode"] = stream.activeMode;
-        flat[prefix + "frame_id"] = stream.frameId;
-        flat[prefix + "sensor_type"] = stream.sensorType;
-        flat[prefix + "sequence"] = std::to_string(stream.sequence);
-        flat[prefix + "timestamp_ms"] = std::to_string(stream.timestampMs);
-        flat[prefix + "frame_age_ms"] = formatDoubleExact(stream.frameAgeMs);
-        flat[prefix + "latency_ms"] = formatDoubleExact(stream.latencyMs);
-        flat[prefix + "confidence"] = formatDoubleExact(stream.confidence);
-        flat[prefix + "stabilization_mode"] = stream.stabilizationMode;
-        flat[prefix + "stabilization_active"] = stream.stabilizationActive ? "true" : "false";
-    }
-
-    flat["status.disqualified_sources"] = envelope.disqualifiedSources;
-    flat["status.lockout_status"] = envelope.lockoutStatus;
-    flat["status.auth_status"] = envelope.authStatus;
-    flat["status.provenance_status"] = envelope.provenanceStatus;
-    flat["status.logging_status"] = envelope.loggingStatus;
-    flat["status.adapter_status"] = envelope.adapterStatus;
-    flat["status.adapter_reason"] = envelope.adapterReason;
-    flat["status.adapter_fields"] = envelope.adapterFields;
-}
-
-bool inflateEnvelope(const std::map<std::string, std::string> &flat, ExternalIoEnvelope &envelope, std::string &error)
-{
-    auto get = [&](const std::string &key, std::string &out) -> bool
-    {
-        const auto it = flat.find(key);
-        if (it == flat.end())
-        {
-            error = "missing key: " + key;
+        error = "front_view.stream_count must match stream records";
+        return false;
+    }
+    return true;
+}
+
+// Every complete sensor or stream record takes well over this many payload bytes, so a record at
+// index i can only be needed if the payload has room for the i records before it. Higher indices
+// are treated like any other unrecognized key, which bounds record storage by the payload size.
+constexpr std::size_t kMinRecordBytes = 64;
+
+struct RecordSlots
+{
+    std::size_t used = 0;
+    std::vector<std::uint64_t> seen;
+    std::vector<std::uint64_t> valid;
+};
+
+// Reused across parses on the same thread, so well-formed payloads parse without allocating once
+// the buffers have grown.
+struct ParseScratch
+{
+    RecordSlots sensors;
+    RecordSlots streams;
+    std::vector<std::uint32_t> order;
+    std::string text;
+    std::string key;
+    // Keys the schema does not know, kept only to reject duplicates.
+    std::unordered_set<std::string_view> otherKeys;
+    std::deque<std::string> decodedKeys;
+};
+
+ParseScratch &parseScratch()
+{
+    thread_local ParseScratch scratch;
+    return scratch;
+}
+
+// Single pass over the tokens: each key is dispatched through the schema's perfect hash and its
+// value written straight into the envelope. Missing or mistyped fields are only recorded in the
+// masks; finish() reports them in a fixed order once the whole payload has been read.
+class EnvelopeParser
+{
+public:
+    EnvelopeParser(std::string_view payload,
+                   const char *duplicatePrefix,
+                   ExternalIoEnvelope &envelope,
+                   ParseScratch &scratch,
+                   std::string &error)
+        : index(envelopeKeyIndex()),
+          scratch(scratch),
+          envelope(envelope),
+          error(error),
+          duplicatePrefix(duplicatePrefix),
+          recordLimit((payload.size() + kMinRecordBytes - 1) / kMinRecordBytes)
+    {
+        resetRecord(kIdentityFields, envelope.metadata);
+        resetRecord(kMetadataFields, envelope.metadata);
+        resetRecord(kModeFields, envelope.mode);
+        resetRecord(kFrontViewFields, envelope.frontView);
+        resetRecord(kStatusFields, envelope);
+        scratch.sensors.used = 0;
+        scratch.streams.used = 0;
+        scratch.otherKeys.clear();
+        scratch.decodedKeys.clear();
+    }
+
+    // `stableKey` is false when `key` points at scratch memory that the next token reuses.
+    // Indexed record keys are tried first: no top-level key has a digit after its prefix, so each
+    // key costs a single hash lookup.
+    bool accept(std::string_view key, bool stableKey, const ValueToken &value)
+    {
+        std::size_t recordIndex = 0;
+        std::string_view name;
+        if (splitIndexedKey(key, "sensor.", recordIndex, name) && recordIndex < recordLimit)
+        {
+            const std::size_t field = index.sensorFields.find(name);
+            if (field != PerfectHashIndex::npos)
+            {
+                return acceptRecord(envelope.sensors, scratch.sensors, kSensorFields, recordIndex, field, key, value);
+            }
+        }
+        if (splitIndexedKey(key, "front_view_stream.", recordIndex, name) && recordIndex < recordLimit)
+        {
+            const std::size_t field = index.streamFields.find(name);
+            if (field != PerfectHashIndex::npos)
+            {
+                return acceptRecord(envelope.frontViewStreams, scratch.streams, kFrontViewStreamFields, recordIndex,
+                                    field, key, value);
+            }
+        }
+
+        const std::size_t id = index.topLevel.find(key);
+        if (id != PerfectHashIndex::npos)
+        {
+            const std::uint64_t bit = 1ULL << id;
+            if ((seen & bit) != 0)
+            {
+                return duplicate(key);
+            }
+            seen |= bit;
+            if (assignTopLevel(index.fields[id], value))
+            {
+                valid |= bit;
+            }
+            return true;
+        }
+
+        if (!stableKey)
+        {
+            scratch.decodedKeys.emplace_back(key);
+            key = scratch.decodedKeys.back();
+        }
+        if (!scratch.otherKeys.insert(key).second)
+        {
+            return duplicate(key);
+        }
+        return true;
+    }
+
+    bool finish()
+    {
+        for (std::size_t id : index.leadingChecks)
+        {
+            if (!requireTopLevel(id))
+            {
+                return false;
+            }
+        }
+        if (!requireTopLevel(index.sensorCount) || !checkSensors())
+        {
+            return false;
+        }
+        if ((valid & index.frontViewRequired) != index.frontViewRequired)
+        {
+            error = "invalid front_view values";
+            return false;
+        }
+        if (!requireTopLevel(index.streamCount) || !checkStreams())
+        {
+            return false;
+        }
+        envelope.sensors.resize(counts.sensors);
+        envelope.frontViewStreams.resize(counts.streams);
+        return checkEnvelopeStructure(envelope, error);
+    }
+
+private:
+    bool duplicate(std::string_view key)
+    {
+        error.assign(duplicatePrefix);
+        error.append(key.data(), key.size());
+        return false;
+    }
+
+    bool assignTopLevel(const TopLevelField &entry, const ValueToken &value)
+    {
+        std::string &text = scratch.text;
+        switch (entry.group)
+        {
+        case FieldGroup::Identity:
+            return assignField(kIdentityFields[entry.field], envelope.metadata, value, text);
+        case FieldGroup::Metadata:
+            return assignField(kMetadataFields[entry.field], envelope.metadata, value, text);
+        case FieldGroup::Mode:
+            return assignField(kModeFields[entry.field], envelope.mode, value, text);
+        case FieldGroup::FrontView:
+            return assignField(kFrontViewFields[entry.field], envelope.frontView, value, text);
+        case FieldGroup::Status:
+            return assignField(kStatusFields[entry.field], envelope, value, text);
+        case FieldGroup::Counts:
+            return assignField(kCountFields[entry.field], counts, value, text);
+        }
+        return false;
+    }
+
+    // Opens slots up to `recordIndex`, resetting records left over from an earlier parse.
+    template <typename Record, std::size_t N>
+    bool acceptRecord(std::vector<Record> &records,
+                      RecordSlots &slots,
+                      const FieldSchema<Record> (&schema)[N],
+                      std::size_t recordIndex,
+                      std::size_t field,
+                      std::string_view key,
+                      const ValueToken &value)
+    {
+        for (; slots.used <= recordIndex; ++slots.used)
+        {
+            if (slots.used < records.size())
+            {
+                resetRecord(schema, records[slots.used]);
+            }
+            else
+            {
+                records.emplace_back();
+            }
+            if (slots.used < slots.seen.size())
+            {
+                slots.seen[slots.used] = 0;
+                slots.valid[slots.used] = 0;
+            }
+            else
+            {
+                slots.seen.push_back(0);
+                slots.valid.push_back(0);
+            }
+        }
+        const std::uint64_t bit = 1ULL << field;
+        if ((slots.seen[recordIndex] & bit) != 0)
+        {
+            return duplicate(key);
+        }
+        slots.seen[recordIndex] |= bit;
+        if (assignField(schema[field], records[recordIndex], value, scratch.text))
+        {
+            slots.valid[recordIndex] |= bit;
+        }
+        return true;
+    }
+
+    bool requireTopLevel(std::size_t id)
+    {
+        if (((valid >> id) & 1U) != 0)
+        {
+            return true;
+        }
+        const char *prefix = index.fields[id].kind == FieldKind::Text ? "missing key: " : "invalid ";
+        error = prefix + index.topLevel.key(id);
+        return false;
+    }
+
+    bool recordHas(const RecordSlots &slots, std::size_t recordIndex, std::size_t field) const
+    {
+        return recordIndex < slots.used && ((slots.valid[recordIndex] >> field) & 1U) != 0;
+    }
+
+    bool checkSensors()
+    {
+        const std::size_t count = counts.sensors;
+        const RecordSlots &slots = scratch.sensors;
+        // Only records that have ids take part; the lowest repeated position is reported first.
+        auto &order = scratch.order;
+        order.clear();
+        for (std::size_t idx = 0; idx < count && idx < slots.used; ++idx)
+        {
+            if (recordHas(slots, idx, index.sensorId))
+            {
+                order.push_back(static_cast<std::uint32_t>(idx));
+            }
+        }
+        const auto &sensors = envelope.sensors;
+        const std::size_t firstDuplicate = firstRepeatedSensorId(sensors, order, count);
+
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            if (!recordHas(slots, idx, index.sensorId))
+            {
+                error = "missing key: sensor." + std::to_string(idx) + ".id";
+                return false;
+            }
+            if (idx == firstDuplicate)
+            {
+                error = "duplicate sensor id: " + sensors[idx].sensorId;
+                return false;
+            }
+            if ((slots.valid[idx] & index.sensorRequired) != index.sensorRequired)
+            {
+                error = "invalid sensor value at index " + std::to_string(idx);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool checkStreams()
+    {
+        const std::size_t count = counts.streams;
+        const RecordSlots &slots = scratch.streams;
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            if (!recordHas(slots, idx, index.streamId))
+            {
+                error = "missing key: front_view_stream." + std::to_string(idx) + ".stream_id";
+                return false;
+            }
+            if ((slots.valid[idx] & index.streamRequired) != index.streamRequired)
+            {
+                error = "invalid front_view_stream values at index " + std::to_string(idx);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const EnvelopeKeyIndex &index;
+    ParseScratch &scratch;
+    ExternalIoEnvelope &envelope;
+    std::string &error;
+    const char *duplicatePrefix;
+    std::size_t recordLimit = 0;
+    RecordCounts counts{};
+    std::uint64_t seen = 0;
+    std::uint64_t valid = 0;
+};
+
+bool parseJsonEnvelope(std::string_view payload, EnvelopeParser &parser, std::string &keyScratch, std::string &error)
+{
+    std::size_t pos = 0;
+    jsonSkipWhitespace(payload, pos);
+    if (pos >= payload.size() || payload[pos] != '{')
+    {
+        error = "json must start with '{'";
+        return false;
+    }
+    ++pos;
+    jsonSkipWhitespace(payload, pos);
+    if (pos < payload.size() && payload[pos] == '}')
+    {
+        return parser.finish();
+    }
+
+    ValueToken key;
+    ValueToken value;
+    while (pos < payload.size())
+    {
+        jsonSkipWhitespace(payload, pos);
+        if (!jsonScanString(payload, pos, key))
+        {
+            error = "json invalid key";
+            return false;
+        }
+        jsonSkipWhitespace(payload, pos);
+        if (pos >= payload.size() || payload[pos] != ':')
+        {
+            error = "json missing ':'";
+            return false;
+        }
+        ++pos;
+        jsonSkipWhitespace(payload, pos);
+        if (!jsonScanValue(payload, pos, value, error))
+        {
+            return false;
+        }
+        if (!parser.accept(tokenText(key, keyScratch), !key.escaped, value))
+        {
+            return false;
+        }
+
+        jsonSkipWhitespace(payload, pos);
+        if (pos >= payload.size())
+        {
+            error = "json unexpected end";
             return false;
         }
-        out = it->second;
-        return true;
-    };
-    auto optional = [&](const std::string &key, std::string &out) -> void
-    {
-        const auto it = flat.find(key);
-        if (it != flat.end())
+        if (payload[pos] == '}')
+        {
+            ++pos;
+            jsonSkipWhitespace(payload, pos);
+            if (pos != payload.size())
+            {
+                error = "json trailing content";
+                return false;
+            }
+            return parser.finish();
+        }
+        if (payload[pos] != ',')
         {
-            out = it->second;
+            error = "json missing ','";
+            return false;
         }
-    };
+        ++pos;
+    }
 
-    std::string text;
-    if (!get("schema_version", envelope.metadata.schemaVersion) ||
-        !get("interface_id", envelope.metadata.interfaceId) ||
-        !get("metadata.platform_profile", envelope.metadata.platformProfile) ||
-        !get("metadata.adapter_id", envelope.metadata.adapterId) ||
-        !get("metadata.adapter_version", envelope.metadata.adapterVersion) ||
-        !get("metadata.ui_surface", envelope.metadata.uiSurface))
+    error = "json unexpected end";
+    return false;
+}
+
+bool parseKvEnvelope(std::string_view payload, EnvelopeParser &parser, std::string &error)
+{
+    std::size_t lineStart = 0;
+    int lineNumber = 0;
+    ValueToken value;
+    while (lineStart < payload.size())
     {
-        return false;
+        std::size_t lineEnd = payload.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos)
+        {
+            lineEnd = payload.size();
+        }
+        std::string_view line = payload.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        const std::size_t eq = line.find('=');
+        if (eq == std::string_view::npos)
+        {
+            error = "kv missing '=' at line " + std::to_string(lineNumber);
+            return false;
+        }
+        if (!kvScanValue(line.substr(eq + 1), value))
+        {
+            error = "kv invalid escape at line " + std::to_string(lineNumber);
+            return false;
+        }
+        if (!parser.accept(line.substr(0, eq), true, value))
+        {
+            return false;
+        }
     }
-    if (!get("metadata.seed", text) || !parseUnsignedStrict(text, envelope.metadata.seed))
+    return parser.finish();
+}
+
+// Reads fields in the sequence writeEnvelope visits them. Values are held to the same rules as the
+// text codecs (finite doubles, in-range integers, and 0/1 flags), so a binary payload accepts
+// nothing the text forms would reject.
+class BinaryEnvelopeReader
+{
+public:
+    BinaryEnvelopeReader(std::string_view payload, std::string &error)
+        : wire(payload), error(error)
     {
-        error = "invalid metadata.seed";
-        return false;
     }
-    if (!get("metadata.deterministic", text) || !parseBoolStrict(text, envelope.metadata.deterministic))
+
+    bool header()
     {
-        error = "invalid metadata.deterministic";
-        return false;
+        std::string_view magic;
+        if (!wire.bytes(kBinaryEnvelopeMagic.size(), magic) || magic != kBinaryEnvelopeMagic)
+        {
+            error = "binary invalid magic";
+            return false;
+        }
+        std::uint64_t version = 0;
+        if (!wire.varint(version))
+        {
+            return fail("", kNoIndex, "version");
+        }
+        if (version != kBinaryEnvelopeVersion)
+        {
+            error = "binary unsupported version: " + std::to_string(version);
+            return false;
+        }
+        return true;
     }
 
-    if (!get("mode.active", envelope.mode.activeMode))
+    template <typename Record>
+    bool field(const char *prefix, std::size_t index, const FieldSchema<Record> &entry, Record &value)
     {
-        return false;
+        return readField(entry, value) || fail(prefix, index, entry.name);
     }
-    if (!get("mode.confidence", text) || !parseDoubleStrict(text, envelope.mode.confidence))
+
+    template <typename Record, std::size_t N>
+    bool record(const char *prefix, std::size_t index, Record &value, const FieldSchema<Record> (&schema)[N])
     {
-        error = "invalid mode.confidence";
-        return false;
+        for (const auto &entry : schema)
+        {
+            if (!field(prefix, index, entry, value))
+            {
+                return false;
+            }
+        }
+        return true;
     }
-    optional("mode.decision_reason", envelope.mode.decisionReason);
-    optional("mode.denial_reason", envelope.mode.denialReason);
-    optional("mode.ladder_status", envelope.mode.ladderStatus);
-    optional("mode.contributors", text);
-    if (!text.empty())
+
+    template <typename Record, std::size_t N>
+    bool records(const char *prefix, std::vector<Record> &values, const FieldSchema<Record> (&schema)[N])
     {
-        envelope.mode.contributors = split(text, ',');
+        // Every record takes at least one byte, which bounds record storage by the payload size.
+        std::uint64_t count = 0;
+        if (!wire.varint(count) || count > wire.remaining())
+        {
+            return fail(prefix, kNoIndex, "count");
+        }
+        values.resize(static_cast<std::size_t>(count));
+        for (std::size_t idx = 0; idx < values.size(); ++idx)
+        {
+            if (!record(prefix, idx, values[idx], schema))
+            {
+                return false;
+            }
+        }
+        return true;
     }
 
-    unsigned int sensorCount = 0;
-    if (!get("sensor.count", text) || !parseUnsignedStrict(text, sensorCount))
+    // Applies a DeltaEnvelopeWriter record on top of `value`, which holds the previous envelope's.
+    template <typename Record, std::size_t N>
+    bool recordDelta(const char *prefix, std::size_t index, Record &value, const FieldSchema<Record> (&schema)[N])
     {
-        error = "invalid sensor.count";
-        return false;
+        std::uint64_t mask = 0;
+        if (!wire.varint(mask) || (N < 64 && (mask >> N) != 0))
+        {
+            return fail(prefix, index, "mask");
+        }
+        for (std::size_t idx = 0; idx < N; ++idx)
+        {
+            if (((mask >> idx) & 1U) && !field(prefix, index, schema[idx], value))
+            {
+                return false;
+            }
+        }
+        return true;
     }
-    envelope.sensors.clear();
-    std::unordered_set<std::string> sensorIds;
-    for (unsigned int idx = 0; idx < sensorCount; ++idx)
+
+    template <typename Record, std::size_t N>
+    bool recordsDelta(const char *prefix, std::vector<Record> &values, const FieldSchema<Record> (&schema)[N])
     {
-        const std::string prefix = "sensor." + std::to_string(idx) + ".";
-        ExternalIoSensorRecord sensor;
-        if (!get(prefix + "id", sensor.sensorId))
+        // Unchanged records still cost their one-byte mask, so the same payload-size bound holds.
+        std::uint64_t count = 0;
+        if (!wire.varint(count) || count > wire.remaining())
         {
-            return false;
+            return fail(prefix, kNoIndex, "count");
         }
-        if (!sensorIds.insert(sensor.sensorId).second)
+        const std::size_t previous = values.size();
+        values.resize(static_cast<std::size_t>(count));
+        for (std::size_t idx = 0; idx < values.size(); ++idx)
         {
-            error = "duplicate sensor id: " + sensor.sensorId;
-            return false;
+            if (idx < previous ? !recordDelta(prefix, idx, values[idx], schema) : !record(prefix, idx, values[idx], schema))
+            {
+                return false;
+            }
         }
-        if (!get(prefix + "available", text) || !parseBoolStrict(text, sensor.available) ||
-            !get(prefix + "healthy", text) || !parseBoolStrict(text, sensor.healthy) ||
-            !get(prefix + "has_measurement", text) || !parseBoolStrict(text, sensor.hasMeasurement) ||
-            !get(prefix + "freshness_seconds", text) || !parseDoubleStrict(text, sensor.freshnessSeconds) ||
-            !get(prefix + "confidence", text) || !parseDoubleStrict(text, sensor.confidence))
+        return true;
+    }
+
+    bool finish()
+    {
+        if (wire.remaining() != 0)
         {
-            error = "invalid sensor value at index " + std::to_string(idx);
+            error = "binary trailing bytes";
             return false;
         }
-        optional(prefix + "last_error", sensor.lastError);
-        envelope.sensors.push_back(sensor);
-    }
-
-    optional("front_view.active_mode", envelope.frontView.activeMode);
-    optional("front_view.view_state", envelope.frontView.viewState);
-    optional("front_view.frame_id", envelope.frontView.frameId);
-    optional("front_view.source_id", envelope.frontView.sourceId);
-    optional("front_view.sensor_type", envelope.frontView.sensorType);
-    if (!get("front_view.sequence", text) || !parseUnsignedStrict(text, envelope.frontView.sequence) ||
-        !get("front_view.timestamp_ms", text) || !parseUInt64Strict(text, envelope.frontView.timestampMs) ||
-        !get("front_view.frame_age_ms", text) || !parseDoubleStrict(text, envelope.frontView.frameAgeMs) ||
-        !get("front_view.acquisition_latency_ms", text) || !parseDoubleStrict(text, envelope.frontView.acquisitionLatencyMs) ||
-        !get("front_view.processing_latency_ms", text) || !parseDoubleStrict(text, envelope.frontView.processingLatencyMs) ||
-        !get("front_view.render_latency_ms", text) || !parseDoubleStrict(text, envelope.frontView.renderLatencyMs) ||
-        !get("front_view.latency_ms", text) || !parseDoubleStrict(text, envelope.frontView.latencyMs) ||
-        !get("front_view.dropped_frames", text) || !parseIntStrict(text, envelope.frontView.droppedFrames) ||
-        !get("front_view.spoof_active", text) || !parseBoolStrict(text, envelope.frontView.spoofActive) ||
-        !get("front_view.confidence", text) || !parseDoubleStrict(text, envelope.frontView.confidence) ||
-        !get("front_view.stream_index", text) || !parseUnsignedStrict(text, envelope.frontView.streamIndex) ||
-        !get("front_view.stream_count", text) || !parseUnsignedStrict(text, envelope.frontView.streamCount) ||
-        !get("front_view.max_concurrent_views", text) || !parseUnsignedStrict(text, envelope.frontView.maxConcurrentViews) ||
-        !get("front_view.stabilization_active", text) || !parseBoolStrict(text, envelope.frontView.stabilizationActive) ||
-        !get("front_view.stabilization_error_deg", text) || !parseDoubleStrict(text, envelope.frontView.stabilizationErrorDeg) ||
-        !get("front_view.gimbal_yaw_deg", text) || !parseDoubleStrict(text, envelope.frontView.gimbalYawDeg) ||
-        !get("front_view.gimbal_pitch_deg", text) || !parseDoubleStrict(text, envelope.frontView.gimbalPitchDeg) ||
-        !get("front_view.gimbal_yaw_rate_deg_s", text) || !parseDoubleStrict(text, envelope.frontView.gimbalYawRateDegPerSec) ||
-        !get("front_view.gimbal_pitch_rate_deg_s", text) || !parseDoubleStrict(text, envelope.frontView.gimbalPitchRateDegPerSec))
-    {
-        error = "invalid front_view values";
-        return false;
+        return true;
     }
-    optional("front_view.drop_reason", envelope.frontView.dropReason);
-    optional("front_view.provenance", envelope.frontView.provenance);
-    optional("front_view.auth_status", envelope.frontView.authStatus);
-    optional("front_view.stream_id", envelope.frontView.streamId);
-    optional("front_view.stabilization_mode", envelope.frontView.stabilizationMode);
 
-    unsigned int streamCount = 0;
-    if (!get("front_view_stream.count", text) || !parseUnsignedStrict(text, streamCount))
+private:
+    static constexpr std::size_t kNoIndex = EnvelopeWriter::kNoIndex;
+
+    template <typename Record>
+    bool readField(const FieldSchema<Record> &entry, Record &value)
     {
-        error = "invalid front_view_stream.count";
+        switch (entry.kind)
+        {
+        case FieldKind::Text:
+            return wire.text(value.*entry.text);
+        case FieldKind::TextList:
+        {
+            std::uint64_t count = 0;
+            if (!wire.varint(count) || count > wire.remaining())
+            {
+                return false;
+            }
+            auto &items = value.*entry.list;
+            items.resize(static_cast<std::size_t>(count));
+            for (auto &item : items)
+            {
+                if (!wire.text(item))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case FieldKind::Flag:
+        {
+            std::uint8_t flag = 0;
+            if (!wire.byte(flag) || flag > 1U)
+            {
+                return false;
+            }
+            value.*entry.flag = flag != 0U;
+            return true;
+        }
+        case FieldKind::Unsigned:
+        {
+            std::uint64_t number = 0;
+            if (!wire.varint(number) || number > std::numeric_limits<unsigned int>::max())
+            {
+                return false;
+            }
+            value.*entry.number = static_cast<unsigned int>(number);
+            return true;
+        }
+        case FieldKind::Wide:
+            return wire.varint(value.*entry.wide);
+        case FieldKind::Signed:
+        {
+            std::int64_t number = 0;
+            if (!wire.zigzag(number) || number < std::numeric_limits<int>::min() ||
+                number > std::numeric_limits<int>::max())
+            {
+                return false;
+            }
+            value.*entry.integer = static_cast<int>(number);
+            return true;
+        }
+        case FieldKind::Real:
+        {
+            double number = 0.0;
+            if (!wire.real(number) || !std::isfinite(number))
+            {
+                return false;
+            }
+            value.*entry.real = number;
+            return true;
+        }
+        }
         return false;
     }
-    envelope.frontViewStreams.clear();
-    for (unsigned int idx = 0; idx < streamCount; ++idx)
+
+    bool fail(const char *prefix, std::size_t index, const char *name)
     {
-        const std::string prefix = "front_view_stream." + std::to_string(idx) + ".";
-        ExternalIoFrontViewStreamRecord streamRecord;
-        if (!get(prefix + "stream_id", streamRecord.streamId))
+        if (wire.truncated())
         {
+            error = "binary payload truncated";
             return false;
         }
-        if (!get(prefix + "active_mode", streamRecord.activeMode) ||
-            !get(prefix + "frame_id", streamRecord.frameId) ||
-            !get(prefix + "sensor_type", streamRecord.sensorType) ||
-            !get(prefix + "sequence", text) || !parseUnsignedStrict(text, streamRecord.sequence) ||
-            !get(prefix + "timestamp_ms", text) || !parseUInt64Strict(text, streamRecord.timestampMs) ||
-            !get(prefix + "frame_age_ms", text) || !parseDoubleStrict(text, streamRecord.frameAgeMs) ||
-            !get(prefix + "latency_ms", text) || !parseDoubleStrict(text, streamRecord.latencyMs) ||
-            !get(prefix + "confidence", text) || !parseDoubleStrict(text, streamRecord.confidence) ||
-            !get(prefix + "stabilization_mode", streamRecord.stabilizationMode) ||
-            !get(prefix + "stabilization_active", text) || !parseBoolStrict(text, streamRecord.stabilizationActive))
-        {
-            error = "invalid front_view_stream values at index " + std::to_string(idx);
-            return false;
+        error = "binary invalid ";
+        error += prefix;
+        if (index != kNoIndex)
+        {
+            error += std::to_string(index);
+            error.push_back('.');
         }
-        envelope.frontViewStreams.push_back(streamRecord);
+        error += name;
+        return false;
     }
 
-    optional("status.disqualified_sources", envelope.disqualifiedSources);
-    optional("status.lockout_status", envelope.lockoutStatus);
-    optional("status.auth_status", envelope.authStatus);
-    optional("status.provenance_status", envelope.provenanceStatus);
-    optional("status.logging_status", envelope.loggingStatus);
-    optional("status.adapter_status", envelope.adapterStatus);
-    optional("status.adapter_reason", envelope.adapterReason);
-    optional("status.adapter_fields", envelope.adapterFields);
+    BinaryReader wire;
+    std::string &error;
+};
 
-    if (envelope.mode.activeMode.empty())
+// Cross-record rules every binary decode ends with: unique sensor ids, then the shared structure checks.
+bool checkDecodedEnvelope(const ExternalIoEnvelope &envelope, ParseScratch &scratch, std::string &error)
+{
+    auto &order = scratch.order;
+    order.clear();
+    for (std::size_t idx = 0; idx < envelope.sensors.size(); ++idx)
     {
-        error = "mode.active is required";
-        return false;
+        order.push_back(static_cast<std::uint32_t>(idx));
     }
-    if (envelope.frontView.streamCount > 0 && envelope.frontView.streamIndex >= envelope.frontView.streamCount)
+    const std::size_t firstDuplicate = firstRepeatedSensorId(envelope.sensors, order, envelope.sensors.size());
+    if (firstDuplicate != envelope.sensors.size())
     {
-        error = "front_view.stream_index must be less than stream_count";
+        error = "duplicate sensor id: " + envelope.sensors[firstDuplicate].sensorId;
         return false;
     }
-    if (!envelope.frontViewStreams.empty() &&
-        envelope.frontView.streamCount > 0 &&
-        envelope.frontView.streamCount != envelope.frontViewStreams.size())
+    return checkEnvelopeStructure(envelope, error);
+}
+
+bool parseBinaryEnvelope(std::string_view payload,
+                         ExternalIoEnvelope &envelope,
+                         ParseScratch &scratch,
+                         std::string &error)
+{
+    const std::size_t none = EnvelopeWriter::kNoIndex;
+    BinaryEnvelopeReader reader(payload, error);
+    if (!reader.header() ||
+        !reader.record("front_view.", none, envelope.frontView, kFrontViewFields) ||
+        !reader.records("front_view_stream.", envelope.frontViewStreams, kFrontViewStreamFields) ||
+        !reader.field("", none, kIdentityFields[0], envelope.metadata) ||
+        !reader.record("metadata.", none, envelope.metadata, kMetadataFields) ||
+        !reader.record("mode.", none, envelope.mode, kModeFields) ||
+        !reader.field("", none, kIdentityFields[1], envelope.metadata) ||
+        !reader.records("sensor.", envelope.sensors, kSensorFields) ||
+        !reader.record("status.", none, envelope, kStatusFields) ||
+        !reader.finish())
     {
-        error = "front_view.stream_count must match stream records";
         return false;
     }
+    return checkDecodedEnvelope(envelope, scratch, error);
+}
 
-    return true;
+bool parseBinaryEnvelopeDelta(std::string_view body,
+                              ExternalIoEnvelope &envelope,
+                              ParseScratch &scratch,
+                              std::string &error)
+{
+    const std::size_t none = EnvelopeWriter::kNoIndex;
+    BinaryEnvelopeReader reader(body, error);
+    if (!reader.recordDelta("front_view.", none, envelope.frontView, kFrontViewFields) ||
+        !reader.recordsDelta("front_view_stream.", envelope.frontViewStreams, kFrontViewStreamFields) ||
+        !reader.recordDelta("", none, envelope.metadata, kIdentityFields) ||
+        !reader.recordDelta("metadata.", none, envelope.metadata, kMetadataFields) ||
+        !reader.recordDelta("mode.", none, envelope.mode, kModeFields) ||
+        !reader.recordsDelta("sensor.", envelope.sensors, kSensorFields) ||
+        !reader.recordDelta("status.", none, envelope, kStatusFields) ||
+        !reader.finish())
+    {
+        return false;
+    }
+    return checkDecodedEnvelope(envelope, scratch, error);
 }
 } // namespace
 
@@ -927,59 +2071,28 @@ IoEnvelopeParseResult parseExternalIoEnvelope(const std::string &formatName, con
 IoEnvelopeParseResult parseExternalIoEnvelope(IoEnvelopeFormat format, const std::string &payload)
 {
     IoEnvelopeParseResult result;
-    std::map<std::string, std::string> flat;
+    result.ok = parseExternalIoEnvelope(format, std::string_view(payload), result.envelope, result.error);
+    return result;
+}
 
-    if (format == IoEnvelopeFormat::KeyValue)
-    {
-        std::stringstream stream(payload);
-        std::string line;
-        int lineNumber = 0;
-        while (std::getline(stream, line))
-        {
-            ++lineNumber;
-            if (!line.empty() && line.back() == '\r')
-            {
-                line.pop_back();
-            }
-            if (line.empty() || line[0] == '#')
-            {
-                continue;
-            }
-            const std::size_t eq = line.find('=');
-            if (eq == std::string::npos)
-            {
-                result.error = "kv missing '=' at line " + std::to_string(lineNumber);
-                return result;
-            }
-            std::string value;
-            if (!kvUnescape(line.substr(eq + 1), value))
-            {
-                result.error = "kv invalid escape at line " + std::to_string(lineNumber);
-                return result;
-            }
-            const std::string key = line.substr(0, eq);
-            if (flat.find(key) != flat.end())
-            {
-                result.error = "kv duplicate key: " + key;
-                return result;
-            }
-            flat[key] = value;
-        }
-    }
-    else
+bool parseExternalIoEnvelope(IoEnvelopeFormat format,
+                             std::string_view payload,
+                             ExternalIoEnvelope &envelope,
+                             std::string &error)
+{
+    error.clear();
+    ParseScratch &scratch = parseScratch();
+    if (format == IoEnvelopeFormat::Binary)
     {
-        if (!parseFlatJson(payload, flat, result.error))
-        {
-            return result;
-        }
+        return parseBinaryEnvelope(payload, envelope, scratch, error);
     }
-
-    if (!inflateEnvelope(flat, result.envelope, result.error))
+    if (format == IoEnvelopeFormat::KeyValue)
     {
-        return result;
+        EnvelopeParser parser(payload, "kv duplicate key: ", envelope, scratch, error);
+        return parseKvEnvelope(payload, parser, error);
     }
-    result.ok = true;
-    return result;
+    EnvelopeParser parser(payload, "json duplicate key: ", envelope, scratch, error);
+    return parseJsonEnvelope(payload, parser, scratch.key, error);
 }
 
 IoEnvelopeSerializeResult serializeExternalIoEnvelope(const std::string &formatName, const ExternalIoEnvelope &envelope)
@@ -997,37 +2110,22 @@ IoEnvelopeSerializeResult serializeExternalIoEnvelope(const std::string &formatN
 IoEnvelopeSerializeResult serializeExternalIoEnvelope(IoEnvelopeFormat format, const ExternalIoEnvelope &envelope)
 {
     IoEnvelopeSerializeResult result;
-    std::map<std::string, std::string> flat;
-    flattenEnvelope(envelope, flat);
-
-    if (format == IoEnvelopeFormat::KeyValue)
-    {
-        std::ostringstream out;
-        for (const auto &entry : flat)
-        {
-            out << entry.first << "=" << kvEscape(entry.second) << "\n";
-        }
-        result.ok = true;
-        result.payload = out.str();
-        return result;
-    }
+    result.ok = serializeExternalIoEnvelope(format, envelope, result.payload);
+    return result;
+}
 
-    std::ostringstream out;
-    out << "{";
-    bool first = true;
-    for (const auto &entry : flat)
+bool serializeExternalIoEnvelope(IoEnvelopeFormat format, const ExternalIoEnvelope &envelope, std::string &payload)
+{
+    payload.clear();
+    if (format == IoEnvelopeFormat::Binary)
     {
-        if (!first)
-        {
-            out << ",";
-        }
-        out << "\"" << jsonEscape(entry.first) << "\":\"" << jsonEscape(entry.second) << "\"";
-        first = false;
+        BinaryEnvelopeWriter writer(payload);
+        writeEnvelope(writer, envelope);
+        return true;
     }
-    out << "}";
-    result.ok = true;
-    result.payload = out.str();
-    return result;
+    EnvelopeWriter writer(format, payload);
+    writeEnvelope(writer, envelope);
+    return true;
 }
 
 IoEnvelopeSerializeResult convertExternalIoEnvelope(
@@ -1066,4 +2164,128 @@ IoEnvelopeSerializeResult convertExternalIoEnvelope(
     }
     return serializeExternalIoEnvelope(outputFormat, parsed.envelope);
 }
+
+IoEnvelopeDeltaEncoder::IoEnvelopeDeltaEncoder(std::uint32_t keyframeInterval)
+    : keyframeInterval(keyframeInterval)
+{
+}
+
+void IoEnvelopeDeltaEncoder::encode(const ExternalIoEnvelope &envelope, std::string &payload)
+{
+    payload.clear();
+    const bool keyframe = !havePrevious || keyframeRequested || (keyframeInterval > 0 && sinceKeyframe >= keyframeInterval);
+    BinaryWriter header(payload);
+    header.bytes(kDeltaEnvelopeMagic);
+    header.varint(kDeltaEnvelopeVersion);
+    header.byte(keyframe ? kDeltaKeyframe : kDeltaChange);
+    header.varint(nextSequence);
+    if (keyframe)
+    {
+        BinaryEnvelopeWriter writer(payload);
+        writeEnvelope(writer, envelope);
+        sinceKeyframe = 0;
+        keyframeRequested = false;
+    }
+    else
+    {
+        DeltaEnvelopeWriter writer(payload);
+        writeEnvelopeDelta(writer, envelope, previous);
+    }
+    previous = envelope;
+    havePrevious = true;
+    ++sinceKeyframe;
+    ++nextSequence;
+}
+
+void IoEnvelopeDeltaEncoder::requestKeyframe()
+{
+    keyframeRequested = true;
+}
+
+std::uint64_t IoEnvelopeDeltaEncoder::sequence() const
+{
+    return nextSequence;
+}
+
+bool IoEnvelopeDeltaDecoder::decode(std::string_view payload, ExternalIoEnvelope &envelope, std::string &error)
+{
+    // Every failure below drops sync: the payload may have stood in for a frame this decoder
+    // never saw, so the next delta cannot be trusted until a keyframe arrives.
+    error.clear();
+    BinaryReader header(payload);
+    std::string_view magic;
+    if (!header.bytes(kDeltaEnvelopeMagic.size(), magic) || magic != kDeltaEnvelopeMagic)
+    {
+        error = "delta invalid magic";
+        awaitingKeyframe = true;
+        return false;
+    }
+    std::uint64_t version = 0;
+    std::uint8_t kind = 0;
+    std::uint64_t sequence = 0;
+    if (!header.varint(version) || version != kDeltaEnvelopeVersion)
+    {
+        error = header.truncated() ? "delta payload truncated" : "delta unsupported version: " + std::to_string(version);
+        awaitingKeyframe = true;
+        return false;
+    }
+    if (!header.byte(kind) || !header.varint(sequence))
+    {
+        error = header.truncated() ? "delta payload truncated" : "delta invalid sequence";
+        awaitingKeyframe = true;
+        return false;
+    }
+    const std::string_view body = payload.substr(payload.size() - header.remaining());
+
+    ParseScratch &scratch = parseScratch();
+    if (kind == kDeltaKeyframe)
+    {
+        if (!parseBinaryEnvelope(body, working, scratch, error))
+        {
+            awaitingKeyframe = true;
+            return false;
+        }
+    }
+    else if (kind == kDeltaChange)
+    {
+        if (awaitingKeyframe)
+        {
+            error = "delta awaiting keyframe";
+            return false;
+        }
+        if (sequence != lastSequence + 1)
+        {
+            error = "delta sequence gap: expected " + std::to_string(lastSequence + 1) + ", got " + std::to_string(sequence);
+            awaitingKeyframe = true;
+            return false;
+        }
+        working = previous;
+        if (!parseBinaryEnvelopeDelta(body, working, scratch, error))
+        {
+            awaitingKeyframe = true;
+            return false;
+        }
+    }
+    else
+    {
+        error = "delta invalid frame kind: " + std::to_string(kind);
+        awaitingKeyframe = true;
+        return false;
+    }
+    std::swap(previous, working);
+    lastSequence = sequence;
+    awaitingKeyframe = false;
+    envelope = previous;
+    return true;
+}
+
+bool IoEnvelopeDeltaDecoder::needsKeyframe() const
+{
+    return awaitingKeyframe;
+}
+
+std::uint64_t IoEnvelopeDeltaDecoder::sequence() const
+{
+    return lastSequence;
+}
 } // namespace tools
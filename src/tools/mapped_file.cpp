@@ -0,0 +1,120 @@
+#include "tools/mapped_file.h"
+
+#include <cstdint>
+#include <limits>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tools
+{
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFileStatus MappedFile::open(const std::string &path)
+{
+    close();
+#if defined(_WIN32)
+    HANDLE file = ::CreateFileA(path.c_str(),
+                                GENERIC_READ,
+                                FILE_SHARE_READ,
+                                nullptr,
+                                OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                                nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return MappedFileStatus::OpenFailed;
+    }
+    LARGE_INTEGER fileSize{};
+    if (::GetFileType(file) != FILE_TYPE_DISK || !::GetFileSizeEx(file, &fileSize) ||
+        static_cast<std::uint64_t>(fileSize.QuadPart) > std::numeric_limits<std::size_t>::max())
+    {
+        ::CloseHandle(file);
+        return MappedFileStatus::StatFailed;
+    }
+    const std::size_t size = static_cast<std::size_t>(fileSize.QuadPart);
+    if (size > 0)
+    {
+        // Zero-length mappings are rejected, hence the empty-file case above. The view keeps the
+        // mapping and file alive once both handles are closed.
+        HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void *data = mapping != nullptr ? ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (mapping != nullptr)
+        {
+            ::CloseHandle(mapping);
+        }
+        if (data == nullptr)
+        {
+            ::CloseHandle(file);
+            return MappedFileStatus::MapFailed;
+        }
+        mapped = static_cast<const char *>(data);
+        mappedSize = size;
+    }
+    ::CloseHandle(file);
+    return MappedFileStatus::Ok;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return MappedFileStatus::OpenFailed;
+    }
+    struct stat info
+    {
+    };
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) ||
+        static_cast<std::uint64_t>(info.st_size) > std::numeric_limits<std::size_t>::max())
+    {
+        ::close(fd);
+        return MappedFileStatus::StatFailed;
+    }
+    const std::size_t size = static_cast<std::size_t>(info.st_size);
+    if (size > 0)
+    {
+        void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(fd);
+            return MappedFileStatus::MapFailed;
+        }
+        // Readers walk their ranges front to back.
+        ::madvise(data, size, MADV_SEQUENTIAL);
+        mapped = static_cast<const char *>(data);
+        mappedSize = size;
+    }
+    ::close(fd);
+    return MappedFileStatus::Ok;
+#endif
+}
+
+void MappedFile::close()
+{
+    if (mapped != nullptr)
+    {
+#if defined(_WIN32)
+        ::UnmapViewOfFile(mapped);
+#else
+        ::munmap(const_cast<char *>(mapped), mappedSize);
+#endif
+    }
+    mapped = nullptr;
+    mappedSize = 0;
+}
+
+std::string_view MappedFile::bytes() const
+{
+    return std::string_view(mapped, mappedSize);
+}
+} // namespace tools
@@ -0,0 +1,174 @@
+#include "tools/perfect_hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <utility>
+
+namespace tools
+{
+namespace
+{
+std::uint64_t mix(std::uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+std::size_t bucketCountFor(std::size_t keyCount)
+{
+    return keyCount / 4 + 1;
+}
+
+// Maps the high hash word onto [0, bucketCount) with a multiply instead of a division.
+std::size_t bucketFor(std::uint64_t keyHash, std::size_t bucketCount)
+{
+    return static_cast<std::size_t>(((keyHash >> 32) * bucketCount) >> 32);
+}
+} // namespace
+
+PerfectHashIndex::PerfectHashIndex(std::vector<std::string> keySet)
+    : keys(std::move(keySet))
+{
+    const std::size_t keyCount = keys.size();
+    const std::size_t bucketCount = bucketCountFor(keyCount);
+    std::vector<std::uint64_t> hashes(keyCount);
+    std::vector<std::vector<std::uint32_t>> buckets(bucketCount);
+    for (std::size_t idx = 0; idx < keyCount; ++idx)
+    {
+        hashes[idx] = hash(keys[idx]);
+        auto &bucket = buckets[bucketFor(hashes[idx], bucketCount)];
+        // A repeated key would never separate from its twin; keep the first, as find() reports.
+        const bool repeated = std::any_of(bucket.begin(), bucket.end(), [&](std::uint32_t other)
+        {
+            return keys[other] == keys[idx];
+        });
+        if (!repeated)
+        {
+            bucket.push_back(static_cast<std::uint32_t>(idx));
+        }
+    }
+    std::vector<std::size_t> order(bucketCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs)
+    {
+        return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    // Load factor <= 0.5, so a displacement is usually found within a few tries; if a bucket gets
+    // stuck, double the table and start over.
+    std::size_t slotCount = 4;
+    while (slotCount < keyCount * 2)
+    {
+        slotCount *= 2;
+    }
+    const std::uint32_t kMaxDisplacement = 1U << 16;
+    bool placed = false;
+    std::vector<std::size_t> candidate;
+    while (!placed)
+    {
+        slotMask = slotCount - 1;
+        slots.assign(slotCount, 0U);
+        displacements.assign(bucketCount, 0U);
+        placed = true;
+        for (std::size_t bucketIndex : order)
+        {
+            const auto &bucket = buckets[bucketIndex];
+            if (bucket.empty())
+            {
+                break;
+            }
+            bool fits = false;
+            for (std::uint32_t displacement = 0; displacement < kMaxDisplacement && !fits; ++displacement)
+            {
+                candidate.clear();
+                fits = true;
+                for (std::uint32_t keyIndex : bucket)
+                {
+                    const std::size_t slot = slotFor(hashes[keyIndex], displacement);
+                    if (slots[slot] != 0U || std::find(candidate.begin(), candidate.end(), slot) != candidate.end())
+                    {
+                        fits = false;
+                        break;
+                    }
+                    candidate.push_back(slot);
+                }
+                if (fits)
+                {
+                    displacements[bucketIndex] = displacement;
+                    for (std::size_t idx = 0; idx < bucket.size(); ++idx)
+                    {
+                        slots[candidate[idx]] = bucket[idx] + 1U;
+                    }
+                }
+            }
+            if (!fits)
+            {
+                placed = false;
+                slotCount *= 2;
+                break;
+            }
+        }
+    }
+}
+
+std::size_t PerfectHashIndex::find(std::string_view key) const
+{
+    if (keys.empty())
+    {
+        return npos;
+    }
+    const std::uint64_t keyHash = hash(key);
+    const std::uint32_t displacement = displacements[bucketFor(keyHash, displacements.size())];
+    const std::uint32_t entry = slots[slotFor(keyHash, displacement)];
+    if (entry == 0U || keys[entry - 1U] != key)
+    {
+        return npos;
+    }
+    return entry - 1U;
+}
+
+std::size_t PerfectHashIndex::size() const
+{
+    return keys.size();
+}
+
+const std::string &PerfectHashIndex::key(std::size_t index) const
+{
+    return keys[index];
+}
+
+std::uint64_t PerfectHashIndex::hash(std::string_view key)
+{
+    // Eight bytes per round, then a finalizer so the low bits used for slots are well mixed. Schema
+    // keys are short, so this is a handful of multiplies rather than one per byte.
+    std::uint64_t value = 1469598103934665603ULL ^ key.size();
+    std::size_t pos = 0;
+    for (; pos + 8 <= key.size(); pos += 8)
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, key.data() + pos, 8);
+        value = (value ^ word) * 0x9e3779b97f4a7c15ULL;
+        value ^= value >> 29;
+    }
+    if (pos < key.size())
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, key.data() + pos, key.size() - pos);
+        value = (value ^ word) * 0x9e3779b97f4a7c15ULL;
+        value ^= value >> 29;
+    }
+    return mix(value);
+}
+
+std::size_t PerfectHashIndex::slotFor(std::uint64_t keyHash, std::uint32_t displacement) const
+{
+    // keyHash is already mixed, so one multiply is enough to give each displacement its own slot.
+    const std::uint64_t value = (keyHash ^ (displacement * 0x9e3779b97f4a7c15ULL)) * 0xff51afd7ed558ccdULL;
+    return static_cast<std::size_t>(value >> 32) & slotMask;
+}
+} // namespace tools
@@ -3,12 +3,18 @@
 #include <algorithm>
 #include <cctype>
 #include <cstdlib>
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iterator>
 #include <sstream>
 #include <unordered_map>
 
+#include "core/hash.h"
 #include "core/plugin_auth.h"
 #include "tools/adapter_registry_loader.h"
+#include "tools/perfect_hash.h"
+#include "tools/sim_config_snapshot.h"
 
 namespace
 {
@@ -365,151 +371,309 @@ void setIssue(ConfigResult &result, const std::string &key, const std::string &m
     result.issues.push_back({key, message});
 }
 
-void applyValue(SimConfig &config, ConfigResult &result, const std::string &key, const std::string &value)
+constexpr const char *kInvalidValue = "unknown or invalid value";
+
+// Applies one exact config key; returns the issue to report, or nullptr once the value is stored.
+using ConfigKeyHandler = std::function<const char *(SimConfig &config, const std::string &value)>;
+
+const char *setReal(const std::string &value, double &field)
 {
-    double dval = 0.0;
-    int ival = 0;
-    unsigned int uval = 0;
-    bool bval = false;
-    SimConfig::PlatformProfile profile = SimConfig::PlatformProfile::Base;
-    SimConfig::NetworkAidMode aidMode = SimConfig::NetworkAidMode::Deny;
-    SimConfig::OverrideAuth authMode = SimConfig::OverrideAuth::Credential;
-    SimConfig::DatasetTier tier = SimConfig::DatasetTier::Minimal;
-    SimConfig::ProvenanceMode provenanceMode = SimConfig::ProvenanceMode::Operational;
-    SimConfig::UnknownProvenanceAction unknownAction = SimConfig::UnknownProvenanceAction::Deny;
-    std::string uiSurface;
-
-    if (key == "config.version")
-    {
-        config.version = value;
-    }
-    else if (key == "state.position.x" && toDouble(value, dval)) config.initialState.position.x = dval;
-    else if (key == "state.position.y" && toDouble(value, dval)) config.initialState.position.y = dval;
-    else if (key == "state.position.z" && toDouble(value, dval)) config.initialState.position.z = dval;
-    else if (key == "state.velocity.x" && toDouble(value, dval)) config.initialState.velocity.x = dval;
-    else if (key == "state.velocity.y" && toDouble(value, dval)) config.initialState.velocity.y = dval;
-    else if (key == "state.velocity.z" && toDouble(value, dval)) config.initialState.velocity.z = dval;
-    else if (key == "state.acceleration.x" && toDouble(value, dval)) config.initialState.acceleration.x = dval;
-    else if (key == "state.acceleration.y" && toDouble(value, dval)) config.initialState.acceleration.y = dval;
-    else if (key == "state.acceleration.z" && toDouble(value, dval)) config.initialState.acceleration.z = dval;
-    else if (key == "state.time" && toDouble(value, dval)) config.initialState.time = dval;
-    else if (key == "sim.dt" && toDouble(value, dval)) config.dt = dval;
-    else if (key == "sim.steps" && toInt(value, ival)) config.steps = ival;
-    else if (key == "sim.seed" && toUnsigned(value, uval)) config.seed = uval;
-    else if (key == "bounds.min.x" && toDouble(value, dval)) config.bounds.minPosition.x = dval;
-    else if (key == "bounds.min.y" && toDouble(value, dval)) config.bounds.minPosition.y = dval;
-    else if (key == "bounds.min.z" && toDouble(value, dval)) config.bounds.minPosition.z = dval;
-    else if (key == "bounds.max.x" && toDouble(value, dval)) config.bounds.maxPosition.x = dval;
-    else if (key == "bounds.max.y" && toDouble(value, dval)) config.bounds.maxPosition.y = dval;
-    else if (key == "bounds.max.z" && toDouble(value, dval)) config.bounds.maxPosition.z = dval;
-    else if (key == "bounds.max_speed" && toDouble(value, dval)) config.bounds.maxSpeed = dval;
-    else if (key == "bounds.max_accel" && toDouble(value, dval)) config.bounds.maxAcceleration = dval;
-    else if (key == "bounds.max_turn_rate_deg" && toDouble(value, dval)) config.bounds.maxTurnRateDeg = dval;
-    else if (key == "maneuver.random_accel_std" && toDouble(value, dval)) config.maneuvers.randomAccelStd = dval;
-    else if (key == "maneuver.probability" && toDouble(value, dval)) config.maneuvers.maneuverProbability = dval;
-    else if (key == "sensor.gps.rate_hz" && toDouble(value, dval)) config.gps.rateHz = dval;
-    else if (key == "sensor.gps.noise_std" && toDouble(value, dval)) config.gps.noiseStd = dval;
-    else if (key == "sensor.gps.dropout" && toDouble(value, dval)) config.gps.dropoutProbability = dval;
-    else if (key == "sensor.gps.false_positive" && toDouble(value, dval)) config.gps.falsePositiveProbability = dval;
-    else if (key == "sensor.gps.max_range" && toDouble(value, dval)) config.gps.maxRange = dval;
-    else if (key == "sensor.thermal.rate_hz" && toDouble(value, dval)) config.thermal.rateHz = dval;
-    else if (key == "sensor.thermal.noise_std" && toDouble(value, dval)) config.thermal.noiseStd = dval;
-    else if (key == "sensor.thermal.dropout" && toDouble(value, dval)) config.thermal.dropoutProbability = dval;
-    else if (key == "sensor.thermal.false_positive" && toDouble(value, dval)) config.thermal.falsePositiveProbability = dval;
-    else if (key == "sensor.thermal.max_range" && toDouble(value, dval)) config.thermal.maxRange = dval;
-    else if (key == "sensor.dead_reckoning.rate_hz" && toDouble(value, dval)) config.deadReckoning.rateHz = dval;
-    else if (key == "sensor.dead_reckoning.noise_std" && toDouble(value, dval)) config.deadReckoning.noiseStd = dval;
-    else if (key == "sensor.dead_reckoning.dropout" && toDouble(value, dval)) config.deadReckoning.dropoutProbability = dval;
-    else if (key == "sensor.dead_reckoning.false_positive" && toDouble(value, dval)) config.deadReckoning.falsePositiveProbability = dval;
-    else if (key == "sensor.dead_reckoning.max_range" && toDouble(value, dval)) config.deadReckoning.maxRange = dval;
-    else if (key == "sensor.imu.rate_hz" && toDouble(value, dval)) config.imu.rateHz = dval;
-    else if (key == "sensor.imu.noise_std" && toDouble(value, dval)) config.imu.noiseStd = dval;
-    else if (key == "sensor.imu.dropout" && toDouble(value, dval)) config.imu.dropoutProbability = dval;
-    else if (key == "sensor.imu.false_positive" && toDouble(value, dval)) config.imu.falsePositiveProbability = dval;
-    else if (key == "sensor.imu.max_range" && toDouble(value, dval)) config.imu.maxRange = dval;
-    else if (key == "sensor.radar.rate_hz" && toDouble(value, dval)) config.radar.rateHz = dval;
-    else if (key == "sensor.radar.noise_std" && toDouble(value, dval)) config.radar.noiseStd = dval;
-    else if (key == "sensor.radar.dropout" && toDouble(value, dval)) config.radar.dropoutProbability = dval;
-    else if (key == "sensor.radar.false_positive" && toDouble(value, dval)) config.radar.falsePositiveProbability = dval;
-    else if (key == "sensor.radar.max_range" && toDouble(value, dval)) config.radar.maxRange = dval;
-    else if (key == "sensor.vision.rate_hz" && toDouble(value, dval)) config.vision.rateHz = dval;
-    else if (key == "sensor.vision.noise_std" && toDouble(value, dval)) config.vision.noiseStd = dval;
-    else if (key == "sensor.vision.dropout" && toDouble(value, dval)) config.vision.dropoutProbability = dval;
-    else if (key == "sensor.vision.false_positive" && toDouble(value, dval)) config.vision.falsePositiveProbability = dval;
-    else if (key == "sensor.vision.max_range" && toDouble(value, dval)) config.vision.maxRange = dval;
-    else if (key == "sensor.lidar.rate_hz" && toDouble(value, dval)) config.lidar.rateHz = dval;
-    else if (key == "sensor.lidar.noise_std" && toDouble(value, dval)) config.lidar.noiseStd = dval;
-    else if (key == "sensor.lidar.dropout" && toDouble(value, dval)) config.lidar.dropoutProbability = dval;
-    else if (key == "sensor.lidar.false_positive" && toDouble(value, dval)) config.lidar.falsePositiveProbability = dval;
-    else if (key == "sensor.lidar.max_range" && toDouble(value, dval)) config.lidar.maxRange = dval;
-    else if (key == "sensor.magnetometer.rate_hz" && toDouble(value, dval)) config.magnetometer.rateHz = dval;
-    else if (key == "sensor.magnetometer.noise_std" && toDouble(value, dval)) config.magnetometer.noiseStd = dval;
-    else if (key == "sensor.magnetometer.dropout" && toDouble(value, dval)) config.magnetometer.dropoutProbability = dval;
-    else if (key == "sensor.magnetometer.false_positive" && toDouble(value, dval)) config.magnetometer.falsePositiveProbability = dval;
-    else if (key == "sensor.magnetometer.max_range" && toDouble(value, dval)) config.magnetometer.maxRange = dval;
-    else if (key == "sensor.baro.rate_hz" && toDouble(value, dval)) config.baro.rateHz = dval;
-    else if (key == "sensor.baro.noise_std" && toDouble(value, dval)) config.baro.noiseStd = dval;
-    else if (key == "sensor.baro.dropout" && toDouble(value, dval)) config.baro.dropoutProbability = dval;
-    else if (key == "sensor.baro.false_positive" && toDouble(value, dval)) config.baro.falsePositiveProbability = dval;
-    else if (key == "sensor.baro.max_range" && toDouble(value, dval)) config.baro.maxRange = dval;
-    else if (key == "sensor.celestial.rate_hz" && toDouble(value, dval)) config.celestial.rateHz = dval;
-    else if (key == "sensor.celestial.noise_std" && toDouble(value, dval)) config.celestial.noiseStd = dval;
-    else if (key == "sensor.celestial.dropout" && toDouble(value, dval)) config.celestial.dropoutProbability = dval;
-    else if (key == "sensor.celestial.false_positive" && toDouble(value, dval)) config.celestial.falsePositiveProbability = dval;
-    else if (key == "sensor.celestial.max_range" && toDouble(value, dval)) config.celestial.maxRange = dval;
-    else if (key == "platform.profile" && toProfile(value, profile)) config.platformProfile = profile;
-    else if (key == "platform.profile_parent" && toProfile(value, profile))
-    {
-        config.parentProfile = profile;
-        config.hasParentProfile = true;
-    }
-    else if (key == "platform.permitted_sensors") config.permittedSensors = splitList(value);
-    else if (key == "platform.child_modules") config.childModules = splitList(value);
-    else if (key == "policy.network_aid.mode" && toNetworkAidMode(value, aidMode)) config.policy.networkAidMode = aidMode;
-    else if (key == "policy.network_aid.override_required" && toBool(value, bval)) config.policy.overrideRequired = bval;
-    else if (key == "policy.network_aid.override_auth" && toOverrideAuth(value, authMode)) config.policy.overrideAuth = authMode;
-    else if (key == "policy.network_aid.override_timeout_seconds" && toInt(value, ival)) config.policy.overrideTimeoutSeconds = ival;
-    else if (key == "policy.roles") config.policy.roles = splitList(value);
-    else if (key == "policy.active_role") config.policy.activeRole = toLower(trim(value));
-    else if (key == "policy.authorization.version") config.policy.authorization.version = value;
-    else if (key == "policy.authorization.source") config.policy.authorization.source = value;
-    else if (key == "policy.authorization.allowed_modes") config.policy.authorization.allowedModes = splitList(value);
-    else if (key == "policy.debug_admin.enabled" && toBool(value, bval)) config.policy.debugAdmin.enabled = bval;
-    else if (key == "policy.debug_admin.enabled") setIssue(result, key, "invalid boolean");
-    else if (key == "policy.debug_admin.start_active" && toBool(value, bval)) config.policy.debugAdmin.startActive = bval;
-    else if (key == "policy.debug_admin.start_active") setIssue(result, key, "invalid boolean");
-    else if (key == "provenance.run_mode" && toProvenanceMode(value, provenanceMode)) config.provenance.runMode = provenanceMode;
-    else if (key == "provenance.run_mode") setIssue(result, key, "invalid provenance run_mode");
-    else if (key == "provenance.allowed_inputs")
-    {
-        std::vector<std::string> inputs = splitList(value);
-        std::vector<SimConfig::ProvenanceMode> parsed;
-        parsed.reserve(inputs.size());
-        bool ok = true;
-        for (const auto &entry : inputs)
-        {
-            SimConfig::ProvenanceMode mode = SimConfig::ProvenanceMode::Operational;
-            if (!toProvenanceMode(entry, mode))
-            {
-                ok = false;
-                break;
-            }
-            parsed.push_back(mode);
-        }
-        if (!ok)
+    double parsed = 0.0;
+    if (!toDouble(value, parsed))
+    {
+        return kInvalidValue;
+    }
+    field = parsed;
+    return nullptr;
+}
+
+const char *setInteger(const std::string &value, int &field)
+{
+    int parsed = 0;
+    if (!toInt(value, parsed))
+    {
+        return kInvalidValue;
+    }
+    field = parsed;
+    return nullptr;
+}
+
+const char *setUnsigned(const std::string &value, unsigned int &field)
+{
+    unsigned int parsed = 0;
+    if (!toUnsigned(value, parsed))
+    {
+        return kInvalidValue;
+    }
+    field = parsed;
+    return nullptr;
+}
+
+const char *setFlag(const std::string &value, bool &field, const char *invalid = kInvalidValue)
+{
+    bool parsed = false;
+    if (!toBool(value, parsed))
+    {
+        return invalid;
+    }
+    field = parsed;
+    return nullptr;
+}
+
+// Parses with one of the to<Enum>() converters above.
+template <typename Value>
+const char *setParsed(const std::string &value, Value &field, bool (*parse)(const std::string &, Value &),
+                      const char *invalid = kInvalidValue)
+{
+    Value parsed{};
+    if (!parse(value, parsed))
+    {
+        return invalid;
+    }
+    field = parsed;
+    return nullptr;
+}
+
+const char *setAllowedInputs(SimConfig &config, const std::string &value)
+{
+    std::vector<SimConfig::ProvenanceMode> parsed;
+    for (const auto &entry : splitList(value))
+    {
+        SimConfig::ProvenanceMode mode = SimConfig::ProvenanceMode::Operational;
+        if (!toProvenanceMode(entry, mode))
         {
-            setIssue(result, key, "invalid provenance value");
+            return "invalid provenance value";
         }
-        else
+        parsed.push_back(mode);
+    }
+    config.provenance.allowedInputs = std::move(parsed);
+    return nullptr;
+}
+
+const char *setMaxAuxPipelines(SimConfig &config, const std::string &value)
+{
+    int parsed = 0;
+    if (!toInt(value, parsed))
+    {
+        return kInvalidValue;
+    }
+    if (parsed < 0)
+    {
+        return "must be >= 0";
+    }
+    config.scheduler.maxAuxPipelines = static_cast<std::size_t>(parsed);
+    return nullptr;
+}
+
+// Exact config keys resolved through one perfect-hash lookup instead of a chain of string
+// compares; keys that embed a role or sensor name are matched by prefix in applyValue().
+struct ConfigKeyTable
+{
+    tools::PerfectHashIndex index;
+    std::vector<ConfigKeyHandler> handlers;
+};
+
+ConfigKeyTable buildConfigKeyTable()
+{
+    std::vector<std::string> keys;
+    ConfigKeyTable table;
+    auto add = [&](std::string key, ConfigKeyHandler handler) {
+        keys.push_back(std::move(key));
+        table.handlers.push_back(std::move(handler));
+    };
+    using Config = SimConfig;
+    using Value = const std::string &;
+
+    add("config.version", [](Config &c, Value v) { c.version = v; return nullptr; });
+    add("state.position.x", [](Config &c, Value v) { return setReal(v, c.initialState.position.x); });
+    add("state.position.y", [](Config &c, Value v) { return setReal(v, c.initialState.position.y); });
+    add("state.position.z", [](Config &c, Value v) { return setReal(v, c.initialState.position.z); });
+    add("state.velocity.x", [](Config &c, Value v) { return setReal(v, c.initialState.velocity.x); });
+    add("state.velocity.y", [](Config &c, Value v) { return setReal(v, c.initialState.velocity.y); });
+    add("state.velocity.z", [](Config &c, Value v) { return setReal(v, c.initialState.velocity.z); });
+    add("state.acceleration.x", [](Config &c, Value v) { return setReal(v, c.initialState.acceleration.x); });
+    add("state.acceleration.y", [](Config &c, Value v) { return setReal(v, c.initialState.acceleration.y); });
+    add("state.acceleration.z", [](Config &c, Value v) { return setReal(v, c.initialState.acceleration.z); });
+    add("state.time", [](Config &c, Value v) { return setReal(v, c.initialState.time); });
+    add("sim.dt", [](Config &c, Value v) { return setReal(v, c.dt); });
+    add("sim.steps", [](Config &c, Value v) { return setInteger(v, c.steps); });
+    add("sim.seed", [](Config &c, Value v) { return setUnsigned(v, c.seed); });
+    add("bounds.min.x", [](Config &c, Value v) { return setReal(v, c.bounds.minPosition.x); });
+    add("bounds.min.y", [](Config &c, Value v) { return setReal(v, c.bounds.minPosition.y); });
+    add("bounds.min.z", [](Config &c, Value v) { return setReal(v, c.bounds.minPosition.z); });
+    add("bounds.max.x", [](Config &c, Value v) { return setReal(v, c.bounds.maxPosition.x); });
+    add("bounds.max.y", [](Config &c, Value v) { return setReal(v, c.bounds.maxPosition.y); });
+    add("bounds.max.z", [](Config &c, Value v) { return setReal(v, c.bounds.maxPosition.z); });
+    add("bounds.max_speed", [](Config &c, Value v) { return setReal(v, c.bounds.maxSpeed); });
+    add("bounds.max_accel", [](Config &c, Value v) { return setReal(v, c.bounds.maxAcceleration); });
+    add("bounds.max_turn_rate_deg", [](Config &c, Value v) { return setReal(v, c.bounds.maxTurnRateDeg); });
+    add("maneuver.random_accel_std", [](Config &c, Value v) { return setReal(v, c.maneuvers.randomAccelStd); });
+    add("maneuver.probability", [](Config &c, Value v) { return setReal(v, c.maneuvers.maneuverProbability); });
+
+    const std::pair<const char *, SensorConfig SimConfig::*> sensors[] = {
+        {"gps", &SimConfig::gps},
+        {"thermal", &SimConfig::thermal},
+        {"dead_reckoning", &SimConfig::deadReckoning},
+        {"imu", &SimConfig::imu},
+        {"radar", &SimConfig::radar},
+        {"vision", &SimConfig::vision},
+        {"lidar", &SimConfig::lidar},
+        {"magnetometer", &SimConfig::magnetometer},
+        {"baro", &SimConfig::baro},
+        {"celestial", &SimConfig::celestial}};
+    const std::pair<const char *, double SensorConfig::*> sensorFields[] = {
+        {"rate_hz", &SensorConfig::rateHz},
+        {"noise_std", &SensorConfig::noiseStd},
+        {"dropout", &SensorConfig::dropoutProbability},
+        {"false_positive", &SensorConfig::falsePositiveProbability},
+        {"max_range", &SensorConfig::maxRange}};
+    for (const auto &sensor : sensors)
+    {
+        for (const auto &field : sensorFields)
+        {
+            add(std::string("sensor.") + sensor.first + "." + field.first,
+                [sensor = sensor.second, field = field.second](Config &c, Value v) { return setReal(v, (c.*sensor).*field); });
+        }
+    }
+
+    add("platform.profile", [](Config &c, Value v) { return setParsed(v, c.platformProfile, toProfile); });
+    add("platform.profile_parent", [](Config &c, Value v) {
+        if (const char *issue = setParsed(v, c.parentProfile, toProfile))
+        {
+            return issue;
+        }
+        c.hasParentProfile = true;
+        return static_cast<const char *>(nullptr);
+    });
+    add("platform.permitted_sensors", [](Config &c, Value v) { c.permittedSensors = splitList(v); return nullptr; });
+    add("platform.child_modules", [](Config &c, Value v) { c.childModules = splitList(v); return nullptr; });
+    add("policy.network_aid.mode", [](Config &c, Value v) { return setParsed(v, c.policy.networkAidMode, toNetworkAidMode); });
+    add("policy.network_aid.override_required", [](Config &c, Value v) { return setFlag(v, c.policy.overrideRequired); });
+    add("policy.network_aid.override_auth", [](Config &c, Value v) { return setParsed(v, c.policy.overrideAuth, toOverrideAuth); });
+    add("policy.network_aid.override_timeout_seconds", [](Config &c, Value v) { return setInteger(v, c.policy.overrideTimeoutSeconds); });
+    add("policy.roles", [](Config &c, Value v) { c.policy.roles = splitList(v); return nullptr; });
+    add("policy.active_role", [](Config &c, Value v) { c.policy.activeRole = toLower(trim(v)); return nullptr; });
+    add("policy.authorization.version", [](Config &c, Value v) { c.policy.authorization.version = v; return nullptr; });
+    add("policy.authorization.source", [](Config &c, Value v) { c.policy.authorization.source = v; return nullptr; });
+    add("policy.authorization.allowed_modes", [](Config &c, Value v) { c.policy.authorization.allowedModes = splitList(v); return nullptr; });
+    add("policy.debug_admin.enabled", [](Config &c, Value v) { return setFlag(v, c.policy.debugAdmin.enabled, "invalid boolean"); });
+    add("policy.debug_admin.start_active", [](Config &c, Value v) { return setFlag(v, c.policy.debugAdmin.startActive, "invalid boolean"); });
+    add("provenance.run_mode", [](Config &c, Value v) {
+        return setParsed(v, c.provenance.runMode, toProvenanceMode, "invalid provenance run_mode");
+    });
+    add("provenance.allowed_inputs", setAllowedInputs);
+    add("provenance.allow_mixed", [](Config &c, Value v) { return setFlag(v, c.provenance.allowMixed, "invalid boolean"); });
+    add("provenance.unknown_action", [](Config &c, Value v) {
+        return setParsed(v, c.provenance.unknownAction, toUnknownProvenanceAction, "invalid unknown_action");
+    });
+
+    add("dataset.celestial.tier", [](Config &c, Value v) { return setParsed(v, c.dataset.tier, toDatasetTier); });
+    add("dataset.celestial.max_size_mb", [](Config &c, Value v) { return setReal(v, c.dataset.maxSizeMB); });
+    add("dataset.celestial.catalog_path", [](Config &c, Value v) { c.dataset.celestialCatalogPath = v; return nullptr; });
+    add("dataset.celestial.ephemeris_path", [](Config &c, Value v) { c.dataset.celestialEphemerisPath = v; return nullptr; });
+    add("dataset.celestial.catalog_hash", [](Config &c, Value v) { c.dataset.celestialCatalogHash = v; return nullptr; });
+    add("dataset.celestial.ephemeris_hash", [](Config &c, Value v) { c.dataset.celestialEphemerisHash = v; return nullptr; });
+
+    add("adapter.id", [](Config &c, Value v) { c.adapter.id = toLower(trim(v)); return nullptr; });
+    add("adapter.version", [](Config &c, Value v) { c.adapter.version = trim(v); return nullptr; });
+    add("adapter.manifest_path", [](Config &c, Value v) { c.adapter.manifestPath = trim(v); return nullptr; });
+    add("adapter.allowlist_path", [](Config &c, Value v) { c.adapter.allowlistPath = trim(v); return nullptr; });
+    add("adapter.core_version", [](Config &c, Value v) { c.adapter.coreVersion = trim(v); return nullptr; });
+    add("adapter.tools_version", [](Config &c, Value v) { c.adapter.toolsVersion = trim(v); return nullptr; });
+    add("adapter.ui_version", [](Config &c, Value v) { c.adapter.uiVersion = trim(v); return nullptr; });
+    add("adapter.contract_version", [](Config &c, Value v) { c.adapter.adapterContractVersion = trim(v); return nullptr; });
+    add("ui.contract_version", [](Config &c, Value v) { c.adapter.uiContractVersion = trim(v); return nullptr; });
+    add("adapter.allowlist_max_age_days", [](Config &c, Value v) { return setInteger(v, c.adapter.allowlistMaxAgeDays); });
+    add("ui.surface", [](Config &c, Value v) { return setParsed(v, c.adapter.uiSurface, toUiSurface, "invalid ui surface"); });
+
+    add("plugin.id", [](Config &c, Value v) { c.plugin.id = toLower(trim(v)); return nullptr; });
+    add("plugin.version", [](Config &c, Value v) { c.plugin.version = trim(v); return nullptr; });
+    add("plugin.signature_hash", [](Config &c, Value v) { c.plugin.signatureHash = trim(v); return nullptr; });
+    add("plugin.signature_algorithm", [](Config &c, Value v) { c.plugin.signatureAlgorithm = toLower(trim(v)); return nullptr; });
+    add("plugin.allowlist.id", [](Config &c, Value v) { c.plugin.allowlistId = toLower(trim(v)); return nullptr; });
+    add("plugin.allowlist.version", [](Config &c, Value v) { c.plugin.allowlistVersion = trim(v); return nullptr; });
+    add("plugin.allowlist.signature_hash", [](Config &c, Value v) { c.plugin.allowlistSignatureHash = trim(v); return nullptr; });
+    add("plugin.allowlist.signature_algorithm", [](Config &c, Value v) {
+        c.plugin.allowlistSignatureAlgorithm = toLower(trim(v));
+        return nullptr;
+    });
+    add("plugin.authorization_required", [](Config &c, Value v) { return setFlag(v, c.plugin.authorizationRequired); });
+    add("plugin.authorization_granted", [](Config &c, Value v) { return setFlag(v, c.plugin.authorizationGranted); });
+    add("plugin.device_driver", [](Config &c, Value v) { return setFlag(v, c.plugin.deviceDriver); });
+
+    add("front_view.enabled", [](Config &c, Value v) { return setFlag(v, c.frontView.enabled); });
+    add("front_view.display_families", [](Config &c, Value v) { c.frontView.displayFamilies = splitList(v); return nullptr; });
+    add("front_view.auto_cycle.enabled", [](Config &c, Value v) { return setFlag(v, c.frontView.autoCycleEnabled); });
+    add("front_view.auto_cycle.interval_ms", [](Config &c, Value v) { return setInteger(v, c.frontView.autoCycleIntervalMs); });
+    add("front_view.auto_cycle.order", [](Config &c, Value v) { c.frontView.autoCycleOrder = splitList(v); return nullptr; });
+    add("front_view.render.latency_budget_ms", [](Config &c, Value v) { return setReal(v, c.frontView.renderLatencyBudgetMs); });
+    add("front_view.proximity.max_range_m", [](Config &c, Value v) { return setReal(v, c.frontView.proximityMaxRangeMeters); });
+    add("front_view.frame.max_age_ms", [](Config &c, Value v) { return setReal(v, c.frontView.frameMaxAgeMs); });
+    add("front_view.frame.min_confidence", [](Config &c, Value v) { return setReal(v, c.frontView.frameMinConfidence); });
+    add("front_view.multi_view.max_streams", [](Config &c, Value v) { return setInteger(v, c.frontView.maxConcurrentViews); });
+    add("front_view.multi_view.stream_ids", [](Config &c, Value v) { c.frontView.streamIds = splitList(v); return nullptr; });
+    add("front_view.stabilization.enabled", [](Config &c, Value v) { return setFlag(v, c.frontView.stabilizationEnabled); });
+    add("front_view.stabilization.mode", [](Config &c, Value v) { c.frontView.stabilizationMode = toLower(trim(v)); return nullptr; });
+    add("front_view.gimbal.enabled", [](Config &c, Value v) { return setFlag(v, c.frontView.gimbalEnabled); });
+    add("front_view.gimbal.max_yaw_rate_deg_s", [](Config &c, Value v) { return setReal(v, c.frontView.gimbalMaxYawRateDegPerSec); });
+    add("front_view.gimbal.max_pitch_rate_deg_s", [](Config &c, Value v) {
+        return setReal(v, c.frontView.gimbalMaxPitchRateDegPerSec);
+    });
+    add("front_view.spoof.enabled", [](Config &c, Value v) { return setFlag(v, c.frontView.spoofEnabled); });
+    add("front_view.spoof.pattern", [](Config &c, Value v) { c.frontView.spoofPattern = toLower(trim(v)); return nullptr; });
+    add("front_view.spoof.motion_profile", [](Config &c, Value v) { c.frontView.spoofMotionProfile = toLower(trim(v)); return nullptr; });
+    add("front_view.spoof.seed", [](Config &c, Value v) { return setUnsigned(v, c.frontView.spoofSeed); });
+    add("front_view.spoof.rate_hz", [](Config &c, Value v) { return setReal(v, c.frontView.spoofRateHz); });
+    add("front_view.security.require_signed_assets", [](Config &c, Value v) { return setFlag(v, c.frontView.requireSignedAssets); });
+    add("front_view.threading.enabled", [](Config &c, Value v) { return setFlag(v, c.frontView.threadingEnabled); });
+    add("front_view.threading.max_workers", [](Config &c, Value v) { return setInteger(v, c.frontView.threadingMaxWorkers); });
+
+    add("mode.ladder_order", [](Config &c, Value v) { c.mode.ladderOrder = splitList(v); return nullptr; });
+    add("mode.min_healthy_count", [](Config &c, Value v) { return setInteger(v, c.mode.minHealthyCount); });
+    add("mode.min_dwell_steps", [](Config &c, Value v) { return setInteger(v, c.mode.minDwellSteps); });
+    add("mode.max_stale_count", [](Config &c, Value v) { return setInteger(v, c.mode.maxStaleCount); });
+    add("mode.max_low_confidence_count", [](Config &c, Value v) { return setInteger(v, c.mode.maxLowConfidenceCount); });
+    add("mode.lockout_steps", [](Config &c, Value v) { return setInteger(v, c.mode.lockoutSteps); });
+    add("mode.history_window", [](Config &c, Value v) { return setInteger(v, c.mode.historyWindow); });
+    add("fusion.max_data_age_seconds", [](Config &c, Value v) { return setReal(v, c.fusion.maxDataAgeSeconds); });
+    add("fusion.disagreement_threshold", [](Config &c, Value v) { return setReal(v, c.fusion.disagreementThreshold); });
+    add("fusion.min_confidence", [](Config &c, Value v) { return setReal(v, c.fusion.minConfidence); });
+    add("fusion.max_disagreement_count", [](Config &c, Value v) { return setInteger(v, c.fusion.maxDisagreementCount); });
+    add("fusion.max_residual_age_seconds", [](Config &c, Value v) { return setReal(v, c.fusion.maxResidualAgeSeconds); });
+    add("scheduler.primary_budget_ms", [](Config &c, Value v) { return setReal(v, c.scheduler.primaryBudgetMs); });
+    add("scheduler.aux_budget_ms", [](Config &c, Value v) { return setReal(v, c.scheduler.auxBudgetMs); });
+    add("scheduler.max_aux_pipelines", setMaxAuxPipelines);
+    add("scheduler.aux_min_service_interval", [](Config &c, Value v) {
+        return setReal(v, c.scheduler.auxMinServiceIntervalSeconds);
+    });
+    add("scheduler.allow_snapshot_overlap", [](Config &c, Value v) { return setFlag(v, c.scheduler.allowSnapshotOverlap); });
+
+    table.index = tools::PerfectHashIndex(std::move(keys));
+    return table;
+}
+
+const ConfigKeyTable &configKeyTable()
+{
+    static const ConfigKeyTable kTable = buildConfigKeyTable();
+    return kTable;
+}
+
+void applyValue(SimConfig &config, ConfigResult &result, const std::string &key, const std::string &value)
+{
+    const ConfigKeyTable &table = configKeyTable();
+    const std::size_t handler = table.index.find(key);
+    if (handler != tools::PerfectHashIndex::npos)
+    {
+        if (const char *issue = table.handlers[handler](config, value))
         {
-            config.provenance.allowedInputs = std::move(parsed);
+            setIssue(result, key, issue);
         }
+        return;
     }
-    else if (key == "provenance.allow_mixed" && toBool(value, bval)) config.provenance.allowMixed = bval;
-    else if (key == "provenance.allow_mixed") setIssue(result, key, "invalid boolean");
-    else if (key == "provenance.unknown_action" && toUnknownProvenanceAction(value, unknownAction)) config.provenance.unknownAction = unknownAction;
-    else if (key == "provenance.unknown_action") setIssue(result, key, "invalid unknown_action");
-    else if (key.rfind("policy.role_permissions.", 0) == 0)
+
+    double dval = 0.0;
+    bool bval = false;
+    if (key.rfind("policy.role_permissions.", 0) == 0)
     {
         std::string role = toLower(trim(key.substr(std::string("policy.role_permissions.").size())));
         if (role.empty())
@@ -573,86 +737,6 @@ void applyValue(SimConfig &config, ConfigResult &result, const std::string &key,
             }
         }
     }
-    else if (key == "dataset.celestial.tier" && toDatasetTier(value, tier)) config.dataset.tier = tier;
-    else if (key == "dataset.celestial.max_size_mb" && toDouble(value, dval)) config.dataset.maxSizeMB = dval;
-    else if (key == "dataset.celestial.catalog_path") config.dataset.celestialCatalogPath = value;
-    else if (key == "dataset.celestial.ephemeris_path") config.dataset.celestialEphemerisPath = value;
-    else if (key == "dataset.celestial.catalog_hash") config.dataset.celestialCatalogHash = value;
-    else if (key == "dataset.celestial.ephemeris_hash") config.dataset.celestialEphemerisHash = value;
-    else if (key == "adapter.id") config.adapter.id = toLower(trim(value));
-    else if (key == "adapter.version") config.adapter.version = trim(value);
-    else if (key == "adapter.manifest_path") config.adapter.manifestPath = trim(value);
-    else if (key == "adapter.allowlist_path") config.adapter.allowlistPath = trim(value);
-    else if (key == "adapter.core_version") config.adapter.coreVersion = trim(value);
-    else if (key == "adapter.tools_version") config.adapter.toolsVersion = trim(value);
-    else if (key == "adapter.ui_version") config.adapter.uiVersion = trim(value);
-    else if (key == "adapter.contract_version") config.adapter.adapterContractVersion = trim(value);
-    else if (key == "ui.contract_version") config.adapter.uiContractVersion = trim(value);
-    else if (key == "adapter.allowlist_max_age_days" && toInt(value, ival)) config.adapter.allowlistMaxAgeDays = ival;
-    else if (key == "ui.surface" && toUiSurface(value, uiSurface)) config.adapter.uiSurface = uiSurface;
-    else if (key == "ui.surface") setIssue(result, key, "invalid ui surface");
-    else if (key == "plugin.id") config.plugin.id = toLower(trim(value));
-    else if (key == "plugin.version") config.plugin.version = trim(value);
-    else if (key == "plugin.signature_hash") config.plugin.signatureHash = trim(value);
-    else if (key == "plugin.signature_algorithm") config.plugin.signatureAlgorithm = toLower(trim(value));
-    else if (key == "plugin.allowlist.id") config.plugin.allowlistId = toLower(trim(value));
-    else if (key == "plugin.allowlist.version") config.plugin.allowlistVersion = trim(value);
-    else if (key == "plugin.allowlist.signature_hash") config.plugin.allowlistSignatureHash = trim(value);
-    else if (key == "plugin.allowlist.signature_algorithm") config.plugin.allowlistSignatureAlgorithm = toLower(trim(value));
-    else if (key == "plugin.authorization_required" && toBool(value, bval)) config.plugin.authorizationRequired = bval;
-    else if (key == "plugin.authorization_granted" && toBool(value, bval)) config.plugin.authorizationGranted = bval;
-    else if (key == "plugin.device_driver" && toBool(value, bval)) config.plugin.deviceDriver = bval;
-    else if (key == "front_view.enabled" && toBool(value, bval)) config.frontView.enabled = bval;
-    else if (key == "front_view.display_families") config.frontView.displayFamilies = splitList(value);
-    else if (key == "front_view.auto_cycle.enabled" && toBool(value, bval)) config.frontView.autoCycleEnabled = bval;
-    else if (key == "front_view.auto_cycle.interval_ms" && toInt(value, ival)) config.frontView.autoCycleIntervalMs = ival;
-    else if (key == "front_view.auto_cycle.order") config.frontView.autoCycleOrder = splitList(value);
-    else if (key == "front_view.render.latency_budget_ms" && toDouble(value, dval)) config.frontView.renderLatencyBudgetMs = dval;
-    else if (key == "front_view.proximity.max_range_m" && toDouble(value, dval)) config.frontView.proximityMaxRangeMeters = dval;
-    else if (key == "front_view.frame.max_age_ms" && toDouble(value, dval)) config.frontView.frameMaxAgeMs = dval;
-    else if (key == "front_view.frame.min_confidence" && toDouble(value, dval)) config.frontView.frameMinConfidence = dval;
-    else if (key == "front_view.multi_view.max_streams" && toInt(value, ival)) config.frontView.maxConcurrentViews = ival;
-    else if (key == "front_view.multi_view.stream_ids") config.frontView.streamIds = splitList(value);
-    else if (key == "front_view.stabilization.enabled" && toBool(value, bval)) config.frontView.stabilizationEnabled = bval;
-    else if (key == "front_view.stabilization.mode") config.frontView.stabilizationMode = toLower(trim(value));
-    else if (key == "front_view.gimbal.enabled" && toBool(value, bval)) config.frontView.gimbalEnabled = bval;
-    else if (key == "front_view.gimbal.max_yaw_rate_deg_s" && toDouble(value, dval)) config.frontView.gimbalMaxYawRateDegPerSec = dval;
-    else if (key == "front_view.gimbal.max_pitch_rate_deg_s" && toDouble(value, dval)) config.frontView.gimbalMaxPitchRateDegPerSec = dval;
-    else if (key == "front_view.spoof.enabled" && toBool(value, bval)) config.frontView.spoofEnabled = bval;
-    else if (key == "front_view.spoof.pattern") config.frontView.spoofPattern = toLower(trim(value));
-    else if (key == "front_view.spoof.motion_profile") config.frontView.spoofMotionProfile = toLower(trim(value));
-    else if (key == "front_view.spoof.seed" && toUnsigned(value, uval)) config.frontView.spoofSeed = uval;
-    else if (key == "front_view.spoof.rate_hz" && toDouble(value, dval)) config.frontView.spoofRateHz = dval;
-    else if (key == "front_view.security.require_signed_assets" && toBool(value, bval)) config.frontView.requireSignedAssets = bval;
-    else if (key == "front_view.threading.enabled" && toBool(value, bval)) config.frontView.threadingEnabled = bval;
-    else if (key == "front_view.threading.max_workers" && toInt(value, ival)) config.frontView.threadingMaxWorkers = ival;
-    else if (key == "mode.ladder_order") config.mode.ladderOrder = splitList(value);
-    else if (key == "mode.min_healthy_count" && toInt(value, ival)) config.mode.minHealthyCount = ival;
-    else if (key == "mode.min_dwell_steps" && toInt(value, ival)) config.mode.minDwellSteps = ival;
-    else if (key == "mode.max_stale_count" && toInt(value, ival)) config.mode.maxStaleCount = ival;
-    else if (key == "mode.max_low_confidence_count" && toInt(value, ival)) config.mode.maxLowConfidenceCount = ival;
-    else if (key == "mode.lockout_steps" && toInt(value, ival)) config.mode.lockoutSteps = ival;
-    else if (key == "mode.history_window" && toInt(value, ival)) config.mode.historyWindow = ival;
-    else if (key == "fusion.max_data_age_seconds" && toDouble(value, dval)) config.fusion.maxDataAgeSeconds = dval;
-    else if (key == "fusion.disagreement_threshold" && toDouble(value, dval)) config.fusion.disagreementThreshold = dval;
-    else if (key == "fusion.min_confidence" && toDouble(value, dval)) config.fusion.minConfidence = dval;
-    else if (key == "fusion.max_disagreement_count" && toInt(value, ival)) config.fusion.maxDisagreementCount = ival;
-    else if (key == "fusion.max_residual_age_seconds" && toDouble(value, dval)) config.fusion.maxResidualAgeSeconds = dval;
-    else if (key == "scheduler.primary_budget_ms" && toDouble(value, dval)) config.scheduler.primaryBudgetMs = dval;
-    else if (key == "scheduler.aux_budget_ms" && toDouble(value, dval)) config.scheduler.auxBudgetMs = dval;
-    else if (key == "scheduler.max_aux_pipelines" && toInt(value, ival))
-    {
-        if (ival < 0)
-        {
-            setIssue(result, key, "must be >= 0");
-        }
-        else
-        {
-            config.scheduler.maxAuxPipelines = static_cast<std::size_t>(ival);
-        }
-    }
-    else if (key == "scheduler.aux_min_service_interval" && toDouble(value, dval)) config.scheduler.auxMinServiceIntervalSeconds = dval;
-    else if (key == "scheduler.allow_snapshot_overlap" && toBool(value, bval)) config.scheduler.allowSnapshotOverlap = bval;
     else if (key.rfind("fusion.source_weights.", 0) == 0)
     {
         std::string sensor = toLower(trim(key.substr(std::string("fusion.source_weights.").size())));
@@ -671,7 +755,7 @@ void applyValue(SimConfig &config, ConfigResult &result, const std::string &key,
     }
     else
     {
-        setIssue(result, key, "unknown or invalid value");
+        setIssue(result, key, kInvalidValue);
     }
 }
 
@@ -1249,23 +1333,17 @@ void validateConfig(ConfigResult &result)
         setIssue(result, "front_view.multi_view.max_streams", "must be 1 when front_view.threading.enabled is false");
     }
 }
-} // namespace
 
-ConfigResult loadSimConfig(const std::string &path)
+// Parses, defaults, and validates config text. The result depends on the text alone, which is
+// what lets a snapshot stand in for it.
+ConfigResult compileSimConfig(std::istream &input)
 {
     ConfigResult result;
     result.config.initialState = {{0.0, 0.0, 100.0}, {15.0, 10.0, 0.0}, {0.2, -0.1, 0.0}, 0.0};
 
-    std::ifstream file(path);
-    if (!file)
-    {
-        setIssue(result, path, "unable to open config");
-        return result;
-    }
-
     std::string line;
     bool versionSeen = false;
-    while (std::getline(file, line))
+    while (std::getline(input, line))
     {
         std::string trimmed = trim(line);
         if (trimmed.empty() || trimmed[0] == '#')
@@ -1331,7 +1409,13 @@ ConfigResult loadSimConfig(const std::string &path)
     }
 
     validateConfig(result);
+    return result;
+}
 
+// Checks against registry files and the clock, which can change without the config text
+// changing, so they run on every load.
+void checkExternalBindings(ConfigResult &result)
+{
     if (result.ok && !result.config.adapter.id.empty())
     {
         std::string reason;
@@ -1362,6 +1446,103 @@ ConfigResult loadSimConfig(const std::string &path)
             setIssue(result, "plugin.auth", pluginResult.reason);
         }
     }
+}
+
+bool readWholeFile(const std::string &path, std::string &contents)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !file.bad();
+}
+
+// Written to a temporary name and renamed, so a concurrent reader never sees half a snapshot.
+// Failing to write only costs the next load a recompile.
+void writeSnapshot(const std::string &snapshotPath, const std::string &bytes)
+{
+    const std::string temporary = snapshotPath + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!out.flush())
+        {
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temporary, snapshotPath, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temporary, ec);
+    }
+}
+} // namespace
+
+ConfigResult loadSimConfig(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        ConfigResult result;
+        setIssue(result, path, "unable to open config");
+        return result;
+    }
+    ConfigResult result = compileSimConfig(file);
+    checkExternalBindings(result);
+    return result;
+}
+
+ConfigResult loadSimConfigCached(const std::string &path, const std::string &snapshotPath, bool *fromSnapshot)
+{
+    if (fromSnapshot != nullptr)
+    {
+        *fromSnapshot = false;
+    }
+    std::string text;
+    if (!readWholeFile(path, text))
+    {
+        ConfigResult result;
+        setIssue(result, path, "unable to open config");
+        return result;
+    }
+    const std::string sourceHash = sha256Hex(text.data(), text.size());
 
+    ConfigResult result;
+    std::string snapshot;
+    bool reused = readWholeFile(snapshotPath, snapshot) && tools::decodeSimConfigSnapshot(snapshot, sourceHash, result.config);
+    if (reused)
+    {
+        // The schema ID only tracks the sources CMake hashed, so a snapshot is re-validated under
+        // the current rules and dropped if they now reject it.
+        validateConfig(result);
+        reused = result.ok;
+    }
+    if (reused)
+    {
+        if (fromSnapshot != nullptr)
+        {
+            *fromSnapshot = true;
+        }
+    }
+    else
+    {
+        std::istringstream input(text);
+        result = compileSimConfig(input);
+        // Rejected configs are not cached; they are re-reported in full every time, and a snapshot
+        // left by a build with looser rules is removed.
+        if (result.ok)
+        {
+            writeSnapshot(snapshotPath, tools::encodeSimConfigSnapshot(result.config, sourceHash));
+        }
+        else if (!snapshot.empty())
+        {
+            std::error_code ec;
+            std::filesystem::remove(snapshotPath, ec);
+        }
+    }
+    checkExternalBindings(result);
     return result;
 }
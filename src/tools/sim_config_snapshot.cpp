@@ -0,0 +1,458 @@
+#include "tools/sim_config_snapshot.h"
+
+#include "core/hash.h"
+#include "tools/binary_wire.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Set by CMake from the SimConfig declaration, loader, and snapshot sources; a build outside it
+// falls back to its own compile time so snapshots are still never shared across builds.
+#ifndef AIRTRACE_SIM_CONFIG_SCHEMA_ID
+#define AIRTRACE_SIM_CONFIG_SCHEMA_ID __DATE__ " " __TIME__
+#endif
+
+namespace tools
+{
+namespace
+{
+constexpr std::string_view kMagic = "ATSC";
+constexpr std::size_t kTrailerBytes = 32;
+
+// Encoder and decoder expose the same calls, so one transfer() walk over SimConfig serves both
+// directions and the two cannot drift apart.
+class SnapshotEncoder
+{
+public:
+    explicit SnapshotEncoder(std::string &out)
+        : writer(out)
+    {
+    }
+
+    void operator()(const std::string &value) { writer.text(value); }
+    void operator()(double value) { writer.real(value); }
+    void operator()(int value) { writer.zigzag(value); }
+    void operator()(bool value) { writer.byte(value ? 1U : 0U); }
+
+    template <typename Unsigned>
+    std::enable_if_t<std::is_unsigned<Unsigned>::value> operator()(Unsigned value)
+    {
+        writer.varint(value);
+    }
+
+    template <typename Enum>
+    void choice(Enum value, Enum)
+    {
+        writer.varint(static_cast<std::uint64_t>(value));
+    }
+
+    template <typename Value>
+    void sequence(std::vector<Value> &values)
+    {
+        writer.varint(values.size());
+        for (Value &value : values)
+        {
+            transfer(*this, value);
+        }
+    }
+
+    // Sorted by key, so equal maps encode to equal bytes whatever their bucket order.
+    template <typename Value>
+    void mapping(std::unordered_map<std::string, Value> &values)
+    {
+        std::vector<std::pair<const std::string, Value> *> entries;
+        entries.reserve(values.size());
+        for (auto &entry : values)
+        {
+            entries.push_back(&entry);
+        }
+        std::sort(entries.begin(), entries.end(), [](const auto *lhs, const auto *rhs) { return lhs->first < rhs->first; });
+        writer.varint(entries.size());
+        for (auto *entry : entries)
+        {
+            writer.text(entry->first);
+            transfer(*this, entry->second);
+        }
+    }
+
+private:
+    BinaryWriter writer;
+};
+
+class SnapshotDecoder
+{
+public:
+    explicit SnapshotDecoder(std::string_view in)
+        : reader(in)
+    {
+    }
+
+    void operator()(std::string &value) { good = good && reader.text(value); }
+    void operator()(double &value) { good = good && reader.real(value); }
+
+    void operator()(int &value)
+    {
+        std::int64_t raw = 0;
+        good = good && reader.zigzag(raw) && raw >= std::numeric_limits<int>::min() && raw <= std::numeric_limits<int>::max();
+        value = good ? static_cast<int>(raw) : 0;
+    }
+
+    void operator()(bool &value)
+    {
+        std::uint8_t raw = 0;
+        good = good && reader.byte(raw) && raw <= 1U;
+        value = raw == 1U;
+    }
+
+    template <typename Unsigned>
+    std::enable_if_t<std::is_unsigned<Unsigned>::value> operator()(Unsigned &value)
+    {
+        std::uint64_t raw = 0;
+        good = good && reader.varint(raw) && raw <= std::numeric_limits<Unsigned>::max();
+        value = good ? static_cast<Unsigned>(raw) : 0;
+    }
+
+    template <typename Enum>
+    void choice(Enum &value, Enum last)
+    {
+        std::uint64_t raw = 0;
+        good = good && reader.varint(raw) && raw <= static_cast<std::uint64_t>(last);
+        value = good ? static_cast<Enum>(raw) : Enum{};
+    }
+
+    template <typename Value>
+    void sequence(std::vector<Value> &values)
+    {
+        values.clear();
+        std::uint64_t count = 0;
+        // Every element takes at least one byte, which bounds the allocation.
+        good = good && reader.varint(count) && count <= reader.remaining();
+        if (!good)
+        {
+            return;
+        }
+        values.resize(static_cast<std::size_t>(count));
+        for (Value &value : values)
+        {
+            transfer(*this, value);
+        }
+    }
+
+    template <typename Value>
+    void mapping(std::unordered_map<std::string, Value> &values)
+    {
+        values.clear();
+        std::uint64_t count = 0;
+        good = good && reader.varint(count) && count <= reader.remaining();
+        for (std::uint64_t idx = 0; good && idx < count; ++idx)
+        {
+            std::string key;
+            Value value{};
+            good = reader.text(key);
+            transfer(*this, value);
+            good = good && values.emplace(std::move(key), std::move(value)).second;
+        }
+    }
+
+    bool finished() const
+    {
+        return good && reader.remaining() == 0;
+    }
+
+private:
+    BinaryReader reader;
+    bool good = true;
+};
+
+template <typename Io, typename Value>
+void transfer(Io &io, Value &value)
+{
+    io(value);
+}
+
+template <typename Io, typename Value>
+void transfer(Io &io, std::vector<Value> &values)
+{
+    io.sequence(values);
+}
+
+template <typename Io, typename Value>
+void transfer(Io &io, std::unordered_map<std::string, Value> &values)
+{
+    io.mapping(values);
+}
+
+template <typename Io>
+void transfer(Io &io, SimConfig::PlatformProfile &value)
+{
+    io.choice(value, SimConfig::PlatformProfile::Subsea);
+}
+
+template <typename Io>
+void transfer(Io &io, SimConfig::NetworkAidMode &value)
+{
+    io.choice(value, SimConfig::NetworkAidMode::TestOnly);
+}
+
+template <typename Io>
+void transfer(Io &io, SimConfig::OverrideAuth &value)
+{
+    io.choice(value, SimConfig::OverrideAuth::Token);
+}
+
+template <typename Io>
+void transfer(Io &io, SimConfig::DatasetTier &value)
+{
+    io.choice(value, SimConfig::DatasetTier::Extended);
+}
+
+template <typename Io>
+void transfer(Io &io, SimConfig::ProvenanceMode &value)
+{
+    io.choice(value, SimConfig::ProvenanceMode::Test);
+}
+
+template <typename Io>
+void transfer(Io &io, SimConfig::UnknownProvenanceAction &value)
+{
+    io.choice(value, SimConfig::UnknownProvenanceAction::Hold);
+}
+
+template <typename Io>
+void transfer(Io &io, Vec3 &value)
+{
+    io(value.x);
+    io(value.y);
+    io(value.z);
+}
+
+template <typename Io>
+void transfer(Io &io, State9 &value)
+{
+    transfer(io, value.position);
+    transfer(io, value.velocity);
+    transfer(io, value.acceleration);
+    io(value.time);
+}
+
+template <typename Io>
+void transfer(Io &io, SensorConfig &value)
+{
+    io(value.rateHz);
+    io(value.noiseStd);
+    io(value.dropoutProbability);
+    io(value.falsePositiveProbability);
+    io(value.maxRange);
+}
+
+template <typename Io>
+void transfer(Io &io, SimConfig::PolicyConfig::RoleUiPreset &value)
+{
+    io(value.uiSurface);
+    io(value.frontViewEnabled);
+    io(value.hasFrontViewEnabled);
+    transfer(io, value.frontViewFamilies);
+    io(value.hasFrontViewFamilies);
+}
+
+template <typename Io>
+void transfer(Io &io, SimConfig::PolicyConfig &policy)
+{
+    transfer(io, policy.networkAidMode);
+    io(policy.overrideRequired);
+    transfer(io, policy.overrideAuth);
+    io(policy.overrideTimeoutSeconds);
+    transfer(io, policy.roles);
+    transfer(io, policy.rolePermissions);
+    transfer(io, policy.roleUiPresets);
+    io(policy.activeRole);
+    io(policy.authorization.version);
+    io(policy.authorization.source);
+    transfer(io, policy.authorization.allowedModes);
+    io(policy.debugAdmin.enabled);
+    io(policy.debugAdmin.startActive);
+}
+
+template <typename Io>
+void transfer(Io &io, SimConfig::FrontViewConfig &view)
+{
+    io(view.enabled);
+    transfer(io, view.displayFamilies);
+    io(view.autoCycleEnabled);
+    io(view.autoCycleIntervalMs);
+    transfer(io, view.autoCycleOrder);
+    io(view.renderLatencyBudgetMs);
+    io(view.proximityMaxRangeMeters);
+    io(view.frameMaxAgeMs);
+    io(view.frameMinConfidence);
+    io(view.maxConcurrentViews);
+    transfer(io, view.streamIds);
+    io(view.stabilizationEnabled);
+    io(view.stabilizationMode);
+    io(view.gimbalEnabled);
+    io(view.gimbalMaxYawRateDegPerSec);
+    io(view.gimbalMaxPitchRateDegPerSec);
+    io(view.spoofEnabled);
+    io(view.spoofPattern);
+    io(view.spoofMotionProfile);
+    io(view.spoofSeed);
+    io(view.spoofRateHz);
+    io(view.requireSignedAssets);
+    io(view.threadingEnabled);
+    io(view.threadingMaxWorkers);
+}
+
+template <typename Io>
+void transfer(Io &io, SimConfig &config)
+{
+    io(config.version);
+    transfer(io, config.initialState);
+    io(config.dt);
+    io(config.steps);
+    io(config.seed);
+
+    transfer(io, config.platformProfile);
+    io(config.hasParentProfile);
+    transfer(io, config.parentProfile);
+    transfer(io, config.childModules);
+    transfer(io, config.permittedSensors);
+    transfer(io, config.policy);
+
+    transfer(io, config.provenance.runMode);
+    transfer(io, config.provenance.allowedInputs);
+    io(config.provenance.allowMixed);
+    transfer(io, config.provenance.unknownAction);
+
+    transfer(io, config.dataset.tier);
+    io(config.dataset.maxSizeMB);
+    io(config.dataset.celestialCatalogPath);
+    io(config.dataset.celestialEphemerisPath);
+    io(config.dataset.celestialCatalogHash);
+    io(config.dataset.celestialEphemerisHash);
+
+    io(config.adapter.id);
+    io(config.adapter.version);
+    io(config.adapter.manifestPath);
+    io(config.adapter.allowlistPath);
+    io(config.adapter.uiSurface);
+    io(config.adapter.coreVersion);
+    io(config.adapter.toolsVersion);
+    io(config.adapter.uiVersion);
+    io(config.adapter.adapterContractVersion);
+    io(config.adapter.uiContractVersion);
+    io(config.adapter.allowlistMaxAgeDays);
+
+    io(config.plugin.id);
+    io(config.plugin.version);
+    io(config.plugin.signatureHash);
+    io(config.plugin.signatureAlgorithm);
+    io(config.plugin.allowlistId);
+    io(config.plugin.allowlistVersion);
+    io(config.plugin.allowlistSignatureHash);
+    io(config.plugin.allowlistSignatureAlgorithm);
+    io(config.plugin.authorizationRequired);
+    io(config.plugin.authorizationGranted);
+    io(config.plugin.deviceDriver);
+
+    transfer(io, config.frontView);
+
+    transfer(io, config.mode.ladderOrder);
+    io(config.mode.minHealthyCount);
+    io(config.mode.minDwellSteps);
+    io(config.mode.maxStaleCount);
+    io(config.mode.maxLowConfidenceCount);
+    io(config.mode.lockoutSteps);
+    io(config.mode.historyWindow);
+
+    io(config.fusion.maxDataAgeSeconds);
+    io(config.fusion.disagreementThreshold);
+    io(config.fusion.minConfidence);
+    io(config.fusion.maxDisagreementCount);
+    io(config.fusion.maxResidualAgeSeconds);
+    transfer(io, config.fusion.sourceWeights);
+
+    io(config.scheduler.primaryBudgetMs);
+    io(config.scheduler.auxBudgetMs);
+    io(config.scheduler.maxAuxPipelines);
+    io(config.scheduler.auxMinServiceIntervalSeconds);
+    io(config.scheduler.allowSnapshotOverlap);
+
+    transfer(io, config.bounds.minPosition);
+    transfer(io, config.bounds.maxPosition);
+    io(config.bounds.maxSpeed);
+    io(config.bounds.maxAcceleration);
+    io(config.bounds.maxTurnRateDeg);
+    io(config.maneuvers.randomAccelStd);
+    io(config.maneuvers.maneuverProbability);
+
+    for (SensorConfig *sensor : {&config.gps, &config.thermal, &config.deadReckoning, &config.imu, &config.radar,
+                                 &config.vision, &config.lidar, &config.magnetometer, &config.baro, &config.celestial})
+    {
+        transfer(io, *sensor);
+    }
+}
+
+void writeHeader(BinaryWriter &writer, const std::string &sourceHash)
+{
+    writer.bytes(kMagic);
+    writer.varint(kSimConfigSnapshotFormat);
+    writer.text(AIRTRACE_TOOLS_CONTRACT_VERSION);
+    writer.text(AIRTRACE_SIM_CONFIG_SCHEMA_ID);
+    writer.varint(sizeof(SimConfig));
+    writer.text(sourceHash);
+}
+} // namespace
+
+std::string encodeSimConfigSnapshot(const SimConfig &config, const std::string &sourceHash)
+{
+    std::string out;
+    BinaryWriter writer(out);
+    writeHeader(writer, sourceHash);
+    SimConfig copy = config;
+    SnapshotEncoder encoder(out);
+    transfer(encoder, copy);
+
+    Sha256 hasher;
+    hasher.update(out.data(), out.size());
+    const Sha256::Digest digest = hasher.finish();
+    out.append(reinterpret_cast<const char *>(digest.data()), digest.size());
+    return out;
+}
+
+bool decodeSimConfigSnapshot(std::string_view bytes, const std::string &sourceHash, SimConfig &config)
+{
+    if (bytes.size() < kTrailerBytes)
+    {
+        return false;
+    }
+    const std::string_view body = bytes.substr(0, bytes.size() - kTrailerBytes);
+    Sha256 hasher;
+    hasher.update(body.data(), body.size());
+    const Sha256::Digest digest = hasher.finish();
+    if (std::memcmp(digest.data(), bytes.data() + body.size(), digest.size()) != 0)
+    {
+        return false;
+    }
+
+    std::string expectedHeader;
+    BinaryWriter header(expectedHeader);
+    writeHeader(header, sourceHash);
+    if (body.compare(0, expectedHeader.size(), expectedHeader) != 0)
+    {
+        return false;
+    }
+    SimConfig decoded;
+    SnapshotDecoder decoder(body.substr(expectedHeader.size()));
+    transfer(decoder, decoded);
+    if (!decoder.finished())
+    {
+        return false;
+    }
+    config = std::move(decoded);
+    return true;
+}
+} // namespace tools
@@ -257,15 +257,18 @@ bool frontViewBuildCycleOrder(const SimConfig::FrontViewConfig &config, std::vec
     return true;
 }
 
-bool frontViewGenerateFrame(const SimConfig::FrontViewConfig &config,
-                            const std::string &mode,
-                            unsigned int sequence,
-                            std::mt19937 &rng,
-                            FrontViewFrameResult &result,
-                            std::string &reason,
-                            const std::string &streamId,
-                            unsigned int streamIndex,
-                            unsigned int streamCount)
+namespace
+{
+template <typename Engine>
+bool generateFrameWith(const SimConfig::FrontViewConfig &config,
+                       const std::string &mode,
+                       unsigned int sequence,
+                       Engine &rng,
+                       FrontViewFrameResult &result,
+                       std::string &reason,
+                       const std::string &streamId,
+                       unsigned int streamIndex,
+                       unsigned int streamCount)
 {
     result = FrontViewFrameResult{};
 
@@ -455,6 +458,34 @@ bool frontViewGenerateFrame(const SimConfig::FrontViewConfig &config,
     return true;
 }
 
+} // namespace
+
+bool frontViewGenerateFrame(const SimConfig::FrontViewConfig &config,
+                            const std::string &mode,
+                            unsigned int sequence,
+                            std::mt19937 &rng,
+                            FrontViewFrameResult &result,
+                            std::string &reason,
+                            const std::string &streamId,
+                            unsigned int streamIndex,
+                            unsigned int streamCount)
+{
+    return generateFrameWith(config, mode, sequence, rng, result, reason, streamId, streamIndex, streamCount);
+}
+
+bool frontViewGenerateFrame(const SimConfig::FrontViewConfig &config,
+                            const std::string &mode,
+                            unsigned int sequence,
+                            CounterRng &rng,
+                            FrontViewFrameResult &result,
+                            std::string &reason,
+                            const std::string &streamId,
+                            unsigned int streamIndex,
+                            unsigned int streamCount)
+{
+    return generateFrameWith(config, mode, sequence, rng, result, reason, streamId, streamIndex, streamCount);
+}
+
 bool frontViewCycleFrames(const SimConfig::FrontViewConfig &config,
                           bool cycleAllModes,
                           std::mt19937 &rng,
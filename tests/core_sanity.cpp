@@ -4,20 +4,35 @@
 #include "core/Tracker.h"
 #include "core/HeatSignature.h"
 #include "tools/sim_config_loader.h"
+#include "tools/sim_config_snapshot.h"
 #include "tools/adapter_registry_loader.h"
+#include "tools/dataset_integrity.h"
+#include "tools/io_envelope_stream.h"
 #include "tools/io_packager.h"
+#include "tools/mapped_file.h"
 #include "core/mode_scheduler.h"
+#include "core/motion_models.h"
+#include "core/random_streams.h"
+#include "core/sensor_sampling.h"
 #include "core/state.h"
+#include "core/track_filter.h"
+#include "core/imm_filter.h"
 #include "core/hash.h"
 
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <ctime>
 #include <filesystem>
 #include <fstream>
 #include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace
@@ -72,6 +87,16 @@ public:
         status.lastMeasurement = measurement;
     }
 
+    void setRangeMeasurement(double range)
+    {
+        Measurement measurement;
+        measurement.range = range;
+        measurement.valid = true;
+        measurement.provenance = provenance;
+        status.hasMeasurement = true;
+        status.lastMeasurement = measurement;
+    }
+
 protected:
     Measurement generateMeasurement(const State9 &, std::mt19937 &) override
     {
@@ -138,6 +163,635 @@ int main()
     assert(std::fabs(xy.x - 22.0) < eps);
     assert(std::fabs(xy.y - -10.0) < eps);
 
+    State9Batch batch;
+    batch.push_back(state);
+    State9 secondState = state;
+    secondState.position = {5.0, 6.0, -7.0};
+    secondState.velocity = {-3.0, 4.0, 0.5};
+    batch.push_back(secondState);
+    assert(batch.size() == 2);
+    integrateStates(batch, dt);
+    const State9 batchFirst = batch.get(0);
+    const State9 singleSecond = integrateState(secondState, dt);
+    assert(batchFirst.position.x == next.position.x);
+    assert(batchFirst.velocity.x == next.velocity.x);
+    assert(batchFirst.time == next.time);
+    assert(batch.get(1).position.y == singleSecond.position.y);
+    assert(batch.get(1).velocity.z == singleSecond.velocity.z);
+
+    MotionBounds batchBounds{{-50.0, -50.0, -50.0}, {50.0, 50.0, 50.0}, 6.0, 2.0, 15.0};
+    ManeuverParams batchManeuvers{1.5, 0.5};
+    const MotionModelType batchModels[] = {
+        MotionModelType::ConstantVelocity,
+        MotionModelType::ConstantAcceleration,
+        MotionModelType::CoordinatedTurn};
+    for (MotionModelType model : batchModels)
+    {
+        std::vector<State9> tracks;
+        for (int idx = 0; idx < 5; ++idx)
+        {
+            State9 track = state;
+            track.position = {10.0 * idx, -4.0 * idx, 45.0};
+            track.velocity = {3.0 - idx, 2.0 * idx, 1.0};
+            track.acceleration = {0.5 * idx, -0.25, 3.0};
+            tracks.push_back(track);
+        }
+        State9Batch trackBatch;
+        for (const auto &track : tracks)
+        {
+            trackBatch.push_back(track);
+        }
+        std::mt19937 singleRng(7);
+        std::mt19937 batchRng(7);
+        stepMotionModels(trackBatch, model, 0.5, batchBounds, batchManeuvers, batchRng);
+        for (std::size_t idx = 0; idx < tracks.size(); ++idx)
+        {
+            const State9 expected = stepMotionModel(tracks[idx], model, 0.5, batchBounds, batchManeuvers, singleRng);
+            const State9 actual = trackBatch.get(idx);
+            assert(actual.position.x == expected.position.x);
+            assert(actual.position.y == expected.position.y);
+            assert(actual.position.z == expected.position.z);
+            assert(actual.velocity.x == expected.velocity.x);
+            assert(actual.velocity.y == expected.velocity.y);
+            assert(actual.velocity.z == expected.velocity.z);
+            assert(actual.acceleration.x == expected.acceleration.x);
+            assert(actual.acceleration.z == expected.acceleration.z);
+            assert(actual.time == expected.time);
+        }
+    }
+
+    State9Batch maneuverBatchA;
+    State9Batch maneuverBatchB;
+    for (int idx = 0; idx < 8; ++idx)
+    {
+        maneuverBatchA.push_back(state);
+        maneuverBatchB.push_back(state);
+    }
+    std::mt19937 maneuverRngA(99);
+    std::mt19937 maneuverRngB(99);
+    stepMotionModels(maneuverBatchA, MotionModelType::RandomManeuver, 0.5, batchBounds, batchManeuvers, maneuverRngA);
+    stepMotionModels(maneuverBatchB, MotionModelType::RandomManeuver, 0.5, batchBounds, batchManeuvers, maneuverRngB);
+    assert(maneuverBatchA.accelerationX == maneuverBatchB.accelerationX);
+    assert(maneuverBatchA.positionZ == maneuverBatchB.positionZ);
+    for (std::size_t idx = 0; idx < maneuverBatchA.size(); ++idx)
+    {
+        const State9 bounded = maneuverBatchA.get(idx);
+        const double speed = std::sqrt(bounded.velocity.x * bounded.velocity.x +
+                                       bounded.velocity.y * bounded.velocity.y +
+                                       bounded.velocity.z * bounded.velocity.z);
+        assert(speed <= batchBounds.maxSpeed + eps);
+    }
+
+    const SimdLevel simdLevels[] = {SimdLevel::Scalar, SimdLevel::Sse4, SimdLevel::Avx2, SimdLevel::Avx512};
+    const MotionModelType simdModels[] = {
+        MotionModelType::ConstantVelocity,
+        MotionModelType::ConstantAcceleration,
+        MotionModelType::CoordinatedTurn,
+        MotionModelType::RandomManeuver};
+    assert(simdLevelSupported(SimdLevel::Scalar));
+    for (MotionModelType model : simdModels)
+    {
+        State9Batch reference;
+        for (int idx = 0; idx < 19; ++idx)
+        {
+            State9 track = state;
+            track.position = {7.0 * idx - 60.0, 3.0 * idx, 48.0 - idx};
+            track.velocity = {4.0 - 0.5 * idx, 0.75 * idx, (idx % 3) - 1.0};
+            track.acceleration = {0.3 * idx, -1.0, 0.5};
+            reference.push_back(track);
+        }
+        std::mt19937 referenceRng(5);
+        stepMotionModels(reference, model, 0.25, batchBounds, batchManeuvers, referenceRng, SimdLevel::Scalar);
+        for (SimdLevel level : simdLevels)
+        {
+            if (!simdLevelSupported(level))
+            {
+                continue;
+            }
+            State9Batch candidate;
+            for (int idx = 0; idx < 19; ++idx)
+            {
+                State9 track = state;
+                track.position = {7.0 * idx - 60.0, 3.0 * idx, 48.0 - idx};
+                track.velocity = {4.0 - 0.5 * idx, 0.75 * idx, (idx % 3) - 1.0};
+                track.acceleration = {0.3 * idx, -1.0, 0.5};
+                candidate.push_back(track);
+            }
+            std::mt19937 candidateRng(5);
+            stepMotionModels(candidate, model, 0.25, batchBounds, batchManeuvers, candidateRng, level);
+            assert(candidate.positionX == reference.positionX);
+            assert(candidate.positionY == reference.positionY);
+            assert(candidate.positionZ == reference.positionZ);
+            assert(candidate.velocityX == reference.velocityX);
+            assert(candidate.velocityY == reference.velocityY);
+            assert(candidate.velocityZ == reference.velocityZ);
+            assert(candidate.accelerationX == reference.accelerationX);
+            assert(candidate.time == reference.time);
+        }
+    }
+
+    {
+        TrackFilterConfig filterConfig;
+        State9 truth{};
+        truth.position = {1200.0, -800.0, 450.0};
+        truth.velocity = {35.0, 20.0, -1.5};
+        truth.acceleration = {0.5, -0.25, 0.0};
+
+        TrackEstimate predicted = makeTrackEstimate(truth, 25.0, 4.0, 1.0);
+        predictTrack(predicted, 0.5, filterConfig);
+        const State9 integrated = integrateState(truth, 0.5);
+        const State9 predictedState = trackState(predicted);
+        assert(std::fabs(predictedState.position.x - integrated.position.x) < 1e-9);
+        assert(std::fabs(predictedState.position.z - integrated.position.z) < 1e-9);
+        assert(std::fabs(predictedState.velocity.y - integrated.velocity.y) < 1e-12);
+        assert(predictedState.time == 0.5);
+        // P = F P F^T + Q: position variance grows by dt^2 * velocity variance plus the rest.
+        assert(predicted.covariance(0, 0) > 25.0 + 0.25 * 4.0);
+        assert(predicted.covariance(0, 3) == predicted.covariance(3, 0));
+        assert(predicted.covariance(0, 1) == 0.0);
+
+        // Batched predict/update are bit-identical to the per-track path.
+        TrackFilterBatch filterBatch;
+        std::vector<TrackEstimate> singles;
+        std::vector<Measurement> filterMeasurements;
+        for (std::uint32_t idx = 0; idx < 6; ++idx)
+        {
+            State9 start = truth;
+            start.position.x += 100.0 * idx;
+            singles.push_back(makeTrackEstimate(start, 25.0 + idx, 4.0, 1.0));
+            filterBatch.push_back(singles.back());
+            Measurement measurement;
+            measurement.valid = idx != 3;
+            measurement.position = Vec3{start.position.x + 2.0, start.position.y - 1.0, start.position.z};
+            if (idx % 2 == 0)
+            {
+                measurement.range = std::sqrt(start.position.x * start.position.x +
+                                              start.position.y * start.position.y +
+                                              start.position.z * start.position.z);
+                measurement.altitude = start.position.z + 1.0;
+                measurement.heading = std::atan2(start.velocity.y, start.velocity.x) + 0.01;
+            }
+            filterMeasurements.push_back(measurement);
+        }
+        assert(filterBatch.size() == 6);
+        predictTracks(filterBatch, 0.1, filterConfig);
+        const std::size_t batchUpdates = updateTracks(filterBatch, filterMeasurements, filterConfig);
+        std::size_t singleUpdates = 0;
+        for (std::size_t idx = 0; idx < singles.size(); ++idx)
+        {
+            predictTrack(singles[idx], 0.1, filterConfig);
+            singleUpdates += updateTrack(singles[idx], filterMeasurements[idx], filterConfig);
+            const TrackEstimate fromBatch = filterBatch.get(idx);
+            for (std::size_t entry = 0; entry < kTrackStateDim; ++entry)
+            {
+                assert(fromBatch.state.values[entry] == singles[idx].state.values[entry]);
+            }
+            for (std::size_t entry = 0; entry < kTrackStateDim * kTrackStateDim; ++entry)
+            {
+                assert(fromBatch.covariance.values[entry] == singles[idx].covariance.values[entry]);
+            }
+        }
+        assert(batchUpdates == singleUpdates);
+        assert(batchUpdates == 3 * 4 + 2 * 1);
+
+        // Each model shrinks the variance it observes; Joseph form keeps P symmetric.
+        TrackEstimate modelTrack = makeTrackEstimate(truth, 100.0, 25.0, 4.0);
+        assert(updateTrack<BaroAltitudeModel>(modelTrack, truth.position.z + 3.0, filterConfig.altitudeStd));
+        assert(modelTrack.covariance(2, 2) < 100.0);
+        assert(modelTrack.covariance(0, 0) == 100.0);
+        assert(updateTrack<RadarRangeModel>(modelTrack, 1500.0, filterConfig.rangeStd));
+        assert(modelTrack.covariance(0, 0) < 100.0);
+        const double velocityVariance = modelTrack.covariance(4, 4);
+        assert(updateTrack<MagHeadingModel>(modelTrack, 0.5, filterConfig.headingStd));
+        assert(modelTrack.covariance(4, 4) < velocityVariance);
+        for (std::size_t row = 0; row < kTrackStateDim; ++row)
+        {
+            assert(modelTrack.covariance(row, row) > 0.0);
+            for (std::size_t col = 0; col < kTrackStateDim; ++col)
+            {
+                assert(std::fabs(modelTrack.covariance(row, col) - modelTrack.covariance(col, row)) < 1e-9);
+            }
+        }
+        TrackEstimate stationary = makeTrackEstimate(State9{}, 1.0, 1.0, 1.0);
+        assert(!updateTrack<RadarRangeModel>(stationary, 10.0, filterConfig.rangeStd));
+        assert(!updateTrack<MagHeadingModel>(stationary, 0.0, filterConfig.headingStd));
+
+        // Heading innovations wrap across +/-pi.
+        State9 westbound{};
+        westbound.velocity = {-10.0, 0.01, 0.0};
+        TrackEstimate headingTrack = makeTrackEstimate(westbound, 1.0, 1.0, 1.0);
+        assert(updateTrack<MagHeadingModel>(headingTrack, -3.14, filterConfig.headingStd));
+        assert(std::fabs(headingTrack.state(4, 0)) < 0.1);
+
+        // Noisy position fixes on a constant-acceleration target converge below the fix noise.
+        TrackEstimate tracked = makeTrackEstimate(truth, 400.0, 100.0, 10.0);
+        tracked.state(0, 0) += 30.0;
+        tracked.state(4, 0) -= 8.0;
+        State9 moving = truth;
+        for (std::uint32_t step = 0; step < 200; ++step)
+        {
+            moving = integrateState(moving, 0.1);
+            predictTrack(tracked, 0.1, filterConfig);
+            CounterRng fixNoise({99ULL, 0U, randomStreamId("gps"), step});
+            const Vec3 fix{moving.position.x + fixNoise.gaussian(filterConfig.positionStd),
+                           moving.position.y + fixNoise.gaussian(filterConfig.positionStd),
+                           moving.position.z + fixNoise.gaussian(filterConfig.positionStd)};
+            assert(updateTrack<GpsPositionModel>(tracked, fix, filterConfig.positionStd));
+        }
+        const State9 trackedState = trackState(tracked);
+        const double positionError = std::sqrt(
+            (trackedState.position.x - moving.position.x) * (trackedState.position.x - moving.position.x) +
+            (trackedState.position.y - moving.position.y) * (trackedState.position.y - moving.position.y) +
+            (trackedState.position.z - moving.position.z) * (trackedState.position.z - moving.position.z));
+        assert(positionError < filterConfig.positionStd);
+        assert(std::fabs(trackedState.velocity.y - moving.velocity.y) < 2.0);
+        assert(tracked.covariance(0, 0) < filterConfig.positionStd * filterConfig.positionStd);
+    }
+
+    {
+        // IMM: a straight track and a turning track, plus a duplicate to check lanes are independent.
+        ImmConfig immConfig;
+        immConfig.turnRateDeg = 6.0;
+        ImmFilterBank imm(immConfig);
+        State9 straight{};
+        straight.position = {0.0, 0.0, 1000.0};
+        straight.velocity = {120.0, 0.0, 0.0};
+        State9 turning = straight;
+        turning.position = {5000.0, 0.0, 1000.0};
+        imm.reserve(3);
+        imm.addTrack(makeTrackEstimate(straight, 25.0, 4.0, 1.0));
+        imm.addTrack(makeTrackEstimate(turning, 25.0, 4.0, 1.0));
+        imm.addTrack(makeTrackEstimate(turning, 25.0, 4.0, 1.0));
+        assert(imm.size() == 3);
+        assert(imm.modelProbability(0, MotionModelType::CoordinatedTurn) == 0.25);
+
+        const MotionBounds turnBounds{{-1e6, -1e6, -1e6}, {1e6, 1e6, 1e6}, 500.0, 50.0, immConfig.turnRateDeg};
+        const ManeuverParams noManeuver{0.0, 0.0};
+        std::mt19937 unusedRng(1U);
+        std::vector<Measurement> immMeasurements(3);
+        for (std::uint32_t step = 0; step < 150; ++step)
+        {
+            straight = stepMotionModel(straight, MotionModelType::ConstantVelocity, 0.1, turnBounds, noManeuver, unusedRng);
+            turning = stepMotionModel(turning, MotionModelType::CoordinatedTurn, 0.1, turnBounds, noManeuver, unusedRng);
+            imm.predict(0.1);
+            const State9 *truths[3] = {&straight, &turning, &turning};
+            for (std::uint32_t idx = 0; idx < 3; ++idx)
+            {
+                CounterRng fixNoise({5ULL, idx == 2 ? 1U : idx, randomStreamId("gps"), step});
+                Measurement &fix = immMeasurements[idx];
+                fix.valid = true;
+                fix.position = Vec3{truths[idx]->position.x + fixNoise.gaussian(2.0),
+                                    truths[idx]->position.y + fixNoise.gaussian(2.0),
+                                    truths[idx]->position.z + fixNoise.gaussian(2.0)};
+            }
+            const std::size_t updated = imm.update(immMeasurements);
+            assert(updated == 3);
+            double total = 0.0;
+            for (std::size_t model = 0; model < kImmModelCount; ++model)
+            {
+                total += imm.modelProbability(0, static_cast<MotionModelType>(model));
+            }
+            assert(std::fabs(total - 1.0) < 1e-9);
+        }
+        assert(imm.mostLikelyModel(1) == MotionModelType::CoordinatedTurn);
+        assert(imm.modelProbability(1, MotionModelType::CoordinatedTurn) > 0.5);
+        assert(imm.mostLikelyModel(0) == MotionModelType::ConstantVelocity);
+        assert(imm.modelProbability(0, MotionModelType::CoordinatedTurn) < 0.25);
+        assert(imm.modelProbability(1, MotionModelType::ConstantVelocity) ==
+               imm.modelProbability(2, MotionModelType::ConstantVelocity));
+
+        TrackFilterBatch combined;
+        imm.combine(combined);
+        assert(combined.size() == 3);
+        const TrackEstimate turningEstimate = imm.combinedEstimate(1);
+        for (std::size_t row = 0; row < kTrackStateDim; ++row)
+        {
+            assert(std::fabs(combined.state[row][1] - turningEstimate.state(row, 0)) < 1e-9);
+        }
+        assert(std::fabs(combined.covariance[0][1] - turningEstimate.covariance(0, 0)) < 1e-9);
+        const State9 turningState = trackState(turningEstimate);
+        assert(std::fabs(turningState.position.x - turning.position.x) < 5.0);
+        assert(std::fabs(turningState.position.y - turning.position.y) < 5.0);
+
+        // Without a measurement the probabilities are the Markov prediction alone.
+        imm.predict(0.1);
+        const double predictedTurn = imm.modelProbability(1, MotionModelType::CoordinatedTurn);
+        immMeasurements[1].valid = false;
+        const std::size_t updatedWithoutFix = imm.update(immMeasurements);
+        assert(updatedWithoutFix == 2);
+        assert(imm.modelProbability(1, MotionModelType::CoordinatedTurn) == predictedTurn);
+    }
+
+    {
+        // IMM config validation: unreachable models and a zero floor fall back to the defaults.
+        assert(validateImmConfig(ImmConfig{}));
+        ImmConfig unreachable;
+        for (std::size_t from = 0; from < kImmModelCount; ++from)
+        {
+            unreachable.transition[from][from] += unreachable.transition[from][3];
+            unreachable.transition[from][3] = 0.0;
+        }
+        assert(!validateImmConfig(unreachable));
+        ImmFilterBank fallback(unreachable);
+        assert(!fallback.configValid());
+        assert(fallback.getConfig().transition[0][3] == ImmConfig{}.transition[0][3]);
+        ImmConfig zeroFloor;
+        zeroFloor.minProbability = 0.0;
+        assert(!validateImmConfig(zeroFloor));
+        ImmConfig unbalanced;
+        unbalanced.transition[1][1] = 0.5;
+        assert(!validateImmConfig(unbalanced));
+
+        // No switching, with every track starting in one model: the other models' predicted
+        // probabilities are 0 and their mixing must not divide by it.
+        ImmConfig noSwitch;
+        for (std::size_t from = 0; from < kImmModelCount; ++from)
+        {
+            for (std::size_t to = 0; to < kImmModelCount; ++to)
+            {
+                noSwitch.transition[from][to] = from == to ? 1.0 : 0.0;
+            }
+            noSwitch.initialProbability[from] = from == 0 ? 1.0 : 0.0;
+        }
+        assert(validateImmConfig(noSwitch));
+        ImmFilterBank pinned(noSwitch);
+        assert(pinned.configValid());
+        State9 cruise{};
+        cruise.velocity = {50.0, 0.0, 0.0};
+        pinned.addTrack(makeTrackEstimate(cruise, 25.0, 4.0, 1.0));
+        std::vector<Measurement> fixes(1);
+        fixes[0].valid = true;
+        for (int step = 1; step <= 5; ++step)
+        {
+            pinned.predict(0.1);
+            fixes[0].position = Vec3{5.0 * step, 0.0, 0.0};
+            const std::size_t updated = pinned.update(fixes);
+            assert(updated == 1);
+        }
+        double total = 0.0;
+        for (std::size_t model = 0; model < kImmModelCount; ++model)
+        {
+            const double probability = pinned.modelProbability(0, static_cast<MotionModelType>(model));
+            assert(std::isfinite(probability));
+            total += probability;
+        }
+        assert(std::fabs(total - 1.0) < 1e-9);
+        const TrackEstimate pinnedEstimate = pinned.combinedEstimate(0);
+        for (std::size_t row = 0; row < kTrackStateDim; ++row)
+        {
+            assert(std::isfinite(pinnedEstimate.state(row, 0)));
+        }
+    }
+
+    const std::array<std::uint32_t, 4> philoxZero = philox4x32({0U, 0U, 0U, 0U}, {0U, 0U});
+    assert(philoxZero[0] == 0x6627e8d5U);
+    assert(philoxZero[1] == 0xe169c58dU);
+    assert(philoxZero[2] == 0xbc57ac4cU);
+    assert(philoxZero[3] == 0x9b00dbd8U);
+
+    const RandomStreamKey streamKey{20240601ULL, 3U, randomStreamId("gps"), 12U};
+    CounterRng streamA(streamKey);
+    CounterRng streamB(streamKey);
+    for (int draw = 0; draw < 16; ++draw)
+    {
+        const double a = streamA.gaussian(2.0);
+        assert(a == streamB.gaussian(2.0));
+        const double u = streamA.uniform();
+        assert(u == streamB.uniform());
+        assert(u >= 0.0 && u < 1.0);
+    }
+    RandomStreamKey nextStepKey = streamKey;
+    nextStepKey.step += 1;
+    assert(CounterRng(streamKey)() != CounterRng(nextStepKey)());
+    assert(randomStreamId("gps") != randomStreamId("thermal"));
+
+    std::vector<double> entityNoise(8, 0.0);
+    std::vector<std::uint8_t> entityEvents(8, 0U);
+    gaussianAcrossEntities(streamKey, 4U, 1.5, entityNoise.data(), entityNoise.size());
+    bernoulliAcrossEntities(streamKey, 5U, 0.5, entityEvents.data(), entityEvents.size());
+    for (std::size_t idx = 0; idx < entityNoise.size(); ++idx)
+    {
+        RandomStreamKey entityKey = streamKey;
+        entityKey.entityId += static_cast<std::uint32_t>(idx);
+        double first = 0.0;
+        double second = 0.0;
+        counterGaussianPair(entityKey, 4U, first, second);
+        assert(entityNoise[idx] == first * 1.5);
+        assert((entityEvents[idx] == 1U) == (counterUniform(entityKey, 5U) < 0.5));
+    }
+
+    {
+        // Counter-keyed maneuvers do not depend on how the batch is partitioned.
+        const ManeuverParams alwaysManeuver{1.5, 1.0};
+        const RandomStreamKey motionKey{77ULL, 100U, randomStreamId("motion"), 0U};
+        State9Batch whole;
+        State9Batch head;
+        State9Batch tail;
+        for (int idx = 0; idx < 10; ++idx)
+        {
+            State9 track{};
+            track.position = {static_cast<double>(idx), 0.0, 1.0};
+            track.velocity = {1.0, 0.5, 0.0};
+            whole.push_back(track);
+            (idx < 4 ? head : tail).push_back(track);
+        }
+        RandomStreamKey tailKey = motionKey;
+        tailKey.entityId += 4U;
+        stepMotionModels(whole, MotionModelType::RandomManeuver, 0.5, batchBounds, alwaysManeuver, motionKey);
+        stepMotionModels(tail, MotionModelType::RandomManeuver, 0.5, batchBounds, alwaysManeuver, tailKey);
+        stepMotionModels(head, MotionModelType::RandomManeuver, 0.5, batchBounds, alwaysManeuver, motionKey);
+        for (std::size_t idx = 0; idx < whole.size(); ++idx)
+        {
+            const State9 expected = idx < 4 ? head.get(idx) : tail.get(idx - 4);
+            const State9 actual = whole.get(idx);
+            assert(actual.position.x == expected.position.x);
+            assert(actual.velocity.y == expected.velocity.y);
+            assert(actual.acceleration.z == expected.acceleration.z);
+        }
+        assert(whole.accelerationX[0] != whole.accelerationX[1]);
+
+        CounterNoiseSource singleNoiseA(motionKey);
+        CounterNoiseSource singleNoiseB(motionKey);
+        const State9 singleA = stepMotionModel(whole.get(0), MotionModelType::RandomManeuver, 0.5,
+                                               batchBounds, alwaysManeuver, singleNoiseA);
+        const State9 singleB = stepMotionModel(whole.get(0), MotionModelType::RandomManeuver, 0.5,
+                                               batchBounds, alwaysManeuver, singleNoiseB);
+        assert(singleA.acceleration.x == singleB.acceleration.x);
+        assert(singleA.position.z == singleB.position.z);
+    }
+
+    {
+        // Legacy std::mt19937 sampling is unchanged; counter streams are per-sensor and order-free.
+        State9 sensorState{};
+        sensorState.position = {120.0, -40.0, 300.0};
+        sensorState.velocity = {5.0, 1.0, 0.0};
+        const SensorConfig noisyConfig{1.0, 2.0, 0.1, 0.0, 5000.0};
+        GpsSensor legacyGps(noisyConfig);
+        GpsSensor wrappedGps(noisyConfig);
+        std::mt19937 legacyRng(11U);
+        std::mt19937 wrappedRng(11U);
+        Mt19937NoiseSource wrappedNoise(wrappedRng);
+        for (int step = 0; step < 6; ++step)
+        {
+            Measurement legacy = legacyGps.sample(sensorState, 1.0, legacyRng);
+            Measurement wrapped = wrappedGps.sample(sensorState, 1.0, wrappedNoise);
+            assert(legacy.valid == wrapped.valid);
+            if (legacy.valid)
+            {
+                assert(legacy.position->x == wrapped.position->x);
+                assert(legacy.position->z == wrapped.position->z);
+            }
+        }
+
+        GpsSensor gpsFirst(noisyConfig);
+        BarometerSensor baroFirst(noisyConfig);
+        GpsSensor gpsSecond(noisyConfig);
+        BarometerSensor baroSecond(noisyConfig);
+        for (std::uint32_t step = 0; step < 6; ++step)
+        {
+            CounterNoiseSource gpsNoiseA({9ULL, 1U, gpsFirst.getStreamId(), step});
+            CounterNoiseSource baroNoiseA({9ULL, 1U, baroFirst.getStreamId(), step});
+            Measurement gpsA = gpsFirst.sample(sensorState, 1.0, gpsNoiseA);
+            Measurement baroA = baroFirst.sample(sensorState, 1.0, baroNoiseA);
+
+            CounterNoiseSource baroNoiseB({9ULL, 1U, baroSecond.getStreamId(), step});
+            CounterNoiseSource gpsNoiseB({9ULL, 1U, gpsSecond.getStreamId(), step});
+            Measurement baroB = baroSecond.sample(sensorState, 1.0, baroNoiseB);
+            Measurement gpsB = gpsSecond.sample(sensorState, 1.0, gpsNoiseB);
+            assert(gpsA.valid == gpsB.valid);
+            assert(baroA.valid == baroB.valid);
+            if (gpsA.valid)
+            {
+                assert(gpsA.position->y == gpsB.position->y);
+            }
+            if (baroA.valid)
+            {
+                assert(*baroA.altitude == *baroB.altitude);
+            }
+        }
+
+        TestSensor legacyOnly("legacy_only");
+        CounterNoiseSource counterOnly({1ULL, 0U, legacyOnly.getStreamId(), 0U});
+        Measurement unsupported = legacyOnly.sample(sensorState, 1.0, counterOnly);
+        assert(!unsupported.valid);
+    }
+
+    {
+        // Sampling-stage output matches sequential counter-stream sampling for any worker count.
+        const SensorConfig stageConfig{2.0, 1.5, 0.05, 0.02, 5000.0};
+        std::vector<State9> targets(3);
+        for (std::size_t idx = 0; idx < targets.size(); ++idx)
+        {
+            targets[idx].position = {100.0 * static_cast<double>(idx + 1), 50.0, 200.0};
+            targets[idx].velocity = {3.0, -1.0, 0.5};
+        }
+        auto buildSensors = [&]()
+        {
+            std::vector<std::unique_ptr<SensorBase>> built;
+            for (std::size_t idx = 0; idx < targets.size(); ++idx)
+            {
+                built.push_back(std::make_unique<GpsSensor>(stageConfig));
+                built.push_back(std::make_unique<RadarSensor>(stageConfig));
+                built.push_back(std::make_unique<BarometerSensor>(stageConfig));
+                built.push_back(std::make_unique<MagnetometerSensor>(stageConfig));
+            }
+            return built;
+        };
+
+        std::vector<std::unique_ptr<SensorBase>> sequentialSensors = buildSensors();
+        std::vector<std::vector<Measurement>> expected;
+        for (std::uint32_t step = 0; step < 5; ++step)
+        {
+            std::vector<Measurement> stepResults;
+            for (std::size_t idx = 0; idx < sequentialSensors.size(); ++idx)
+            {
+                const std::uint32_t entity = static_cast<std::uint32_t>(idx / 4);
+                CounterNoiseSource noise({55ULL, entity, sequentialSensors[idx]->getStreamId(), step});
+                stepResults.push_back(sequentialSensors[idx]->sample(targets[entity], 0.5, noise));
+            }
+            expected.push_back(stepResults);
+        }
+
+        for (std::size_t workers : {std::size_t{1}, std::size_t{4}})
+        {
+            std::vector<std::unique_ptr<SensorBase>> stageSensors = buildSensors();
+            SensorSamplingStage stage(workers);
+            assert(stage.workerCount() == workers);
+            double fakeNow = 0.0;
+            std::mutex clockMutex;
+            stage.setClock([&]()
+            {
+                std::lock_guard<std::mutex> lock(clockMutex);
+                fakeNow += 0.001;
+                return fakeNow;
+            });
+            for (std::size_t idx = 0; idx < stageSensors.size(); ++idx)
+            {
+                const std::uint32_t entity = static_cast<std::uint32_t>(idx / 4);
+                const std::size_t task = stage.addTask(*stageSensors[idx], targets[entity], entity);
+                assert(task == idx);
+            }
+            for (std::uint32_t step = 0; step < 5; ++step)
+            {
+                stage.run(0.5, 55ULL, step);
+                for (std::size_t idx = 0; idx < stageSensors.size(); ++idx)
+                {
+                    const Measurement &actual = stage.measurement(idx);
+                    const Measurement &reference = expected[step][idx];
+                    assert(actual.valid == reference.valid);
+                    assert(actual.note == reference.note);
+                    assert(actual.position.has_value() == reference.position.has_value());
+                    if (actual.position)
+                    {
+                        assert(actual.position->x == reference.position->x);
+                    }
+                    if (actual.range)
+                    {
+                        assert(*actual.range == *reference.range);
+                    }
+                    if (actual.altitude)
+                    {
+                        assert(*actual.altitude == *reference.altitude);
+                    }
+                    if (actual.heading)
+                    {
+                        assert(*actual.heading == *reference.heading);
+                    }
+                }
+            }
+            // A sensor with only the std::mt19937 generator is refused rather than sampled blank.
+            TestSensor legacyOnly("legacy_only");
+            assert(!legacyOnly.supportsNoiseSource());
+            assert(stageSensors.front()->supportsNoiseSource());
+            const std::size_t refused = stage.addTask(legacyOnly, targets.front(), 0);
+            assert(refused == SensorSamplingStage::npos);
+            assert(stage.tasks().size() == stageSensors.size());
+            const std::vector<SensorSamplingTiming> timings = stage.timings();
+            assert(timings.size() == 4);
+            assert(timings.front().sensorName == "gps");
+            for (const auto &timing : timings)
+            {
+                assert(timing.samples == targets.size() * 5);
+                assert(timing.seconds > 0.0);
+            }
+        }
+
+        WorkStealingPool pool(3);
+        std::vector<int> visits(257, 0);
+        for (int round = 0; round < 20; ++round)
+        {
+            pool.parallelFor(visits.size(), [&](std::size_t index, std::size_t worker)
+            {
+                assert(worker < 3);
+                visits[index] += 1;
+            });
+        }
+        for (int count : visits)
+        {
+            assert(count == 20);
+        }
+    }
+
     std::filesystem::path missingVersion = writeConfigFile(
         "airtrace_missing_version.cfg",
         "sim.dt=0.2\n");
@@ -163,6 +817,38 @@ int main()
     assert(!invalidLadderResult.ok);
     std::filesystem::remove(invalidLadder);
 
+    {
+        // Keys are dispatched by exact match, so near misses stay unknown and each key keeps its
+        // own rejection message.
+        std::filesystem::path keyDispatchConfig = writeConfigFile(
+            "airtrace_key_dispatch.cfg",
+            "config.version=1.0\n"
+            "sensor.lidar.max_range=1200\n"
+            "platform.profile_parent=base\n"
+            "sensor.gps.rate_hzz=1\n"
+            "sim.step=5\n"
+            "sim.steps=many\n"
+            "policy.debug_admin.enabled=maybe\n"
+            "scheduler.max_aux_pipelines=-1\n"
+            "ui.surface=hologram\n");
+        ConfigResult keyDispatchResult = loadSimConfig(keyDispatchConfig.string());
+        assert(!keyDispatchResult.ok);
+        assert(keyDispatchResult.config.lidar.maxRange == 1200.0);
+        assert(keyDispatchResult.config.hasParentProfile);
+        std::map<std::string, std::string> keyIssues;
+        for (const auto &issue : keyDispatchResult.issues)
+        {
+            keyIssues.emplace(issue.key, issue.message);
+        }
+        assert(keyIssues["sensor.gps.rate_hzz"] == "unknown or invalid value");
+        assert(keyIssues["sim.step"] == "unknown or invalid value");
+        assert(keyIssues["sim.steps"] == "unknown or invalid value");
+        assert(keyIssues["policy.debug_admin.enabled"] == "invalid boolean");
+        assert(keyIssues["scheduler.max_aux_pipelines"] == "must be >= 0");
+        assert(keyIssues["ui.surface"] == "invalid ui surface");
+        std::filesystem::remove(keyDispatchConfig);
+    }
+
     std::filesystem::path policyConfigPath = writeConfigFile(
         "airtrace_policy.cfg",
         "config.version=1.0\n"
@@ -184,6 +870,85 @@ int main()
     assert(policyResult.ok);
     std::filesystem::remove(policyConfigPath);
 
+    // Compiled config snapshots: reused only for identical text under the current schema and rules,
+    // rewritten when stale or damaged, never kept for rejected configs.
+    {
+        const std::string snapshotText =
+            "config.version=1.0\n"
+            "sim.seed=7\n"
+            "policy.roles=operator,supervisor\n"
+            "policy.role_permissions.operator=network_aid\n"
+            "policy.role_permissions.supervisor=network_aid,dataset_tier\n"
+            "policy.role_preset.operator.ui_surface=tui\n"
+            "policy.role_preset.supervisor.front_view_enabled=true\n"
+            "fusion.source_weights.gps=0.7\n"
+            "fusion.source_weights.imu=0.3\n";
+        std::filesystem::path snapshotConfig = writeConfigFile("airtrace_snapshot.cfg", snapshotText);
+        const std::string snapshotPath = (std::filesystem::current_path() / "airtrace_snapshot.cfg.snapshot").string();
+        std::filesystem::remove(snapshotPath);
+        const ConfigResult parsed = loadSimConfig(snapshotConfig.string());
+        assert(parsed.ok);
+        const std::string sourceHash = sha256Hex(snapshotText.data(), snapshotText.size());
+        const std::string expectedSnapshot = tools::encodeSimConfigSnapshot(parsed.config, sourceHash);
+
+        bool fromSnapshot = true;
+        ConfigResult cached = loadSimConfigCached(snapshotConfig.string(), snapshotPath, &fromSnapshot);
+        assert(cached.ok && !fromSnapshot);
+        assert(std::filesystem::exists(snapshotPath));
+        cached = loadSimConfigCached(snapshotConfig.string(), snapshotPath, &fromSnapshot);
+        assert(cached.ok && fromSnapshot);
+        assert(tools::encodeSimConfigSnapshot(cached.config, sourceHash) == expectedSnapshot);
+        assert(cached.config.seed == 7U);
+        assert(cached.config.policy.rolePermissions.at("supervisor").size() == 2U);
+        assert(cached.config.policy.roleUiPresets.at("supervisor").hasFrontViewEnabled);
+        assert(cached.config.fusion.sourceWeights.at("imu") == 0.3);
+
+        SimConfig decoded;
+        bool snapshotDecoded = tools::decodeSimConfigSnapshot(expectedSnapshot, sha256Hex(std::vector<unsigned char>{}), decoded);
+        assert(!snapshotDecoded);
+        snapshotDecoded = tools::decodeSimConfigSnapshot(
+            std::string_view(expectedSnapshot).substr(0, expectedSnapshot.size() - 1), sourceHash, decoded);
+        assert(!snapshotDecoded);
+        std::string damaged = expectedSnapshot;
+        damaged[damaged.size() / 2] = static_cast<char>(damaged[damaged.size() / 2] ^ 0x01);
+        snapshotDecoded = tools::decodeSimConfigSnapshot(damaged, sourceHash, decoded);
+        assert(!snapshotDecoded);
+        {
+            std::ofstream out(snapshotPath, std::ios::binary | std::ios::trunc);
+            out << damaged;
+        }
+        cached = loadSimConfigCached(snapshotConfig.string(), snapshotPath, &fromSnapshot);
+        assert(cached.ok && !fromSnapshot);
+        cached = loadSimConfigCached(snapshotConfig.string(), snapshotPath, &fromSnapshot);
+        assert(cached.ok && fromSnapshot);
+
+        snapshotConfig = writeConfigFile("airtrace_snapshot.cfg", snapshotText + "sim.seed=8\n");
+        cached = loadSimConfigCached(snapshotConfig.string(), snapshotPath, &fromSnapshot);
+        assert(cached.ok && !fromSnapshot && cached.config.seed == 8U);
+
+        std::filesystem::remove(snapshotPath);
+        snapshotConfig = writeConfigFile("airtrace_snapshot.cfg", "config.version=1.0\nsim.dt=0\n");
+        const ConfigResult rejected = loadSimConfigCached(snapshotConfig.string(), snapshotPath, &fromSnapshot);
+        assert(!rejected.ok && !fromSnapshot);
+        const ConfigResult rejectedDirect = loadSimConfig(snapshotConfig.string());
+        assert(rejected.issues.size() == rejectedDirect.issues.size());
+        assert(!std::filesystem::exists(snapshotPath));
+
+        // A snapshot that decodes but breaks the current rules, as one from a looser build would,
+        // is re-validated, rejected, and removed.
+        {
+            const std::string rejectedText = "config.version=1.0\nsim.dt=0\n";
+            std::ofstream out(snapshotPath, std::ios::binary | std::ios::trunc);
+            out << tools::encodeSimConfigSnapshot(loadSimConfig(snapshotConfig.string()).config,
+                                                  sha256Hex(rejectedText.data(), rejectedText.size()));
+        }
+        const ConfigResult revalidated = loadSimConfigCached(snapshotConfig.string(), snapshotPath, &fromSnapshot);
+        assert(!revalidated.ok && !fromSnapshot);
+        assert(revalidated.issues.size() == rejected.issues.size());
+        assert(!std::filesystem::exists(snapshotPath));
+        std::filesystem::remove(snapshotConfig);
+    }
+
     std::filesystem::path authMissingConfig = writeConfigFile(
         "airtrace_auth_missing.cfg",
         "config.version=1.0\n"
@@ -709,6 +1474,152 @@ int main()
     std::string abcHash = sha256Hex(abc);
     assert(hashEquals("BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD", abcHash));
 
+    // Streaming SHA-256: every backend matches the FIPS 180-2 vectors however the input is split.
+    const std::string twoBlockMessage = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    const std::string millionA(1000000, 'a');
+    std::vector<unsigned char> shaSample(1500);
+    for (std::size_t idx = 0; idx < shaSample.size(); ++idx)
+    {
+        shaSample[idx] = static_cast<unsigned char>((idx * 131U + 7U) & 0xFFU);
+    }
+    const std::string shaSampleHash = sha256Hex(shaSample);
+    for (Sha256Backend backend : {Sha256Backend::Portable, Sha256Backend::X86Sha})
+    {
+        if (!sha256BackendSupported(backend))
+        {
+            continue;
+        }
+        Sha256 hasher(backend);
+        assert(hasher.backend() == backend);
+        std::string digest = hasher.finishHex();
+        assert(digest == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+        hasher.update(twoBlockMessage.data(), twoBlockMessage.size());
+        digest = hasher.finishHex();
+        assert(digest == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+        for (std::size_t offset = 0; offset < millionA.size(); offset += 999)
+        {
+            hasher.update(millionA.data() + offset, std::min<std::size_t>(999, millionA.size() - offset));
+        }
+        assert(hasher.bytesHashed() == millionA.size());
+        digest = hasher.finishHex();
+        assert(digest == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+        for (std::size_t split = 0; split <= 130; ++split)
+        {
+            hasher.update(shaSample.data(), split);
+            hasher.update(shaSample.data() + split, shaSample.size() - split);
+            digest = hasher.finishHex();
+            assert(digest == shaSampleHash);
+        }
+    }
+    assert(std::string(sha256BackendName(detectSha256Backend())) != "unknown");
+
+    // Multi-buffer batches: lanes refill as messages of mixed lengths finish, and every backend
+    // matches one-at-a-time hashing, including the empty message and every padding boundary.
+    {
+        std::vector<std::string> batchStore;
+        for (std::size_t length = 0; length <= 200; ++length)
+        {
+            batchStore.push_back(std::string(reinterpret_cast<const char *>(shaSample.data()) + length, length));
+        }
+        batchStore.push_back(millionA);
+        const std::vector<std::string_view> batchMessages(batchStore.begin(), batchStore.end());
+        for (Sha256BatchBackend backend : {Sha256BatchBackend::Serial, Sha256BatchBackend::X86Shax2, Sha256BatchBackend::X86Avx2x8})
+        {
+            if (!sha256BatchBackendSupported(backend))
+            {
+                continue;
+            }
+            const std::vector<Sha256::Digest> batchDigests = sha256Batch(batchMessages, backend);
+            assert(batchDigests.size() == batchMessages.size());
+            for (std::size_t idx = 0; idx < batchMessages.size(); ++idx)
+            {
+                assert(sha256DigestHex(batchDigests[idx]) == sha256Hex(batchMessages[idx].data(), batchMessages[idx].size()));
+            }
+            assert(sha256Batch({}, backend).empty());
+        }
+        assert(sha256BatchBackendSupported(detectSha256BatchBackend()));
+        assert(std::string(sha256BatchBackendName(detectSha256BatchBackend())) != "unknown");
+    }
+
+    // Dataset integrity: whole-file and chunked digests, size limit before hashing, first failure wins.
+    {
+        std::string catalogBytes(300 * 1024 + 17, '\0');
+        for (std::size_t idx = 0; idx < catalogBytes.size(); ++idx)
+        {
+            catalogBytes[idx] = static_cast<char>((idx * 7U + 3U) & 0xFFU);
+        }
+        const std::string ephemerisBytes = "ephemeris-v1\n";
+        const std::filesystem::path catalogPath = writeConfigFile("airtrace_dataset_catalog.bin", catalogBytes);
+        const std::filesystem::path ephemerisPath = writeConfigFile("airtrace_dataset_ephemeris.bin", ephemerisBytes);
+        const std::filesystem::path emptyPath = writeConfigFile("airtrace_dataset_empty.bin", "");
+        const std::string catalogHash = sha256Hex(catalogBytes.data(), catalogBytes.size());
+        const std::string ephemerisHash = sha256Hex(ephemerisBytes.data(), ephemerisBytes.size());
+
+        const std::string chunked = tools::chunkedDatasetHash(catalogBytes, 64);
+        assert(tools::chunkedDatasetHash(catalogBytes, 64, 4) == chunked);
+        assert(tools::chunkedDatasetHash(catalogBytes, 32) != chunked);
+        Sha256 chunkRoot;
+        for (std::size_t offset = 0; offset < catalogBytes.size(); offset += 64 * 1024)
+        {
+            Sha256 chunkHasher;
+            chunkHasher.update(catalogBytes.data() + offset, std::min<std::size_t>(64 * 1024, catalogBytes.size() - offset));
+            const Sha256::Digest chunkDigest = chunkHasher.finish();
+            chunkRoot.update(chunkDigest.data(), chunkDigest.size());
+        }
+        assert(chunked == "sha256-chunked:64:" + chunkRoot.finishHex());
+
+        for (std::size_t workers : {1U, 3U})
+        {
+            tools::DatasetIntegrityOptions options;
+            options.workers = workers;
+            tools::DatasetIntegrityResult verified = tools::verifyDatasetFiles(
+                {{"catalog", catalogPath.string(), chunked}, {"ephemeris", ephemerisPath.string(), ephemerisHash}}, options);
+            assert(verified.ok);
+            assert(verified.totalBytes == catalogBytes.size() + ephemerisBytes.size());
+            verified = tools::verifyDatasetFiles(
+                {{"catalog", catalogPath.string(), catalogHash}, {"ephemeris", ephemerisPath.string(), catalogHash}}, options);
+            assert(!verified.ok && verified.message == "ephemeris hash mismatch");
+
+            options.maxSizeMB = 0.25;
+            verified = tools::verifyDatasetFiles(
+                {{"catalog", catalogPath.string(), "not-checked"}, {"ephemeris", ephemerisPath.string(), ephemerisHash}}, options);
+            assert(!verified.ok && verified.message == "dataset size exceeds limit");
+        }
+
+        tools::DatasetIntegrityOptions options;
+        tools::DatasetIntegrityResult failed =
+            tools::verifyDatasetFiles({{"catalog", "airtrace_dataset_missing.bin", catalogHash}}, options);
+        assert(failed.message == "catalog unable to open");
+        failed = tools::verifyDatasetFiles({{"ephemeris", emptyPath.string(), ephemerisHash}}, options);
+        assert(failed.message == "ephemeris is empty");
+        failed = tools::verifyDatasetFiles({{"catalog", catalogPath.string(), "sha256-chunked:0:" + catalogHash}}, options);
+        assert(failed.message == "catalog hash format invalid");
+        failed = tools::verifyDatasetFiles({{"catalog", catalogPath.string(), "sha256-chunked:64:abc"}}, options);
+        assert(failed.message == "catalog hash format invalid");
+        std::string tampered = chunked;
+        tampered.back() = tampered.back() == '0' ? '1' : '0';
+        failed = tools::verifyDatasetFiles({{"catalog", catalogPath.string(), tampered}}, options);
+        assert(failed.message == "catalog hash mismatch");
+        failed = tools::verifyDatasetFiles({{"catalog", std::filesystem::current_path().string(), catalogHash}}, options);
+        assert(failed.message == "catalog unable to open");
+
+        tools::MappedFile mappedFile;
+        const tools::MappedFileStatus catalogStatus = mappedFile.open(catalogPath.string());
+        assert(catalogStatus == tools::MappedFileStatus::Ok && mappedFile.bytes() == catalogBytes);
+        const tools::MappedFileStatus emptyStatus = mappedFile.open(emptyPath.string());
+        assert(emptyStatus == tools::MappedFileStatus::Ok && mappedFile.bytes().empty());
+        const tools::MappedFileStatus missingStatus = mappedFile.open("airtrace_dataset_missing.bin");
+        assert(missingStatus == tools::MappedFileStatus::OpenFailed && mappedFile.bytes().empty());
+#if !defined(_WIN32)
+        const tools::MappedFileStatus directoryStatus = mappedFile.open(std::filesystem::current_path().string());
+        assert(directoryStatus == tools::MappedFileStatus::StatFailed);
+#endif
+
+        std::filesystem::remove(catalogPath);
+        std::filesystem::remove(ephemerisPath);
+        std::filesystem::remove(emptyPath);
+    }
+
     std::vector<Object> seededTargetsA = generateTargets(5, 100, 1337);
     std::vector<Object> seededTargetsB = generateTargets(5, 100, 1337);
     assert(seededTargetsA.size() == seededTargetsB.size());
@@ -819,6 +1730,60 @@ int main()
     decision = manager.decide(sensors);
     assert(decision.mode == TrackingMode::Gps);
 
+    {
+        ModeManager compactManager(modeConfig);
+        assert(compactManager.getLastDecisionDetail().selectedMode.empty());
+        gps.setHealthy(true);
+        thermal.setHealthy(true);
+        const CompactModeDecision &compact = compactManager.decideCompact(sensors);
+        assert(compact.mode == TrackingMode::Hold);
+        assert(compact.reason == DecisionReason::NoSensors);
+        assert(compact.changed);
+        compactManager.decideCompact(sensors);
+        assert(compact.mode == TrackingMode::Gps);
+        assert(compact.reason == DecisionReason::Enter);
+        assert(compact.changed);
+        assert(compact.contributorMask != 0);
+        const ModeDecisionDetail &compactDetail = compactManager.getLastDecisionDetail();
+        assert(compactDetail.selectedMode == "gps");
+        assert(compactDetail.reason == "enter_gps");
+        assert(compactDetail.contributors.size() == 1);
+        std::size_t contributorBits = 0;
+        for (std::size_t id = 0; id < 64; ++id)
+        {
+            if ((compact.contributorMask >> id) & 1ULL)
+            {
+                assert(compactManager.sensorName(id) == compactDetail.contributors[contributorBits]);
+                ++contributorBits;
+            }
+        }
+        assert(contributorBits == compactDetail.contributors.size());
+        std::string compactReason;
+        ModeManager::writeDecisionReason(compact, compactReason);
+        assert(compactReason == compactDetail.reason);
+
+        compactManager.decideCompact(sensors);
+        assert(compact.reason == DecisionReason::Maintain);
+        assert(compact.changed);
+        compactManager.decideCompact(sensors);
+        assert(compact.reason == DecisionReason::Maintain);
+        assert(!compact.changed);
+        assert(compactManager.getLastDecisionDetail().reason == "maintain_gps");
+
+        gps.setHealthy(false);
+        thermal.setHealthy(false);
+        compactManager.decideCompact(sensors);
+        assert(compact.mode == TrackingMode::Hold);
+        assert(compact.reason == DecisionReason::NoSensors);
+        assert(compact.changed);
+        assert(compact.contributorMask == 0);
+        assert(std::string(ModeManager::decisionReasonName(compact.reason)) == "no_sensors");
+        assert(compactManager.getLastDecisionDetail().reason == "no_sensors");
+        assert(!compactManager.getLastDecisionDetail().disqualifiedSources.empty());
+        gps.setHealthy(true);
+        thermal.setHealthy(true);
+    }
+
     ModeManagerConfig policyConfig;
     policyConfig.minHealthyCount = 1;
     policyConfig.permittedSensors = {"gps"};
@@ -870,6 +1835,15 @@ int main()
     decision = authDeniedManager.decide(sensors);
     assert(decision.mode == TrackingMode::Hold);
     assert(decision.reason == "auth_denied");
+    const ModeDecisionDetail &authDeniedDetail = authDeniedManager.getLastDecisionDetail();
+    assert(!authDeniedDetail.disqualifiedSources.empty());
+    assert(authDeniedDetail.disqualifiedSources.front().source == "authorization");
+    assert(authDeniedDetail.disqualifiedSources.front().reason == "auth_denied");
+    assert(authDeniedDetail.downgradeReason == "auth_denied");
+    decision = authDeniedManager.decide(sensors);
+    assert(decision.reason == "auth_denied");
+    assert(authDeniedDetail.disqualifiedSources.size() == 1);
+    assert(authDeniedDetail.disqualifiedSources.front().mode == "gps");
 
     ModeManagerConfig provenanceModeConfig;
     provenanceModeConfig.minHealthyCount = 1;
@@ -1162,6 +2136,43 @@ int main()
     decision = residualManager.decide(residualSensors);
     assert(decision.mode == TrackingMode::GpsIns);
 
+    // Residuals are cached per sensor pair and only recomputed when a measurement changes.
+    const std::uint64_t residualUpdates = residualManager.residualUpdateCount();
+    assert(residualUpdates > 0);
+    residualGps.setPositionMeasurement({0.0, 0.0, 0.0});
+    decision = residualManager.decide(residualSensors);
+    assert(decision.mode == TrackingMode::GpsIns);
+    assert(residualManager.residualUpdateCount() == residualUpdates);
+    residualImu.setPositionMeasurement({1.0, 0.0, 0.0});
+    decision = residualManager.decide(residualSensors);
+    assert(decision.mode == TrackingMode::GpsIns);
+    assert(residualManager.residualUpdateCount() == residualUpdates + 1);
+    residualImu.setPositionMeasurement({50.0, 0.0, 0.0});
+    decision = residualManager.decide(residualSensors);
+    assert(decision.mode == TrackingMode::Hold);
+    assert(residualManager.getLastDecisionDetail().downgradeReason == "residual_conflict");
+    assert(residualManager.residualUpdateCount() == residualUpdates + 2);
+
+    ModeManagerConfig derivedConfig;
+    derivedConfig.minHealthyCount = 1;
+    derivedConfig.disagreementThreshold = 5.0;
+    derivedConfig.permittedSensors = {"radar", "imu"};
+    derivedConfig.ladderOrder = {"radar_inertial"};
+    ModeManager derivedManager(derivedConfig);
+    TestSensor derivedRadar("radar");
+    TestSensor derivedImu("imu");
+    std::vector<SensorBase *> derivedSensors{&derivedRadar, &derivedImu};
+    derivedRadar.setHealthy(true);
+    derivedImu.setHealthy(true);
+    derivedRadar.setRangeMeasurement(5.0);
+    derivedImu.setPositionMeasurement({3.0, 4.0, 0.0});
+    decision = derivedManager.decide(derivedSensors);
+    assert(decision.mode == TrackingMode::RadarInertial);
+    derivedRadar.setRangeMeasurement(20.0);
+    decision = derivedManager.decide(derivedSensors);
+    assert(decision.mode == TrackingMode::Hold);
+    assert(derivedManager.getLastDecisionDetail().downgradeReason == "residual_conflict");
+
     ModeManagerConfig historyConfig;
     historyConfig.minHealthyCount = 1;
     historyConfig.minConfidence = 0.5;
@@ -1244,6 +2255,18 @@ int main()
     multipathImu.setPositionMeasurement({100.0, 0.0, 0.0});
     decision = multipathManager.decide(multipathSensors);
     assert(decision.mode == TrackingMode::Hold);
+    const ModeDecisionDetail &multipathDetail = multipathManager.getLastDecisionDetail();
+    assert(multipathDetail.downgradeReason == "residual_conflict");
+    assert(multipathDetail.disqualifiedSources.size() == 2);
+    assert(multipathDetail.disqualifiedSources[0].mode == "lio");
+    assert(multipathDetail.disqualifiedSources[0].source == "lidar");
+    assert(multipathDetail.disqualifiedSources[1].source == "imu");
+    assert(multipathDetail.lockouts.size() == 2);
+    // Lockouts are listed in interned sensor-ID order (built-in sensors first, in mode-table order).
+    assert(multipathDetail.lockouts[0].source == "imu");
+    assert(multipathDetail.lockouts[1].source == "lidar");
+    assert(multipathDetail.lockouts[0].reason == "disagreement");
+    assert(multipathDetail.lockouts[0].remainingSteps == 2);
 
     multipathLidar.setPositionMeasurement({0.0, 0.0, 0.0});
     multipathImu.setPositionMeasurement({0.0, 0.0, 0.0});
@@ -1252,8 +2275,13 @@ int main()
 
     multipathLidar.setPositionMeasurement({0.0, 0.0, 0.0});
     multipathImu.setPositionMeasurement({0.0, 0.0, 0.0});
-    decision = multipathManager.decide(multipathSensors);
-    assert(decision.mode == TrackingMode::Lio);
+    const ModeDecision &multipathDecision = multipathManager.decide(multipathSensors);
+    assert(multipathDecision.mode == TrackingMode::Lio);
+    assert(multipathDecision.reason == "enter_lio");
+    assert(&multipathManager.decide(multipathSensors) == &multipathDecision);
+    assert(multipathDecision.reason == "maintain_lio");
+    assert(multipathManager.getLastDecisionDetail().lockouts.empty());
+    assert(multipathManager.getLastDecisionDetail().contributors.size() == 2);
 
     ModeManagerConfig saturationConfig;
     saturationConfig.minHealthyCount = 1;
@@ -1361,6 +2389,66 @@ int main()
     assert(convertedParsed.ok);
     assert(convertedParsed.envelope.mode.activeMode == "gps");
 
+    // Buffer overload: byte-identical payloads, keys in byte order even past ten indexed records.
+    {
+        ExternalIoEnvelope manySensors = packagerEnvelope;
+        manySensors.sensors.clear();
+        for (int idx = 0; idx < 12; ++idx)
+        {
+            manySensors.sensors.push_back({"s" + std::to_string(idx), true, idx % 2 == 0, true, 0.5, 1.0 / 3.0, ""});
+        }
+        manySensors.sensors[3].lastError = "line\nbreak \"quoted\" \\";
+        manySensors.mode.contributors = {"gps", "im,u"};
+        manySensors.frontView.droppedFrames = -3;
+        manySensors.frontView.timestampMs = 18446744073709551615ULL;
+
+        std::string buffer;
+        bool serialized = tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Json, packagerEnvelope, buffer);
+        assert(serialized);
+        assert(buffer == serializedJson.payload);
+        serialized = tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, manySensors, buffer);
+        assert(serialized);
+        assert(buffer == tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, manySensors).payload);
+        assert(buffer.find("mode.contributors=gps,im,u\n") != std::string::npos);
+        assert(buffer.find("front_view.dropped_frames=-3\n") != std::string::npos);
+        assert(buffer.find("front_view.timestamp_ms=18446744073709551615\n") != std::string::npos);
+        assert(buffer.find("sensor.0.confidence=0.33333333333333331\n") != std::string::npos);
+        assert(buffer.find("sensor.3.last_error=line\\nbreak \"quoted\" \\\\\n") != std::string::npos);
+        assert(buffer.find("sensor.1.last_error=\nsensor.10.available=true\n") != std::string::npos);
+        assert(buffer.find("sensor.11.id=s11\nsensor.11.last_error=\nsensor.2.available=true\n") !=
+               std::string::npos);
+        std::string previousKey;
+        std::size_t lineStart = 0;
+        while (lineStart < buffer.size())
+        {
+            const std::size_t lineEnd = buffer.find('\n', lineStart);
+            const std::string key = buffer.substr(lineStart, buffer.find('=', lineStart) - lineStart);
+            assert(previousKey.empty() || previousKey < key);
+            previousKey = key;
+            lineStart = lineEnd + 1;
+        }
+        assert(previousKey == "status.provenance_status");
+        const tools::IoEnvelopeParseResult manyParsed =
+            tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, buffer);
+        assert(manyParsed.ok);
+        assert(manyParsed.envelope.sensors.size() == 12U);
+        assert(manyParsed.envelope.sensors[10].sensorId == "s10");
+        assert(manyParsed.envelope.sensors[3].lastError == manySensors.sensors[3].lastError);
+
+        const std::size_t capacity = buffer.capacity();
+        serialized = tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Json, manySensors, buffer);
+        assert(serialized);
+        assert(buffer.front() == '{' && buffer.back() == '}');
+        assert(buffer.find("\"sensor.3.last_error\":\"line\\nbreak \\\"quoted\\\" \\\\\"") != std::string::npos);
+        const tools::IoEnvelopeParseResult manyJson =
+            tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::Json, buffer);
+        assert(manyJson.ok);
+        assert(manyJson.envelope.mode.contributors.size() == 3U);
+        serialized = tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, manySensors, buffer);
+        assert(serialized);
+        assert(buffer.capacity() >= capacity);
+    }
+
     std::vector<tools::IoEnvelopeCodecDescriptor> codecs = tools::listIoEnvelopeCodecs();
     assert(codecs.size() >= 2U);
     bool sawJsonCodec = false;
@@ -1433,6 +2521,31 @@ int main()
         tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::Json, "{\"schema_version\":\"1.0.0\"");
     assert(!malformedJson.ok);
 
+    // Without mode.contributors the list is empty; it used to be split from the leftover
+    // mode.confidence text.
+    {
+        std::string noContributorsJson = serializedJson.payload;
+        const std::size_t jsonKey = noContributorsJson.find("\"mode.contributors\":\"");
+        assert(jsonKey != std::string::npos);
+        const std::size_t jsonValueEnd = noContributorsJson.find('"', jsonKey + 21);
+        const bool trailingComma = noContributorsJson[jsonValueEnd + 1] == ',';
+        noContributorsJson.erase(trailingComma ? jsonKey : jsonKey - 1, jsonValueEnd + 2 - jsonKey);
+        std::string noContributorsKv = serializedKv.payload;
+        const std::size_t kvKey = noContributorsKv.find("mode.contributors=");
+        assert(kvKey != std::string::npos);
+        noContributorsKv.erase(kvKey, noContributorsKv.find('\n', kvKey) + 1 - kvKey);
+        const std::pair<tools::IoEnvelopeFormat, std::string> withoutContributors[] = {
+            {tools::IoEnvelopeFormat::Json, noContributorsJson},
+            {tools::IoEnvelopeFormat::KeyValue, noContributorsKv}};
+        for (const auto &payload : withoutContributors)
+        {
+            tools::IoEnvelopeParseResult parsed = tools::parseExternalIoEnvelope(payload.first, payload.second);
+            assert(parsed.ok);
+            assert(parsed.envelope.mode.contributors.empty());
+            assert(parsed.envelope.mode.confidence == packagerEnvelope.mode.confidence);
+        }
+    }
+
     std::string nonFiniteKvPayload = serializedKv.payload;
     const auto replaceKvValue = [](std::string &text, const std::string &key, const std::string &value) -> bool
     {
@@ -1457,5 +2570,398 @@ int main()
         tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, nonFiniteKvPayload);
     assert(!nonFiniteKv.ok);
 
+    // In-place parse: same outcome and errors as the result overloads, with the envelope reused.
+    {
+        ExternalIoEnvelope reused;
+        std::string error;
+        bool parsedInPlace = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::Json, serializedJson.payload, reused, error);
+        assert(parsedInPlace);
+        assert(error.empty());
+        assert(tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Json, reused).payload == serializedJson.payload);
+        parsedInPlace = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, nonFiniteKvPayload, reused, error);
+        assert(!parsedInPlace);
+        assert(error == nonFiniteKv.error);
+        parsedInPlace = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, serializedKv.payload, reused, error);
+        assert(parsedInPlace);
+        assert(reused.sensors.size() == 1U);
+        assert(reused.frontView.confidence == packagerEnvelope.frontView.confidence);
+
+        const std::string duplicateKv = serializedKv.payload + "sensor.0.healthy=false\n";
+        parsedInPlace = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, duplicateKv, reused, error);
+        assert(!parsedInPlace);
+        assert(error == "kv duplicate key: sensor.0.healthy");
+        std::string duplicateJson = serializedJson.payload;
+        duplicateJson.insert(1, "\"mode.active\":\"imu\",");
+        parsedInPlace = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::Json, duplicateJson, reused, error);
+        assert(!parsedInPlace);
+        assert(error == "json duplicate key: mode.active");
+        const std::string unknownTwiceKv = serializedKv.payload + "extra.key=1\nextra.key=2\n";
+        parsedInPlace = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, unknownTwiceKv, reused, error);
+        assert(!parsedInPlace);
+        assert(error == "kv duplicate key: extra.key");
+
+        std::string badSensorKv = serializedKv.payload;
+        bool replaced = replaceKvValue(badSensorKv, "sensor.0.available", "yes");
+        assert(replaced);
+        parsedInPlace = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, badSensorKv, reused, error);
+        assert(!parsedInPlace);
+        assert(error == "invalid sensor value at index 0");
+        std::string badSeedJson = serializedJson.payload;
+        replaced = replaceJsonQuotedValue(badSeedJson, "metadata.seed", "-1");
+        assert(replaced);
+        parsedInPlace = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::Json, badSeedJson, reused, error);
+        assert(!parsedInPlace);
+        assert(error == "invalid metadata.seed");
+
+        // An absent optional list parses as empty rather than inheriting another field's text.
+        std::string noContributorsKv = serializedKv.payload;
+        const std::size_t contributorsPos = noContributorsKv.find("mode.contributors=");
+        noContributorsKv.erase(contributorsPos, noContributorsKv.find('\n', contributorsPos) + 1 - contributorsPos);
+        parsedInPlace = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, noContributorsKv, reused, error);
+        assert(parsedInPlace);
+        assert(reused.mode.contributors.empty());
+
+        // Records left over from a larger envelope do not leak into a smaller one.
+        ExternalIoEnvelope threeSensors = packagerEnvelope;
+        threeSensors.sensors.push_back({"imu", true, false, true, 0.0, 0.5, "drift"});
+        threeSensors.sensors.push_back({"baro", false, true, false, 1.0, 0.25, ""});
+        const std::string threeKv = tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, threeSensors).payload;
+        parsedInPlace = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, threeKv, reused, error);
+        assert(parsedInPlace);
+        assert(reused.sensors.size() == 3U);
+        assert(reused.sensors[1].lastError == "drift");
+        parsedInPlace = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, serializedKv.payload, reused, error);
+        assert(parsedInPlace);
+        assert(reused.sensors.size() == 1U);
+        assert(tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::KeyValue, reused).payload == serializedKv.payload);
+    }
+
+    // Binary codec: exact round-trip, same structural rules as the text codecs, fail-closed framing.
+    {
+        assert(tools::isSupportedIoEnvelopeFormat("ie_bin_v1"));
+        assert(tools::isSupportedIoEnvelopeFormat("binary"));
+        assert(tools::ioEnvelopeFormatName(tools::IoEnvelopeFormat::Binary) == "ie_bin_v1");
+
+        ExternalIoEnvelope binaryEnvelope = packagerEnvelope;
+        binaryEnvelope.mode.contributors = {"gps", "im,u", ""};
+        binaryEnvelope.sensors.push_back({"imu", false, true, false, 5e-324, -0.0, "line\nbreak"});
+        binaryEnvelope.frontView.droppedFrames = std::numeric_limits<int>::min();
+        binaryEnvelope.frontView.timestampMs = std::numeric_limits<std::uint64_t>::max();
+        binaryEnvelope.frontView.streamCount = 1U;
+        binaryEnvelope.frontViewStreams.push_back({"primary", "eo", "f1", "eo", 7U, 99U, 1.5, 2.5, 0.75, "gimbal_lock", true});
+
+        std::string binary;
+        const bool serializedBinary = tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, binaryEnvelope, binary);
+        assert(serializedBinary);
+        assert(binary.compare(0, 4, "ATIE") == 0);
+        assert(binary == tools::serializeExternalIoEnvelope("bin", binaryEnvelope).payload);
+        const std::string jsonText = tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Json, binaryEnvelope).payload;
+        assert(binary.size() * 3 < jsonText.size());
+
+        ExternalIoEnvelope decoded;
+        std::string error;
+        bool parsedBinary = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, binary, decoded, error);
+        assert(parsedBinary);
+        assert(decoded.mode.contributors == binaryEnvelope.mode.contributors);
+        assert(decoded.sensors.size() == 2U);
+        assert(decoded.sensors[1].freshnessSeconds == 5e-324);
+        assert(std::signbit(decoded.sensors[1].confidence));
+        assert(decoded.sensors[1].lastError == "line\nbreak");
+        assert(decoded.frontView.droppedFrames == std::numeric_limits<int>::min());
+        assert(decoded.frontView.timestampMs == std::numeric_limits<std::uint64_t>::max());
+        assert(decoded.frontViewStreams.size() == 1U && decoded.frontViewStreams[0].stabilizationActive);
+        assert(tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, decoded).payload == binary);
+
+        const tools::IoEnvelopeSerializeResult binaryToKv =
+            tools::convertExternalIoEnvelope(binary, "ie_bin_v1", "ie_kv_v1");
+        assert(binaryToKv.ok);
+        const tools::IoEnvelopeSerializeResult kvToBinary =
+            tools::convertExternalIoEnvelope(serializedKv.payload, "kv", "bin");
+        assert(kvToBinary.ok);
+        assert(kvToBinary.payload == tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, parsedKv.envelope).payload);
+
+        parsedBinary = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, binary.substr(0, binary.size() - 1), decoded, error);
+        assert(!parsedBinary);
+        assert(error == "binary payload truncated");
+        parsedBinary = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, binary + '\0', decoded, error);
+        assert(!parsedBinary);
+        assert(error == "binary trailing bytes");
+        parsedBinary = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, serializedJson.payload, decoded, error);
+        assert(!parsedBinary);
+        assert(error == "binary invalid magic");
+        std::string futureVersion = binary;
+        futureVersion[4] = 2;
+        parsedBinary = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, futureVersion, decoded, error);
+        assert(!parsedBinary);
+        assert(error == "binary unsupported version: 2");
+
+        ExternalIoEnvelope invalid = binaryEnvelope;
+        invalid.sensors[1].sensorId = "gps";
+        parsedBinary = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::Binary,
+                                                      tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, invalid).payload,
+                                                      decoded, error);
+        assert(!parsedBinary);
+        assert(error == "duplicate sensor id: gps");
+        invalid = binaryEnvelope;
+        invalid.frontView.latencyMs = std::numeric_limits<double>::infinity();
+        parsedBinary = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::Binary,
+                                                      tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, invalid).payload,
+                                                      decoded, error);
+        assert(!parsedBinary);
+        assert(error == "binary invalid front_view.latency_ms");
+        invalid = binaryEnvelope;
+        invalid.frontView.streamIndex = 1U;
+        parsedBinary = tools::parseExternalIoEnvelope(tools::IoEnvelopeFormat::Binary,
+                                                      tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, invalid).payload,
+                                                      decoded, error);
+        assert(!parsedBinary);
+        assert(error == "front_view.stream_index must be less than stream_count");
+    }
+
+    // Delta stream codec: keyframes and deltas reconstruct each envelope exactly; gaps force a resync.
+    {
+        ExternalIoEnvelope tick = packagerEnvelope;
+        tick.frontView.streamCount = 1U;
+        tick.frontViewStreams.push_back({"primary", "eo", "f1", "eo", 7U, 99U, 1.5, 2.5, 0.75, "gimbal_lock", true});
+        tools::IoEnvelopeDeltaEncoder encoder(4);
+        tools::IoEnvelopeDeltaDecoder decoder;
+        ExternalIoEnvelope decoded;
+        std::string payload;
+        std::string error;
+        std::vector<std::string> payloads;
+        assert(decoder.needsKeyframe());
+        for (std::uint64_t step = 0; step < 10U; ++step)
+        {
+            tick.frontView.timestampMs += 20U;
+            tick.frontView.sequence += 1U;
+            tick.frontView.latencyMs = 10.0 + static_cast<double>(step);
+            tick.frontViewStreams[0].timestampMs = tick.frontView.timestampMs;
+            tick.sensors[0].freshnessSeconds = 0.01 * static_cast<double>(step);
+            if (step == 3U)
+            {
+                tick.sensors.push_back({"imu", true, true, false, 0.2, 0.5, ""});
+                tick.mode.contributors = {"imu", "gps"};
+            }
+            if (step == 5U)
+            {
+                tick.sensors[1].confidence = -0.0;
+            }
+            if (step == 6U)
+            {
+                tick.sensors.erase(tick.sensors.begin());
+                tick.frontViewStreams.clear();
+                tick.frontView.streamCount = 0U;
+            }
+            encoder.encode(tick, payload);
+            payloads.push_back(payload);
+            const bool decodedStep = decoder.decode(payload, decoded, error);
+            assert(decodedStep);
+            assert(decoder.sequence() == step);
+            assert(tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, decoded).payload ==
+                   tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, tick).payload);
+            assert((payload[5] == 0) == (step % 4U == 0U));
+        }
+        assert(std::signbit(decoded.sensors[0].confidence));
+        assert(payloads[1].size() * 5 < payloads[0].size());
+        assert(encoder.sequence() == 10U);
+
+        tools::IoEnvelopeDeltaDecoder late;
+        bool lateDecoded = late.decode(payloads[1], decoded, error);
+        assert(!lateDecoded);
+        assert(error == "delta awaiting keyframe");
+        lateDecoded = late.decode(payloads[0], decoded, error);
+        assert(lateDecoded);
+        lateDecoded = late.decode(payloads[2], decoded, error);
+        assert(!lateDecoded);
+        assert(error == "delta sequence gap: expected 1, got 2");
+        assert(late.needsKeyframe());
+        lateDecoded = late.decode(payloads[1], decoded, error);
+        assert(!lateDecoded);
+        assert(error == "delta awaiting keyframe");
+        encoder.requestKeyframe();
+        encoder.encode(tick, payload);
+        assert(payload[5] == 0);
+        lateDecoded = late.decode(payload, decoded, error);
+        assert(lateDecoded);
+        assert(!late.needsKeyframe());
+        assert(tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, decoded).payload ==
+               tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Binary, tick).payload);
+
+        tick.frontView.sequence += 1U;
+        encoder.encode(tick, payload);
+        lateDecoded = late.decode(payload.substr(0, payload.size() - 1), decoded, error);
+        assert(!lateDecoded);
+        assert(error == "binary payload truncated");
+        assert(late.needsKeyframe());
+        std::string foreign = payload;
+        foreign[3] = 'X';
+        lateDecoded = late.decode(foreign, decoded, error);
+        assert(!lateDecoded);
+        assert(error == "delta invalid magic");
+        assert(late.needsKeyframe());
+
+        // An unknown frame kind drops sync like any other failure.
+        encoder.requestKeyframe();
+        encoder.encode(tick, payload);
+        lateDecoded = late.decode(payload, decoded, error);
+        assert(lateDecoded);
+        tick.frontView.sequence += 1U;
+        encoder.encode(tick, payload);
+        std::string unknownKind = payload;
+        unknownKind[5] = 7;
+        lateDecoded = late.decode(unknownKind, decoded, error);
+        assert(!lateDecoded);
+        assert(error == "delta invalid frame kind: 7");
+        assert(late.needsKeyframe());
+        lateDecoded = late.decode(payload, decoded, error);
+        assert(!lateDecoded);
+        assert(error == "delta awaiting keyframe");
+
+        ExternalIoEnvelope duplicate = tick;
+        duplicate.sensors.push_back(duplicate.sensors[0]);
+        encoder.requestKeyframe();
+        encoder.encode(tick, payload);
+        lateDecoded = late.decode(payload, decoded, error);
+        assert(lateDecoded);
+        encoder.encode(duplicate, payload);
+        lateDecoded = late.decode(payload, decoded, error);
+        assert(!lateDecoded);
+        assert(error == "duplicate sensor id: imu");
+    }
+
+    // Envelope streams: framed records convert through bounded windows, and the parallel archive
+    // path writes the same bytes and stops at the same record as the sequential one.
+    {
+        const auto readFile = [](const std::filesystem::path &path) {
+            std::ifstream file(path.string(), std::ios::binary);
+            return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        };
+        const auto convertFile = [](const std::filesystem::path &input,
+                                    const std::filesystem::path &output,
+                                    const tools::IoEnvelopeStreamOptions &options,
+                                    bool archive) {
+            const int outputFd = tools::openIoEnvelopeStreamFile(output.string(), true);
+            assert(outputFd >= 0);
+            tools::IoEnvelopeStreamResult result;
+            if (archive)
+            {
+                tools::IoEnvelopeArchive mapped;
+                std::string openError;
+                const bool opened = mapped.open(input.string(), openError);
+                assert(opened);
+                result = tools::convertExternalIoEnvelopeArchive(mapped.bytes(), outputFd, options);
+            }
+            else
+            {
+                const int inputFd = tools::openIoEnvelopeStreamFile(input.string(), false);
+                assert(inputFd >= 0);
+                result = tools::convertExternalIoEnvelopeStream(inputFd, outputFd, options);
+                tools::closeIoEnvelopeStreamFile(inputFd);
+            }
+            tools::closeIoEnvelopeStreamFile(outputFd);
+            return result;
+        };
+
+        tools::IoEnvelopeFraming framing = tools::IoEnvelopeFraming::Newline;
+        bool framingParsed = tools::parseIoEnvelopeFraming("length", framing);
+        assert(framingParsed && framing == tools::IoEnvelopeFraming::LengthPrefixed);
+        framingParsed = tools::parseIoEnvelopeFraming("ndjson", framing);
+        assert(framingParsed && framing == tools::IoEnvelopeFraming::Newline);
+        framingParsed = tools::parseIoEnvelopeFraming("csv", framing);
+        assert(!framingParsed);
+        assert(!tools::isIoEnvelopeFramingSupported(tools::IoEnvelopeFormat::KeyValue, tools::IoEnvelopeFraming::Newline));
+
+        std::string ndjson;
+        std::string canonical;
+        for (std::uint64_t idx = 0; idx < 40U; ++idx)
+        {
+            ExternalIoEnvelope record = packagerEnvelope;
+            record.frontView.timestampMs = 1000U + idx;
+            const std::string line = tools::serializeExternalIoEnvelope(tools::IoEnvelopeFormat::Json, record).payload;
+            canonical += line + "\n";
+            ndjson += line + (idx == 5U ? "\r\n\n" : "\n");
+        }
+        ndjson.pop_back();
+        const std::filesystem::path ndjsonPath = writeConfigFile("stream_envelopes.ndjson", ndjson);
+        const std::filesystem::path binaryPath = std::filesystem::current_path() / "stream_envelopes.bin";
+        const std::filesystem::path roundTripPath = std::filesystem::current_path() / "stream_envelopes_rt.ndjson";
+        const std::filesystem::path parallelPath = std::filesystem::current_path() / "stream_envelopes_par.bin";
+
+        tools::IoEnvelopeStreamOptions toBinary;
+        toBinary.outputFormat = tools::IoEnvelopeFormat::Binary;
+        toBinary.outputFraming = tools::IoEnvelopeFraming::LengthPrefixed;
+        tools::IoEnvelopeStreamResult streamed = convertFile(ndjsonPath, binaryPath, toBinary, false);
+        assert(streamed.ok);
+        assert(streamed.records == 40U);
+        assert(streamed.bytesIn == ndjson.size());
+        assert(streamed.bytesOut == std::filesystem::file_size(binaryPath));
+
+        tools::IoEnvelopeStreamOptions toJson;
+        toJson.inputFormat = tools::IoEnvelopeFormat::Binary;
+        toJson.inputFraming = tools::IoEnvelopeFraming::LengthPrefixed;
+        tools::IoEnvelopeStreamResult roundTrip = convertFile(binaryPath, roundTripPath, toJson, false);
+        assert(roundTrip.ok);
+        assert(readFile(roundTripPath) == canonical);
+
+        tools::IoEnvelopeStreamOptions parallel = toBinary;
+        parallel.workers = 4;
+        parallel.chunkBytes = 1500;
+        tools::IoEnvelopeStreamResult chunked = convertFile(ndjsonPath, parallelPath, parallel, true);
+        assert(chunked.ok);
+        assert(chunked.records == 40U);
+        assert(readFile(parallelPath) == readFile(binaryPath));
+        toJson.workers = 3;
+        toJson.chunkBytes = 700;
+        roundTrip = convertFile(binaryPath, roundTripPath, toJson, true);
+        assert(roundTrip.ok);
+        assert(readFile(roundTripPath) == canonical);
+
+        // The failing record is reported by index and everything before it is still written.
+        std::string broken = canonical;
+        std::size_t recordStart = 0;
+        for (int line = 0; line < 17; ++line)
+        {
+            recordStart = broken.find('\n', recordStart) + 1;
+        }
+        broken.insert(recordStart, "{\"schema_version\":\"2.0.0\"}\n");
+        const std::filesystem::path brokenPath = writeConfigFile("stream_envelopes_broken.ndjson", broken);
+        tools::IoEnvelopeStreamResult brokenSequential = convertFile(brokenPath, binaryPath, toBinary, false);
+        assert(!brokenSequential.ok);
+        assert(brokenSequential.error.rfind("record 17: ", 0) == 0);
+        assert(brokenSequential.records == 17U);
+        tools::IoEnvelopeStreamResult brokenParallel = convertFile(brokenPath, parallelPath, parallel, true);
+        assert(brokenParallel.error == brokenSequential.error);
+        assert(brokenParallel.records == 17U);
+        assert(readFile(parallelPath) == readFile(binaryPath));
+
+        streamed = convertFile(ndjsonPath, binaryPath, toBinary, false);
+        assert(streamed.ok);
+        const std::string framed = readFile(binaryPath);
+        writeConfigFile("stream_envelopes_cut.bin", framed.substr(0, framed.size() - 1));
+        toJson.workers = 1;
+        tools::IoEnvelopeStreamResult cut =
+            convertFile(std::filesystem::current_path() / "stream_envelopes_cut.bin", roundTripPath, toJson, false);
+        assert(cut.error == "record 39: truncated record");
+        assert(cut.records == 39U);
+        toJson.maxRecordBytes = 64;
+        cut = convertFile(binaryPath, roundTripPath, toJson, true);
+        assert(cut.error == "record 0: record exceeds max_record_bytes");
+        tools::IoEnvelopeStreamOptions kvLines;
+        kvLines.outputFormat = tools::IoEnvelopeFormat::KeyValue;
+        const tools::IoEnvelopeStreamResult kvRejected = convertFile(ndjsonPath, roundTripPath, kvLines, false);
+        assert(kvRejected.error == "newline framing does not support output format: ie_kv_v1");
+
+        tools::IoEnvelopeStreamWriter writer(-1, tools::IoEnvelopeFraming::Newline);
+        const bool wroteNewline = writer.write("a\nb");
+        assert(!wroteNewline);
+        assert(writer.error() == "payload cannot be newline framed");
+
+        for (const char *name : {"stream_envelopes.ndjson", "stream_envelopes.bin", "stream_envelopes_rt.ndjson",
+                                 "stream_envelopes_par.bin", "stream_envelopes_broken.ndjson", "stream_envelopes_cut.bin"})
+        {
+            std::filesystem::remove(std::filesystem::current_path() / name);
+        }
+    }
+
     return 0;
 }
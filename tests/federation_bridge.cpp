@@ -1,14 +1,24 @@
+#include "core/hash.h"
 #include "tools/audit_log.h"
 #include "tools/federation_bridge.h"
+#include "tools/federation_publish_queue.h"
+#include "tools/federation_route_table.h"
 #include "tools/io_packager.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdio>
 #include <exception>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <limits>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace
 {
@@ -219,6 +229,367 @@ int main()
     assert(fanoutResult2.frames[0].routeSequence == 1U);
     assert(fanoutResult2.frames[1].routeSequence == 1U);
 
+    tools::FederationBridgeConfig binaryFanoutConfig = fanoutConfig;
+    binaryFanoutConfig.endpoints = {{"edge_bin", "binary", true, true, {"key_alpha"}}};
+    tools::FederationBridge binaryFanoutBridge(binaryFanoutConfig);
+    tools::FederationFanoutResult binaryFanout = binaryFanoutBridge.publishFanout(fanoutEnvelope);
+    assert(binaryFanout.ok);
+    const tools::FederationEventFrame &binaryFrame = binaryFanout.frames[0];
+    assert(binaryFrame.payloadFormat == "ie_bin_v1");
+    assert(binaryFrame.payload.size() < fanoutResult.frames[0].payload.size());
+    tools::IoEnvelopeParseResult binaryPayloadParsed =
+        tools::parseExternalIoEnvelope(binaryFrame.payloadFormat, binaryFrame.payload);
+    assert(binaryPayloadParsed.ok);
+    assert(binaryPayloadParsed.envelope.mode.activeMode == fanoutEnvelope.mode.activeMode);
+    const std::string binaryFrameJson = tools::serializeFederationEventFrameJson(binaryFrame);
+    assert(binaryFrameJson.find("\"payload_encoding\":\"base64\",\"payload\":\"QVRJRQ") != std::string::npos);
+
+    const std::string frameBytes = tools::serializeFederationEventFrameBinary(binaryFrame);
+    assert(frameBytes.size() < binaryFrameJson.size());
+    tools::FederationEventFrame decodedFrame;
+    std::string frameError;
+    bool frameParsed = tools::parseFederationEventFrameBinary(frameBytes, decodedFrame, frameError);
+    assert(frameParsed);
+    assert(decodedFrame.payload == binaryFrame.payload);
+    assert(decodedFrame.routeKey == binaryFrame.routeKey);
+    assert(decodedFrame.federateKeyValidUntilTimestampMs == binaryFrame.federateKeyValidUntilTimestampMs);
+    assert(decodedFrame.sourceLatencyMs == binaryFrame.sourceLatencyMs);
+    assert(decodedFrame.federateAttestationTag == "attest_alpha");
+    assert(tools::serializeFederationEventFrameJson(decodedFrame) == binaryFrameJson);
+    frameParsed = tools::parseFederationEventFrameBinary(frameBytes.substr(0, frameBytes.size() - 1), decodedFrame, frameError);
+    assert(!frameParsed);
+    assert(frameError == "binary frame truncated");
+    frameParsed = tools::parseFederationEventFrameBinary(frameBytes + "x", decodedFrame, frameError);
+    assert(!frameParsed);
+    assert(frameError == "binary frame trailing bytes");
+
+    // A batch matches publishFanout() envelope by envelope, rejections and route sequences included.
+    tools::FederationBridgeConfig batchConfig = fanoutConfig;
+    batchConfig.endpoints.push_back({"Edge_C", "ie_json_v1", true, true, {"KEY_ALPHA"}});
+    batchConfig.requireMonotonicSourceTimestamp = true;
+    std::vector<ExternalIoEnvelope> batchEnvelopes(5, fanoutEnvelope);
+    batchEnvelopes[0].frontView.timestampMs = 5U;
+    batchEnvelopes[1].frontView.timestampMs = 10U;
+    batchEnvelopes[2].frontView.timestampMs = 7U;
+    batchEnvelopes[3].frontView.timestampMs = 12U;
+    batchEnvelopes[3].metadata.platformProfile = "AIR";
+    batchEnvelopes[4].frontView.sourceId = "rear_sensor";
+    tools::FederationBridge sequentialBridge(batchConfig);
+    tools::FederationBridge batchBridge(batchConfig);
+    tools::FederationFrameArena arena;
+    std::size_t batchPublished = batchBridge.publishBatch(batchEnvelopes, arena);
+    assert(batchPublished == 4U);
+    assert(arena.outcomes.size() == 5U);
+    assert(arena.frameCount == 12U);
+    for (std::size_t idx = 0; idx < batchEnvelopes.size(); ++idx)
+    {
+        const tools::FederationFanoutResult expected = sequentialBridge.publishFanout(batchEnvelopes[idx]);
+        const tools::FederationPublishOutcome &outcome = arena.outcomes[idx];
+        assert(outcome.ok == expected.ok);
+        assert(outcome.error == expected.error);
+        assert(outcome.frameCount == expected.frames.size());
+        for (std::size_t frame = 0; frame < outcome.frameCount; ++frame)
+        {
+            assert(tools::serializeFederationEventFrameJson(arena.frames[outcome.firstFrame + frame]) ==
+                   tools::serializeFederationEventFrameJson(expected.frames[frame]));
+        }
+    }
+    assert(arena.outcomes[2].error == "source timestamp regressed for route");
+    assert(arena.frames[arena.outcomes[3].firstFrame].routeSequence == 2U);
+    assert(arena.frames[arena.outcomes[4].firstFrame + 2].endpointId == "edge_c");
+    assert(arena.frames[2].payload == arena.frames[0].payload);
+    std::vector<ExternalIoEnvelope> secondBatch(1, batchEnvelopes[4]);
+    secondBatch[0].frontView.timestampMs = 40U;
+    batchPublished = batchBridge.publishBatch(secondBatch, arena);
+    assert(batchPublished == 1U);
+    assert(arena.frameCount == 3U);
+    assert(arena.frames.size() == 12U);
+    assert(arena.frames[0].routeSequence == 1U);
+    assert(arena.frames[0].routeKey == "theater_alpha/air/rear_sensor");
+
+    // Route-independent rejections are reported ahead of the route-state ones.
+    tools::FederationBridgeConfig precedenceConfig = fanoutConfig;
+    precedenceConfig.startTimestampMs = 5000;
+    precedenceConfig.requireMonotonicSourceTimestamp = true;
+    tools::FederationBridge precedenceBridge(precedenceConfig);
+    ExternalIoEnvelope precedenceEnvelope = fanoutEnvelope;
+    precedenceEnvelope.frontView.timestampMs = 4990U;
+    const tools::FederationFanoutResult precedenceFirst = precedenceBridge.publishFanout(precedenceEnvelope);
+    assert(precedenceFirst.ok);
+    precedenceEnvelope.frontView.timestampMs = 3000U;
+    const tools::FederationFanoutResult regressedAndLate = precedenceBridge.publishFanout(precedenceEnvelope);
+    assert(!regressedAndLate.ok);
+    assert(regressedAndLate.error == "latency budget exceeded");
+
+    // Concurrent producers keep per-route order through the queue; the egress thread owns sequences.
+    {
+        constexpr std::size_t kProducers = 4;
+        constexpr std::size_t kPerProducer = 500;
+        // Logical time advances per publish across all producers, so widen the latency budget.
+        tools::FederationBridgeConfig queueBridgeConfig = fanoutConfig;
+        queueBridgeConfig.maxLatencyBudgetMs = 1.0e9;
+        tools::FederationPublishQueueConfig queueConfig;
+        queueConfig.capacity = 64;
+        queueConfig.maxBatch = 16;
+        std::vector<std::vector<std::uint64_t>> routeSequences(kProducers);
+        std::vector<std::vector<std::uint64_t>> routeTimestamps(kProducers);
+        std::atomic<std::size_t> rejected{0};
+        {
+            tools::FederationPublishQueue queue(
+                queueBridgeConfig,
+                queueConfig,
+                [&](const tools::FederationEventFrame &frame) {
+                    if (frame.endpointId != "edge_a")
+                    {
+                        return;
+                    }
+                    const std::size_t producer = static_cast<std::size_t>(frame.routeKey.back() - '0');
+                    routeSequences[producer].push_back(frame.routeSequence);
+                    routeTimestamps[producer].push_back(frame.sourceTimestampMs);
+                },
+                [&](const ExternalIoEnvelope &, const std::string &) { rejected.fetch_add(1); });
+            std::vector<std::thread> producers;
+            for (std::size_t producer = 0; producer < kProducers; ++producer)
+            {
+                producers.emplace_back([&, producer]() {
+                    ExternalIoEnvelope produced = fanoutEnvelope;
+                    produced.frontView.sourceId = "sensor_" + std::to_string(producer);
+                    for (std::size_t idx = 0; idx < kPerProducer; ++idx)
+                    {
+                        produced.frontView.timestampMs = 1U + idx;
+                        const bool queued = queue.enqueue(produced);
+                        assert(queued);
+                    }
+                });
+            }
+            for (std::thread &producer : producers)
+            {
+                producer.join();
+            }
+            queue.flush();
+            const tools::FederationQueueStats queueStats = queue.stats();
+            assert(queueStats.enqueued == kProducers * kPerProducer);
+            assert(queueStats.published == kProducers * kPerProducer);
+            assert(queueStats.rejected == 0U);
+            assert(queueStats.dropped == 0U);
+            std::uint64_t histogramTotal = 0;
+            for (std::uint64_t count : queueStats.latencyNs)
+            {
+                histogramTotal += count;
+            }
+            assert(histogramTotal == kProducers * kPerProducer);
+            assert(queueStats.latencyQuantileNs(0.5) <= queueStats.latencyQuantileNs(0.99));
+            assert(queueStats.latencyQuantileNs(0.99) > 0U);
+        }
+        assert(rejected.load() == 0U);
+        for (std::size_t producer = 0; producer < kProducers; ++producer)
+        {
+            assert(routeSequences[producer].size() == kPerProducer);
+            for (std::size_t idx = 0; idx < kPerProducer; ++idx)
+            {
+                assert(routeSequences[producer][idx] == idx);
+                assert(routeTimestamps[producer][idx] == 1U + idx);
+            }
+        }
+
+        // DropNewest hands overflow to the hook while the egress thread is held in the sink.
+        std::atomic<bool> releaseSink{false};
+        std::atomic<bool> sinkEntered{false};
+        std::atomic<std::size_t> droppedEnvelopes{0};
+        std::atomic<std::size_t> rejectedEnvelopes{0};
+        std::string rejectReason;
+        tools::FederationPublishQueueConfig dropConfig;
+        dropConfig.capacity = 4;
+        dropConfig.maxBatch = 1;
+        dropConfig.overflow = tools::FederationQueueOverflow::DropNewest;
+        {
+            tools::FederationPublishQueue dropQueue(
+                fanoutConfig,
+                dropConfig,
+                [&](const tools::FederationEventFrame &) {
+                    sinkEntered.store(true);
+                    while (!releaseSink.load())
+                    {
+                        std::this_thread::yield();
+                    }
+                },
+                [&](const ExternalIoEnvelope &, const std::string &error) {
+                    rejectReason = error;
+                    rejectedEnvelopes.fetch_add(1);
+                },
+                [&](const ExternalIoEnvelope &) { droppedEnvelopes.fetch_add(1); });
+            bool queued = dropQueue.enqueue(fanoutEnvelope);
+            assert(queued);
+            while (!sinkEntered.load())
+            {
+                std::this_thread::yield();
+            }
+            ExternalIoEnvelope invalidEnvelope = fanoutEnvelope;
+            invalidEnvelope.metadata.schemaVersion.clear();
+            queued = dropQueue.enqueue(invalidEnvelope);
+            assert(queued);
+            for (int idx = 0; idx < 3; ++idx)
+            {
+                queued = dropQueue.enqueue(fanoutEnvelope);
+                assert(queued);
+            }
+            queued = dropQueue.enqueue(fanoutEnvelope);
+            assert(!queued);
+            assert(droppedEnvelopes.load() == 1U);
+            releaseSink.store(true);
+            dropQueue.flush();
+            const tools::FederationQueueStats dropStats = dropQueue.stats();
+            assert(dropStats.enqueued == 5U);
+            assert(dropStats.dropped == 1U);
+            assert(dropStats.rejected == 1U);
+        }
+        assert(rejectedEnvelopes.load() == 1U);
+        assert(!rejectReason.empty());
+
+        // Block on a full ring: the producer stops retrying and sleeps until the egress thread
+        // frees a slot, then every envelope is published.
+        std::atomic<bool> releaseBlocked{false};
+        std::atomic<bool> blockedSinkEntered{false};
+        tools::FederationPublishQueueConfig blockConfig;
+        blockConfig.capacity = 2;
+        blockConfig.maxBatch = 1;
+        tools::FederationBridgeConfig blockBridgeConfig = fanoutConfig;
+        blockBridgeConfig.maxLatencyBudgetMs = 1.0e9;
+        {
+            tools::FederationPublishQueue blockQueue(
+                blockBridgeConfig,
+                blockConfig,
+                [&](const tools::FederationEventFrame &) {
+                    blockedSinkEntered.store(true);
+                    while (!releaseBlocked.load())
+                    {
+                        std::this_thread::yield();
+                    }
+                });
+            const bool queued = blockQueue.enqueue(fanoutEnvelope);
+            assert(queued);
+            while (!blockedSinkEntered.load())
+            {
+                std::this_thread::yield();
+            }
+            std::thread blockedProducer([&]() {
+                for (int idx = 0; idx < 4; ++idx)
+                {
+                    const bool producerQueued = blockQueue.enqueue(fanoutEnvelope);
+                    assert(producerQueued);
+                }
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            const std::uint64_t settledWaits = blockQueue.stats().backpressureWaits;
+            assert(settledWaits == 1U);
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            assert(blockQueue.stats().backpressureWaits == settledWaits);
+            assert(blockQueue.stats().enqueued == 3U);
+            releaseBlocked.store(true);
+            blockedProducer.join();
+            blockQueue.flush();
+            assert(blockQueue.stats().published == 5U);
+        }
+    }
+
+    // Route handles are interned once; bridges sharing a table never reuse a route sequence.
+    {
+        tools::FlatRouteIndex index;
+        for (std::uint64_t idx = 0; idx < 1000U; ++idx)
+        {
+            const std::string key = "route/" + std::to_string(idx);
+            index.insert(key, tools::FlatRouteIndex::hash(key), idx * 7U);
+        }
+        assert(index.size() == 1000U);
+        for (std::uint64_t idx = 0; idx < 1000U; ++idx)
+        {
+            const std::string key = "route/" + std::to_string(idx);
+            std::uint64_t handle = 0;
+            const bool found = index.find(key, tools::FlatRouteIndex::hash(key), handle);
+            assert(found && handle == idx * 7U);
+        }
+        std::uint64_t missing = 0;
+        assert(!index.find("route/1000", tools::FlatRouteIndex::hash("route/1000"), missing));
+
+        tools::FederationRouteTable routeTable(2, 3);
+        assert(routeTable.shardCount() == 4U);
+        const tools::FederationRouteTable::Handle first = routeTable.intern("theater_alpha/air/a");
+        const tools::FederationRouteTable::Handle second = routeTable.intern("theater_alpha/air/b");
+        assert(second != first);
+        const tools::FederationRouteTable::Handle firstAgain = routeTable.intern("theater_alpha/air/a");
+        assert(firstAgain == first);
+        assert(routeTable.size() == 2U);
+        assert(routeTable.acquire(first).entry().routeKey == "theater_alpha/air/a");
+        assert(routeTable.acquire(first).entry().sequences.size() == 2U);
+
+        constexpr std::size_t kWorkers = 2;
+        constexpr std::size_t kPerWorker = 300;
+        tools::FederationBridgeConfig sharedConfig = fanoutConfig;
+        sharedConfig.maxLatencyBudgetMs = 1.0e9;
+        auto sharedTable = std::make_shared<tools::FederationRouteTable>(2, 8);
+        std::vector<std::vector<std::uint64_t>> workerSequences(kWorkers);
+        std::vector<std::thread> workers;
+        for (std::size_t worker = 0; worker < kWorkers; ++worker)
+        {
+            workers.emplace_back([&, worker]() {
+                tools::FederationBridge workerBridge(sharedConfig, sharedTable);
+                ExternalIoEnvelope routed = fanoutEnvelope;
+                // Differently-cased profiles still resolve to one shared route.
+                routed.metadata.platformProfile = worker == 0 ? "air" : "AIR";
+                for (std::size_t idx = 0; idx < kPerWorker; ++idx)
+                {
+                    const tools::FederationFanoutResult routedResult = workerBridge.publishFanout(routed);
+                    assert(routedResult.ok);
+                    assert(routedResult.frames[0].routeSequence == routedResult.frames[1].routeSequence);
+                    workerSequences[worker].push_back(routedResult.frames[0].routeSequence);
+                }
+            });
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+        std::vector<std::uint64_t> allSequences;
+        for (const auto &sequences : workerSequences)
+        {
+            allSequences.insert(allSequences.end(), sequences.begin(), sequences.end());
+        }
+        std::sort(allSequences.begin(), allSequences.end());
+        for (std::size_t idx = 0; idx < allSequences.size(); ++idx)
+        {
+            assert(allSequences[idx] == idx);
+        }
+        assert(sharedTable->size() == 1U);
+
+        // Rejected envelopes never intern routes into the shared table.
+        tools::FederationBridge gatedBridge(sharedConfig, sharedTable);
+        ExternalIoEnvelope unroutable = fanoutEnvelope;
+        for (std::size_t idx = 0; idx < 50; ++idx)
+        {
+            unroutable.frontView.sourceId = "rejected_" + std::to_string(idx);
+            unroutable.frontView.timestampMs = 5000U + idx;
+            const tools::FederationFanoutResult rejected = gatedBridge.publishFanout(unroutable);
+            assert(!rejected.ok);
+            assert(rejected.error == "source timestamp ahead of time authority");
+        }
+        assert(sharedTable->size() == 1U);
+        unroutable.frontView.sourceId = "accepted";
+        unroutable.frontView.timestampMs = 500U;
+        const tools::FederationFanoutResult accepted = gatedBridge.publishFanout(unroutable);
+        assert(accepted.ok);
+        assert(sharedTable->size() == 2U);
+        unroutable.frontView.timestampMs -= 1U;
+        const tools::FederationFanoutResult regressed = gatedBridge.publishFanout(unroutable);
+        assert(!regressed.ok);
+        assert(regressed.error == "source timestamp regressed for route");
+        assert(sharedTable->size() == 2U);
+
+        tools::FederationBridge mismatchedBridge(fanoutConfig, std::make_shared<tools::FederationRouteTable>(1));
+        const tools::FederationFanoutResult mismatched = mismatchedBridge.publishFanout(fanoutEnvelope);
+        assert(!mismatched.ok);
+        assert(mismatched.error == "route table endpoint count mismatch");
+    }
+
     tools::FederationBridgeConfig untrustedKeyFanoutConfig = fanoutConfig;
     untrustedKeyFanoutConfig.endpoints = {
         {"edge_a", "ie_json_v1", true, true, {"key_other"}}};
@@ -255,6 +626,281 @@ int main()
     assert(auditContent.find("\"event\":\"federation_bridge_denied\"") != std::string::npos);
     assert(auditContent.find("source not allowed by route policy") != std::string::npos);
     removeError.clear();
+    (void)std::filesystem::remove(auditLogPath, removeError);
+
+    // Group-committed records keep the hash chain intact across concurrent writers.
+    std::filesystem::path asyncAuditPath = std::filesystem::current_path() / "audit_log_federation_async_test.jsonl";
+    (void)std::filesystem::remove(asyncAuditPath, removeError);
+    tools::AuditLogConfig asyncAuditConfig = auditConfig;
+    asyncAuditConfig.logPath = asyncAuditPath.string();
+    asyncAuditConfig.asyncWrites = true;
+    asyncAuditConfig.syncEachCommit = true;
+    bool asyncInitOk = tools::initializeAuditLog(asyncAuditConfig, auditStatus);
+    assert(asyncInitOk);
+    {
+        std::vector<std::thread> auditWriters;
+        for (int writer = 0; writer < 4; ++writer)
+        {
+            auditWriters.emplace_back([writer]() {
+                for (int idx = 0; idx < 250; ++idx)
+                {
+                    bool logged = tools::logAuditEvent("async_test", "writer " + std::to_string(writer), std::to_string(idx));
+                    assert(logged);
+                }
+            });
+        }
+        for (std::thread &writer : auditWriters)
+        {
+            writer.join();
+        }
+    }
+    bool asyncFlushOk = tools::flushAuditLog();
+    assert(asyncFlushOk);
+    auto readAuditLines = [](const std::filesystem::path &path) {
+        std::vector<std::string> lines;
+        std::ifstream file(path.string());
+        for (std::string line; std::getline(file, line);)
+        {
+            lines.push_back(line);
+        }
+        return lines;
+    };
+    auto hashField = [](const std::string &line, const std::string &field) {
+        const std::string marker = "\"" + field + "\":\"";
+        const std::size_t begin = line.find(marker) + marker.size();
+        return line.substr(begin, line.find('"', begin) - begin);
+    };
+    std::vector<std::string> asyncLines = readAuditLines(asyncAuditPath);
+    assert(asyncLines.size() == 1001U);
+    for (std::size_t idx = 1; idx < asyncLines.size(); ++idx)
+    {
+        assert(hashField(asyncLines[idx], "prev_hash") == hashField(asyncLines[idx - 1], "entry_hash"));
+    }
+    // Re-initializing drains the writer before the log is reopened.
+    bool beforeReinitLogged = tools::logAuditEvent("async_test", "before reinit", "");
+    assert(beforeReinitLogged);
+    asyncAuditConfig.syncEachCommit = false;
+    asyncInitOk = tools::initializeAuditLog(asyncAuditConfig, auditStatus);
+    assert(asyncInitOk);
+    asyncLines = readAuditLines(asyncAuditPath);
+    assert(asyncLines.size() == 1003U);
+    assert(asyncLines[1001].find("before reinit") != std::string::npos);
+    assert(asyncLines[1002].find("\"event\":\"audit_start\"") != std::string::npos);
+    removeError.clear();
+    (void)std::filesystem::remove(asyncAuditPath, removeError);
+
+    // Rotation seals full segments into a hash-chained manifest, synchronously and from the writer.
+    auto removeAuditFamily = [](const std::filesystem::path &logPath) {
+        const std::string prefix = logPath.filename().string();
+        std::vector<std::filesystem::path> matches;
+        for (const auto &entry : std::filesystem::directory_iterator(logPath.parent_path()))
+        {
+            if (entry.path().filename().string().compare(0, prefix.size(), prefix) == 0)
+            {
+                matches.push_back(entry.path());
+            }
+        }
+        for (const auto &match : matches)
+        {
+            std::error_code ignored;
+            (void)std::filesystem::remove(match, ignored);
+        }
+    };
+    auto countRotatedRecords = [&](const std::filesystem::path &logPath, std::size_t maxSegmentBytes) {
+        std::size_t records = readAuditLines(logPath).size();
+        for (int index = 1;; ++index)
+        {
+            std::string digits = std::to_string(index);
+            digits.insert(0, 6 - digits.size(), '0');
+            const std::filesystem::path segment = logPath.string() + "." + digits;
+            if (!std::filesystem::exists(segment))
+            {
+                break;
+            }
+            assert(std::filesystem::file_size(segment) <= maxSegmentBytes);
+            records += readAuditLines(segment).size();
+        }
+        return records;
+    };
+    std::string segmentError;
+    std::filesystem::path rotatedAuditPath = std::filesystem::current_path() / "audit_log_federation_rotate_test.jsonl";
+    removeAuditFamily(rotatedAuditPath);
+    tools::AuditLogConfig rotatedAuditConfig = auditConfig;
+    rotatedAuditConfig.logPath = rotatedAuditPath.string();
+    rotatedAuditConfig.rotateBytes = 2000;
+    bool rotatedInitOk = tools::initializeAuditLog(rotatedAuditConfig, auditStatus);
+    assert(rotatedInitOk);
+    for (int idx = 0; idx < 30; ++idx)
+    {
+        bool logged = tools::logAuditEvent("rotate_test", "sync \"quoted\" \\ \n\t\x01", std::to_string(idx));
+        assert(logged);
+    }
+    assert(std::filesystem::exists(rotatedAuditPath.string() + ".000003"));
+    assert(countRotatedRecords(rotatedAuditPath, 2000) == 31U);
+    bool segmentsOk = tools::verifyAuditLogSegments(rotatedAuditPath.string(), segmentError);
+    assert(segmentsOk);
+
+    // A later run continues the numbering and the manifest chain, here through the async writer.
+    rotatedAuditConfig.asyncWrites = true;
+    rotatedAuditConfig.groupCommitBytes = 512;
+    rotatedInitOk = tools::initializeAuditLog(rotatedAuditConfig, auditStatus);
+    assert(rotatedInitOk);
+    {
+        std::vector<std::thread> auditWriters;
+        for (int writer = 0; writer < 4; ++writer)
+        {
+            auditWriters.emplace_back([writer]() {
+                for (int idx = 0; idx < 50; ++idx)
+                {
+                    bool logged = tools::logAuditEvent("rotate_test", "async " + std::to_string(writer), std::to_string(idx));
+                    assert(logged);
+                }
+            });
+        }
+        for (std::thread &writer : auditWriters)
+        {
+            writer.join();
+        }
+    }
+    bool rotatedFlushOk = tools::flushAuditLog();
+    assert(rotatedFlushOk);
+    assert(countRotatedRecords(rotatedAuditPath, 2000) == 232U);
+    segmentsOk = tools::verifyAuditLogSegments(rotatedAuditPath.string(), segmentError);
+    assert(segmentsOk);
+    std::size_t manifestEntries = readAuditLines(rotatedAuditPath.string() + ".manifest").size();
+    assert(manifestEntries > 20U);
+
+    {
+        std::ofstream tamper(rotatedAuditPath.string() + ".000002", std::ios::app);
+        tamper << "x";
+    }
+    segmentsOk = tools::verifyAuditLogSegments(rotatedAuditPath.string(), segmentError);
+    assert(!segmentsOk);
+    assert(segmentError == "segment 2: contents differ from manifest");
+    removeAuditFamily(rotatedAuditPath);
+
+    // An edit made before rotation is sealed into the manifest, so only rehashing the records
+    // catches it.
+    rotatedAuditConfig.asyncWrites = false;
+    rotatedInitOk = tools::initializeAuditLog(rotatedAuditConfig, auditStatus);
+    assert(rotatedInitOk);
+    bool originalLogged = tools::logAuditEvent("rotate_test", "original", "0");
+    assert(originalLogged);
+    {
+        std::fstream tamper(rotatedAuditPath, std::ios::in | std::ios::out | std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(tamper)), std::istreambuf_iterator<char>());
+        const std::size_t at = contents.find("original");
+        assert(at != std::string::npos);
+        tamper.seekp(static_cast<std::streamoff>(at));
+        tamper << "0riginal";
+    }
+    for (int idx = 0; idx < 30; ++idx)
+    {
+        bool logged = tools::logAuditEvent("rotate_test", "after", std::to_string(idx));
+        assert(logged);
+    }
+    segmentsOk = tools::verifyAuditLogSegments(rotatedAuditPath.string(), segmentError);
+    assert(!segmentsOk);
+    assert(segmentError == "segment 1: record chain broken");
+    removeAuditFamily(rotatedAuditPath);
+
+    // Records dropped behind a resealed manifest are still caught: at a segment boundary, and
+    // behind an audit_start forged to restart the chain.
+    auto auditSegmentPath = [](const std::filesystem::path &logPath, int index) {
+        std::string digits = std::to_string(index);
+        digits.insert(0, 6 - digits.size(), '0');
+        return std::filesystem::path(logPath.string() + "." + digits);
+    };
+    auto readAuditFile = [](const std::filesystem::path &path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+    auto writeAuditLines = [](const std::filesystem::path &path, const std::vector<std::string> &lines) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        for (const std::string &line : lines)
+        {
+            file << line << "\n";
+        }
+    };
+    auto resealManifest = [&](const std::filesystem::path &logPath) {
+        std::string manifest;
+        std::string prevManifestHash;
+        for (int index = 1; std::filesystem::exists(auditSegmentPath(logPath, index)); ++index)
+        {
+            const std::filesystem::path segment = auditSegmentPath(logPath, index);
+            const std::string bytes = readAuditFile(segment);
+            const std::vector<std::string> lines = readAuditLines(segment);
+            const std::string name = segment.filename().string();
+            const std::string first = hashField(lines.front(), "entry_hash");
+            const std::string last = hashField(lines.back(), "entry_hash");
+            const std::string segmentSha = sha256Hex(bytes.data(), bytes.size());
+            const std::string payload = std::to_string(index) + "|" + name + "|" + std::to_string(bytes.size()) + "|" +
+                                        std::to_string(lines.size()) + "|" + first + "|" + last + "|" + segmentSha +
+                                        "|" + prevManifestHash;
+            const std::string manifestHash = sha256Hex(payload.data(), payload.size());
+            manifest += "{\"segment_index\":" + std::to_string(index) + ",\"segment\":\"" + name + "\",\"bytes\":" +
+                        std::to_string(bytes.size()) + ",\"records\":" + std::to_string(lines.size()) +
+                        ",\"first_entry_hash\":\"" + first + "\",\"last_entry_hash\":\"" + last +
+                        "\",\"segment_sha256\":\"" + segmentSha + "\",\"prev_manifest_hash\":\"" + prevManifestHash +
+                        "\",\"manifest_hash\":\"" + manifestHash + "\"}\n";
+            prevManifestHash = manifestHash;
+        }
+        std::ofstream file(logPath.string() + ".manifest", std::ios::binary | std::ios::trunc);
+        file << manifest;
+    };
+    bool boundaryInitOk = tools::initializeAuditLog(rotatedAuditConfig, auditStatus);
+    assert(boundaryInitOk);
+    for (int idx = 0; idx < 30; ++idx)
+    {
+        bool logged = tools::logAuditEvent("rotate_test", "boundary", std::to_string(idx));
+        assert(logged);
+    }
+    const int sealedSegments = static_cast<int>(readAuditLines(rotatedAuditPath.string() + ".manifest").size());
+    assert(sealedSegments >= 3);
+    resealManifest(rotatedAuditPath);
+    bool resealedOk = tools::verifyAuditLogSegments(rotatedAuditPath.string(), segmentError);
+    assert(resealedOk);
+
+    const std::filesystem::path secondSegment = auditSegmentPath(rotatedAuditPath, 2);
+    const std::string secondSegmentBytes = readAuditFile(secondSegment);
+    std::vector<std::string> segmentLines = readAuditLines(secondSegment);
+    segmentLines.erase(segmentLines.begin());
+    writeAuditLines(secondSegment, segmentLines);
+    resealManifest(rotatedAuditPath);
+    bool droppedAtBoundary = tools::verifyAuditLogSegments(rotatedAuditPath.string(), segmentError);
+    assert(!droppedAtBoundary);
+    assert(segmentError == "segment 2: record chain broken");
+    {
+        std::ofstream restore(secondSegment, std::ios::binary | std::ios::trunc);
+        restore << secondSegmentBytes;
+    }
+
+    // The forged record hashes correctly, so only its non-empty prev_hash gives it away.
+    const std::filesystem::path lastSegment = auditSegmentPath(rotatedAuditPath, sealedSegments);
+    segmentLines = readAuditLines(lastSegment);
+    assert(segmentLines.size() >= 3U);
+    segmentLines.erase(segmentLines.end() - 2);
+    std::string &forged = segmentLines.back();
+    const std::string seedMarker = "\"seed\":";
+    const std::size_t seedBegin = forged.find(seedMarker) + seedMarker.size();
+    const std::string forgedPayload = std::string("audit_start|") + hashField(forged, "message") + "|" +
+                                      hashField(forged, "detail") + "|" + hashField(forged, "ts") + "|" +
+                                      hashField(forged, "build_id") + "|" + hashField(forged, "config_id") + "|" +
+                                      hashField(forged, "config_version") + "|" + hashField(forged, "run_id") + "|" +
+                                      forged.substr(seedBegin, forged.find(',', seedBegin) - seedBegin) + "|" +
+                                      hashField(forged, "role") + "|" + hashField(forged, "prev_hash");
+    const std::string oldEntryHash = hashField(forged, "entry_hash");
+    forged.replace(forged.find("\"event\":\"rotate_test\""), std::string("\"event\":\"rotate_test\"").size(),
+                   "\"event\":\"audit_start\"");
+    forged.replace(forged.find(oldEntryHash), oldEntryHash.size(), sha256Hex(forgedPayload.data(), forgedPayload.size()));
+    writeAuditLines(lastSegment, segmentLines);
+    resealManifest(rotatedAuditPath);
+    bool forgedRestart = tools::verifyAuditLogSegments(rotatedAuditPath.string(), segmentError);
+    assert(!forgedRestart);
+    assert(segmentError == "segment " + std::to_string(sealedSegments) + ": record chain broken");
+    bool defaultInitOk = tools::initializeAuditLog(auditConfig, auditStatus);
+    assert(defaultInitOk);
+    removeAuditFamily(rotatedAuditPath);
     (void)std::filesystem::remove(auditLogPath, removeError);
 
         return 0;
@@ -61,6 +61,18 @@ void runFrontViewDisplayTests()
     assert(frames.front().streamId == "primary");
     assert(frames[1].streamId == "turret");
 
+    const RandomStreamKey frameKey{1337ULL, 2U, randomStreamId("front_view"), 4U};
+    CounterRng counterRngA(frameKey);
+    CounterRng counterRngB(frameKey);
+    FrontViewFrameResult counterFrameA;
+    FrontViewFrameResult counterFrameB;
+    bool counterOkA = frontViewGenerateFrame(config, "ir_white_hot", 4U, counterRngA, counterFrameA, reason, "turret", 2U, 2U);
+    bool counterOkB = frontViewGenerateFrame(config, "ir_white_hot", 4U, counterRngB, counterFrameB, reason, "turret", 2U, 2U);
+    assert(counterOkA && counterOkB);
+    assert(counterFrameA.latencyMs == counterFrameB.latencyMs);
+    assert(counterFrameA.confidence == counterFrameB.confidence);
+    assert(counterFrameA.gimbalYawRateDegPerSec == counterFrameB.gimbalYawRateDegPerSec);
+
     SimConfig::FrontViewConfig invalidModeConfig = config;
     invalidModeConfig.autoCycleEnabled = false;
     invalidModeConfig.displayFamilies = {"invalid_mode"};